@@ -0,0 +1,84 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include <vector>
+#include "algo/crypt/blowfish.h"
+#include "algo/crypt/crc32.h"
+#include "algo/crypt/md5.h"
+#include "algo/crypt/mt.h"
+#include "algo/crypt/sha1.h"
+#include "algo/range.h"
+#include "benchmark.h"
+
+using namespace au;
+
+static const auto _ = []()
+{
+    static bstr input(4 * 1024 * 1024);
+    u32 state = 0x12345678;
+    for (const auto i : algo::range(input.size()))
+    {
+        state = state * 0x343FD + 0x269EC3;
+        input[i] = state >> 24;
+    }
+
+    bench::register_benchmark(
+        "algo::crypt::crc32 4MiB",
+        input.size(),
+        []()
+        {
+            volatile auto checksum = algo::crypt::crc32(input);
+        });
+
+    bench::register_benchmark(
+        "algo::crypt::md5 4MiB",
+        input.size(),
+        []()
+        {
+            const auto digest = algo::crypt::md5(input);
+        });
+
+    bench::register_benchmark(
+        "algo::crypt::sha1 4MiB",
+        input.size(),
+        []()
+        {
+            const auto digest = algo::crypt::sha1(input);
+        });
+
+    static const algo::crypt::Blowfish blowfish("benchmark key"_b);
+    static const bstr blowfish_input(input.get<const u8>(), 1024 * 1024);
+    bench::register_benchmark(
+        "algo::crypt::Blowfish::decrypt 1MiB",
+        blowfish_input.size(),
+        []()
+        {
+            const auto output = blowfish.decrypt(blowfish_input);
+        });
+
+    bench::register_benchmark(
+        "algo::crypt::MersenneTwister 1M words",
+        1024 * 1024 * sizeof(u32),
+        []()
+        {
+            static std::vector<u32> output(1024 * 1024);
+            const auto mt = algo::crypt::MersenneTwister::Classic(0x215D);
+            mt->next_u32_batch(output.data(), output.size());
+        });
+
+    return true;
+}();
@@ -0,0 +1,71 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "algo/pack/huffman.h"
+#include "algo/range.h"
+#include "benchmark.h"
+#include "io/memory_byte_stream.h"
+#include "io/msb_bit_stream.h"
+
+using namespace au;
+
+// Serializes a balanced tree over all 256 symbols in the preorder format
+// HuffmanTree expects. With this tree every code is the symbol's own 8
+// bits, so the payload can be emitted as plain bytes.
+static void write_tree(
+    io::BaseBitStream &bit_stream, const size_t low, const size_t high)
+{
+    if (high - low == 1)
+    {
+        bit_stream.write(1, 0);
+        bit_stream.write(8, low);
+        return;
+    }
+    bit_stream.write(1, 1);
+    const auto mid = (low + high) / 2;
+    write_tree(bit_stream, low, mid);
+    write_tree(bit_stream, mid, high);
+}
+
+static const auto _ = []()
+{
+    static const size_t target_size = 2 * 1024 * 1024;
+
+    io::MemoryByteStream backing_stream;
+    io::MsbBitStream bit_stream(backing_stream);
+    write_tree(bit_stream, 0, 256);
+    u32 state = 0x12345678;
+    for (const auto i : algo::range(target_size))
+    {
+        state = state * 0x343FD + 0x269EC3;
+        bit_stream.write(8, state >> 24);
+    }
+    bit_stream.flush();
+    backing_stream.seek(0);
+    static const auto input = backing_stream.read_to_eof();
+
+    bench::register_benchmark(
+        "algo::pack::decode_huffman 2MiB",
+        target_size,
+        []()
+        {
+            const auto output
+                = algo::pack::decode_huffman(input, target_size);
+        });
+
+    return true;
+}();
@@ -0,0 +1,78 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "algo/pack/lzss.h"
+#include "algo/pack/zlib.h"
+#include "algo/range.h"
+#include "benchmark.h"
+
+using namespace au;
+
+// moderately compressible input: short runs of pseudo-random bytes with
+// repeated phrases mixed in, roughly resembling unpacked game scripts
+static bstr make_input(const size_t size)
+{
+    bstr output(size);
+    u32 state = 0x12345678;
+    for (const auto i : algo::range(size))
+    {
+        state = state * 0x343FD + 0x269EC3;
+        output[i] = (i % 7 == 0) ? state >> 24 : "pattern "[i & 7];
+    }
+    return output;
+}
+
+static const auto _ = []()
+{
+    static const auto input = make_input(4 * 1024 * 1024);
+
+    static const auto lzss_packed = algo::pack::lzss_compress(input);
+    bench::register_benchmark(
+        "algo::pack::lzss_decompress 4MiB",
+        input.size(),
+        []()
+        {
+            const auto output
+                = algo::pack::lzss_decompress(lzss_packed, input.size());
+        });
+
+    static const auto zlib_packed = algo::pack::zlib_deflate(
+        input,
+        algo::pack::ZlibKind::PlainZlib,
+        algo::pack::CompressionLevel::Fast);
+    bench::register_benchmark(
+        "algo::pack::zlib_inflate 4MiB",
+        input.size(),
+        []()
+        {
+            const auto output = algo::pack::zlib_inflate(
+                zlib_packed, input.size());
+        });
+
+    bench::register_benchmark(
+        "algo::pack::zlib_deflate fast 4MiB",
+        input.size(),
+        []()
+        {
+            const auto output = algo::pack::zlib_deflate(
+                input,
+                algo::pack::ZlibKind::PlainZlib,
+                algo::pack::CompressionLevel::Fast);
+        });
+
+    return true;
+}();
@@ -0,0 +1,92 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "benchmark.h"
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+using namespace au;
+using namespace au::bench;
+
+namespace
+{
+    struct Benchmark final
+    {
+        std::string name;
+        size_t bytes_per_iteration;
+        std::function<void()> iteration;
+    };
+}
+
+// iterations per benchmark are bounded by both time and count, so cheap
+// kernels don't spin forever and expensive ones still get a few samples
+static const auto min_duration = std::chrono::milliseconds(500);
+static const size_t max_iterations = 10000;
+
+static std::vector<Benchmark> &get_benchmarks()
+{
+    static std::vector<Benchmark> benchmarks;
+    return benchmarks;
+}
+
+bool bench::register_benchmark(
+    const std::string &name,
+    const size_t bytes_per_iteration,
+    const std::function<void()> iteration)
+{
+    get_benchmarks().push_back({name, bytes_per_iteration, iteration});
+    return true;
+}
+
+void bench::run_benchmarks(const std::string &filter)
+{
+    std::printf("%-40s %10s %12s %9s\n", "name", "iters", "ms/iter", "MB/s");
+    for (const auto &benchmark : get_benchmarks())
+    {
+        if (!filter.empty()
+            && benchmark.name.find(filter) == std::string::npos)
+        {
+            continue;
+        }
+
+        benchmark.iteration(); // warmup
+
+        size_t iterations = 0;
+        const auto start = std::chrono::steady_clock::now();
+        auto now = start;
+        while (now - start < min_duration && iterations < max_iterations)
+        {
+            benchmark.iteration();
+            ++iterations;
+            now = std::chrono::steady_clock::now();
+        }
+
+        const auto total_seconds = std::chrono::duration_cast<
+            std::chrono::nanoseconds>(now - start).count() / 1e9;
+        const auto seconds_per_iteration = total_seconds / iterations;
+        const auto rate = benchmark.bytes_per_iteration
+            / seconds_per_iteration / (1024.0 * 1024.0);
+        std::printf(
+            "%-40s %10zu %12.3f %9.1f\n",
+            benchmark.name.c_str(),
+            iterations,
+            seconds_per_iteration * 1000.0,
+            rate);
+        std::fflush(stdout);
+    }
+}
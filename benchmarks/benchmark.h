@@ -0,0 +1,41 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include "types.h"
+
+namespace au {
+namespace bench {
+
+    // Registers a benchmark at static initialization time, mirroring how
+    // decoders register themselves. The function runs one iteration over
+    // data prepared outside of it; bytes_per_iteration feeds the
+    // throughput report.
+    bool register_benchmark(
+        const std::string &name,
+        const size_t bytes_per_iteration,
+        const std::function<void()> iteration);
+
+    // Runs every benchmark whose name contains the filter (all of them
+    // when the filter is empty): one warmup iteration, then repeated
+    // timed iterations, reporting time per iteration and MB/s.
+    void run_benchmarks(const std::string &filter);
+
+} }
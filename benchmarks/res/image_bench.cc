@@ -0,0 +1,95 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include <vector>
+#include "algo/range.h"
+#include "benchmark.h"
+#include "res/image.h"
+#include "res/pixel_format.h"
+
+using namespace au;
+
+static bstr make_input(const size_t size)
+{
+    bstr output(size);
+    u32 state = 0x12345678;
+    for (const auto i : algo::range(size))
+    {
+        state = state * 0x343FD + 0x269EC3;
+        output[i] = state >> 24;
+    }
+    return output;
+}
+
+static const auto _ = []()
+{
+    static const size_t pixel_count = 1024 * 1024;
+
+    static const auto input_32 = make_input(pixel_count * 4);
+    bench::register_benchmark(
+        "res::read_pixels BGRA8888 1M pixels",
+        input_32.size(),
+        []()
+        {
+            static std::vector<res::Pixel> output(pixel_count);
+            res::read_pixels(
+                input_32.get<const u8>(),
+                output,
+                res::PixelFormat::BGRA8888);
+        });
+
+    static const auto input_16 = make_input(pixel_count * 2);
+    bench::register_benchmark(
+        "res::read_pixels BGR565 1M pixels",
+        input_16.size(),
+        []()
+        {
+            static std::vector<res::Pixel> output(pixel_count);
+            res::read_pixels(
+                input_16.get<const u8>(),
+                output,
+                res::PixelFormat::BGR565);
+        });
+
+    static const auto input_24 = make_input(pixel_count * 3);
+    bench::register_benchmark(
+        "res::read_pixels BGR888 1M pixels",
+        input_24.size(),
+        []()
+        {
+            static std::vector<res::Pixel> output(pixel_count);
+            res::read_pixels(
+                input_24.get<const u8>(),
+                output,
+                res::PixelFormat::BGR888);
+        });
+
+    static const res::Image overlay_source(
+        1024, 1024, input_32, res::PixelFormat::BGRA8888);
+    bench::register_benchmark(
+        "res::Image::overlay 1024x1024",
+        pixel_count * 4,
+        []()
+        {
+            static res::Image base(1024, 1024);
+            base.overlay(
+                overlay_source,
+                res::Image::OverlayKind::OverwriteNonTransparent);
+        });
+
+    return true;
+}();
@@ -0,0 +1,183 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "algo/alloc_stats.h"
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using namespace au;
+using namespace au::algo;
+
+namespace
+{
+    struct AtomicEntry final
+    {
+        std::atomic<u64> alloc_count {0};
+        std::atomic<u64> alloc_bytes {0};
+    };
+}
+
+std::atomic<bool> AllocStats::active(false);
+
+static std::atomic<u64> live_bytes(0);
+static std::atomic<u64> peak_bytes(0);
+
+// entries are never erased, so the thread-local pointers below stay
+// valid for the lifetime of the process
+static std::mutex entries_mutex;
+static std::map<std::string, std::unique_ptr<AtomicEntry>> &get_entries()
+{
+    static std::map<std::string, std::unique_ptr<AtomicEntry>> entries;
+    return entries;
+}
+
+static thread_local AtomicEntry *current_entry = nullptr;
+static thread_local std::string current_label;
+
+static AtomicEntry &resolve(const std::string &label)
+{
+    std::unique_lock<std::mutex> lock(entries_mutex);
+    auto &entries = get_entries();
+    auto it = entries.find(label);
+    if (it == entries.end())
+        it = entries.emplace(label, std::make_unique<AtomicEntry>()).first;
+    return *it->second;
+}
+
+static AtomicEntry &current()
+{
+    if (!current_entry)
+        current_entry = &resolve(current_label);
+    return *current_entry;
+}
+
+void AllocStats::enable()
+{
+    active.store(true);
+}
+
+void AllocStats::disable()
+{
+    active.store(false);
+}
+
+void AllocStats::set_label(const std::string &label)
+{
+    current_label = label;
+    current_entry = &resolve(label);
+}
+
+std::string AllocStats::get_label()
+{
+    return current_label;
+}
+
+void AllocStats::record_alloc(const size_t size)
+{
+    auto &entry = current();
+    entry.alloc_count.fetch_add(1, std::memory_order_relaxed);
+    entry.alloc_bytes.fetch_add(size, std::memory_order_relaxed);
+    const auto live
+        = live_bytes.fetch_add(size, std::memory_order_relaxed) + size;
+    auto peak = peak_bytes.load(std::memory_order_relaxed);
+    while (live > peak
+        && !peak_bytes.compare_exchange_weak(
+            peak, live, std::memory_order_relaxed))
+    {
+    }
+}
+
+void AllocStats::record_free(const size_t size)
+{
+    // clamped rather than subtracted blindly: buffers allocated before
+    // the collection was enabled get freed while it runs
+    auto live = live_bytes.load(std::memory_order_relaxed);
+    while (!live_bytes.compare_exchange_weak(
+        live, live >= size ? live - size : 0, std::memory_order_relaxed))
+    {
+    }
+}
+
+AllocStatsEntry AllocStats::get(const std::string &label)
+{
+    const auto &entry = resolve(label);
+    AllocStatsEntry result;
+    result.alloc_count = entry.alloc_count.load();
+    result.alloc_bytes = entry.alloc_bytes.load();
+    return result;
+}
+
+u64 AllocStats::get_live_bytes()
+{
+    return live_bytes.load();
+}
+
+u64 AllocStats::get_peak_bytes()
+{
+    return peak_bytes.load();
+}
+
+void AllocStats::dump(const Logger &logger)
+{
+    std::vector<std::pair<std::string, AllocStatsEntry>> rows;
+    {
+        std::unique_lock<std::mutex> lock(entries_mutex);
+        for (const auto &kv : get_entries())
+            rows.push_back({kv.first, {}});
+    }
+    for (auto &row : rows)
+        row.second = get(row.first);
+    std::sort(
+        rows.begin(),
+        rows.end(),
+        [](const decltype(rows)::value_type &a,
+            const decltype(rows)::value_type &b)
+        {
+            return a.second.alloc_bytes > b.second.alloc_bytes;
+        });
+
+    logger.info(
+        "buffer allocations (live %.1f MB, peak %.1f MB):\n",
+        get_live_bytes() / (1024.0 * 1024.0),
+        get_peak_bytes() / (1024.0 * 1024.0));
+    logger.info("    allocs     alloc MB  label\n");
+    for (const auto &row : rows)
+    {
+        if (!row.second.alloc_count)
+            continue;
+        logger.info(
+            "%10llu %12.1f  %s\n",
+            static_cast<unsigned long long>(row.second.alloc_count),
+            row.second.alloc_bytes / (1024.0 * 1024.0),
+            row.first.empty() ? "(unlabeled)" : row.first.c_str());
+    }
+}
+
+void AllocStats::reset()
+{
+    std::unique_lock<std::mutex> lock(entries_mutex);
+    for (const auto &kv : get_entries())
+    {
+        kv.second->alloc_count = 0;
+        kv.second->alloc_bytes = 0;
+    }
+    live_bytes = 0;
+    peak_bytes = 0;
+}
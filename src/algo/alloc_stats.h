@@ -0,0 +1,72 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <atomic>
+#include <string>
+#include "logger.h"
+#include "types.h"
+
+namespace au {
+namespace algo {
+
+    struct AllocStatsEntry final
+    {
+        u64 alloc_count = 0;
+        u64 alloc_bytes = 0;
+    };
+
+    // Global buffer allocation counters fed by bstr and Grid, keyed by a
+    // thread-local label (the decoder working on the current thread).
+    // Off by default; when disabled, allocation sites pay one relaxed
+    // load and nothing else. The live and peak totals are process-wide
+    // and exact; the per-label numbers are cumulative, since a buffer
+    // may be freed on a different thread than it was allocated on.
+    class AllocStats final
+    {
+    public:
+        static void enable();
+        static void disable();
+
+        static bool enabled()
+        {
+            return active.load(std::memory_order_relaxed);
+        }
+
+        static void set_label(const std::string &label);
+        static std::string get_label();
+
+        static void record_alloc(const size_t size);
+        static void record_free(const size_t size);
+
+        static AllocStatsEntry get(const std::string &label);
+        static u64 get_live_bytes();
+        static u64 get_peak_bytes();
+
+        // Prints the top consumers sorted by allocated bytes, plus the
+        // process-wide live and peak totals.
+        static void dump(const Logger &logger);
+
+        // Zeroes all counters; labels stay registered.
+        static void reset();
+
+    private:
+        static std::atomic<bool> active;
+    };
+
+} }
@@ -0,0 +1,142 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "algo/big_alloc.h"
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <new>
+#include <vector>
+#include "algo/quota.h"
+
+#if defined(__linux__)
+    #include <sys/mman.h>
+#endif
+
+using namespace au;
+using namespace au::algo;
+
+// big buffers are rounded up to whole huge pages, so identical image
+// dimensions land in identical size classes
+static const size_t huge_page_size = 2 * 1024 * 1024;
+
+// Freed big buffers are kept around rather than returned to the system.
+// Animation archives decode thousands of same-dimension frames, and each
+// frame's pixel buffer would otherwise be allocated, soft-faulted in and
+// torn down again; recycling makes the next frame hit warm, already-mapped
+// memory. Buckets are keyed by the rounded size, reuse is LIFO for cache
+// warmth, and the pool stops growing at a fixed byte cap.
+static const size_t pool_byte_cap = 256 * 1024 * 1024;
+
+namespace
+{
+    class BigBufferPool final
+    {
+    public:
+        u8 *take(const size_t rounded_size)
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            auto bucket = buckets.find(rounded_size);
+            if (bucket == buckets.end() || bucket->second.empty())
+                return nullptr;
+            const auto data = bucket->second.back();
+            bucket->second.pop_back();
+            pooled_bytes -= rounded_size;
+            return data;
+        }
+
+        bool put(u8 *data, const size_t rounded_size)
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (pooled_bytes + rounded_size > pool_byte_cap)
+                return false;
+            buckets[rounded_size].push_back(data);
+            pooled_bytes += rounded_size;
+            return true;
+        }
+
+    private:
+        std::mutex mutex;
+        std::map<size_t, std::vector<u8*>> buckets;
+        size_t pooled_bytes = 0;
+    };
+}
+
+static BigBufferPool pool;
+
+static size_t round_to_huge_pages(const size_t size)
+{
+    return (size + huge_page_size - 1) & ~(huge_page_size - 1);
+}
+
+static u8 *big_alloc_raw(const size_t rounded_size)
+{
+    #if defined(__linux__)
+        // an allocation aligned to the huge page size and spanning whole
+        // huge pages is the shape the khugepaged collapse path wants; the
+        // madvise makes the region eligible even under madvise-only system
+        // settings
+        void *data = nullptr;
+        if (posix_memalign(&data, huge_page_size, rounded_size) != 0)
+        {
+            // plain malloc keeps the free() side uniform for this size
+            // class
+            data = std::malloc(rounded_size);
+            if (!data)
+                throw std::bad_alloc();
+            return reinterpret_cast<u8*>(data);
+        }
+        madvise(data, rounded_size, MADV_HUGEPAGE);
+        return reinterpret_cast<u8*>(data);
+    #else
+        return new u8[rounded_size];
+    #endif
+}
+
+static void big_free_raw(u8 *data)
+{
+    #if defined(__linux__)
+        std::free(data);
+    #else
+        delete[] data;
+    #endif
+}
+
+u8 *algo::big_alloc(const size_t size)
+{
+    if (size < big_alloc_threshold)
+        return new u8[size];
+    // large buffers are where forged header sizes materialize, so the
+    // decode quotas hook in here, before any memory is committed
+    DecodeQuota::check_allocation(size);
+    const auto rounded_size = round_to_huge_pages(size);
+    const auto recycled = pool.take(rounded_size);
+    if (recycled)
+        return recycled;
+    return big_alloc_raw(rounded_size);
+}
+
+void algo::big_free(u8 *data, const size_t size)
+{
+    if (size < big_alloc_threshold)
+    {
+        delete[] data;
+        return;
+    }
+    if (!pool.put(data, round_to_huge_pages(size)))
+        big_free_raw(data);
+}
@@ -0,0 +1,72 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstddef>
+#include "types.h"
+
+namespace au {
+namespace algo {
+
+    // Allocation backend for the big flat buffers - decoded images and
+    // audio run to tens of megabytes and every pixel pass walks them.
+    // Buffers at or above the threshold are allocated aligned to the huge
+    // page size and advised as huge page candidates, which cuts TLB misses
+    // during the walks; anything smaller takes the plain heap path. Freed
+    // big buffers are recycled through a size-bucketed pool, so the
+    // same-dimension frames of an animation archive reuse one warm
+    // mapping instead of faulting in a fresh buffer each. The two size
+    // classes free differently, so the deallocation site must pass the
+    // same size the buffer was allocated with.
+    static const size_t big_alloc_threshold = 1024 * 1024;
+
+    u8 *big_alloc(const size_t size);
+    void big_free(u8 *data, const size_t size);
+
+    // Adapts the backend for container storage (algo::Grid's pixels).
+    // Not final: the standard library derives from allocators to get the
+    // empty base optimization.
+    template<typename T> struct BigAllocator
+    {
+        using value_type = T;
+
+        BigAllocator() = default;
+        template<typename U> BigAllocator(const BigAllocator<U> &) {}
+
+        T *allocate(const size_t count)
+        {
+            return reinterpret_cast<T*>(big_alloc(count * sizeof(T)));
+        }
+
+        void deallocate(T *data, const size_t count)
+        {
+            big_free(reinterpret_cast<u8*>(data), count * sizeof(T));
+        }
+
+        template<typename U> bool operator ==(const BigAllocator<U> &) const
+        {
+            return true;
+        }
+
+        template<typename U> bool operator !=(const BigAllocator<U> &) const
+        {
+            return false;
+        }
+    };
+
+} }
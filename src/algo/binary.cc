@@ -25,8 +25,9 @@ using namespace au;
 bstr algo::unxor(const bstr &input, const u8 key)
 {
     bstr output(input);
-    for (const auto i : algo::range(input.size()))
-        output[i] ^= key;
+    auto output_ptr = output.get<u8>();
+    for (const auto i : algo::range(output.size()))
+        output_ptr[i] ^= key;
     return output;
 }
 
@@ -35,7 +36,10 @@ bstr algo::unxor(const bstr &input, const bstr &key)
     if (!key.size())
         throw err::BadDataSizeError();
     bstr output(input);
-    for (const auto i : algo::range(input.size()))
-        output[i] ^= key[i % key.size()];
+    auto output_ptr = output.get<u8>();
+    const auto key_ptr = key.get<const u8>();
+    const auto key_size = key.size();
+    for (const auto i : algo::range(output.size()))
+        output_ptr[i] ^= key_ptr[i % key_size];
     return output;
 }
@@ -0,0 +1,192 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "algo/copy_stats.h"
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "algo/format.h"
+
+using namespace au;
+using namespace au::algo;
+
+namespace
+{
+    struct AtomicEntry final
+    {
+        std::atomic<u64> copy_count {0};
+        std::atomic<u64> copy_bytes {0};
+    };
+}
+
+std::atomic<bool> CopyStats::active(false);
+
+static std::atomic<u64> output_bytes(0);
+
+// entries are never erased, so references handed out below stay valid
+// for the lifetime of the process
+static std::mutex entries_mutex;
+static std::map<std::string, std::unique_ptr<AtomicEntry>> &get_entries()
+{
+    static std::map<std::string, std::unique_ptr<AtomicEntry>> entries;
+    return entries;
+}
+
+static thread_local const char *current_site = nullptr;
+
+static AtomicEntry &resolve(const std::string &site)
+{
+    std::unique_lock<std::mutex> lock(entries_mutex);
+    auto &entries = get_entries();
+    auto it = entries.find(site);
+    if (it == entries.end())
+        it = entries.emplace(site, std::make_unique<AtomicEntry>()).first;
+    return *it->second;
+}
+
+void CopyStats::enable()
+{
+    active.store(true);
+}
+
+void CopyStats::disable()
+{
+    active.store(false);
+}
+
+CopyStats::SiteScope::SiteScope(const char *site)
+    : previous_site(current_site)
+{
+    current_site = site;
+}
+
+CopyStats::SiteScope::~SiteScope()
+{
+    current_site = previous_site;
+}
+
+void CopyStats::record_copy(const size_t size)
+{
+    record_copy(current_site ? current_site : "bstr copy", size);
+}
+
+void CopyStats::record_copy(const char *site, const size_t size)
+{
+    if (!enabled() || size < copy_stats_threshold)
+        return;
+    auto &entry = resolve(site);
+    entry.copy_count.fetch_add(1, std::memory_order_relaxed);
+    entry.copy_bytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+void CopyStats::record_output(const size_t size)
+{
+    if (!enabled())
+        return;
+    output_bytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+CopyStatsEntry CopyStats::get(const std::string &site)
+{
+    const auto &entry = resolve(site);
+    CopyStatsEntry result;
+    result.copy_count = entry.copy_count.load();
+    result.copy_bytes = entry.copy_bytes.load();
+    return result;
+}
+
+u64 CopyStats::get_total_copied_bytes()
+{
+    std::unique_lock<std::mutex> lock(entries_mutex);
+    u64 total = 0;
+    for (const auto &kv : get_entries())
+        total += kv.second->copy_bytes.load();
+    return total;
+}
+
+u64 CopyStats::get_output_bytes()
+{
+    return output_bytes.load();
+}
+
+void CopyStats::dump(const Logger &logger)
+{
+    std::vector<std::pair<std::string, CopyStatsEntry>> rows;
+    {
+        std::unique_lock<std::mutex> lock(entries_mutex);
+        for (const auto &kv : get_entries())
+            rows.push_back({kv.first, {}});
+    }
+    for (auto &row : rows)
+        row.second = get(row.first);
+    std::sort(
+        rows.begin(),
+        rows.end(),
+        [](const decltype(rows)::value_type &a,
+            const decltype(rows)::value_type &b)
+        {
+            return a.second.copy_bytes > b.second.copy_bytes;
+        });
+
+    u64 total_copies = 0;
+    u64 total_bytes = 0;
+    for (const auto &row : rows)
+    {
+        total_copies += row.second.copy_count;
+        total_bytes += row.second.copy_bytes;
+    }
+
+    logger.info(
+        "buffer copies of %llu KB and up:\n",
+        static_cast<unsigned long long>(copy_stats_threshold / 1024));
+    logger.info("    copies      copy MB  site\n");
+    for (const auto &row : rows)
+    {
+        if (!row.second.copy_count)
+            continue;
+        logger.info(
+            "%10llu %12.1f  %s\n",
+            static_cast<unsigned long long>(row.second.copy_count),
+            row.second.copy_bytes / (1024.0 * 1024.0),
+            row.first.c_str());
+    }
+    const auto output = get_output_bytes();
+    logger.info(
+        "%10llu %12.1f  (total)\n",
+        static_cast<unsigned long long>(total_copies),
+        total_bytes / (1024.0 * 1024.0));
+    logger.info(
+        "output: %.1f MB, copied bytes per output byte: %s\n",
+        output / (1024.0 * 1024.0),
+        output
+            ? algo::format("%.2f", total_bytes / static_cast<f64>(output))
+                .c_str()
+            : "n/a");
+}
+
+void CopyStats::reset()
+{
+    std::unique_lock<std::mutex> lock(entries_mutex);
+    for (const auto &kv : get_entries())
+    {
+        kv.second->copy_count = 0;
+        kv.second->copy_bytes = 0;
+    }
+    output_bytes = 0;
+}
@@ -0,0 +1,96 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <atomic>
+#include <string>
+#include "logger.h"
+#include "types.h"
+
+namespace au {
+namespace algo {
+
+    // copies smaller than this are noise (magic numbers, header
+    // fragments) and are not recorded
+    static const size_t copy_stats_threshold = 64 * 1024;
+
+    struct CopyStatsEntry final
+    {
+        u64 copy_count = 0;
+        u64 copy_bytes = 0;
+    };
+
+    // Global buffer copy counters, keyed by the call site performing the
+    // copy. The recording points sit at the copy primitives (bstr copy
+    // construction and assignment); call sites that wrap a primitive
+    // claim the copy through a SiteScope, so each copied byte is counted
+    // exactly once, at the most specific site that owns it. Together
+    // with the bytes saved to disk this yields the copies-per-output-byte
+    // figure of a run - the number every zero-copy change should push
+    // down. Off by default; when disabled, the copy sites pay a single
+    // relaxed load and nothing else.
+    class CopyStats final
+    {
+    public:
+        static void enable();
+        static void disable();
+
+        static bool enabled()
+        {
+            return active.load(std::memory_order_relaxed);
+        }
+
+        // Attributes copy primitives hit on this thread to the given
+        // site for the lifetime of the scope; nested scopes win.
+        class SiteScope final
+        {
+        public:
+            SiteScope(const char *site);
+            ~SiteScope();
+
+        private:
+            const char *previous_site;
+        };
+
+        // Records a copy at the innermost active SiteScope of this
+        // thread, or under "bstr copy" when there is none.
+        static void record_copy(const size_t size);
+
+        // Records a copy at an explicit site, bypassing the scopes.
+        static void record_copy(const char *site, const size_t size);
+
+        // Records bytes that reached their final destination - the
+        // denominator of the copies-per-output-byte ratio.
+        static void record_output(const size_t size);
+
+        static CopyStatsEntry get(const std::string &site);
+        static u64 get_total_copied_bytes();
+        static u64 get_output_bytes();
+
+        // Prints per-site totals sorted by copied bytes, plus the
+        // copied-bytes-per-output-byte ratio of the run.
+        static void dump(const Logger &logger);
+
+        // Zeroes all counters; sites stay registered.
+        static void reset();
+
+    private:
+        static std::atomic<bool> active;
+    };
+
+} }
@@ -0,0 +1,80 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "algo/cpu.h"
+#include <atomic>
+
+using namespace au;
+using namespace au::algo;
+
+// compilers without the detection builtins get scalar-only dispatch
+static bool detect(const CpuVariant variant)
+{
+    if (variant == CpuVariant::Scalar)
+        return true;
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    if (variant == CpuVariant::Sse4)
+        return __builtin_cpu_supports("sse4.2") != 0;
+    if (variant == CpuVariant::Avx2)
+        return __builtin_cpu_supports("avx2") != 0;
+#endif
+#if defined(__aarch64__) || defined(__ARM_NEON)
+    if (variant == CpuVariant::Neon)
+        return true;
+#endif
+    return false;
+}
+
+// no cap by default; force_cpu_variant lowers it so tests can pretend
+// to run on a weaker CPU
+static std::atomic<u8> variant_cap(0xFF);
+
+bool algo::cpu_supports(const CpuVariant variant)
+{
+    if (static_cast<u8>(variant) > variant_cap.load())
+        return false;
+    static const bool supported[] =
+    {
+        detect(CpuVariant::Scalar),
+        detect(CpuVariant::Sse4),
+        detect(CpuVariant::Avx2),
+        detect(CpuVariant::Neon),
+    };
+    return supported[static_cast<u8>(variant)];
+}
+
+void algo::force_cpu_variant(const CpuVariant variant)
+{
+    variant_cap.store(static_cast<u8>(variant));
+}
+
+void algo::reset_cpu_variant()
+{
+    variant_cap.store(0xFF);
+}
+
+std::string algo::cpu_variant_name(const CpuVariant variant)
+{
+    switch (variant)
+    {
+        case CpuVariant::Scalar: return "scalar";
+        case CpuVariant::Sse4: return "sse4";
+        case CpuVariant::Avx2: return "avx2";
+        case CpuVariant::Neon: return "neon";
+    }
+    return "?";
+}
@@ -0,0 +1,72 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <string>
+#include "types.h"
+
+namespace au {
+namespace algo {
+
+    // Instruction set tiers a kernel implementation can target. One
+    // binary ships all compiled-in variants and picks the best one the
+    // running CPU offers, so accelerated kernels never make the binary
+    // unportable.
+    enum class CpuVariant : u8
+    {
+        Scalar,
+        Sse4,
+        Avx2,
+        Neon,
+    };
+
+    // Whether the running CPU supports the given variant; detection
+    // happens once, on first use. Scalar is always supported.
+    bool cpu_supports(const CpuVariant variant);
+
+    // Testing hook: hides every variant above the given one, so tests
+    // can exercise each compiled-in code path on any machine. Affects
+    // subsequent cpu_supports calls until reset_cpu_variant.
+    void force_cpu_variant(const CpuVariant variant);
+    void reset_cpu_variant();
+
+    std::string cpu_variant_name(const CpuVariant variant);
+
+    // Per-kernel dispatch table. The scalar entry is mandatory; the
+    // accelerated entries stay null on platforms they are not compiled
+    // for and are skipped when the CPU lacks them.
+    template<typename T> struct CpuDispatch final
+    {
+        T choose() const
+        {
+            if (avx2 && cpu_supports(CpuVariant::Avx2))
+                return avx2;
+            if (sse4 && cpu_supports(CpuVariant::Sse4))
+                return sse4;
+            if (neon && cpu_supports(CpuVariant::Neon))
+                return neon;
+            return scalar;
+        }
+
+        T scalar;
+        T sse4 = nullptr;
+        T avx2 = nullptr;
+        T neon = nullptr;
+    };
+
+} }
@@ -464,3 +464,34 @@ void Camellia::decrypt_block_128(
     for (const auto i : algo::range(4))
         output_block[i] ^= key_ptr[i];
 }
+
+void Camellia::decrypt_blocks_128(
+    const size_t first_block_offset,
+    const u8 *input,
+    u8 *output,
+    const size_t block_count) const
+{
+    for (const auto i : algo::range(block_count))
+    {
+        u32 input_block[4];
+        u32 output_block[4];
+        for (const auto j : algo::range(4))
+        {
+            input_block[j]
+                = input[0]
+                | (input[1] << 8)
+                | (input[2] << 16)
+                | (static_cast<u32>(input[3]) << 24);
+            input += 4;
+        }
+        decrypt_block_128(
+            first_block_offset + i * 0x10, input_block, output_block);
+        for (const auto j : algo::range(4))
+        {
+            *output++ = output_block[j] >> 24;
+            *output++ = output_block[j] >> 16;
+            *output++ = output_block[j] >> 8;
+            *output++ = output_block[j];
+        }
+    }
+}
@@ -41,6 +41,16 @@ namespace crypt {
             const u32 input[4],
             u32 output[4]) const;
 
+        // Decrypts a contiguous run of 16-byte blocks in one call. Input
+        // words are read little-endian and output words are written
+        // big-endian, matching the layout the LIB stream reader uses, so
+        // whole spans can be handed over without per-word stream calls.
+        void decrypt_blocks_128(
+            const size_t first_block_offset,
+            const u8 *input,
+            u8 *output,
+            const size_t block_count) const;
+
     private:
         const std::vector<u32> key;
         const size_t grand_rounds;
@@ -16,17 +16,23 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "algo/crypt/lcg.h"
-#include <functional>
+#include <stdexcept>
 
 using namespace au;
 using namespace au::algo::crypt;
 
 struct Lcg::Priv final
 {
+    LcgKind kind;
     u32 seed;
-    std::function<u32(u32&)> next;
 };
 
+static inline u32 msvc(u32 &seed)
+{
+    seed = seed * 0x343FD + 0x269EC3;
+    return (seed >> 16) & 0x7FFF;
+}
+
 static inline u32 minstd(u32 &seed, u32 a, u32 q, u32 r, u32 m)
 {
     s32 x = seed;
@@ -41,41 +47,48 @@ static inline u32 minstd(u32 &seed, u32 a, u32 q, u32 r, u32 m)
 
 Lcg::Lcg(LcgKind kind, u32 seed) : p(new Priv)
 {
+    if (kind != LcgKind::MicrosoftVisualC
+        && kind != LcgKind::ParkMiller
+        && kind != LcgKind::ParkMillerRevised)
+    {
+        throw std::logic_error("Unknown LCG kind");
+    }
+    p->kind = kind;
     p->seed = seed;
-    switch (kind)
+}
+
+Lcg::~Lcg()
+{
+}
+
+u32 Lcg::next()
+{
+    u32 ret = 0;
+    next(&ret, 1);
+    return ret;
+}
+
+void Lcg::next(u32 *output, const size_t count)
+{
+    // the recurrence runs in a tight per-kind loop on a local seed copy
+    // so the whole keystream costs one dispatch
+    auto seed = p->seed;
+    switch (p->kind)
     {
         case LcgKind::MicrosoftVisualC:
-            p->next = [](u32 &seed)
-            {
-                seed = seed * 0x343FD + 0x269EC3;
-                return (seed >> 16) & 0x7FFF;
-            };
+            for (size_t i = 0; i < count; i++)
+                output[i] = msvc(seed);
             break;
 
         case LcgKind::ParkMiller:
-            p->next = [](u32 &seed)
-            {
-                return minstd(seed, 16807, 127773, 2836, 2147483647);
-            };
+            for (size_t i = 0; i < count; i++)
+                output[i] = minstd(seed, 16807, 127773, 2836, 2147483647);
             break;
 
         case LcgKind::ParkMillerRevised:
-            p->next = [](u32 &seed)
-            {
-                return minstd(seed, 48271, 44488, 3399, 2147483647);
-            };
+            for (size_t i = 0; i < count; i++)
+                output[i] = minstd(seed, 48271, 44488, 3399, 2147483647);
             break;
-
-        default:
-            throw std::logic_error("Unknown LCG kind");
     }
-}
-
-Lcg::~Lcg()
-{
-}
-
-u32 Lcg::next()
-{
-    return p->next(p->seed);
+    p->seed = seed;
 }
@@ -38,6 +38,11 @@ namespace crypt {
         ~Lcg();
         u32 next();
 
+        // Draws many values in one call; decryption loops drained the
+        // generator one dispatch per output byte, which dominated over
+        // the recurrence itself.
+        void next(u32 *output, const size_t count);
+
     private:
         struct Priv;
         std::unique_ptr<Priv> p;
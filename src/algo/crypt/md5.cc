@@ -19,6 +19,7 @@
 #include <openssl/md5.h>
 
 using namespace au;
+using namespace au::algo::crypt;
 
 bstr algo::crypt::md5(const bstr &input)
 {
@@ -30,6 +31,37 @@ bstr algo::crypt::md5(const bstr &input)
     return bstr(output, MD5_DIGEST_LENGTH);
 }
 
+struct Md5::Priv final
+{
+    MD5_CTX ctx;
+};
+
+Md5::Md5() : p(new Priv())
+{
+    MD5_Init(&p->ctx);
+}
+
+Md5::~Md5()
+{
+}
+
+void Md5::update(const u8 *data, const size_t size)
+{
+    MD5_Update(&p->ctx, data, size);
+}
+
+void Md5::update(const bstr &data)
+{
+    update(data.get<const u8>(), data.size());
+}
+
+bstr Md5::finish()
+{
+    u8 output[MD5_DIGEST_LENGTH];
+    MD5_Final(output, &p->ctx);
+    return bstr(output, MD5_DIGEST_LENGTH);
+}
+
 bstr algo::crypt::md5(
     const bstr &input,
     const std::array<u32, 4> &custom_init)
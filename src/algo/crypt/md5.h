@@ -18,6 +18,7 @@
 #pragma once
 
 #include <array>
+#include <memory>
 #include "types.h"
 
 namespace au {
@@ -27,4 +28,20 @@ namespace crypt {
     bstr md5(const bstr &input);
     bstr md5(const bstr &input, const std::array<u32, 4> &custom_init);
 
+    // Incremental variant for hashing data as it streams by, without
+    // materializing the whole input first.
+    class Md5 final
+    {
+    public:
+        Md5();
+        ~Md5();
+        void update(const u8 *data, const size_t size);
+        void update(const bstr &data);
+        bstr finish();
+
+    private:
+        struct Priv;
+        std::unique_ptr<Priv> p;
+    };
+
 } } }
@@ -17,6 +17,7 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "algo/crypt/mt.h"
+#include <algorithm>
 #include <array>
 #include "algo/range.h"
 
@@ -111,40 +112,68 @@ MersenneTwister::~MersenneTwister()
 {
 }
 
-u32 MersenneTwister::next_u32()
+static void refill(std::array<u32, n> &mt)
 {
     u32 y;
     static const u32 mag01[2] = {0x0, matrix_a};
+    int kk;
 
-    if (p->mti >= n)
+    for (kk = 0; kk < n - m; kk++)
     {
-        int kk;
-
-        if (p->mti == n + 1)
-            p->seed_func(p.get(), p->default_seed);
-
-        for (kk = 0; kk < n - m; kk++)
-        {
-            y = (p->mt[kk] & upper_mask) | (p->mt[kk + 1] & lower_mask);
-            p->mt[kk] = p->mt[kk + m] ^ (y >> 1) ^ mag01[y & 0x1];
-        }
-
-        for (; kk < n - 1; kk++)
-        {
-            y = (p->mt[kk] & upper_mask) | (p->mt[kk + 1] & lower_mask);
-            p->mt[kk] = p->mt[kk + (m - n)] ^ (y >> 1) ^ mag01[y & 0x1];
-        }
-
-        y = (p->mt[n - 1] & upper_mask) | (p->mt[0] & lower_mask);
-        p->mt[n - 1] = p->mt[m - 1] ^ (y >> 1) ^ mag01[y & 0x1];
+        y = (mt[kk] & upper_mask) | (mt[kk + 1] & lower_mask);
+        mt[kk] = mt[kk + m] ^ (y >> 1) ^ mag01[y & 0x1];
+    }
 
-        p->mti = 0;
+    for (; kk < n - 1; kk++)
+    {
+        y = (mt[kk] & upper_mask) | (mt[kk + 1] & lower_mask);
+        mt[kk] = mt[kk + (m - n)] ^ (y >> 1) ^ mag01[y & 0x1];
     }
 
-    y = p->mt[p->mti++];
+    y = (mt[n - 1] & upper_mask) | (mt[0] & lower_mask);
+    mt[n - 1] = mt[m - 1] ^ (y >> 1) ^ mag01[y & 0x1];
+}
+
+static u32 temper(u32 y)
+{
     y ^= tempering_shift_u(y);
     y ^= tempering_shift_s(y) & tempering_mask_b;
     y ^= tempering_shift_t(y) & tempering_mask_c;
     y ^= tempering_shift_l(y);
     return y;
 }
+
+u32 MersenneTwister::next_u32()
+{
+    if (p->mti >= n)
+    {
+        if (p->mti == static_cast<size_t>(n) + 1)
+            p->seed_func(p.get(), p->default_seed);
+        refill(p->mt);
+        p->mti = 0;
+    }
+
+    return temper(p->mt[p->mti++]);
+}
+
+void MersenneTwister::next_u32_batch(u32 *output, const size_t count)
+{
+    size_t left = count;
+    while (left)
+    {
+        if (p->mti >= n)
+        {
+            if (p->mti == static_cast<size_t>(n) + 1)
+                p->seed_func(p.get(), p->default_seed);
+            refill(p->mt);
+            p->mti = 0;
+        }
+
+        const auto run = std::min(left, n - p->mti);
+        for (const auto i : algo::range(run))
+            output[i] = temper(p->mt[p->mti + i]);
+        p->mti += run;
+        output += run;
+        left -= run;
+    }
+}
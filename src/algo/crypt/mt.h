@@ -37,6 +37,11 @@ namespace crypt {
 
         u32 next_u32();
 
+        // Equivalent to calling next_u32 in a loop, but refills the state
+        // and tempers whole runs at once; intended for keystream use over
+        // large buffers.
+        void next_u32_batch(u32 *output, const size_t count);
+
     private:
         struct Priv;
         MersenneTwister(
@@ -77,12 +77,12 @@ Rsa::~Rsa()
 bstr Rsa::decrypt(const bstr &input) const
 {
     const auto output_size = RSA_size(p->key_impl);
-    auto output = std::make_unique<u8[]>(output_size);
+    bstr output(output_size);
 
     const auto result = RSA_public_decrypt(
         input.size(),
         input.get<const u8>(),
-        output.get(),
+        output.get<u8>(),
         p->key_impl,
         RSA_PKCS1_PADDING);
 
@@ -94,5 +94,5 @@ bstr Rsa::decrypt(const bstr &input) const
         throw err::CorruptDataError(std::string(err.get()));
     }
 
-    return bstr(reinterpret_cast<char*>(output.get()), output_size);
+    return output;
 }
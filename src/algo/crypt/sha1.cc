@@ -19,6 +19,7 @@
 #include <openssl/sha.h>
 
 using namespace au;
+using namespace au::algo::crypt;
 
 bstr algo::crypt::sha1(const bstr &input)
 {
@@ -29,3 +30,34 @@ bstr algo::crypt::sha1(const bstr &input)
     SHA1_Final(output, &ctx);
     return bstr(output, SHA_DIGEST_LENGTH);
 }
+
+struct Sha1::Priv final
+{
+    SHA_CTX ctx;
+};
+
+Sha1::Sha1() : p(new Priv())
+{
+    SHA1_Init(&p->ctx);
+}
+
+Sha1::~Sha1()
+{
+}
+
+void Sha1::update(const u8 *data, const size_t size)
+{
+    SHA1_Update(&p->ctx, data, size);
+}
+
+void Sha1::update(const bstr &data)
+{
+    update(data.get<const u8>(), data.size());
+}
+
+bstr Sha1::finish()
+{
+    u8 output[SHA_DIGEST_LENGTH];
+    SHA1_Final(output, &p->ctx);
+    return bstr(output, SHA_DIGEST_LENGTH);
+}
@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include <memory>
 #include "types.h"
 
 namespace au {
@@ -25,4 +26,20 @@ namespace crypt {
 
     bstr sha1(const bstr &input);
 
+    // Incremental variant for hashing data as it streams by, without
+    // materializing the whole input first.
+    class Sha1 final
+    {
+    public:
+        Sha1();
+        ~Sha1();
+        void update(const u8 *data, const size_t size);
+        void update(const bstr &data);
+        bstr finish();
+
+    private:
+        struct Priv;
+        std::unique_ptr<Priv> p;
+    };
+
 } } }
@@ -21,7 +21,7 @@
 
 using namespace au;
 
-std::string algo::format(const std::string fmt, ...)
+std::string algo::format(const char *fmt, ...)
 {
     std::va_list args;
     va_start(args, fmt);
@@ -30,26 +30,42 @@ std::string algo::format(const std::string fmt, ...)
     return ret;
 }
 
-std::string algo::format(const std::string fmt, std::va_list args)
+std::string algo::format(const char *fmt, std::va_list args)
 {
-    size_t size;
     std::va_list args_copy;
     va_copy(args_copy, args);
 
+    char buffer[256];
+    const int size = vsnprintf(buffer, sizeof(buffer), fmt, args);
+    if (size < 0)
     {
-        const size_t buffer_size = 256;
-        char buffer[buffer_size];
-        size = vsnprintf(buffer, buffer_size, fmt.c_str(), args);
-        if (size < buffer_size)
-        {
-            va_end(args_copy);
-            return std::string(buffer, size);
-        }
+        va_end(args_copy);
+        return "";
+    }
+    if (static_cast<size_t>(size) < sizeof(buffer))
+    {
+        va_end(args_copy);
+        return std::string(buffer, size);
     }
 
-    size++;
-    auto buf = std::make_unique<char[]>(size);
-    vsnprintf(buf.get(), size, fmt.c_str(), args_copy);
+    // long messages format straight into the result's own storage
+    std::string ret(size + 1, '\0');
+    vsnprintf(&ret[0], size + 1, fmt, args_copy);
     va_end(args_copy);
-    return std::string(buf.get(), buf.get() + size - 1);
+    ret.resize(size);
+    return ret;
+}
+
+std::string algo::format(const std::string fmt, ...)
+{
+    std::va_list args;
+    va_start(args, fmt);
+    const auto ret = format(fmt.c_str(), args);
+    va_end(args);
+    return ret;
+}
+
+std::string algo::format(const std::string fmt, std::va_list args)
+{
+    return format(fmt.c_str(), args);
 }
@@ -20,9 +20,23 @@
 #include <cstdarg>
 #include <string>
 
+#if defined(__GNUC__) || defined(__clang__)
+    #define AU_PRINTF_FORMAT(fmt_index, args_index) \
+        __attribute__((format(printf, fmt_index, args_index)))
+#else
+    #define AU_PRINTF_FORMAT(fmt_index, args_index)
+#endif
+
 namespace au {
 namespace algo {
 
+    // literal format strings get checked against their arguments at
+    // compile time and skip the std::string copy per call
+    std::string format(const char *fmt, ...) AU_PRINTF_FORMAT(1, 2);
+    std::string format(const char *fmt, std::va_list args)
+        AU_PRINTF_FORMAT(1, 0);
+
+    // for format strings assembled at runtime
     std::string format(const std::string fmt, ...);
     std::string format(const std::string fmt, std::va_list args);
 
@@ -18,6 +18,8 @@
 #pragma once
 
 #include <vector>
+#include "algo/alloc_stats.h"
+#include "algo/big_alloc.h"
 #include "algo/range.h"
 #include "err.h"
 
@@ -32,6 +34,8 @@ namespace algo {
         {
             if (!width || !height)
                 throw err::BadDataSizeError();
+            if (AllocStats::enabled())
+                AllocStats::record_alloc(content.capacity() * sizeof(T));
         }
 
         Grid(const Grid &other) : Grid(other.width(), other.height())
@@ -43,6 +47,8 @@ namespace algo {
 
         virtual ~Grid()
         {
+            if (AllocStats::enabled())
+                AllocStats::record_free(content.capacity() * sizeof(T));
         }
 
         size_t width() const
@@ -65,6 +71,38 @@ namespace algo {
             return content[x + y * _width];
         }
 
+        // Raw data layer for bulk kernels: rows are contiguous and
+        // consecutive rows are stride() elements apart. The base pointer
+        // is at least malloc-aligned (huge-page aligned for big grids,
+        // see algo/big_alloc.h); rows carry no alignment of their own, so
+        // wide kernels should use the alignment-agnostic packed accessors
+        // (res/pixel.h) rather than assume vector alignment. No bounds
+        // checks.
+        size_t stride() const
+        {
+            return _width;
+        }
+
+        T *data()
+        {
+            return content.data();
+        }
+
+        const T *data() const
+        {
+            return content.data();
+        }
+
+        T *row(const size_t y)
+        {
+            return content.data() + y * _width;
+        }
+
+        const T *row(const size_t y) const
+        {
+            return content.data() + y * _width;
+        }
+
         T *begin()
         {
             return content.data();
@@ -86,7 +124,8 @@ namespace algo {
         }
 
     protected:
-        std::vector<T> content;
+        // big grids come out huge-page backed, see algo/big_alloc.h
+        std::vector<T, BigAllocator<T>> content;
         size_t _width, _height;
     };
 
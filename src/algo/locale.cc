@@ -16,11 +16,18 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "algo/locale.h"
+#include <algorithm>
 #include <cerrno>
+#include <cstring>
 #include <iconv.h>
 #include <memory>
+#include "algo/cpu.h"
 #include "err.h"
 
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#endif
+
 using namespace au;
 
 static bstr replace(const bstr &input, const bstr &from, const bstr &to)
@@ -38,25 +45,108 @@ static bstr replace(const bstr &input, const bstr &from, const bstr &to)
     return output;
 }
 
-static bstr convert_locale(
-    const bstr &input, const std::string &from, const std::string &to)
+namespace
+{
+    // iconv descriptors are expensive to open and filename conversion
+    // runs once per archive entry, so each conversion pair keeps one
+    // descriptor per thread
+    class Converter final
+    {
+    public:
+        Converter(const char *from, const char *to)
+            : conv(iconv_open(to, from))
+        {
+            if (conv == reinterpret_cast<iconv_t>(-1))
+                throw std::logic_error("Failed to initialize iconv");
+        }
+
+        ~Converter()
+        {
+            iconv_close(conv);
+        }
+
+        iconv_t conv;
+    };
+}
+
+// Index of the first byte with the high bit set, or size. Script-heavy
+// archives convert megabytes of mostly-ASCII text, so the scan is the
+// inner loop of transcoding and runs a block at a time.
+using FindNonAsciiFn = size_t (*)(const u8 *data, const size_t size);
+
+static size_t find_non_ascii_scalar(const u8 *data, const size_t size)
+{
+    size_t i = 0;
+    while (i + 8 <= size)
+    {
+        u64 word;
+        std::memcpy(&word, data + i, 8);
+        if (word & 0x8080808080808080ull)
+            break;
+        i += 8;
+    }
+    while (i < size && !(data[i] & 0x80))
+        i++;
+    return i;
+}
+
+#if defined(__AVX2__)
+static size_t find_non_ascii_avx2(const u8 *data, const size_t size)
 {
-    iconv_t conv = iconv_open(to.c_str(), from.c_str());
-    if (!conv)
-        throw std::logic_error("Failed to initialize iconv");
+    size_t i = 0;
+    while (i + 32 <= size)
+    {
+        const auto block = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(data + i));
+        const auto mask = _mm256_movemask_epi8(block);
+        if (mask)
+            return i + __builtin_ctz(mask);
+        i += 32;
+    }
+    return i + find_non_ascii_scalar(data + i, size - i);
+}
+#endif
+
+static const algo::CpuDispatch<FindNonAsciiFn> find_non_ascii_dispatch
+{
+    find_non_ascii_scalar,
+    nullptr,
+    #if defined(__AVX2__)
+        find_non_ascii_avx2,
+    #else
+        nullptr,
+    #endif
+    nullptr,
+};
+
+static size_t find_non_ascii(const u8 *data, const size_t size)
+{
+    return find_non_ascii_dispatch.choose()(data, size);
+}
+
+// 7-bit content encodes identically in SJIS and UTF-8
+static bool is_7bit_clean(const bstr &input)
+{
+    return find_non_ascii(input.get<const u8>(), input.size()) == input.size();
+}
+
+static bstr convert_locale(const bstr &input, const iconv_t conv)
+{
+    // discard any shift state left over from a previously failed run
+    iconv(conv, nullptr, nullptr, nullptr, nullptr);
 
     bstr output;
     output.reserve(input.size() * 2);
 
     auto input_ptr = const_cast<char*>(input.get<const char>());
     auto input_bytes_left = input.size();
-    bstr buffer(32);
+    char buffer[1024];
 
     while (true)
     {
-        auto output_buffer = buffer.get<char>();
-        auto output_bytes_left = buffer.size();
-        int ret = iconv(
+        auto output_buffer = buffer;
+        auto output_bytes_left = sizeof(buffer);
+        const auto ret = iconv(
             conv,
             &input_ptr,
             &input_bytes_left,
@@ -64,16 +154,15 @@ static bstr convert_locale(
             &output_bytes_left);
         const auto err = errno;
 
-        output += buffer.substr(0, buffer.size() - output_bytes_left);
+        output += bstr(buffer, sizeof(buffer) - output_bytes_left);
 
-        if (ret != -1 && input_bytes_left == 0)
+        if (ret != static_cast<size_t>(-1) && input_bytes_left == 0)
             break;
 
         // repeat the iteration unless nothing was parsed at all
-        if (err == E2BIG && output_bytes_left != buffer.size())
+        if (err == E2BIG && output_bytes_left != sizeof(buffer))
             continue;
 
-        iconv_close(conv);
         if (err == E2BIG)
             throw err::CorruptDataError("Code point too large to decode (?)");
         else if (err == EINVAL || err == EILSEQ)
@@ -82,28 +171,78 @@ static bstr convert_locale(
             throw err::CorruptDataError("Unknown iconv error");
     }
 
-    iconv_close(conv);
     return output;
 }
 
+// ASCII stretches shorter than this ride along with the surrounding SJIS
+// run; an iconv call per tiny island would cost more than it saves
+static const size_t min_ascii_span = 32;
+
 bstr algo::sjis_to_utf8(const bstr &input)
 {
-    return convert_locale(input, "cp932", "utf-8");
+    const auto *data = input.get<const u8>();
+    const auto size = input.size();
+    if (find_non_ascii(data, size) == size)
+        return input;
+    thread_local Converter converter("cp932", "utf-8");
+
+    // Mixed content converts span-wise: ASCII spans are copied through
+    // verbatim - they encode identically in both - and only the SJIS runs
+    // go through iconv. The run scan steps whole characters (half-width
+    // katakana is a single byte, everything else above 0x7F leads a two
+    // byte pair), so a trail byte that happens to fall in the ASCII range
+    // never cuts a character in half.
+    bstr output;
+    output.reserve(size + size / 2);
+    size_t pos = 0;
+    while (pos < size)
+    {
+        const auto ascii_span = find_non_ascii(data + pos, size - pos);
+        output += bstr(data + pos, ascii_span);
+        pos += ascii_span;
+        if (pos == size)
+            break;
+
+        const auto run_start = pos;
+        while (pos < size)
+        {
+            const auto c = data[pos];
+            if (!(c & 0x80))
+            {
+                const auto island = find_non_ascii(data + pos, size - pos);
+                if (island >= min_ascii_span || pos + island == size)
+                    break;
+                pos += island;
+            }
+            else if (c >= 0xA1 && c <= 0xDF)
+                pos++;
+            else
+                pos += std::min<size_t>(2, size - pos);
+        }
+        output += convert_locale(
+            bstr(data + run_start, pos - run_start), converter.conv);
+    }
+    return output;
 }
 
 bstr algo::utf16_to_utf8(const bstr &input)
 {
-    return convert_locale(input, "utf-16le", "utf-8");
+    thread_local Converter converter("utf-16le", "utf-8");
+    return convert_locale(input, converter.conv);
 }
 
 bstr algo::utf8_to_sjis(const bstr &input)
 {
-    return convert_locale(input, "utf-8", "cp932");
+    if (is_7bit_clean(input))
+        return input;
+    thread_local Converter converter("utf-8", "cp932");
+    return convert_locale(input, converter.conv);
 }
 
 bstr algo::utf8_to_utf16(const bstr &input)
 {
-    return convert_locale(input, "utf-8", "utf-16le");
+    thread_local Converter converter("utf-8", "utf-16le");
+    return convert_locale(input, converter.conv);
 }
 
 bstr algo::normalize_sjis(const bstr &utf8_input)
@@ -16,11 +16,18 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "algo/pack/huffman.h"
+#include <cstring>
+#include "err.h"
 #include "io/msb_bit_stream.h"
 
 using namespace au;
 using namespace au::algo::pack;
 
+static bool is_internal_node(const u16 node)
+{
+    return node >= 256 && node <= 511;
+}
+
 static int init_huffman_impl(
     io::BaseBitStream &input_stream, u16 nodes[2][512], int &size)
 {
@@ -39,6 +46,7 @@ HuffmanTree::HuffmanTree(io::BaseBitStream &input_stream)
 {
     size = 256;
     root = init_huffman_impl(input_stream, nodes, size);
+    build_table();
 }
 
 HuffmanTree::HuffmanTree(const bstr &data)
@@ -46,22 +54,119 @@ HuffmanTree::HuffmanTree(const bstr &data)
     io::MsbBitStream input_stream(data);
     size = 256;
     root = init_huffman_impl(input_stream, nodes, size);
+    build_table();
 }
 
-bstr algo::pack::decode_huffman(
+void HuffmanTree::fill_table(
+    const u16 node, const u32 code, const size_t length)
+{
+    if (!is_internal_node(node))
+    {
+        // every table slot whose prefix equals this code decodes to it
+        const auto first = code << (table_bits - length);
+        const auto count = 1 << (table_bits - length);
+        for (auto i = first; i < first + count; i++)
+            table[i] = {node, static_cast<u8>(length)};
+        return;
+    }
+    if (length == table_bits)
+    {
+        table[code] = {node, 0};
+        return;
+    }
+    fill_table(nodes[0][node], code << 1, length + 1);
+    fill_table(nodes[1][node], (code << 1) | 1, length + 1);
+}
+
+void HuffmanTree::build_table()
+{
+    if (is_internal_node(root))
+        fill_table(root, 0, 0);
+}
+
+static u32 peek_bits(
+    const u8 *data,
+    const size_t data_size,
+    const size_t bit_pos,
+    const size_t count)
+{
+    const auto byte_pos = bit_pos >> 3;
+    u64 window = 0;
+    for (const auto i : {0, 1, 2, 3, 4, 5, 6, 7})
+    {
+        window <<= 8;
+        if (byte_pos + i < data_size)
+            window |= data[byte_pos + i];
+    }
+    return (window >> (64 - (bit_pos & 7) - count)) & ((1 << count) - 1);
+}
+
+static bstr decode_huffman_impl(
     const HuffmanTree &huffman_tree,
     const bstr &input,
+    size_t bit_pos,
     const size_t target_size)
 {
     bstr output;
-    output.resize(target_size);
-    io::MsbBitStream input_stream(input);
-    while (output.size() < target_size && input_stream.left())
+    output.reserve(target_size);
+    const auto *data = input.get<const u8>();
+    const auto total_bits = input.size() * 8;
+
+    if (!is_internal_node(huffman_tree.root))
     {
-        auto byte = huffman_tree.root;
-        while (byte >= 256 && byte <= 511)
-            byte = huffman_tree.nodes[input_stream.read(1)][byte];
-        output += static_cast<const u8>(byte);
+        // degenerate single-leaf tree: emits symbols without consuming bits
+        if (bit_pos < total_bits)
+        {
+            output.resize(target_size);
+            std::memset(
+                output.get<u8>(),
+                static_cast<u8>(huffman_tree.root),
+                target_size);
+        }
+        return output;
+    }
+
+    while (output.size() < target_size && bit_pos < total_bits)
+    {
+        const auto peeked = peek_bits(
+            data, input.size(), bit_pos, HuffmanTree::table_bits);
+        const auto &entry = huffman_tree.table[peeked];
+        if (entry.length)
+        {
+            if (bit_pos + entry.length > total_bits)
+                throw err::EofError();
+            output += static_cast<u8>(entry.value);
+            bit_pos += entry.length;
+            continue;
+        }
+        // code longer than the table covers - walk the remaining levels
+        auto node = entry.value;
+        bit_pos += HuffmanTree::table_bits;
+        while (is_internal_node(node))
+        {
+            if (bit_pos >= total_bits)
+                throw err::EofError();
+            node = huffman_tree.nodes
+                [peek_bits(data, input.size(), bit_pos, 1)][node];
+            bit_pos++;
+        }
+        output += static_cast<u8>(node);
     }
     return output;
 }
+
+bstr algo::pack::decode_huffman(
+    const HuffmanTree &huffman_tree,
+    const bstr &input,
+    const size_t target_size)
+{
+    return decode_huffman_impl(huffman_tree, input, 0, target_size);
+}
+
+bstr algo::pack::decode_huffman(const bstr &input, const size_t target_size)
+{
+    io::MsbBitStream input_stream(input);
+    const HuffmanTree huffman_tree(input_stream);
+    return decode_huffman_impl(
+        huffman_tree, input, input_stream.pos(), target_size);
+}
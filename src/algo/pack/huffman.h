@@ -31,6 +31,22 @@ namespace pack {
         int size;
         u16 root;
         u16 nodes[2][512];
+
+        // Lookup table mapping the next table_bits of input to a decoded
+        // symbol and its code length in one load; codes longer than
+        // table_bits store the node to continue the walk from and a zero
+        // length.
+        static const size_t table_bits = 10;
+        struct TableEntry final
+        {
+            u16 value;
+            u8 length;
+        };
+        TableEntry table[1 << table_bits];
+
+    private:
+        void build_table();
+        void fill_table(const u16 node, const u32 code, const size_t length);
     };
 
     bstr decode_huffman(
@@ -38,4 +54,8 @@ namespace pack {
         const bstr &input,
         const size_t target_size);
 
+    // For streams that carry the serialized tree immediately followed by
+    // the compressed payload.
+    bstr decode_huffman(const bstr &input, const size_t target_size);
+
 } } }
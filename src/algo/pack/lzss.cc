@@ -16,9 +16,11 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "algo/pack/lzss.h"
-#include <array>
+#include "algo/pack/lzss_engine.h"
 #include "algo/ptr.h"
 #include "algo/range.h"
+#include "algo/scratch_arena.h"
+#include "err.h"
 #include "io/memory_byte_stream.h"
 #include "io/msb_bit_stream.h"
 
@@ -164,43 +166,54 @@ bstr algo::pack::lzss_decompress(
     const size_t output_size,
     const BitwiseLzssSettings &settings)
 {
-    io::MsbBitStream bit_stream(input);
-    return lzss_decompress(bit_stream, output_size, settings);
-}
+    // mirrors the stream overload below, including the EofError on
+    // truncated input, but pulls bits from a local 64-bit cache instead
+    // of making a virtual stream call per bit field
+    const u8 *input_ptr = input.get<const u8>();
+    const u8 *input_end = input_ptr + input.size();
+    u64 cache = 0;
+    size_t cached_bits = 0;
+    const auto read_bits = [&](const size_t bits) -> u32
+    {
+        while (cached_bits < bits)
+        {
+            if (input_ptr >= input_end)
+                throw err::EofError();
+            cache = (cache << 8) | *input_ptr++;
+            cached_bits += 8;
+        }
+        cached_bits -= bits;
+        return (cache >> cached_bits) & ((1ull << bits) - 1);
+    };
 
-bstr algo::pack::lzss_decompress(
-    io::BaseBitStream &input_stream,
-    const size_t output_size,
-    const BitwiseLzssSettings &settings)
-{
-    std::vector<u8> dict(1 << settings.position_bits, 0);
-    auto dict_ptr
-        = algo::make_cyclic_ptr(dict.data(), dict.size())
-        + settings.initial_dictionary_pos;
+    algo::ScratchBuffer dict(1 << settings.position_bits);
+    const size_t dict_mask = dict.size() - 1;
+    size_t dict_pos = settings.initial_dictionary_pos & dict_mask;
 
     bstr output(output_size);
-    auto output_ptr = algo::make_ptr(output);
-    while (output_ptr.left())
+    u8 *output_ptr = output.get<u8>();
+    const u8 *output_end = output_ptr + output_size;
+    while (output_ptr < output_end)
     {
-        if (input_stream.read(1))
+        if (read_bits(1))
         {
-            const auto b = input_stream.read(8);
+            const u8 b = read_bits(8);
             *output_ptr++ = b;
-            *dict_ptr++ = b;
+            dict[dict_pos] = b;
+            dict_pos = (dict_pos + 1) & dict_mask;
         }
         else
         {
-            auto look_behind_pos = input_stream.read(settings.position_bits);
-            auto repetitions = input_stream.read(settings.size_bits)
+            size_t look_behind_pos = read_bits(settings.position_bits);
+            auto repetitions = read_bits(settings.size_bits)
                 + settings.min_match_size;
-            auto source_ptr
-                = algo::make_cyclic_ptr(dict.data(), dict.size())
-                + look_behind_pos;
-            while (repetitions-- && output_ptr.left())
+            while (repetitions-- && output_ptr < output_end)
             {
-                const auto b = *source_ptr++;
+                const u8 b = dict[look_behind_pos];
+                look_behind_pos = (look_behind_pos + 1) & dict_mask;
                 *output_ptr++ = b;
-                *dict_ptr++ = b;
+                dict[dict_pos] = b;
+                dict_pos = (dict_pos + 1) & dict_mask;
             }
         }
     }
@@ -208,42 +221,30 @@ bstr algo::pack::lzss_decompress(
 }
 
 bstr algo::pack::lzss_decompress(
-    const bstr &input,
+    io::BaseBitStream &input_stream,
     const size_t output_size,
-    const BytewiseLzssSettings &settings)
+    const BitwiseLzssSettings &settings)
 {
-    std::array<u8, 0x1000> dict = {0};
+    algo::ScratchBuffer dict(1 << settings.position_bits);
     auto dict_ptr
         = algo::make_cyclic_ptr(dict.data(), dict.size())
         + settings.initial_dictionary_pos;
 
     bstr output(output_size);
     auto output_ptr = algo::make_ptr(output);
-    auto input_ptr = algo::make_ptr(input);
-
-    u16 control = 0;
     while (output_ptr.left())
     {
-        control >>= 1;
-        if (!(control & 0x100))
-        {
-            if (!input_ptr.left()) break;
-            control = *input_ptr++ | 0xFF00;
-        }
-        if (control & 1)
+        if (input_stream.read(1))
         {
-            if (!input_ptr.left()) break;
-            const auto b = *input_ptr++;
+            const auto b = input_stream.read(8);
             *output_ptr++ = b;
             *dict_ptr++ = b;
         }
         else
         {
-            if (input_ptr.left() < 2) break;
-            const auto lo = *input_ptr++;
-            const auto hi = *input_ptr++;
-            const auto look_behind_pos = lo | ((hi & 0xF0) << 4);
-            auto repetitions = (hi & 0xF) + 3;
+            auto look_behind_pos = input_stream.read(settings.position_bits);
+            auto repetitions = input_stream.read(settings.size_bits)
+                + settings.min_match_size;
             auto source_ptr
                 = algo::make_cyclic_ptr(dict.data(), dict.size())
                 + look_behind_pos;
@@ -258,6 +259,32 @@ bstr algo::pack::lzss_decompress(
     return output;
 }
 
+namespace
+{
+    // the classic encoding: 12-bit dictionary index plus 4-bit count
+    struct BytewiseLzssSpec final
+    {
+        static constexpr size_t dict_size = 0x1000;
+
+        static void decode_reference(
+            const u8 lo, const u8 hi,
+            size_t &look_behind_pos, size_t &repetitions)
+        {
+            look_behind_pos = lo | ((hi & 0xF0) << 4);
+            repetitions = (hi & 0xF) + 3;
+        }
+    };
+}
+
+bstr algo::pack::lzss_decompress(
+    const bstr &input,
+    const size_t output_size,
+    const BytewiseLzssSettings &settings)
+{
+    return lzss_decompress<BytewiseLzssSpec>(
+        input, output_size, settings.initial_dictionary_pos);
+}
+
 LzssEncoderState::LzssEncoderState(
     const size_t dict_size, const size_t max_match_size) :
         dict_size(dict_size),
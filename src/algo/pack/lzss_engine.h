@@ -0,0 +1,131 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include "types.h"
+
+namespace au {
+namespace algo {
+namespace pack {
+
+    // Compile-time specialized core for the byte-control LZSS variants
+    // scattered across the decoders. A variant supplies a spec:
+    //
+    //     struct Spec final
+    //     {
+    //         static const size_t dict_size;  // power of two
+    //         // decodes a two byte back-reference into a dictionary
+    //         // index and a repetition count
+    //         static void decode_reference(
+    //             const u8 lo, const u8 hi,
+    //             size_t &look_behind_pos, size_t &repetitions);
+    //     };
+    //
+    // The dictionary window maps 1:1 onto the last dict_size output
+    // bytes, so references are resolved against the output buffer itself:
+    // a dictionary index translates into a constant look-behind distance
+    // for the whole run, references into the never-written portion of the
+    // initial dictionary yield zeros, and far matches become straight
+    // block copies. Decoding stops quietly when the input runs out.
+    template<typename Spec> inline bstr lzss_decompress(
+        const u8 *&input_ptr,
+        const u8 *input_end,
+        const size_t output_size,
+        const size_t initial_dict_pos)
+    {
+        static_assert(
+            (Spec::dict_size & (Spec::dict_size - 1)) == 0,
+            "dictionary size must be a power of two");
+        const size_t mask = Spec::dict_size - 1;
+
+        bstr output(output_size);
+        u8 *output_ptr = output.get<u8>();
+        const u8 *output_start = output_ptr;
+        const u8 *output_end = output_ptr + output_size;
+
+        u16 control = 0;
+        while (output_ptr < output_end)
+        {
+            control >>= 1;
+            if (!(control & 0x100))
+            {
+                if (input_ptr >= input_end)
+                    break;
+                control = *input_ptr++ | 0xFF00;
+            }
+
+            if (control & 1)
+            {
+                if (input_ptr >= input_end)
+                    break;
+                *output_ptr++ = *input_ptr++;
+                continue;
+            }
+
+            if (input_end - input_ptr < 2)
+                break;
+            const u8 lo = *input_ptr++;
+            const u8 hi = *input_ptr++;
+            size_t look_behind_pos, repetitions;
+            Spec::decode_reference(lo, hi, look_behind_pos, repetitions);
+            look_behind_pos &= mask;
+
+            const size_t output_pos = output_ptr - output_start;
+            size_t distance
+                = (initial_dict_pos + output_pos - look_behind_pos) & mask;
+            if (!distance)
+                distance = Spec::dict_size;
+            const u8 *source_ptr = output_ptr - distance;
+
+            auto left = std::min<size_t>(repetitions, output_end - output_ptr);
+            while (left && source_ptr < output_start)
+            {
+                *output_ptr++ = 0;
+                source_ptr++;
+                left--;
+            }
+            // close matches repeat bytes and must stay byte-wise; anything
+            // else is a straight block copy
+            if (source_ptr + left <= output_ptr)
+            {
+                std::memcpy(output_ptr, source_ptr, left);
+                output_ptr += left;
+            }
+            else
+            {
+                while (left--)
+                    *output_ptr++ = *source_ptr++;
+            }
+        }
+        return output;
+    }
+
+    template<typename Spec> inline bstr lzss_decompress(
+        const bstr &input,
+        const size_t output_size,
+        const size_t initial_dict_pos)
+    {
+        const u8 *input_ptr = input.get<const u8>();
+        return lzss_decompress<Spec>(
+            input_ptr, input_ptr + input.size(), output_size,
+            initial_dict_pos);
+    }
+
+} } }
@@ -85,10 +85,10 @@ static bstr process_stream(
     if (ret != Z_STREAM_END)
     {
         throw err::CorruptDataError(algo::format(
-            "%s (%s near %x)",
+            "%s (%s near %llx)",
             error_message.c_str(),
             s.msg ? s.msg : "unknown error",
-            pos));
+            static_cast<unsigned long long>(pos)));
     }
     return output;
 }
@@ -114,12 +114,118 @@ bstr algo::pack::zlib_inflate(
         "Failed to inflate zlib stream");
 }
 
+void algo::pack::zlib_inflate(
+    io::BaseByteStream &input_stream,
+    const std::function<void(const bstr &chunk)> &sink,
+    const ZlibKind kind)
+{
+    const int window_bits
+        = kind == ZlibKind::RawDeflate ? -MAX_WBITS
+        : kind == ZlibKind::PlainZlib ? MAX_WBITS
+        : kind == ZlibKind::Gzip ? MAX_WBITS | 16
+        : 0;
+    if (!window_bits)
+        throw std::logic_error("Bad zlib kind");
+
+    z_stream s;
+    std::memset(&s, 0, sizeof(s));
+    if (inflateInit2(&s, window_bits) != Z_OK)
+        throw std::logic_error("Failed to initialize zlib stream");
+
+    bstr input_chunk, output_chunk(buffer_size);
+    size_t written = 0;
+    int ret;
+    const auto initial_pos = input_stream.pos();
+    do
+    {
+        if (s.avail_in == 0)
+        {
+            input_chunk = input_stream.read(
+                std::min<size_t>(input_stream.left(), buffer_size));
+            s.next_in = const_cast<Bytef*>(input_chunk.get<const Bytef>());
+            s.avail_in = input_chunk.size();
+        }
+
+        s.next_out = output_chunk.get<Bytef>();
+        s.avail_out = output_chunk.size();
+
+        ret = inflate(&s, Z_NO_FLUSH);
+        if (s.total_out > written)
+        {
+            sink(output_chunk.substr(0, s.total_out - written));
+            written = s.total_out;
+        }
+        if (ret == Z_BUF_ERROR)
+        {
+            input_chunk += input_stream.read(
+                std::min<size_t>(input_stream.left(), buffer_size));
+            s.next_in = const_cast<Bytef*>(input_chunk.get<const Bytef>());
+            s.avail_in = input_chunk.size();
+        }
+    }
+    while (ret == Z_OK);
+
+    input_stream.seek(initial_pos + s.total_in);
+    const auto pos = s.next_in - input_chunk.get<const Bytef>();
+    inflateEnd(&s);
+    if (ret != Z_STREAM_END)
+    {
+        throw err::CorruptDataError(algo::format(
+            "Failed to inflate zlib stream (%s near %llx)",
+            s.msg ? s.msg : "unknown error",
+            static_cast<unsigned long long>(pos)));
+    }
+}
+
+void algo::pack::zlib_inflate(
+    io::BaseByteStream &input_stream,
+    io::BaseByteStream &output_stream,
+    const ZlibKind kind)
+{
+    ::zlib_inflate(
+        input_stream,
+        [&output_stream](const bstr &chunk) { output_stream.write(chunk); },
+        kind);
+}
+
 bstr algo::pack::zlib_inflate(const bstr &input, const ZlibKind kind)
 {
     io::MemoryByteStream input_stream(input);
     return ::zlib_inflate(input_stream, kind);
 }
 
+bstr algo::pack::zlib_inflate(
+    const bstr &input, const size_t output_size, const ZlibKind kind)
+{
+    const int window_bits
+        = kind == ZlibKind::RawDeflate ? -MAX_WBITS
+        : kind == ZlibKind::PlainZlib ? MAX_WBITS
+        : kind == ZlibKind::Gzip ? MAX_WBITS | 16
+        : 0;
+    if (!window_bits)
+        throw std::logic_error("Bad zlib kind");
+
+    z_stream s;
+    std::memset(&s, 0, sizeof(s));
+    if (inflateInit2(&s, window_bits) != Z_OK)
+        throw std::logic_error("Failed to initialize zlib stream");
+
+    bstr output(output_size);
+    s.next_in = const_cast<Bytef*>(input.get<const Bytef>());
+    s.avail_in = input.size();
+    s.next_out = output.get<Bytef>();
+    s.avail_out = output_size;
+    const auto ret = inflate(&s, Z_FINISH);
+    const auto total_out = s.total_out;
+    inflateEnd(&s);
+    if (ret == Z_STREAM_END && total_out == output_size)
+        return output;
+
+    // the declared size was wrong - let the incremental path sort it out
+    // (and produce its usual diagnostics if the data is simply corrupt)
+    return zlib_inflate(input, kind);
+}
+
 bstr algo::pack::zlib_deflate(
     const bstr &input,
     const ZlibKind kind,
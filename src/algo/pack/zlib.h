@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include <functional>
 #include "algo/pack/compression_level.h"
 #include "io/base_byte_stream.h"
 #include "types.h"
@@ -36,9 +37,31 @@ namespace pack {
         io::BaseByteStream &input_stream,
         const ZlibKind kind = ZlibKind::PlainZlib);
 
+    // Streaming variants: decompressed data is handed out in bounded
+    // chunks rather than materialized as one bstr, so peak memory stays
+    // flat no matter how large the entry inflates to.
+    void zlib_inflate(
+        io::BaseByteStream &input_stream,
+        const std::function<void(const bstr &chunk)> &sink,
+        const ZlibKind kind = ZlibKind::PlainZlib);
+
+    void zlib_inflate(
+        io::BaseByteStream &input_stream,
+        io::BaseByteStream &output_stream,
+        const ZlibKind kind = ZlibKind::PlainZlib);
+
     bstr zlib_inflate(
         const bstr &input, const ZlibKind kind = ZlibKind::PlainZlib);
 
+    // One-shot variant for the common case where the archive records the
+    // exact decompressed size: the output is allocated once and inflated in
+    // a single call. Falls back to the incremental path when the stream
+    // doesn't match the declared size.
+    bstr zlib_inflate(
+        const bstr &input,
+        const size_t output_size,
+        const ZlibKind kind = ZlibKind::PlainZlib);
+
     bstr zlib_deflate(
         const bstr &input,
         const ZlibKind kind = ZlibKind::PlainZlib,
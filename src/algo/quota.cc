@@ -0,0 +1,87 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "algo/quota.h"
+#include <chrono>
+#include "algo/format.h"
+#include "err.h"
+
+using namespace au;
+using namespace au::algo;
+
+static std::atomic<u64> output_limit(0);
+static std::atomic<u64> time_limit_ms(0);
+
+// 0 = the quotas are not armed on this thread
+static thread_local u64 output_cap = 0;
+static thread_local u64 deadline_ns = 0;
+
+std::atomic<bool> DecodeQuota::deadline_active(false);
+
+static u64 now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void DecodeQuota::set_output_limit(const u64 bytes)
+{
+    output_limit.store(bytes, std::memory_order_relaxed);
+}
+
+u64 DecodeQuota::get_output_limit()
+{
+    return output_limit.load(std::memory_order_relaxed);
+}
+
+void DecodeQuota::set_time_limit(const u64 milliseconds)
+{
+    time_limit_ms.store(milliseconds, std::memory_order_relaxed);
+    deadline_active.store(milliseconds != 0, std::memory_order_relaxed);
+}
+
+void DecodeQuota::arm()
+{
+    output_cap = output_limit.load(std::memory_order_relaxed);
+    const auto limit = time_limit_ms.load(std::memory_order_relaxed);
+    deadline_ns = limit ? now_ns() + limit * 1'000'000 : 0;
+}
+
+void DecodeQuota::disarm()
+{
+    output_cap = 0;
+    deadline_ns = 0;
+}
+
+void DecodeQuota::check_allocation(const size_t size)
+{
+    if (output_cap && size > output_cap)
+    {
+        throw err::QuotaError(algo::format(
+            "Allocation of %zu bytes exceeds the output quota", size));
+    }
+    if (deadline_ns)
+        check_deadline();
+}
+
+void DecodeQuota::check_deadline()
+{
+    if (!deadline_ns || now_ns() <= deadline_ns)
+        return;
+    deadline_ns = 0;
+    throw err::QuotaError("Decode time quota exceeded");
+}
@@ -0,0 +1,100 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <atomic>
+#include "types.h"
+
+namespace au {
+namespace algo {
+
+    // Cooperative per-task decode quotas. Corrupt archives can make a
+    // decoder allocate absurd buffers (a forged uncompressed size) or
+    // loop for a long time before failing; one such file would otherwise
+    // take a whole batch run down with it. The limits are process-global
+    // and set once from the command line; the flow layer arms them on
+    // the worker thread around each decode, and violations surface as
+    // err::QuotaError, which the task machinery counts as an ordinary
+    // decode error. Both limits default to 0, meaning unlimited.
+    class DecodeQuota final
+    {
+    public:
+        // Caps the output size of a single decode; also applied to any
+        // single large allocation made while armed, since a decode
+        // buffer exceeding the output cap can only come from a forged
+        // header field.
+        static void set_output_limit(const u64 bytes);
+        static u64 get_output_limit();
+
+        // Caps the wall time of a single decode. Enforcement is
+        // cooperative: the deadline is checked from the stream read path
+        // and from large allocations, which every known runaway loop
+        // goes through.
+        static void set_time_limit(const u64 milliseconds);
+
+        // Arms and disarms both quotas for the calling thread.
+        static void arm();
+        static void disarm();
+
+        // Called by the big allocation path; throws err::QuotaError when
+        // the calling thread is armed and the size exceeds the output
+        // cap, and also services the deadline check.
+        static void check_allocation(const size_t size);
+
+        // Throws err::QuotaError when the armed deadline has passed. The
+        // deadline is cleared before throwing, so the error handling
+        // (which may still read streams to salvage the raw file) is not
+        // tripped again.
+        static void check_deadline();
+
+        static bool deadline_enabled()
+        {
+            return deadline_active.load(std::memory_order_relaxed);
+        }
+
+        // Throttled deadline check for stream read paths: the clock is
+        // consulted once every few thousand operations so that the hot
+        // path pays a thread-local decrement and nothing else.
+        static void checkpoint()
+        {
+            thread_local int countdown = 0;
+            if (--countdown >= 0)
+                return;
+            countdown = 4096;
+            check_deadline();
+        }
+
+    private:
+        static std::atomic<bool> deadline_active;
+    };
+
+    // Scope guard matching the task structure of the flow layer.
+    struct DecodeQuotaGuard final
+    {
+        DecodeQuotaGuard()
+        {
+            DecodeQuota::arm();
+        }
+
+        ~DecodeQuotaGuard()
+        {
+            DecodeQuota::disarm();
+        }
+    };
+
+} }
@@ -0,0 +1,84 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "algo/scratch_arena.h"
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+using namespace au;
+using namespace au::algo;
+
+namespace
+{
+    struct Arena final
+    {
+        std::unique_ptr<u8[]> block;
+        size_t capacity = 0;
+        size_t top = 0;
+    };
+}
+
+static thread_local Arena arena;
+
+// keeps successive buffers naturally aligned for the typed loops that run
+// over them
+static size_t align_up(const size_t size)
+{
+    return (size + 15) & ~static_cast<size_t>(15);
+}
+
+ScratchBuffer::ScratchBuffer(const size_t size) : buffer_size(size)
+{
+    // never zero, so that arena_bytes == 0 unambiguously marks the heap
+    // fallback
+    const auto needed = align_up(std::max<size_t>(size, 1));
+    if (arena.top + needed > arena.capacity)
+    {
+        if (arena.top == 0)
+        {
+            // the arena is idle, so it can grow to the new demand; growth
+            // happens a handful of times early on and then never again
+            auto new_capacity = std::max<size_t>(arena.capacity * 2, 0x10000);
+            while (new_capacity < needed)
+                new_capacity *= 2;
+            arena.block = std::make_unique<u8[]>(new_capacity);
+            arena.capacity = new_capacity;
+        }
+        else
+        {
+            // outgrown mid-use; this buffer lives on the heap and the
+            // arena is left untouched
+            buffer = new u8[size];
+            arena_bytes = 0;
+            std::memset(buffer, 0, size);
+            return;
+        }
+    }
+    buffer = arena.block.get() + arena.top;
+    arena_bytes = needed;
+    arena.top += needed;
+    std::memset(buffer, 0, size);
+}
+
+ScratchBuffer::~ScratchBuffer()
+{
+    if (arena_bytes)
+        arena.top -= arena_bytes;
+    else
+        delete[] buffer;
+}
@@ -0,0 +1,78 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstddef>
+#include "types.h"
+
+namespace au {
+namespace algo {
+
+    // Scratch memory for decompressor working buffers - LZSS dictionaries
+    // and similar temporaries allocated inside loops over thousands of
+    // entries. Each buffer is carved from a per-thread arena that grows to
+    // the largest demand once and is then reused, so steady-state unpacking
+    // stops going through the heap (and through its locks) for working
+    // memory entirely. The memory is zero-filled, matching the zeroed
+    // vectors this replaces.
+    //
+    // Buffers are returned to the arena strictly LIFO, which plain scoped
+    // locals satisfy naturally; do not store them in containers or move
+    // them across threads. Oversized or out-of-order demand quietly falls
+    // back to the heap.
+    class ScratchBuffer final
+    {
+    public:
+        ScratchBuffer(const size_t size);
+        ~ScratchBuffer();
+
+        ScratchBuffer(const ScratchBuffer &) = delete;
+        ScratchBuffer &operator =(const ScratchBuffer &) = delete;
+
+        size_t size() const
+        {
+            return buffer_size;
+        }
+
+        u8 *data()
+        {
+            return buffer;
+        }
+
+        const u8 *data() const
+        {
+            return buffer;
+        }
+
+        u8 &operator [](const size_t pos)
+        {
+            return buffer[pos];
+        }
+
+        const u8 &operator [](const size_t pos) const
+        {
+            return buffer[pos];
+        }
+
+    private:
+        u8 *buffer;
+        size_t buffer_size;
+        size_t arena_bytes; // 0 when heap-backed
+    };
+
+} }
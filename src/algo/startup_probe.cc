@@ -0,0 +1,125 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "algo/startup_probe.h"
+#include <chrono>
+#ifdef __linux__
+    #include <fstream>
+    #include <string>
+    #include <unistd.h>
+#endif
+
+using namespace au;
+using namespace au::algo;
+
+static std::chrono::steady_clock::time_point first_init_time;
+static std::chrono::steady_clock::time_point main_entry_time;
+static bool first_init_recorded = false;
+static bool main_entry_recorded = false;
+static u64 process_age_at_main = 0;
+
+#ifdef __GNUC__
+// priority 101 is the earliest available to user code, so this runs
+// before the default-priority static initializers of every other
+// translation unit
+__attribute__((constructor(101)))
+static void record_first_init()
+{
+    first_init_time = std::chrono::steady_clock::now();
+    first_init_recorded = true;
+}
+#endif
+
+#ifdef __linux__
+// the kernel's record of when the process started, which also covers
+// the dynamic loader's work before the first constructor runs
+static u64 process_age_nanoseconds()
+{
+    std::ifstream stat_stream("/proc/self/stat");
+    std::string stat_line;
+    std::getline(stat_stream, stat_line);
+    // the command name in field 2 may contain spaces; fields are
+    // reliable only after its closing parenthesis
+    const auto pos = stat_line.rfind(')');
+    if (pos == std::string::npos)
+        return 0;
+    size_t field = 2;
+    size_t offset = pos + 1;
+    while (field < 21 && offset < stat_line.size())
+    {
+        offset = stat_line.find(' ', offset + 1);
+        if (offset == std::string::npos)
+            return 0;
+        field++;
+    }
+    const auto start_ticks = std::stoull(stat_line.substr(offset + 1));
+
+    std::ifstream uptime_stream("/proc/uptime");
+    double uptime_seconds = 0;
+    uptime_stream >> uptime_seconds;
+    if (uptime_seconds <= 0)
+        return 0;
+
+    const auto ticks_per_second = sysconf(_SC_CLK_TCK);
+    if (ticks_per_second <= 0)
+        return 0;
+    const auto age_seconds
+        = uptime_seconds
+        - start_ticks / static_cast<double>(ticks_per_second);
+    return age_seconds > 0 ? static_cast<u64>(age_seconds * 1e9) : 0;
+}
+#endif
+
+void StartupProbe::mark_main_entry()
+{
+    main_entry_time = std::chrono::steady_clock::now();
+    main_entry_recorded = true;
+    #ifdef __linux__
+        process_age_at_main = process_age_nanoseconds();
+    #endif
+}
+
+u64 StartupProbe::static_init_nanoseconds()
+{
+    if (!first_init_recorded || !main_entry_recorded)
+        return 0;
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        main_entry_time - first_init_time).count();
+}
+
+u64 StartupProbe::pre_main_nanoseconds()
+{
+    return main_entry_recorded ? process_age_at_main : 0;
+}
+
+void StartupProbe::dump(const Logger &logger)
+{
+    logger.info("startup budget:\n");
+    logger.info(
+        "%8.3f ms  process start to main() (loader included)\n",
+        pre_main_nanoseconds() / 1e6);
+    logger.info(
+        "%8.3f ms  static initializers\n",
+        static_init_nanoseconds() / 1e6);
+    if (main_entry_recorded)
+    {
+        const auto since_main
+            = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - main_entry_time).count();
+        logger.info("%8.3f ms  main() to here\n", since_main / 1e6);
+    }
+}
@@ -0,0 +1,51 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "logger.h"
+#include "types.h"
+
+namespace au {
+namespace algo {
+
+    // Measures how much time the process spends before reaching main():
+    // scripted invocations run the binary thousands of times, so startup
+    // is a real budget. The static initializer window is bracketed by a
+    // high-priority constructor hook; the process age at main() comes
+    // from the kernel and additionally covers the dynamic loader. Either
+    // number reads as zero where the platform offers no way to measure
+    // it.
+    class StartupProbe final
+    {
+    public:
+        // Called as early in main() as possible.
+        static void mark_main_entry();
+
+        // Nanoseconds between the first static initializer and main().
+        static u64 static_init_nanoseconds();
+
+        // Nanoseconds the process had existed when main() was entered.
+        static u64 pre_main_nanoseconds();
+
+        // Prints the startup budget, including the time between main()
+        // and this call - with the lazy decoder registration, most setup
+        // cost sits there rather than in static initializers.
+        static void dump(const Logger &logger);
+    };
+
+} }
@@ -16,6 +16,7 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "algo/str.h"
+#include <cctype>
 #include <boost/algorithm/hex.hpp>
 #include <boost/algorithm/string.hpp>
 #include <boost/lexical_cast.hpp>
@@ -69,7 +70,7 @@ std::string algo::hex_verbose(const bstr &input, const size_t columns)
     output.reserve(input.size() * 4.5);
     for (const auto y : range((input.size() + columns - 1) / columns))
     {
-        output += format("%04x: ", y * columns);
+        output += format("%04x: ", static_cast<unsigned int>(y * columns));
         for (const auto x : range(columns))
         {
             const size_t i = x + y * columns;
@@ -134,6 +135,43 @@ std::string algo::replace_all(
     return output;
 }
 
+bool algo::wildcard_match(
+    const std::string &pattern, const std::string &input)
+{
+    // iterative matcher: on mismatch, back up to the last * and let it
+    // swallow one more input character
+    size_t pattern_pos = 0, input_pos = 0;
+    size_t star_pos = std::string::npos, star_input_pos = 0;
+    while (input_pos < input.size())
+    {
+        if (pattern_pos < pattern.size()
+            && (pattern[pattern_pos] == '?'
+                || std::tolower(pattern[pattern_pos])
+                    == std::tolower(input[input_pos])))
+        {
+            pattern_pos++;
+            input_pos++;
+        }
+        else if (pattern_pos < pattern.size() && pattern[pattern_pos] == '*')
+        {
+            star_pos = pattern_pos++;
+            star_input_pos = input_pos;
+        }
+        else if (star_pos != std::string::npos)
+        {
+            pattern_pos = star_pos + 1;
+            input_pos = ++star_input_pos;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    while (pattern_pos < pattern.size() && pattern[pattern_pos] == '*')
+        pattern_pos++;
+    return pattern_pos == pattern.size();
+}
+
 
 namespace au {
 namespace algo {
@@ -48,6 +48,10 @@ namespace algo {
         const std::string &from,
         const std::string &to);
 
+    // Case-insensitive wildcard match where * matches any run of
+    // characters (including path separators) and ? matches exactly one.
+    bool wildcard_match(const std::string &pattern, const std::string &input);
+
     template<typename T> T from_string(const std::string &input);
 
 } }
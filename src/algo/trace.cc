@@ -0,0 +1,174 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "algo/trace.h"
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "algo/format.h"
+#include "algo/range.h"
+
+using namespace au;
+using namespace au::algo;
+
+// how many spans each thread keeps before overwriting the oldest
+static const size_t trace_ring_capacity = 65536;
+
+std::atomic<bool> Trace::active(false);
+
+static std::chrono::steady_clock::time_point trace_epoch;
+
+namespace
+{
+    struct ThreadBuffer final
+    {
+        std::mutex mutex;
+        std::vector<TraceEvent> events;
+        size_t next = 0;
+    };
+}
+
+// buffers are never erased, so the thread-local pointers below stay
+// valid for the lifetime of the process
+static std::mutex buffers_mutex;
+static std::vector<std::unique_ptr<ThreadBuffer>> &get_buffers()
+{
+    static std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    return buffers;
+}
+
+static thread_local ThreadBuffer *current_buffer = nullptr;
+
+static ThreadBuffer &current()
+{
+    if (!current_buffer)
+    {
+        std::unique_lock<std::mutex> lock(buffers_mutex);
+        get_buffers().push_back(std::make_unique<ThreadBuffer>());
+        current_buffer = get_buffers().back().get();
+    }
+    return *current_buffer;
+}
+
+void Trace::enable()
+{
+    trace_epoch = std::chrono::steady_clock::now();
+    active.store(true);
+}
+
+void Trace::disable()
+{
+    active.store(false);
+}
+
+u64 Trace::now_nanoseconds()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - trace_epoch).count();
+}
+
+void Trace::record(
+    const std::string &name,
+    const std::string &category,
+    const u64 start_nanoseconds,
+    const u64 duration_nanoseconds)
+{
+    auto &buffer = current();
+    std::unique_lock<std::mutex> lock(buffer.mutex);
+    if (buffer.events.size() < trace_ring_capacity)
+    {
+        buffer.events.push_back(
+            {start_nanoseconds, duration_nanoseconds, name, category});
+        return;
+    }
+    buffer.events[buffer.next]
+        = {start_nanoseconds, duration_nanoseconds, name, category};
+    buffer.next = (buffer.next + 1) % trace_ring_capacity;
+}
+
+static std::string json_escape(const std::string &input)
+{
+    std::string output;
+    for (const auto c : input)
+    {
+        if (c == '"' || c == '\\')
+        {
+            output += '\\';
+            output += c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20)
+        {
+            output += algo::format("\\u%04X", c);
+        }
+        else
+        {
+            output += c;
+        }
+    }
+    return output;
+}
+
+void Trace::write_chrome_trace(io::BaseByteStream &output_stream)
+{
+    size_t buffer_count;
+    {
+        std::unique_lock<std::mutex> lock(buffers_mutex);
+        buffer_count = get_buffers().size();
+    }
+
+    std::string out;
+    out += "{\"traceEvents\": [";
+    auto first = true;
+    for (const auto i : algo::range(buffer_count))
+    {
+        std::vector<TraceEvent> events;
+        {
+            std::unique_lock<std::mutex> lock(buffers_mutex);
+            auto &buffer = *get_buffers()[i];
+            std::unique_lock<std::mutex> buffer_lock(buffer.mutex);
+            events = buffer.events;
+        }
+        for (const auto &event : events)
+        {
+            out += first ? "\n" : ",\n";
+            first = false;
+            out += algo::format(
+                "  {\"ph\": \"X\", \"pid\": 1, \"tid\": %zu, "
+                "\"ts\": %.3f, \"dur\": %.3f, "
+                "\"name\": \"%s\", \"cat\": \"%s\"}",
+                static_cast<size_t>(i) + 1,
+                event.start_nanoseconds / 1e3,
+                event.duration_nanoseconds / 1e3,
+                json_escape(event.name).c_str(),
+                json_escape(event.category).c_str());
+        }
+    }
+    out += "\n], \"displayTimeUnit\": \"ms\"}\n";
+    output_stream.write(bstr(out));
+}
+
+void Trace::reset()
+{
+    std::unique_lock<std::mutex> lock(buffers_mutex);
+    for (auto &buffer : get_buffers())
+    {
+        std::unique_lock<std::mutex> buffer_lock(buffer->mutex);
+        buffer->events.clear();
+        buffer->next = 0;
+    }
+}
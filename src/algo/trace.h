@@ -0,0 +1,113 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <atomic>
+#include <string>
+#include "io/base_byte_stream.h"
+#include "types.h"
+
+namespace au {
+namespace algo {
+
+    // One completed span; timestamps are relative to when tracing was
+    // enabled.
+    struct TraceEvent final
+    {
+        u64 start_nanoseconds;
+        u64 duration_nanoseconds;
+        std::string name;
+        std::string category;
+    };
+
+    // Collects scoped spans into per-thread ring buffers and exports
+    // them in the Chrome trace event format, loadable in chrome://tracing
+    // or Perfetto. The ring buffers are bounded, so a long run keeps the
+    // most recent spans of every thread rather than growing without
+    // limit. Off by default; a span costs one relaxed load when
+    // disabled.
+    class Trace final
+    {
+    public:
+        static void enable();
+        static void disable();
+
+        static bool enabled()
+        {
+            return active.load(std::memory_order_relaxed);
+        }
+
+        // Nanoseconds since tracing was enabled.
+        static u64 now_nanoseconds();
+
+        static void record(
+            const std::string &name,
+            const std::string &category,
+            const u64 start_nanoseconds,
+            const u64 duration_nanoseconds);
+
+        static void write_chrome_trace(io::BaseByteStream &output_stream);
+
+        // Drops all collected spans; thread buffers stay registered.
+        static void reset();
+
+    private:
+        static std::atomic<bool> active;
+    };
+
+    // Scoped span; does nothing when tracing is disabled at construction
+    // time.
+    class TraceSpan final
+    {
+    public:
+        TraceSpan(const std::string &name, const std::string &category)
+        {
+            if (!Trace::enabled())
+                return;
+            recording = true;
+            this->name = name;
+            this->category = category;
+            start_nanoseconds = Trace::now_nanoseconds();
+        }
+
+        ~TraceSpan()
+        {
+            if (!recording)
+                return;
+            Trace::record(
+                name,
+                category,
+                start_nanoseconds,
+                Trace::now_nanoseconds() - start_nanoseconds);
+        }
+
+    private:
+        bool recording = false;
+        std::string name;
+        std::string category;
+        u64 start_nanoseconds = 0;
+    };
+
+} }
+
+// Traces the enclosing block without naming the guard object.
+#define AU_TRACE_CONCAT2(a, b) a##b
+#define AU_TRACE_CONCAT(a, b) AU_TRACE_CONCAT2(a, b)
+#define AU_TRACE_SPAN(name, category) \
+    const ::au::algo::TraceSpan \
+        AU_TRACE_CONCAT(trace_span_, __LINE__)(name, category)
@@ -16,6 +16,7 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "arg_parser.h"
+#include <unordered_map>
 #include "algo/format.h"
 #include "algo/range.h"
 #include "err.h"
@@ -31,7 +32,6 @@ namespace
         OptionImpl(const std::initializer_list<std::string> &names);
         virtual ~OptionImpl();
         virtual Option *set_description(const std::string &desc) override;
-        bool has_name(const std::string &name) const;
         virtual std::string get_invocation_help() const;
 
         std::vector<std::string> names;
@@ -92,15 +92,6 @@ std::string OptionImpl::get_invocation_help() const
     return invocation;
 }
 
-bool OptionImpl::has_name(const std::string &name) const
-{
-    const auto name_normalized = name.substr(name.find_first_not_of('-'));
-    for (const auto &other : names)
-        if (name_normalized == other.substr(other.find_first_not_of('-')))
-            return true;
-    return false;
-}
-
 Option *OptionImpl::set_description(const std::string &desc)
 {
     description = desc;
@@ -274,29 +265,49 @@ static void print_options(
     logger.info(format_dictionary_as_list("", dict));
 }
 
+static std::string normalize_name(const std::string &name)
+{
+    const auto pos = name.find_first_not_of('-');
+    return pos == std::string::npos ? "" : name.substr(pos);
+}
+
 struct ArgParser::Priv final
 {
-    void check_names(const std::vector<std::string> &names);
+    void register_names(
+        const std::vector<std::string> &names, OptionImpl *option);
+    OptionImpl *find_option(const std::string &name) const;
     void parse_single_arg(const std::string &arg);
 
     std::vector<std::unique_ptr<OptionImpl>> options;
+    // options indexed by every dash-stripped name they answer to, so that
+    // parsing and queries don't rescan the definition list
+    std::unordered_map<std::string, OptionImpl*> options_by_name;
     std::vector<FlagImpl*> flags;
     std::vector<SwitchImpl*> switches;
     std::vector<std::string> stray;
 };
 
-void ArgParser::Priv::check_names(const std::vector<std::string> &names)
+void ArgParser::Priv::register_names(
+    const std::vector<std::string> &names, OptionImpl *option)
 {
     for (const auto &name : names)
-    for (const auto &option : options)
     {
-        if (option->has_name(name))
+        if (options_by_name.find(normalize_name(name))
+            != options_by_name.end())
         {
             throw std::logic_error(algo::format(
                 "An option with name \"%s\" was already registered.",
                 name.c_str()));
         }
     }
+    for (const auto &name : names)
+        options_by_name[normalize_name(name)] = option;
+}
+
+OptionImpl *ArgParser::Priv::find_option(const std::string &name) const
+{
+    const auto it = options_by_name.find(normalize_name(name));
+    return it != options_by_name.end() ? it->second : nullptr;
 }
 
 void ArgParser::Priv::parse_single_arg(const std::string &arg)
@@ -307,10 +318,9 @@ void ArgParser::Priv::parse_single_arg(const std::string &arg)
         return;
     }
 
-    for (const auto &flag : flags)
+    const auto flag = dynamic_cast<FlagImpl*>(find_option(arg));
+    if (flag)
     {
-        if (!flag->has_name(arg))
-            continue;
         flag->is_set = true;
         return;
     }
@@ -321,26 +331,23 @@ void ArgParser::Priv::parse_single_arg(const std::string &arg)
     const auto key = arg.substr(0, tmp);
     const auto value = arg.substr(tmp + 1);
 
-    for (const auto &sw : switches)
-    {
-        if (!sw->has_name(key))
-            continue;
-
-        if (sw->possible_values.size()
-            && std::all_of(
-                sw->possible_values.begin(),
-                sw->possible_values.end(),
-                [&](const auto &it) { return it.first != value; }))
-        {
-            throw err::UsageError(
-                "Bad value for option \"" + key + "\".\n"
-                + format_switch_help(*sw, true));
-        }
-
-        sw->is_set = true;
-        sw->value = value;
+    const auto sw = dynamic_cast<SwitchImpl*>(find_option(key));
+    if (!sw)
         return;
+
+    if (sw->possible_values.size()
+        && std::all_of(
+            sw->possible_values.begin(),
+            sw->possible_values.end(),
+            [&](const auto &it) { return it.first != value; }))
+    {
+        throw err::UsageError(
+            "Bad value for option \"" + key + "\".\n"
+            + format_switch_help(*sw, true));
     }
+
+    sw->is_set = true;
+    sw->value = value;
 }
 
 ArgParser::ArgParser() : p(new Priv)
@@ -359,9 +366,9 @@ void ArgParser::parse(const std::vector<std::string> &args)
 
 Flag *ArgParser::register_flag(const std::initializer_list<std::string> &names)
 {
-    p->check_names(names);
     auto flag = std::make_unique<FlagImpl>(names);
     auto ret = flag.get();
+    p->register_names(flag->names, ret);
     p->flags.push_back(ret);
     p->options.push_back(std::move(flag));
     return ret;
@@ -370,9 +377,9 @@ Flag *ArgParser::register_flag(const std::initializer_list<std::string> &names)
 Switch *ArgParser::register_switch(
     const std::initializer_list<std::string> &names)
 {
-    p->check_names(names);
     auto switch_ = std::make_unique<SwitchImpl>(names);
     auto ret = switch_.get();
+    p->register_names(switch_->names, ret);
     p->switches.push_back(ret);
     p->options.push_back(std::move(switch_));
     return ret;
@@ -380,26 +387,32 @@ Switch *ArgParser::register_switch(
 
 bool ArgParser::has_switch(const std::string &name) const
 {
-    for (const auto &sw : p->switches)
-        if (sw->has_name(name))
-            return sw->is_set;
-    throw std::logic_error("Trying to use undefined switch \"" + name + "\"");
+    const auto sw = dynamic_cast<const SwitchImpl*>(p->find_option(name));
+    if (!sw)
+    {
+        throw std::logic_error(
+            "Trying to use undefined switch \"" + name + "\"");
+    }
+    return sw->is_set;
 }
 
 const std::string ArgParser::get_switch(const std::string &name) const
 {
-    for (const auto &sw : p->switches)
-        if (sw->has_name(name))
-            return sw->value;
-    throw std::logic_error("Trying to use undefined switch \"" + name + "\"");
+    const auto sw = dynamic_cast<const SwitchImpl*>(p->find_option(name));
+    if (!sw)
+    {
+        throw std::logic_error(
+            "Trying to use undefined switch \"" + name + "\"");
+    }
+    return sw->value;
 }
 
 bool ArgParser::has_flag(const std::string &name) const
 {
-    for (const auto &f : p->flags)
-        if (f->has_name(name))
-            return f->is_set;
-    throw std::logic_error("Trying to use undefined flag \"" + name + "\"");
+    const auto flag = dynamic_cast<const FlagImpl*>(p->find_option(name));
+    if (!flag)
+        throw std::logic_error("Trying to use undefined flag \"" + name + "\"");
+    return flag->is_set;
 }
 
 const std::vector<std::string> ArgParser::get_stray() const
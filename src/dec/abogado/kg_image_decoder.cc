@@ -144,7 +144,7 @@ static bstr read_single_channel(
 
 bool KgImageDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.seek(0).read(magic.size()) == magic;
+    return input_file.stream.seek(0).matches(magic);
 }
 
 res::Image KgImageDecoder::decode_impl(
@@ -32,7 +32,7 @@ static const std::string read_string(io::BaseByteStream &input_stream)
 
 bool WadArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.seek(0).read(magic.size()) == magic;
+    return input_file.stream.seek(0).matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> WadArchiveDecoder::read_meta_impl(
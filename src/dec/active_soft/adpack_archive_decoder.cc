@@ -25,7 +25,7 @@ static const bstr magic = "ADPACK32"_b;
 
 bool AdpackArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> AdpackArchiveDecoder::read_meta_impl(
@@ -27,7 +27,7 @@ static const bstr magic = ".8Bit\x8D\x5D\x8C\xCB\x00"_b;
 
 bool Ed8ImageDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 res::Image Ed8ImageDecoder::decode_impl(
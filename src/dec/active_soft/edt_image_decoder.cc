@@ -34,7 +34,7 @@ static inline u8 clamp(const u8 input, const u8 min, const u8 max)
 
 bool EdtImageDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 res::Image EdtImageDecoder::decode_impl(
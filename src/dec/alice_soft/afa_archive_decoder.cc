@@ -21,6 +21,7 @@
 #include "algo/range.h"
 #include "err.h"
 #include "io/memory_byte_stream.h"
+#include "io/slice_byte_stream.h"
 
 using namespace au;
 using namespace au::dec::alice_soft;
@@ -29,12 +30,17 @@ static const bstr magic1 = "AFAH"_b;
 static const bstr magic2 = "AlicArch"_b;
 static const bstr magic3 = "INFO"_b;
 
+bool AfaArchiveDecoder::entries_are_independent() const
+{
+    return true;
+}
+
 bool AfaArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
     if (input_file.stream.read(magic1.size()) != magic1)
         return false;
     input_file.stream.skip(4);
-    return input_file.stream.read(magic2.size()) == magic2;
+    return input_file.stream.matches(magic2);
 }
 
 std::unique_ptr<dec::ArchiveMeta> AfaArchiveDecoder::read_meta_impl(
@@ -84,8 +90,10 @@ std::unique_ptr<io::File> AfaArchiveDecoder::read_file_impl(
     const dec::ArchiveEntry &e) const
 {
     const auto entry = static_cast<const PlainArchiveEntry*>(&e);
-    const auto data = input_file.stream.seek(entry->offset).read(entry->size);
-    auto output_file = std::make_unique<io::File>(entry->path, data);
+    auto output_file = std::make_unique<io::File>(
+        entry->path,
+        std::make_unique<io::SliceByteStream>(
+            input_file.stream, entry->offset, entry->size));
     output_file->guess_extension();
     return output_file;
 }
@@ -26,6 +26,8 @@ namespace alice_soft {
     class AfaArchiveDecoder final : public BaseArchiveDecoder
     {
     public:
+        bool entries_are_independent() const override;
+
         std::vector<std::string> get_linked_formats() const override;
 
     protected:
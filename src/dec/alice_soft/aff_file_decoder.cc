@@ -29,7 +29,7 @@ static const bstr key =
 
 bool AffFileDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 std::unique_ptr<io::File> AffFileDecoder::decode_impl(
@@ -35,7 +35,7 @@ static void decrypt(bstr &input)
 
 bool AjpImageDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 res::Image AjpImageDecoder::decode_impl(
@@ -18,6 +18,7 @@
 #include "dec/alice_soft/ald_archive_decoder.h"
 #include "algo/locale.h"
 #include "algo/range.h"
+#include "io/slice_byte_stream.h"
 
 using namespace au;
 using namespace au::dec::alice_soft;
@@ -29,6 +30,11 @@ static u32 read_24_le(io::BaseByteStream &input_stream)
         | (input_stream.read<u8>() << 24);
 }
 
+bool AldArchiveDecoder::entries_are_independent() const
+{
+    return true;
+}
+
 bool AldArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
     return input_file.path.has_extension("ald");
@@ -71,8 +77,10 @@ std::unique_ptr<io::File> AldArchiveDecoder::read_file_impl(
     const dec::ArchiveEntry &e) const
 {
     const auto entry = static_cast<const PlainArchiveEntry*>(&e);
-    const auto data = input_file.stream.seek(entry->offset).read(entry->size);
-    auto output_file = std::make_unique<io::File>(entry->path, data);
+    auto output_file = std::make_unique<io::File>(
+        entry->path,
+        std::make_unique<io::SliceByteStream>(
+            input_file.stream, entry->offset, entry->size));
     output_file->guess_extension();
     return output_file;
 }
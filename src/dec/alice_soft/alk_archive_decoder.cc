@@ -26,7 +26,7 @@ static const bstr magic = "ALK0"_b;
 
 bool AlkArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> AlkArchiveDecoder::read_meta_impl(
@@ -42,7 +42,8 @@ std::unique_ptr<dec::ArchiveMeta> AlkArchiveDecoder::read_meta_impl(
         entry->size = input_file.stream.read_le<u32>();
         if (entry->size)
         {
-            entry->path = algo::format("%03d.dat", meta->entries.size());
+            entry->path = algo::format(
+                "%03d.dat", static_cast<int>(meta->entries.size()));
             meta->entries.push_back(std::move(entry));
         }
     }
@@ -20,6 +20,7 @@
 #include "algo/range.h"
 #include "algo/str.h"
 #include "err.h"
+#include "io/memory_byte_stream.h"
 
 using namespace au;
 using namespace au::dec::alice_soft;
@@ -114,3 +115,18 @@ std::vector<std::string> DatArchiveDecoder::get_linked_formats() const
 }
 
 static auto _ = dec::register_decoder<DatArchiveDecoder>("alice-soft/dat");
+
+// No magic; the first word sizes the offset table in 256-byte pages, and
+// a table that does not fit the file cannot be walked anyway.
+static auto _2 = dec::register_gate(
+    "alice-soft/dat",
+    2,
+    [](const bstr &prefix, const uoff_t file_size)
+    {
+        if (prefix.size() < 2)
+            return false;
+        io::MemoryByteStream header(prefix);
+        const auto page_count = header.read_le<u16>();
+        return page_count < 2
+            || (page_count - 1) * 256ull <= file_size;
+    });
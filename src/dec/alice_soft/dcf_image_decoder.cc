@@ -28,7 +28,7 @@ static const bstr magic3 = "dcgd"_b;
 
 bool DcfImageDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic1.size()) == magic1;
+    return input_file.stream.matches(magic1);
 }
 
 res::Image DcfImageDecoder::decode_impl(
@@ -19,7 +19,6 @@
 #include "algo/pack/zlib.h"
 #include "algo/range.h"
 #include "err.h"
-#include "io/memory_byte_stream.h"
 
 using namespace au;
 using namespace au::dec::alice_soft;
@@ -38,40 +37,53 @@ namespace
 
 static void deinterleave(res::Image &image, const bstr &input)
 {
-    io::MemoryByteStream input_stream(input);
-
-    size_t x, y;
+    const auto width = image.width();
+    const auto height = image.height();
+    const auto padded_width = width + (width & 1);
+    const auto padded_height = height + (height & 1);
+    if (input.size() < padded_width * padded_height * 3)
+        throw err::BadDataSizeError();
+
+    // the planes store 2x2 blocks padded to even dimensions; with the
+    // size checked once up front, the gather runs on raw pointers
+    const u8 *input_ptr = input.get<const u8>();
     for (const auto i : algo::range(3))
     {
-        for (y = 0; y < image.height() - 1; y += 2)
+        size_t y = 0;
+        for (; y + 1 < height; y += 2)
         {
-            for (x = 0; x < image.width() - 1; x += 2)
+            auto *row0 = image.row(y);
+            auto *row1 = image.row(y + 1);
+            size_t x = 0;
+            for (; x + 1 < width; x += 2)
             {
-                image.at(x, y)[i] = input_stream.read<u8>();
-                image.at(x, y + 1)[i] = input_stream.read<u8>();
-                image.at(x + 1, y)[i] = input_stream.read<u8>();
-                image.at(x + 1, y + 1)[i] = input_stream.read<u8>();
+                row0[x][i] = input_ptr[0];
+                row1[x][i] = input_ptr[1];
+                row0[x + 1][i] = input_ptr[2];
+                row1[x + 1][i] = input_ptr[3];
+                input_ptr += 4;
             }
-            if (x != image.width())
+            if (x != width)
             {
-                image.at(x, y)[i] = input_stream.read<u8>();
-                image.at(x, y + 1)[i] = input_stream.read<u8>();
-                input_stream.skip(2);
+                row0[x][i] = input_ptr[0];
+                row1[x][i] = input_ptr[1];
+                input_ptr += 4;
             }
         }
-        if (y != image.height())
+        if (y != height)
         {
-            for (x = 0; x < image.width() - 1; x += 2)
+            auto *row0 = image.row(y);
+            size_t x = 0;
+            for (; x + 1 < width; x += 2)
             {
-                image.at(x, y)[i] = input_stream.read<u8>();
-                input_stream.skip(1);
-                image.at(x + 1, y)[i] = input_stream.read<u8>();
-                input_stream.skip(1);
+                row0[x][i] = input_ptr[0];
+                row0[x + 1][i] = input_ptr[2];
+                input_ptr += 4;
             }
-            if (x != image.width())
+            if (x != width)
             {
-                image.at(x, y)[i] = input_stream.read<u8>();
-                input_stream.skip(3);
+                row0[x][i] = input_ptr[0];
+                input_ptr += 4;
             }
         }
     }
@@ -79,59 +91,79 @@ static void deinterleave(res::Image &image, const bstr &input)
 
 static void apply_differences(res::Image &image)
 {
-    for (const auto x : algo::range(1, image.width()))
-    for (const auto c : algo::range(3))
-        image.at(x, 0)[c] = image.at(x - 1, 0)[c] - image.at(x, 0)[c];
+    const auto width = image.width();
+    const auto height = image.height();
 
-    for (const auto y : algo::range(1, image.height()))
+    auto *first_row = image.row(0);
+    for (const auto x : algo::range(1, width))
     for (const auto c : algo::range(3))
-        image.at(0, y)[c] = image.at(0, y - 1)[c] - image.at(0, y)[c];
+        first_row[x][c] = first_row[x - 1][c] - first_row[x][c];
 
-    for (const auto y : algo::range(1, image.height()))
-    for (const auto x : algo::range(1, image.width()))
+    for (const auto y : algo::range(1, height))
     for (const auto c : algo::range(3))
+        image.row(y)[0][c] = image.row(y - 1)[0][c] - image.row(y)[0][c];
+
+    for (const auto y : algo::range(1, height))
     {
-        u8 ax = image.at(x - 1, y)[c];
-        u8 ay = image.at(x, y - 1)[c];
-        image.at(x, y)[c] = (ax + ay) / 2 - image.at(x, y)[c];
+        const auto *above = image.row(y - 1);
+        auto *current = image.row(y);
+        for (const auto x : algo::range(1, width))
+        for (const auto c : algo::range(3))
+        {
+            const u8 ax = current[x - 1][c];
+            const u8 ay = above[x][c];
+            current[x][c] = (ax + ay) / 2 - current[x][c];
+        }
     }
 }
 
 static void apply_alpha(res::Image &image, const bstr &input)
 {
+    const auto width = image.width();
+    const auto height = image.height();
+
     if (!input.size())
     {
-        for (const auto y : algo::range(image.height()))
-        for (const auto x : algo::range(image.width()))
-            image.at(x, y).a = 0xFF;
+        for (auto &c : image)
+            c.a = 0xFF;
         return;
     }
 
-    io::MemoryByteStream input_stream(input);
+    // each row is padded to even width in the stream
+    const auto padded_width = width + (width & 1);
+    if (input.size() < padded_width * height)
+        throw err::BadDataSizeError();
 
-    image.at(0, 0).a = input_stream.read<u8>();
-    for (const auto x : algo::range(1, image.width()))
-        image.at(x, 0).a = image.at(x - 1, 0).a - input_stream.read<u8>();
-    if (image.width() & 1)
-        input_stream.skip(1);
+    const u8 *input_ptr = input.get<const u8>();
+    auto *first_row = image.row(0);
+    first_row[0].a = *input_ptr++;
+    for (const auto x : algo::range(1, width))
+    {
+        first_row[x].a = first_row[x - 1].a - *input_ptr;
+        input_ptr++;
+    }
+    if (width & 1)
+        input_ptr++;
 
-    for (const auto y : algo::range(1, image.height()))
+    for (const auto y : algo::range(1, height))
     {
-        image.at(0, y).a = image.at(0, y - 1).a - input_stream.read<u8>();
-        for (const auto x : algo::range(1, image.width()))
+        const auto *above = image.row(y - 1);
+        auto *current = image.row(y);
+        current[0].a = above[0].a - *input_ptr++;
+        for (const auto x : algo::range(1, width))
         {
-            u8 ax = image.at(x - 1, y).a;
-            u8 ay = image.at(x, y - 1).a;
-            image.at(x, y).a = (ax + ay) / 2 - input_stream.read<u8>();
+            const u8 ax = current[x - 1].a;
+            const u8 ay = above[x].a;
+            current[x].a = (ax + ay) / 2 - *input_ptr++;
         }
-        if (image.width() & 1)
-            input_stream.skip(1);
+        if (width & 1)
+            input_ptr++;
     }
 }
 
 bool QntImageDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 res::Image QntImageDecoder::decode_impl(
@@ -389,7 +389,7 @@ Pac3ArchiveDecoder::Pac3ArchiveDecoder()
 
 bool Pac3ArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> Pac3ArchiveDecoder::read_meta_impl(
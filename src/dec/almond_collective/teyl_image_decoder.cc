@@ -24,7 +24,7 @@ static const auto magic = "TEYL"_b;
 
 bool TeylImageDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.seek(0).read(magic.size()) == magic;
+    return input_file.stream.seek(0).matches(magic);
 }
 
 res::Image TeylImageDecoder::decode_impl(
@@ -24,7 +24,7 @@ static const bstr magic = "BGM\x20"_b;
 
 bool BgmAudioDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 std::unique_ptr<io::File> BgmAudioDecoder::decode_impl(
@@ -73,7 +73,7 @@ static bstr decompress(const bstr &input, const size_t size_orig)
 bool PgdC00ImageDecoder::is_recognized_impl(io::File &input_file) const
 {
     input_file.stream.seek(24);
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 res::Image PgdC00ImageDecoder::decode_impl(
@@ -173,7 +173,7 @@ static bstr apply_delta_filter(
 
 bool PgdGeImageDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 res::Image PgdGeImageDecoder::decode_impl(
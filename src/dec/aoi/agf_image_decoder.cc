@@ -27,7 +27,7 @@ static const bstr magic = "AGF\x00"_b;
 
 bool AgfImageDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.seek(0).read(magic.size()) == magic;
+    return input_file.stream.seek(0).matches(magic);
 }
 
 res::Image AgfImageDecoder::decode_impl(
@@ -46,7 +46,7 @@ bool ArcArchiveDecoder::is_recognized_impl(io::File &input_file) const
     if (input_file.stream.read(magic1.size()) == magic1)
         return true;
     input_file.stream.seek(0);
-    return input_file.stream.read(magic2.size()) == magic2;
+    return input_file.stream.matches(magic2);
 }
 
 std::unique_ptr<dec::ArchiveMeta> ArcArchiveDecoder::read_meta_impl(
@@ -40,7 +40,7 @@ static bstr decrypt(const bstr &input)
 
 bool GxpArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.seek(0).read(magic.size()) == magic;
+    return input_file.stream.seek(0).matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> GxpArchiveDecoder::read_meta_impl(
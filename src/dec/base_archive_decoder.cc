@@ -18,6 +18,7 @@
 #include "dec/base_archive_decoder.h"
 #include <algorithm>
 #include <cmath>
+#include <mutex>
 #include "algo/format.h"
 #include "dec/idecoder_visitor.h"
 #include "err.h"
@@ -25,11 +26,98 @@
 using namespace au;
 using namespace au::dec;
 
+static const size_t pool_granularity = 16;
+static const size_t max_pooled_size = 512;
+static const size_t slab_size = 0x10000;
+
+namespace
+{
+    // Size-bucketed slab pool behind ArchiveEntry::operator new. Entries
+    // parsed back to back land sequentially in large slabs, and freed
+    // blocks go to per-bucket free lists for reuse by the next archive.
+    class EntryPool final
+    {
+    public:
+        void *allocate(const size_t size)
+        {
+            const auto b = bucket(size);
+            const std::lock_guard<std::mutex> lock(mutex);
+            if (free_lists[b])
+            {
+                const auto ptr = free_lists[b];
+                free_lists[b] = *static_cast<void**>(ptr);
+                return ptr;
+            }
+            const auto chunk = (b + 1) * pool_granularity;
+            if (slab_space < chunk)
+            {
+                slabs.push_back(std::make_unique<u8[]>(slab_size));
+                slab_ptr = slabs.back().get();
+                slab_space = slab_size;
+            }
+            const auto ptr = slab_ptr;
+            slab_ptr += chunk;
+            slab_space -= chunk;
+            return ptr;
+        }
+
+        void deallocate(void *ptr, const size_t size)
+        {
+            const auto b = bucket(size);
+            const std::lock_guard<std::mutex> lock(mutex);
+            *static_cast<void**>(ptr) = free_lists[b];
+            free_lists[b] = ptr;
+        }
+
+    private:
+        static size_t bucket(const size_t size)
+        {
+            return (size - 1) / pool_granularity;
+        }
+
+        std::mutex mutex;
+        std::vector<std::unique_ptr<u8[]>> slabs;
+        u8 *slab_ptr = nullptr;
+        size_t slab_space = 0;
+        void *free_lists[max_pooled_size / pool_granularity] = {};
+    };
+}
+
+static EntryPool &entry_pool()
+{
+    // deliberately never destroyed - entries may outlive other statics
+    // during shutdown
+    static auto &pool = *new EntryPool;
+    return pool;
+}
+
+void *ArchiveEntry::operator new(const size_t size)
+{
+    if (size > max_pooled_size)
+        return ::operator new(size);
+    return entry_pool().allocate(size);
+}
+
+void ArchiveEntry::operator delete(void *ptr, const size_t size)
+{
+    if (!ptr)
+        return;
+    if (size > max_pooled_size)
+        ::operator delete(ptr);
+    else
+        entry_pool().deallocate(ptr, size);
+}
+
 algo::NamingStrategy BaseArchiveDecoder::naming_strategy() const
 {
     return algo::NamingStrategy::Child;
 }
 
+bool BaseArchiveDecoder::entries_are_independent() const
+{
+    return false;
+}
+
 BaseArchiveDecoder::BaseArchiveDecoder() : numeric_file_names(false)
 {
     add_arg_parser_decorator(
@@ -56,9 +144,22 @@ void BaseArchiveDecoder::accept(IDecoderVisitor &visitor) const
 
 std::unique_ptr<ArchiveMeta> BaseArchiveDecoder::read_meta(
     const Logger &logger, io::File &input_file) const
+{
+    return read_meta(logger, input_file, EntryFilter());
+}
+
+std::unique_ptr<ArchiveMeta> BaseArchiveDecoder::read_meta(
+    const Logger &logger,
+    io::File &input_file,
+    const EntryFilter &entry_filter) const
 {
     input_file.stream.seek(0);
-    auto meta = read_meta_impl(logger, input_file);
+    // --numeric-file-names renames the entries after enumeration, so
+    // path-based filtering inside read_meta_impl would match against
+    // names the user never sees; enumerate everything in that case
+    auto meta = numeric_file_names
+        ? read_meta_impl(logger, input_file)
+        : read_meta_impl(logger, input_file, entry_filter);
 
     const auto width = meta->entries.size() > 1
         ? std::max<int>(1, 1 + std::log10(meta->entries.size()))
@@ -100,6 +201,14 @@ std::unique_ptr<ArchiveMeta> BaseArchiveDecoder::read_meta(
     return meta;
 }
 
+std::unique_ptr<ArchiveMeta> BaseArchiveDecoder::read_meta_impl(
+    const Logger &logger,
+    io::File &input_file,
+    const EntryFilter &entry_filter) const
+{
+    return read_meta_impl(logger, input_file);
+}
+
 std::unique_ptr<io::File> BaseArchiveDecoder::read_file(
     const Logger &logger,
     io::File &input_file,
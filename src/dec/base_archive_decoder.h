@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include <functional>
 #include "base_decoder.h"
 
 namespace au {
@@ -25,6 +26,14 @@ namespace dec {
     struct ArchiveEntry
     {
         virtual ~ArchiveEntry() {}
+
+        // Entry tables are big bursts of small polymorphic objects; a
+        // shared slab pool keeps them contiguous in memory and spares a
+        // general heap round trip per entry. Inherited by all concrete
+        // entry types.
+        static void *operator new(const size_t size);
+        static void operator delete(void *ptr, const size_t size);
+
         io::path path;
     };
 
@@ -51,17 +60,37 @@ namespace dec {
     class BaseArchiveDecoder : public BaseDecoder
     {
     public:
+        // Predicate deciding whether an entry with the given path is worth
+        // materializing at all. An empty function means "everything".
+        using EntryFilter = std::function<bool(const io::path &)>;
+
         BaseArchiveDecoder();
 
         virtual ~BaseArchiveDecoder() {}
 
         virtual algo::NamingStrategy naming_strategy() const override;
 
+        // True when read_file_impl confines itself to the stream view it is
+        // handed and the immutable meta, with no shared mutable state. The
+        // parallel unpacker then admits entry tasks by entry size rather
+        // than by whole archive size, letting many entries of one large
+        // archive decode concurrently.
+        virtual bool entries_are_independent() const;
+
         void accept(IDecoderVisitor &visitor) const override;
 
         std::unique_ptr<ArchiveMeta> read_meta(
             const Logger &logger, io::File &input_file) const;
 
+        // Filtered variant. Decoders that can enumerate their entry tables
+        // lazily consult the predicate while walking and never materialize
+        // rejected entries; everyone else falls back to a full read_meta
+        // followed by caller-side filtering.
+        std::unique_ptr<ArchiveMeta> read_meta(
+            const Logger &logger,
+            io::File &input_file,
+            const EntryFilter &entry_filter) const;
+
         std::unique_ptr<io::File> read_file(
             const Logger &logger,
             io::File &input_file,
@@ -73,6 +102,13 @@ namespace dec {
             const Logger &logger,
             io::File &input_file) const = 0;
 
+        // Default implementation ignores the filter and enumerates
+        // everything.
+        virtual std::unique_ptr<ArchiveMeta> read_meta_impl(
+            const Logger &logger,
+            io::File &input_file,
+            const EntryFilter &entry_filter) const;
+
         virtual std::unique_ptr<io::File> read_file_impl(
             const Logger &logger,
             io::File &input_file,
@@ -39,3 +39,27 @@ res::Audio BaseAudioDecoder::decode(const Logger &logger, io::File &file) const
     file.stream.seek(0);
     return decode_impl(logger, file);
 }
+
+bool BaseAudioDecoder::supports_streamed_decode() const
+{
+    return false;
+}
+
+void BaseAudioDecoder::decode_streamed(
+    const Logger &logger, io::File &file, AudioBlockSink &sink) const
+{
+    if (!is_recognized(file))
+        throw err::RecognitionError();
+    file.stream.seek(0);
+    decode_streamed_impl(logger, file, sink);
+}
+
+void BaseAudioDecoder::decode_streamed_impl(
+    const Logger &logger, io::File &file, AudioBlockSink &sink) const
+{
+    auto audio = decode_impl(logger, file);
+    const auto samples = std::move(audio.samples);
+    audio.samples = ""_b;
+    sink.start(audio);
+    sink.block(samples);
+}
@@ -23,6 +23,17 @@
 namespace au {
 namespace dec {
 
+    // Receives an audio track as a sequence of PCM blocks; start() is
+    // called once with the track's format (the samples member is left
+    // empty) before the first block arrives.
+    class AudioBlockSink
+    {
+    public:
+        virtual ~AudioBlockSink() {}
+        virtual void start(const res::Audio &spec) = 0;
+        virtual void block(const bstr &samples) = 0;
+    };
+
     class BaseAudioDecoder : public BaseDecoder
     {
     public:
@@ -34,9 +45,27 @@ namespace dec {
 
         res::Audio decode(const Logger &logger, io::File &input_file) const;
 
+        // Decoders whose format yields PCM incrementally override
+        // supports_streamed_decode() and decode_streamed_impl(), so a
+        // long track never has to be resident as a whole: each block is
+        // handed to the sink and freed before the next one is decoded.
+        // Everyone else inherits a fallback that decodes the whole track
+        // and hands it over as a single block.
+        virtual bool supports_streamed_decode() const;
+
+        void decode_streamed(
+            const Logger &logger,
+            io::File &input_file,
+            AudioBlockSink &sink) const;
+
     protected:
         virtual res::Audio decode_impl(
             const Logger &logger, io::File &input_file) const = 0;
+
+        virtual void decode_streamed_impl(
+            const Logger &logger,
+            io::File &input_file,
+            AudioBlockSink &sink) const;
     };
 
 } }
@@ -39,3 +39,25 @@ res::Image BaseImageDecoder::decode(const Logger &logger, io::File &file) const
     file.stream.seek(0);
     return decode_impl(logger, file);
 }
+
+bool BaseImageDecoder::supports_banded_decode() const
+{
+    return false;
+}
+
+void BaseImageDecoder::decode_banded(
+    const Logger &logger, io::File &file, ImageBandSink &sink) const
+{
+    if (!is_recognized(file))
+        throw err::RecognitionError();
+    file.stream.seek(0);
+    decode_banded_impl(logger, file, sink);
+}
+
+void BaseImageDecoder::decode_banded_impl(
+    const Logger &logger, io::File &file, ImageBandSink &sink) const
+{
+    const auto image = decode_impl(logger, file);
+    sink.start(image.width(), image.height());
+    sink.band(image);
+}
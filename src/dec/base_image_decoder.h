@@ -23,6 +23,17 @@
 namespace au {
 namespace dec {
 
+    // Receives an image as a sequence of horizontal bands, top to bottom;
+    // start() is called once with the full dimensions before the first
+    // band arrives.
+    class ImageBandSink
+    {
+    public:
+        virtual ~ImageBandSink() {}
+        virtual void start(const size_t width, const size_t height) = 0;
+        virtual void band(const res::Image &image_band) = 0;
+    };
+
     class BaseImageDecoder : public BaseDecoder
     {
     public:
@@ -35,9 +46,27 @@ namespace dec {
         res::Image decode(
             const Logger &logger, io::File &input_file) const;
 
+        // Decoders whose format yields rows incrementally override
+        // supports_banded_decode() and decode_banded_impl(), so a huge
+        // image never has to be resident as a whole: each band is handed
+        // to the sink and freed before the next one is decoded. Everyone
+        // else inherits a fallback that decodes the whole image and hands
+        // it over as a single band.
+        virtual bool supports_banded_decode() const;
+
+        void decode_banded(
+            const Logger &logger,
+            io::File &input_file,
+            ImageBandSink &sink) const;
+
     protected:
         virtual res::Image decode_impl(
             const Logger &logger, io::File &input_file) const = 0;
+
+        virtual void decode_banded_impl(
+            const Logger &logger,
+            io::File &input_file,
+            ImageBandSink &sink) const;
     };
 
 } }
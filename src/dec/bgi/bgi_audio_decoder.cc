@@ -25,7 +25,7 @@ static const bstr magic = "bw\x20\x20"_b;
 bool BgiAudioDecoder::is_recognized_impl(io::File &input_file) const
 {
     input_file.stream.skip(4);
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 std::unique_ptr<io::File> BgiAudioDecoder::decode_impl(
@@ -102,7 +102,7 @@ bstr BseDecoder::decode()
 
 bool BseFileDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 std::unique_ptr<io::File> BseFileDecoder::decode_impl(
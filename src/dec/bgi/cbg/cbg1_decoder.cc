@@ -29,8 +29,9 @@ static bstr decompress_huffman(
     io::BaseBitStream &bit_stream, const Tree &tree, size_t output_size)
 {
     bstr output(output_size);
+    auto output_ptr = output.get<u8>();
     for (const auto i : algo::range(output.size()))
-        output[i] = tree.get_leaf(bit_stream);
+        output_ptr[i] = tree.get_leaf(bit_stream);
     return output;
 }
 
@@ -49,16 +50,11 @@ static bstr decompress_rle(bstr &input, size_t output_size)
         if (output_ptr + size >= output_end)
             size = output_end - output_ptr;
 
-        if (zero_flag)
-        {
-            for (const auto i : algo::range(size))
-                *output_ptr++ = 0;
-        }
-        else
-        {
-            for (const auto i : algo::range(size))
-                *output_ptr++ = input_stream.read<u8>();
-        }
+        // zero runs are already in place - the output buffer starts
+        // zero-filled - and literal runs copy in bulk
+        if (!zero_flag)
+            input_stream.read(output_ptr, size);
+        output_ptr += size;
         zero_flag = !zero_flag;
     }
 
@@ -76,14 +76,18 @@ FreqTable cbg::read_freq_table(
 
 NodeInfo &Tree::operator[](size_t index)
 {
-    return *nodes[index];
+    return nodes[index];
 }
 
 u32 Tree::get_leaf(io::BaseBitStream &bit_stream) const
 {
     u32 node = nodes.size() - 1;
     while (node >= size)
-        node = nodes.at(node)->children[bit_stream.read(1)];
+    {
+        if (node >= nodes.size())
+            throw err::CorruptDataError("Invalid Huffman node");
+        node = nodes[node].children[bit_stream.read(1)];
+    }
     return node;
 }
 
@@ -91,16 +95,17 @@ Tree cbg::build_tree(const FreqTable &freq_table, bool greedy)
 {
     Tree tree;
     tree.size = freq_table.size();
+    tree.nodes.reserve(tree.size * 2);
     u32 freq_sum = 0;
     for (const auto i : algo::range(tree.size))
     {
-        auto node = std::make_shared<NodeInfo>();
-        node->frequency = freq_table[i];
-        node->valid = freq_table[i] > 0;
-        node->children[0] = i;
-        node->children[1] = i;
+        NodeInfo node;
+        node.frequency = freq_table[i];
+        node.valid = freq_table[i] > 0;
+        node.children[0] = i;
+        node.children[1] = i;
         freq_sum += freq_table[i];
-        tree.nodes.push_back(std::move(node));
+        tree.nodes.push_back(node);
     }
 
     for (const auto level : algo::range(tree.size))
@@ -140,12 +145,12 @@ Tree cbg::build_tree(const FreqTable &freq_table, bool greedy)
             tree[children[j]].valid = false;
             freq += tree[children[j]].frequency;
         }
-        auto node = std::make_shared<NodeInfo>();
-        node->valid = true;
-        node->frequency = freq;
-        node->children[0] = children[0];
-        node->children[1] = children[1];
-        tree.nodes.push_back(std::move(node));
+        NodeInfo node;
+        node.valid = true;
+        node.frequency = freq;
+        node.children[0] = children[0];
+        node.children[1] = children[1];
+        tree.nodes.push_back(node);
 
         if (freq >= freq_sum)
             break;
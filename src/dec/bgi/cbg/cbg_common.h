@@ -45,7 +45,9 @@ namespace cbg {
         NodeInfo &operator[](size_t);
 
         u32 size;
-        std::vector<std::shared_ptr<NodeInfo>> nodes;
+        // nodes are stored by value so that the per-symbol walk follows
+        // one contiguous array instead of chasing heap pointers
+        std::vector<NodeInfo> nodes;
     };
 
     u32 read_variable_data(io::BaseByteStream &input_stream);
@@ -48,7 +48,7 @@ static Version get_version(io::BaseByteStream &input_stream)
 
 bool CbgImageDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 res::Image CbgImageDecoder::decode_impl(
@@ -21,7 +21,6 @@
 #include "enc/png/png_image_encoder.h"
 #include "err.h"
 #include "io/memory_byte_stream.h"
-#include "io/msb_bit_stream.h"
 
 using namespace au;
 using namespace au::dec::bgi;
@@ -36,7 +35,7 @@ namespace
         u32 children[2];
     };
 
-    using NodeList = std::vector<std::unique_ptr<NodeInfo>>;
+    using NodeList = std::vector<NodeInfo>;
 }
 
 static const bstr magic = "DSC FORMAT 1.00\x00"_b;
@@ -56,19 +55,14 @@ static int is_image(const bstr &input)
 
 static NodeList get_nodes(io::BaseByteStream &input_stream, u32 key)
 {
-    NodeList nodes;
-    for (const auto i : algo::range(1024))
-    {
-        auto node_info = std::make_unique<NodeInfo>();
-        node_info->has_children = false;
-        node_info->value = 0;
-        nodes.push_back(std::move(node_info));
-    }
+    NodeList nodes(1024);
 
+    const auto depth_table = input_stream.read(512);
+    const auto depth_table_ptr = depth_table.get<const u8>();
     std::vector<u32> arr0;
     for (const auto n : algo::range(512))
     {
-        u8 tmp = input_stream.read<u8>() - get_and_update_key(key);
+        u8 tmp = depth_table_ptr[n] - get_and_update_key(key);
         if (tmp)
             arr0.push_back((tmp << 16) + n);
     }
@@ -90,9 +84,9 @@ static NodeList get_nodes(io::BaseByteStream &input_stream, u32 key)
             const u32 c = arr0_pos < arr0.size() ? arr0[arr0_pos] : 0;
             if (n != (c >> 16))
                 break;
-            nodes[*node_ptr]->has_children = false;
-            nodes[*node_ptr]->look_behind = (arr0[arr0_pos] & 0x100) != 0;
-            nodes[*node_ptr]->value = arr0[arr0_pos] & 0xFF;
+            nodes[*node_ptr].has_children = false;
+            nodes[*node_ptr].look_behind = (arr0[arr0_pos] & 0x100) != 0;
+            nodes[*node_ptr].value = arr0[arr0_pos] & 0xFF;
             arr0_pos++;
             node_ptr++;
             group_count++;
@@ -104,9 +98,9 @@ static NodeList get_nodes(io::BaseByteStream &input_stream, u32 key)
             unk1 = unk1 - group_count;
             for (const auto i : algo::range(unk1))
             {
-                nodes[*node_ptr]->has_children = true;
+                nodes[*node_ptr].has_children = true;
                 for (const auto j : algo::range(2))
-                    *arr1_ptr++ = nodes[*node_ptr]->children[j] = node_index++;
+                    *arr1_ptr++ = nodes[*node_ptr].children[j] = node_index++;
                 node_ptr++;
             }
         }
@@ -126,19 +120,44 @@ static bstr decompress(
     u8 *output_ptr = output.get<u8>();
     const u8 *output_start = output_ptr;
     const u8 *output_end = output_ptr + output.size();
-    io::MsbBitStream bit_stream(input_stream.read_to_eof());
 
-    u32 bits = 0, bit_count = 0;
+    const auto input = input_stream.read_to_eof();
+    const u8 *input_ptr = input.get<const u8>();
+    const u8 *input_end = input_ptr + input.size();
+
+    // the per-symbol walk costs one bit per step, so the bits come from a
+    // local 64-bit cache rather than a virtual stream call each
+    u64 cache = 0;
+    size_t cached_bits = 0;
+    const auto refill = [&](const size_t bits)
+    {
+        while (cached_bits < bits)
+        {
+            if (input_ptr >= input_end)
+                throw err::EofError();
+            cache = (cache << 8) | *input_ptr++;
+            cached_bits += 8;
+        }
+    };
+
     while (output_ptr < output_end)
     {
         u32 node_index = 0;
-        while (nodes[node_index]->has_children)
-            node_index = nodes[node_index]->children[bit_stream.read(1)];
+        while (nodes[node_index].has_children)
+        {
+            refill(1);
+            --cached_bits;
+            node_index
+                = nodes[node_index].children[(cache >> cached_bits) & 1];
+        }
 
-        if (nodes[node_index]->look_behind)
+        const auto &node = nodes[node_index];
+        if (node.look_behind)
         {
-            auto offset = bit_stream.read(12);
-            size_t repetitions = nodes[node_index]->value + 2;
+            refill(12);
+            cached_bits -= 12;
+            const u32 offset = (cache >> cached_bits) & 0xFFF;
+            size_t repetitions = node.value + 2;
             u8 *look_behind = output_ptr - offset - 2;
             if (look_behind < output_start)
                 break;
@@ -149,7 +168,7 @@ static bstr decompress(
         }
         else
         {
-            *output_ptr++ = nodes[node_index]->value;
+            *output_ptr++ = node.value;
         }
     }
 
@@ -158,7 +177,7 @@ static bstr decompress(
 
 bool DscFileDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 std::unique_ptr<io::File> DscFileDecoder::decode_impl(
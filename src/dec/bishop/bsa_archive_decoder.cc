@@ -26,7 +26,7 @@ static const bstr magic = "BSArc\x00\x00\x00"_b;
 
 bool BsaArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 static bool process_directory(
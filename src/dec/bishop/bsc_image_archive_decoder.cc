@@ -24,7 +24,7 @@ static const auto magic = "BSS-Composition"_b;
 
 bool BscImageArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.seek(0).read(magic.size()) == magic;
+    return input_file.stream.seek(0).matches(magic);
 }
 
 algo::NamingStrategy BscImageArchiveDecoder::naming_strategy() const
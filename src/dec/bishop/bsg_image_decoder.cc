@@ -27,7 +27,7 @@ static const bstr magic = "BSS-Graphics"_b;
 
 bool BsgImageDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.seek(0).read(magic.size()) == magic;
+    return input_file.stream.seek(0).matches(magic);
 }
 
 static void unpack_none(
@@ -158,7 +158,14 @@ static std::unique_ptr<res::Image> decode_jpeg(
 
 bool Hg3ImageArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.seek(0).read(magic.size()) == magic;
+    return input_file.stream.seek(0).matches(magic);
+}
+
+bool Hg3ImageArchiveDecoder::entries_are_independent() const
+{
+    // every sub-image carries its own chunk list and reads only its own
+    // byte range, so the variants can be decoded concurrently
+    return true;
 }
 
 std::unique_ptr<dec::ArchiveMeta> Hg3ImageArchiveDecoder::read_meta_impl(
@@ -219,9 +226,14 @@ std::unique_ptr<io::File> Hg3ImageArchiveDecoder::read_file_impl(
     else
         throw err::NotSupportedError("No image data found!\n");
 
+    const auto encoder = enc::png::PngImageEncoder();
+
+    // full-canvas sub-images need no compositing pass
+    if (!x && !y && width == canvas_width && height == canvas_height)
+        return encoder.encode(logger, *image, entry->path);
+
     res::Image actual_image(canvas_width, canvas_height);
     actual_image.overlay(*image, x, y, res::Image::OverlayKind::OverwriteAll);
-    const auto encoder = enc::png::PngImageEncoder();
     return encoder.encode(logger, actual_image, entry->path);
 }
 
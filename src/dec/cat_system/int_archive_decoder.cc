@@ -159,7 +159,7 @@ static bstr get_game_id(const ResourceKeys &res_keys)
 
 bool IntArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 std::unique_ptr<dec::ArchiveMeta> IntArchiveDecoder::read_meta_impl(
     const Logger &logger, io::File &input_file) const
@@ -25,7 +25,7 @@ static const bstr magic = "MYK00\x1A\x00\x00"_b;
 
 bool MykArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> MykArchiveDecoder::read_meta_impl(
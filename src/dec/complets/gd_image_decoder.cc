@@ -20,6 +20,7 @@
 #include "algo/pack/lzss.h"
 #include "algo/ptr.h"
 #include "algo/range.h"
+#include "algo/scratch_arena.h"
 #include "err.h"
 #include "io/msb_bit_stream.h"
 
@@ -45,7 +46,7 @@ static bstr decompress_lzss(
     const size_t height,
     const size_t channels)
 {
-    std::vector<u8> dict(1 << 16, 0);
+    algo::ScratchBuffer dict(1 << 16);
     auto dict_ptr = algo::make_cyclic_ptr(dict.data(), dict.size()) + 1;
 
     bstr output(width * height * channels);
@@ -202,7 +203,9 @@ res::Image GdImageDecoder::decode_impl(
     else
     {
         throw err::NotSupportedError(
-            algo::format("Unknown compression type: %x", compression_type));
+            algo::format(
+                "Unknown compression type: %x",
+                static_cast<unsigned int>(compression_type)));
     }
 
     return res::Image(width, height, output, fmt).flip_vertically();
@@ -28,7 +28,7 @@ static const bstr magic = "AFS2"_b;
 bool Afs2ArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
     input_file.stream.seek(0);
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> Afs2ArchiveDecoder::read_meta_impl(
@@ -26,7 +26,7 @@ static const bstr magic = "AFS\x00"_b;
 bool AfsArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
     input_file.stream.seek(0);
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> AfsArchiveDecoder::read_meta_impl(
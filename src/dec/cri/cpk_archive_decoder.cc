@@ -16,13 +16,13 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "dec/cri/cpk_archive_decoder.h"
+#include <cstring>
 #include <map>
 #include "algo/any.h"
 #include "algo/range.h"
 #include "algo/str.h"
 #include "err.h"
 #include "io/memory_byte_stream.h"
-#include "io/msb_bit_stream.h"
 
 using namespace au;
 using namespace au::dec::cri;
@@ -66,13 +66,38 @@ namespace
     };
 
     using Cell = algo::any;
-    using Row = std::map<std::string, Cell>;
     using Toc = std::map<u32, TocEntry>;
 
-    struct Column final
+    // Lazy, column-indexed view over a @UTF packet. The constructor only
+    // decodes the column descriptors and each column's offset within a
+    // row; cell values are decoded when they are asked for, so tables
+    // with many unused columns (the common case) cost almost nothing.
+    class UtfTable final
     {
-        u32 flags;
-        std::string name;
+    public:
+        UtfTable(const bstr &utf_packet);
+
+        size_t row_count() const;
+        bool has_column(const std::string &name) const;
+
+        // Returns an empty cell for columns that are absent or have no
+        // per-row storage.
+        Cell get(const size_t row, const std::string &name) const;
+
+    private:
+        struct UtfColumn final
+        {
+            u32 flags;
+            size_t offset_in_row;
+        };
+
+        mutable io::MemoryByteStream stream;
+        std::map<std::string, UtfColumn> columns;
+        size_t rows_offset_base;
+        size_t text_offset_base;
+        size_t data_offset_base;
+        size_t row_size;
+        size_t table_row_count;
     };
 }
 
@@ -99,24 +124,67 @@ static bstr read_utf_packet(io::BaseByteStream &input_stream)
         : decrypt_utf_packet(utf_packet);
 }
 
+namespace
+{
+    // CRILAYLA serializes its bit stream starting from the last byte of
+    // the compressed block; this reader walks the buffer backwards with a
+    // small bit cache instead of going through a reversed copy and the
+    // generic bit stream.
+    struct LaylaBitReader final
+    {
+        LaylaBitReader(const u8 *data, const size_t size)
+            : data(data), byte_pos(size), cache(0), cached_bits(0)
+        {
+        }
+
+        u32 read(const size_t bits)
+        {
+            while (cached_bits < bits)
+            {
+                if (!byte_pos)
+                    throw err::BadDataSizeError();
+                cache = (cache << 8) | data[--byte_pos];
+                cached_bits += 8;
+            }
+            cached_bits -= bits;
+            return (cache >> cached_bits) & ((1u << bits) - 1);
+        }
+
+        const u8 *data;
+        size_t byte_pos;
+        u64 cache;
+        size_t cached_bits;
+    };
+}
+
 static bstr decompress_layla(const bstr &input)
 {
     io::MemoryByteStream input_stream(input);
     input_stream.seek(layla_magic.size());
     const auto size_orig = input_stream.read_le<u32>();
     const auto size_comp = input_stream.read_le<u32>();
-    const auto data_comp = algo::reverse(input_stream.read(size_comp));
+    const auto data_comp = input_stream.read(size_comp);
     const auto prefix = input_stream.read_to_eof();
 
-    io::MsbBitStream bit_stream(data_comp);
-    bstr output;
-    output.reserve(size_orig);
-    while (output.size() < size_orig)
+    // the stream also describes its output back to front, so the data is
+    // written into its final position right away, without the temporary
+    // buffer and the two full-size reversals the old implementation paid
+    bstr output(prefix.size() + size_orig);
+    std::memcpy(output.get<u8>(), prefix.get<const u8>(), prefix.size());
+    auto *output_ptr = output.get<u8>();
+    const auto output_start = prefix.size();
+    const auto output_end = output.size();
+    auto write_pos = output_end;
+
+    LaylaBitReader bit_reader(data_comp.get<const u8>(), data_comp.size());
+    while (write_pos > output_start)
     {
-        if (bit_stream.read(1))
+        if (bit_reader.read(1))
         {
-            auto repetitions = 3;
-            auto look_behind = bit_stream.read(13) + 3;
+            size_t repetitions = 3;
+            const size_t look_behind = bit_reader.read(13) + 3;
+            if (look_behind > output_end - write_pos)
+                throw err::CorruptDataError("Reference to missing data");
 
             std::vector<size_t> sizes = {5, 3, 2};
             while (true)
@@ -127,125 +195,167 @@ static bstr decompress_layla(const bstr &input)
                     size = sizes.back();
                     sizes.pop_back();
                 }
-                const auto marker = bit_stream.read(size);
+                const auto marker = bit_reader.read(size);
                 repetitions += marker;
                 if (marker != (1u << size) - 1)
                     break;
             }
 
-            while (repetitions--)
-                output += output.at(output.size() - look_behind);
+            repetitions = std::min(repetitions, write_pos - output_start);
+            if (look_behind >= repetitions)
+            {
+                // disjoint regions - bulk copy
+                write_pos -= repetitions;
+                std::memcpy(
+                    output_ptr + write_pos,
+                    output_ptr + write_pos + look_behind,
+                    repetitions);
+            }
+            else
+            {
+                // overlapping back-reference - repeat the pattern byte by
+                // byte in generation order
+                while (repetitions--)
+                {
+                    write_pos--;
+                    output_ptr[write_pos]
+                        = output_ptr[write_pos + look_behind];
+                }
+            }
         }
         else
-            output += static_cast<u8>(bit_stream.read(8));
+        {
+            output_ptr[--write_pos] = bit_reader.read(8);
+        }
     }
 
-    return prefix + algo::reverse(output);
+    return output;
+}
+
+static size_t get_cell_size(const u32 flags)
+{
+    switch (flags & type_mask)
+    {
+        case type_u8a:
+        case type_u8b:
+            return 1;
+        case type_u16a:
+        case type_u16b:
+            return 2;
+        case type_u32a:
+        case type_u32b:
+        case type_f32:
+        case type_str:
+            return 4;
+        case type_u64a:
+        case type_u64b:
+        case type_data:
+            return 8;
+        default:
+            throw err::CorruptDataError("Unknown column type");
+    }
 }
 
-static std::vector<Row> parse_utf_packet(const bstr &utf_packet)
+UtfTable::UtfTable(const bstr &utf_packet) : stream(utf_packet)
 {
-    io::MemoryByteStream utf_stream(utf_packet);
-    if (utf_stream.read(4) != "@UTF"_b)
+    if (stream.read(4) != "@UTF"_b)
         throw err::CorruptDataError("Expected UTF packet");
-    const auto table_size = utf_stream.read_be<u32>();
-    const auto rows_offset_base = utf_stream.read_be<u32>() + 8;
-    const auto text_offset_base = utf_stream.read_be<u32>() + 8;
-    const auto data_offset_base = utf_stream.read_be<u32>() + 8;
-    const auto table_name_offset = utf_stream.read_be<u32>();
-    const auto column_count = utf_stream.read_be<u16>();
-    const auto row_size = utf_stream.read_be<u16>();
-    const auto row_count = utf_stream.read_be<u32>();
-
-    std::string table_name;
-    utf_stream.peek(
-        text_offset_base + table_name_offset,
-        [&]() { table_name = utf_stream.read_to_zero().str(); });
-
-    std::vector<Column> columns(column_count);
-    for (auto &column : columns)
+    stream.skip(4); // table size
+    rows_offset_base = stream.read_be<u32>() + 8;
+    text_offset_base = stream.read_be<u32>() + 8;
+    data_offset_base = stream.read_be<u32>() + 8;
+    stream.skip(4); // table name offset
+    const auto column_count = stream.read_be<u16>();
+    row_size = stream.read_be<u16>();
+    table_row_count = stream.read_be<u32>();
+
+    size_t offset_in_row = 0;
+    for (const auto i : algo::range(column_count))
     {
-        column.flags = utf_stream.read<u8>();
+        UtfColumn column;
+        column.flags = stream.read<u8>();
         if (column.flags == 0)
-            column.flags = utf_stream.read_be<u32>();
+            column.flags = stream.read_be<u32>();
+        column.offset_in_row = offset_in_row;
 
-        const auto column_name_offset = utf_stream.read_be<u32>();
-        utf_stream.peek(
+        const auto storage_type = column.flags & storage_mask;
+        if (storage_type == storage_per_row)
+            offset_in_row += get_cell_size(column.flags);
+
+        const auto column_name_offset = stream.read_be<u32>();
+        std::string column_name;
+        stream.peek(
             text_offset_base + column_name_offset,
-            [&]() { column.name = utf_stream.read_to_zero().str(); });
+            [&]() { column_name = stream.read_to_zero().str(); });
+        columns[column_name] = column;
     }
+}
 
-    std::vector<Row> rows(row_count);
-    for (const auto y : algo::range(row_count))
-    {
-        auto &row = rows[y];
-        utf_stream.seek(rows_offset_base + y * row_size);
-        for (const auto &column : columns)
-        {
-            auto &cell = row[column.name];
+size_t UtfTable::row_count() const
+{
+    return table_row_count;
+}
 
-            const auto storage_type = column.flags & storage_mask;
-            if (storage_type == storage_none
-                || storage_type == storage_zero
-                || storage_type == storage_const)
-            {
-                continue;
-            }
+bool UtfTable::has_column(const std::string &name) const
+{
+    return columns.find(name) != columns.end();
+}
 
-            const auto type = column.flags & type_mask;
-            switch (type)
-            {
-                case type_u8a:
-                case type_u8b:
-                    cell = utf_stream.read<u8>();
-                    break;
+Cell UtfTable::get(const size_t row, const std::string &name) const
+{
+    const auto it = columns.find(name);
+    if (it == columns.end())
+        return Cell();
+    const auto &column = it->second;
+    if ((column.flags & storage_mask) != storage_per_row)
+        return Cell();
+
+    stream.seek(rows_offset_base + row * row_size + column.offset_in_row);
+    switch (column.flags & type_mask)
+    {
+        case type_u8a:
+        case type_u8b:
+            return stream.read<u8>();
 
-                case type_u16a:
-                case type_u16b:
-                    cell = utf_stream.read_be<u16>();
-                    break;
+        case type_u16a:
+        case type_u16b:
+            return stream.read_be<u16>();
 
-                case type_u32a:
-                case type_u32b:
-                    cell = utf_stream.read_be<u32>();
-                    break;
+        case type_u32a:
+        case type_u32b:
+            return stream.read_be<u32>();
 
-                case type_u64a:
-                case type_u64b:
-                    cell = utf_stream.read_be<u64>();
-                    break;
+        case type_u64a:
+        case type_u64b:
+            return stream.read_be<u64>();
 
-                case type_f32:
-                    cell = utf_stream.read_be<f32>();
-                    break;
+        case type_f32:
+            return stream.read_be<f32>();
 
-                case type_str:
-                {
-                    const auto value_offset = utf_stream.read_be<u32>();
-                    utf_stream.peek(
-                        text_offset_base + value_offset,
-                        [&]()
-                        {
-                            cell = utf_stream.read_to_zero().str();
-                        });
-                    break;
-                }
+        case type_str:
+        {
+            const auto value_offset = stream.read_be<u32>();
+            Cell cell;
+            stream.peek(
+                text_offset_base + value_offset,
+                [&]() { cell = stream.read_to_zero().str(); });
+            return cell;
+        }
 
-                case type_data:
-                {
-                    const auto data_offset = utf_stream.read_be<u32>();
-                    const auto data_size = utf_stream.read_be<u32>();
-                    utf_stream.peek(
-                        data_offset_base + data_offset,
-                        [&]() { cell = utf_stream.read(data_size); });
-                    break;
-                }
-            }
+        case type_data:
+        {
+            const auto data_offset = stream.read_be<u32>();
+            const auto data_size = stream.read_be<u32>();
+            Cell cell;
+            stream.peek(
+                data_offset_base + data_offset,
+                [&]() { cell = stream.read(data_size); });
+            return cell;
         }
-        rows.push_back(row);
-    }
 
-    return rows;
+        default:
+            throw err::CorruptDataError("Unknown column type");
+    }
 }
 
 static void read_toc(
@@ -260,20 +370,21 @@ static void read_toc(
     if (input_stream.read(4) != "TOC\x20"_b)
         throw err::CorruptDataError("Expected TOC packet");
 
-    const auto table = parse_utf_packet(read_utf_packet(input_stream));
-    for (const auto &row : table)
+    const UtfTable table(read_utf_packet(input_stream));
+    for (const auto y : algo::range(table.row_count()))
     {
         TocEntry entry;
-        entry.id = row.at("ID").get<u32>();
-        if (row.at("DirName"))
-            entry.dir_name = row.at("DirName").get<std::string>();
-        entry.file_name = row.at("FileName").get<std::string>();
-        entry.file_offset = row.at("FileOffset").get<u64>() + data_offset_base;
-        entry.file_size = row.at("FileSize").get<u32>();
-        if (row.at("ExtractSize"))
-            entry.extract_size = row.at("ExtractSize").get<u32>();
-        if (row.at("UserString"))
-            entry.user_string = row.at("UserString").get<std::string>();
+        entry.id = table.get(y, "ID").get<u32>();
+        if (table.get(y, "DirName"))
+            entry.dir_name = table.get(y, "DirName").get<std::string>();
+        entry.file_name = table.get(y, "FileName").get<std::string>();
+        entry.file_offset
+            = table.get(y, "FileOffset").get<u64>() + data_offset_base;
+        entry.file_size = table.get(y, "FileSize").get<u32>();
+        if (table.get(y, "ExtractSize"))
+            entry.extract_size = table.get(y, "ExtractSize").get<u32>();
+        if (table.get(y, "UserString"))
+            entry.user_string = table.get(y, "UserString").get<std::string>();
         toc[entry.id] = entry;
     }
 }
@@ -285,14 +396,13 @@ static void read_etoc(
     if (input_stream.read(4) != "ETOC"_b)
         throw err::CorruptDataError("Expected ETOC packet");
 
-    const auto table = parse_utf_packet(read_utf_packet(input_stream));
+    const UtfTable table(read_utf_packet(input_stream));
     for (const auto i : algo::range(toc.size()))
     {
         auto &entry = toc[i];
-        const auto &row = table.at(i);
-        if (row.at("LocalDir"))
-            entry.local_dir = row.at("LocalDir").get<std::string>();
-        entry.mtime = row.at("UpdateDateTime").get<u64>();
+        if (table.get(i, "LocalDir"))
+            entry.local_dir = table.get(i, "LocalDir").get<std::string>();
+        entry.mtime = table.get(i, "UpdateDateTime").get<u64>();
     }
 }
 
@@ -307,27 +417,33 @@ static void read_itoc(
     if (input_stream.read(4) != "ITOC"_b)
         throw err::CorruptDataError("Expected ITOC packet");
 
-    const auto table = parse_utf_packet(read_utf_packet(input_stream));
-    if (table.empty())
+    const UtfTable table(read_utf_packet(input_stream));
+    if (!table.row_count())
         return;
 
-    if (table[0].find("DataL") != table[0].end())
+    if (table.has_column("DataL"))
     {
-        const auto data_l = parse_utf_packet(table[0].at("DataL").get<bstr>());
-        const auto data_h = parse_utf_packet(table[0].at("DataH").get<bstr>());
-        for (const auto &row : data_l)
+        const UtfTable data_l(table.get(0, "DataL").get<bstr>());
+        const UtfTable data_h(table.get(0, "DataH").get<bstr>());
+        for (const auto y : algo::range(data_l.row_count()))
         {
-            const auto entry_id = row.at("ID").get<u16>();
-            toc[entry_id].file_size = row.at("FileSize").get<u16>();
-            if (row.at("ExtractSize"))
-                toc[entry_id].extract_size = row.at("ExtractSize").get<u16>();
+            const auto entry_id = data_l.get(y, "ID").get<u16>();
+            toc[entry_id].file_size = data_l.get(y, "FileSize").get<u16>();
+            if (data_l.get(y, "ExtractSize"))
+            {
+                toc[entry_id].extract_size
+                    = data_l.get(y, "ExtractSize").get<u16>();
+            }
         }
-        for (const auto &row : data_h)
+        for (const auto y : algo::range(data_h.row_count()))
         {
-            const auto entry_id = row.at("ID").get<u16>();
-            toc[entry_id].file_size = row.at("FileSize").get<u32>();
-            if (row.at("ExtractSize"))
-                toc[entry_id].extract_size = row.at("ExtractSize").get<u32>();
+            const auto entry_id = data_h.get(y, "ID").get<u16>();
+            toc[entry_id].file_size = data_h.get(y, "FileSize").get<u32>();
+            if (data_h.get(y, "ExtractSize"))
+            {
+                toc[entry_id].extract_size
+                    = data_h.get(y, "ExtractSize").get<u32>();
+            }
         }
         uoff_t offset = content_offset;
         std::vector<u32> ids;
@@ -342,52 +458,47 @@ static void read_itoc(
             if (size % align)
                 offset += align - (size % align);
         }
-        return;
-    }
-
-    for (const auto &row : table)
-    {
-        const auto id = row.at("ID").get<u32>();
-        const auto idx = row.at("TocIndex").get<u32>();
     }
 }
 
 bool CpkArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.seek(0).read(magic.size()) == magic;
+    return input_file.stream.seek(0).matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> CpkArchiveDecoder::read_meta_impl(
     const Logger &logger, io::File &input_file) const
 {
     input_file.stream.seek(magic.size());
-    const auto header_packet = read_utf_packet(input_file.stream);
-    const auto header = parse_utf_packet(header_packet).at(0);
-    const auto content_offset = header.at("ContentOffset").get<u64>();
-    const auto align = header.at("Align").get<u16>();
+    const UtfTable header(read_utf_packet(input_file.stream));
+    const auto content_offset = header.get(0, "ContentOffset").get<u64>();
+    const auto align = header.get(0, "Align").get<u16>();
     Toc toc;
 
-    if (header.at("TocOffset"))
+    if (header.get(0, "TocOffset"))
     {
         read_toc(
             input_file.stream,
-            header.at("TocOffset").get<u64>(),
+            header.get(0, "TocOffset").get<u64>(),
             content_offset,
             toc);
     }
 
-    if (header.at("ItocOffset"))
+    if (header.get(0, "ItocOffset"))
     {
         read_itoc(
             input_file.stream,
-            header.at("ItocOffset").get<u64>(),
+            header.get(0, "ItocOffset").get<u64>(),
             content_offset,
             align,
             toc);
     }
 
-    if (header.at("EtocOffset"))
-        read_etoc(input_file.stream, header.at("EtocOffset").get<u64>(), toc);
+    if (header.get(0, "EtocOffset"))
+    {
+        read_etoc(
+            input_file.stream, header.get(0, "EtocOffset").get<u64>(), toc);
+    }
 
     auto meta = std::make_unique<ArchiveMeta>();
     for (const auto &kv : toc)
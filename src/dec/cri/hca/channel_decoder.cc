@@ -473,12 +473,13 @@ void ChannelDecoder::decode1(
             value3[i] = bit_stream.read(6);
     }
 
+    const auto &ath = ath_table.get();
     for (const auto i : algo::range(count))
     {
         v = value[i];
         if (v)
         {
-            v = ath_table.get()[i] + ((b + i) >> 8) - ((v * 5) >> 1) + 1;
+            v = ath[i] + ((b + i) >> 8) - ((v * 5) >> 1) + 1;
             if (v < 0)
                 v = 15;
             else if (v >= 0x39)
@@ -106,6 +106,7 @@ static std::array<u8, 0x100> create_v56_table(u32 key1, u32 key2)
 struct Permutator::Priv final
 {
     std::array<u8, 256> table;
+    bool identity;
 };
 
 Permutator::Permutator(u16 type, const u32 key1, const u32 key2) : p(new Priv)
@@ -124,12 +125,27 @@ Permutator::Permutator(u16 type, const u32 key1, const u32 key2) : p(new Priv)
         p->table = create_v56_table(key1, key2);
     else
         throw err::NotSupportedError("Unknown cipher type");
+
+    p->identity = true;
+    for (const auto i : algo::range(0x100))
+    {
+        if (p->table[i] != i)
+        {
+            p->identity = false;
+            break;
+        }
+    }
 }
 
 Permutator::~Permutator()
 {
 }
 
+bool Permutator::is_identity() const
+{
+    return p->identity;
+}
+
 bstr Permutator::permute(const bstr &input)
 {
     bstr output(input.size());
@@ -33,6 +33,10 @@ namespace hca {
         ~Permutator();
         bstr permute(const bstr &data);
 
+        // true when the table maps every byte to itself, so callers can
+        // skip the per-block copy altogether
+        bool is_identity() const;
+
     private:
         struct Priv;
         std::unique_ptr<Priv> p;
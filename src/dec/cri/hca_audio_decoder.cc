@@ -194,7 +194,7 @@ static void decode_block(
 
 bool HcaAudioDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 res::Audio HcaAudioDecoder::decode_impl(
@@ -247,24 +247,28 @@ res::Audio HcaAudioDecoder::decode_impl(
         channel_decoders.push_back(channel_decoder);
     }
 
+    std::vector<const ChannelDecoder*> raw_decoders;
+    for (const auto &channel_decoder : channel_decoders)
+        raw_decoders.push_back(channel_decoder.get());
+
     input_file.stream.seek(meta.hca->data_offset);
-    std::vector<s16> samples;
-    samples.reserve(128 * 8 * channel_count * block_count);
+    std::vector<s16> samples(128 * 8 * channel_count * block_count);
+    auto *samples_ptr = samples.data();
     for (const auto b : algo::range(block_count))
     {
-        decode_block(
-            meta,
-            ath_table,
-            channel_decoders,
-            params,
-            permutator.permute(input_file.stream.read(block_size)));
+        // the only supported cipher is the identity permutation, which
+        // would copy every block for nothing
+        auto block_data = input_file.stream.read(block_size);
+        if (!permutator.is_identity())
+            block_data = permutator.permute(block_data);
+        decode_block(meta, ath_table, channel_decoders, params, block_data);
 
         for (const auto i : algo::range(8))
         for (const auto j : algo::range(128))
         for (const auto k : algo::range(channel_count))
         {
-            const auto value = clamp(channel_decoders[k]->wave[i][j]);
-            samples.push_back(static_cast<s16>(value * 0x7FFF));
+            const auto value = clamp(raw_decoders[k]->wave[i][j]);
+            *samples_ptr++ = static_cast<s16>(value * 0x7FFF);
         }
     }
 
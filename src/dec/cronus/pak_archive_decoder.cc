@@ -89,7 +89,7 @@ bool PakArchiveDecoder::is_recognized_impl(io::File &input_file) const
     if (input_file.stream.read(magic2.size()) == magic2)
         return true;
     input_file.stream.seek(0);
-    return input_file.stream.read(magic3.size()) == magic3;
+    return input_file.stream.matches(magic3);
 }
 
 std::unique_ptr<dec::ArchiveMeta> PakArchiveDecoder::read_meta_impl(
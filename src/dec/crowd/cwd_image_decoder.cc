@@ -25,7 +25,7 @@ static const auto magic = "cwd format  - version 1.00 -"_b;
 
 bool CwdImageDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.seek(0).read(magic.size()) == magic;
+    return input_file.stream.seek(0).matches(magic);
 }
 
 res::Image CwdImageDecoder::decode_impl(
@@ -26,7 +26,7 @@ static const auto magic = "CWDP"_b;
 
 bool CwpImageDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.seek(0).read(magic.size()) == magic;
+    return input_file.stream.seek(0).matches(magic);
 }
 
 res::Image CwpImageDecoder::decode_impl(
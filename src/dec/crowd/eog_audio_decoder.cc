@@ -26,7 +26,7 @@ static const bstr magic = "CRM\x00"_b;
 
 bool EogAudioDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 std::unique_ptr<io::File> EogAudioDecoder::decode_impl(
@@ -44,7 +44,7 @@ namespace
 
 bool PkwvAudioArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> PkwvAudioArchiveDecoder::read_meta_impl(
@@ -16,6 +16,7 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "dec/cyberworks/dat_archive_decoder.h"
+#include <mutex>
 #include "algo/pack/lzss.h"
 #include "dec/cyberworks/common/algo.h"
 #include "dec/cyberworks/common/plugins.h"
@@ -27,9 +28,28 @@ using namespace au::dec::cyberworks;
 
 namespace
 {
+    // Large sets split their content across 20+ numbered data files; they
+    // are resolved on first use, so filtered runs touch only the parts
+    // that actually hold the requested entries.
     struct CustomArchiveMeta final : dec::ArchiveMeta
     {
-        std::vector<std::unique_ptr<io::File>> data_files;
+        io::File &get_data_file(const size_t data_file_id) const
+        {
+            std::unique_lock<std::mutex> lock(data_files_mutex);
+            auto &data_file = data_files.at(data_file_id);
+            if (!data_file)
+            {
+                data_file = VirtualFileSystem::get_by_name(
+                    data_file_names.at(data_file_id));
+                if (!data_file)
+                    throw err::CorruptDataError("Data file not found.");
+            }
+            return *data_file;
+        }
+
+        std::vector<std::string> data_file_names;
+        mutable std::vector<std::unique_ptr<io::File>> data_files;
+        mutable std::mutex data_files_mutex;
         DatPlugin plugin;
     };
 
@@ -80,10 +100,8 @@ std::unique_ptr<dec::ArchiveMeta> DatArchiveDecoder::read_meta_impl(
 
     auto meta = std::make_unique<CustomArchiveMeta>();
     meta->plugin = plugin_manager.get();
-    const auto data_file_names = get_data_file_names(input_file, meta->plugin);
-    for (const auto &data_file_name : data_file_names)
-        meta->data_files.push_back(
-            VirtualFileSystem::get_by_name(data_file_name));
+    meta->data_file_names = get_data_file_names(input_file, meta->plugin);
+    meta->data_files.resize(meta->data_file_names.size());
 
     while (table_stream.left())
     {
@@ -98,11 +116,8 @@ std::unique_ptr<dec::ArchiveMeta> DatArchiveDecoder::read_meta_impl(
         entry->type = table_stream.read(2);
         const auto unk = table_stream.read_le<u32>(); // FFFFFFFF?
         entry->data_file_id = table_stream.read<u8>();
-        if (entry->data_file_id >= meta->data_files.size()
-                || !meta->data_files[entry->data_file_id])
-        {
+        if (entry->data_file_id >= meta->data_file_names.size())
             throw err::CorruptDataError("Data file not found.");
-        }
         meta->entries.push_back(std::move(entry));
     }
     return std::move(meta);
@@ -116,7 +131,8 @@ std::unique_ptr<io::File> DatArchiveDecoder::read_file_impl(
 {
     const auto meta = static_cast<const CustomArchiveMeta*>(&m);
     const auto entry = static_cast<const CustomArchiveEntry*>(&e);
-    auto data_stream = meta->data_files.at(entry->data_file_id)->stream.clone();
+    auto data_stream
+        = meta->get_data_file(entry->data_file_id).stream.clone();
     auto data = data_stream->seek(entry->offset).read(entry->size_comp);
     if (entry->size_orig != entry->size_comp)
         data = algo::pack::lzss_decompress(data, entry->size_orig);
@@ -64,7 +64,7 @@ static const bstr get_key(const bstr &password)
 
 bool AFileDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.seek(0).read(magic.size()) == magic;
+    return input_file.stream.seek(0).matches(magic);
 }
 
 std::unique_ptr<io::File> AFileDecoder::decode_impl(
@@ -16,6 +16,7 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "dec/eagls/gr_image_decoder.h"
+#include <vector>
 #include "algo/crypt/lcg.h"
 #include "algo/pack/lzss.h"
 #include "algo/range.h"
@@ -56,8 +57,14 @@ res::Image GrImageDecoder::decode_impl(
     const auto seed = input_file.stream.read<u8>() ^ xor_value;
 
     algo::crypt::Lcg lcg(algo::crypt::LcgKind::ParkMillerRevised, seed);
-    for (const auto i : algo::range(0, std::min<size_t>(0x174B, data.size())))
-        data[i] ^= key[lcg.next() % key.size()];
+    const auto crypt_size = std::min<size_t>(0x174B, data.size());
+    std::vector<u32> keystream(crypt_size);
+    lcg.next(keystream.data(), keystream.size());
+    const auto key_ptr = key.get<const u8>();
+    const auto key_size = key.size();
+    auto data_ptr = data.get<u8>();
+    for (const auto i : algo::range(crypt_size))
+        data_ptr[i] ^= key_ptr[keystream[i] % key_size];
 
     const auto output_size = guess_output_size(data);
     data = algo::pack::lzss_decompress(data, output_size);
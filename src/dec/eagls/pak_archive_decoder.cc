@@ -16,6 +16,7 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "dec/eagls/pak_archive_decoder.h"
+#include <vector>
 #include "algo/crypt/lcg.h"
 #include "algo/locale.h"
 #include "algo/range.h"
@@ -50,8 +51,13 @@ std::unique_ptr<dec::ArchiveMeta> PakArchiveDecoder::read_meta_impl(
     auto data = index_stream.read(index_stream.size() - 4);
     const auto seed = index_stream.read_le<u32>();
     algo::crypt::Lcg lcg(algo::crypt::LcgKind::MicrosoftVisualC, seed);
+    std::vector<u32> keystream(data.size());
+    lcg.next(keystream.data(), keystream.size());
+    const auto key_ptr = key.get<const u8>();
+    const auto key_size = key.size();
+    auto data_ptr = data.get<u8>();
     for (const auto i : algo::range(data.size()))
-        data[i] ^= key[lcg.next() % key.size()];
+        data_ptr[i] ^= key_ptr[keystream[i] % key_size];
 
     io::MemoryByteStream data_stream(data);
     uoff_t min_offset = std::numeric_limits<uoff_t>::max();
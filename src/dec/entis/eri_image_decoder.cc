@@ -109,13 +109,15 @@ static bstr decode_pixel_data(
     if (!decoder)
     {
         throw err::NotSupportedError(algo::format(
-            "Architecture type %d not supported", header.architecture));
+            "Architecture type %d not supported",
+            static_cast<int>(header.architecture)));
     }
 
     if (header.transformation != common::Transformation::Lossless)
     {
         throw err::NotSupportedError(algo::format(
-            "Transformation type %d not supported", header.transformation));
+            "Transformation type %d not supported",
+            static_cast<int>(header.transformation)));
     }
 
     decoder->set_input(encoded_pixel_data);
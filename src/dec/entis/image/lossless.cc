@@ -16,7 +16,7 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "dec/entis/image/lossless.h"
-#include <functional>
+#include <cstring>
 #include "algo/range.h"
 #include "dec/entis/common/erisa_decoder.h"
 #include "dec/entis/common/gamma_decoder.h"
@@ -47,8 +47,6 @@ namespace
     };
 
     using Permutation = std::vector<int>;
-
-    using ColorTransformer = std::function<void(u8 *, const DecodeContext &)>;
 }
 
 static Permutation init_permutation(const DecodeContext &ctx)
@@ -171,7 +169,7 @@ static void color_op_1111(u8 *decode_buf, const DecodeContext &context)
     }
 }
 
-static std::vector<ColorTransformer> color_ops
+static void (*color_ops[16])(u8 *, const DecodeContext &) =
 {
     color_op_0000, color_op_0000, color_op_0000, color_op_0000,
     color_op_0000, color_op_0101, color_op_0110, color_op_0111,
@@ -192,10 +190,21 @@ static void transform(
     const auto perm_offset = (transformer_code & 0b00'11'0000) >> 4;
     const auto color_op    = (transformer_code & 0b00'00'1111);
 
-    for (const auto i : algo::range(ctx.block_samples))
+    // permutation 0 stores the samples in their natural order
+    if (perm_offset == 0)
     {
-        block_out[permutation[perm_offset * ctx.block_samples + i]]
-            = arrange_buf[i];
+        std::memcpy(
+            block_out.get<u8>(),
+            arrange_buf.get<const u8>(),
+            ctx.block_samples);
+    }
+    else
+    {
+        for (const auto i : algo::range(ctx.block_samples))
+        {
+            block_out[permutation[perm_offset * ctx.block_samples + i]]
+                = arrange_buf[i];
+        }
     }
     if (!transformer_code)
         return;
@@ -345,20 +354,27 @@ static void validate_ctx(const DecodeContext &ctx, const EriHeader &header)
         throw err::CorruptDataError("Blocking degree not set");
 }
 
-static bstr crop(
+// The blocks are copied out into separate channel planes, so this pass
+// both drops the block padding and interleaves the channels. Each plane
+// is read contiguously and written at a constant small stride, which the
+// compiler can widen.
+static bstr crop_and_interleave(
     const bstr &input,
     const DecodeContext &ctx,
     const EriHeader &header)
 {
+    const auto padded_width = ctx.width_blocks * ctx.block_size;
+    const auto plane_area = padded_width * ctx.height_blocks * ctx.block_size;
     bstr output(header.width * header.height * ctx.channel_count);
     for (const auto y : algo::range(header.height))
+    for (const auto c : algo::range(ctx.channel_count))
     {
-        auto *output_ptr = output.get<u8>();
-        const auto *input_ptr = input.get<u8>();
-        output_ptr += y * header.width * ctx.channel_count;
-        input_ptr += y * ctx.width_blocks * ctx.block_stride;
-        for (const auto x : algo::range(header.width * ctx.channel_count))
-            *output_ptr++ = *input_ptr++;
+        const auto *input_ptr = input.get<const u8>()
+            + c * plane_area + y * padded_width;
+        auto *output_ptr = output.get<u8>()
+            + y * header.width * ctx.channel_count + c;
+        for (const auto x : algo::range(header.width))
+            output_ptr[x * ctx.channel_count] = input_ptr[x];
     }
     return output;
 }
@@ -405,7 +421,9 @@ bstr image::decode_lossless_pixel_data(
     else
         throw err::NotSupportedError("Architecture not supported");
 
-    bstr output(ctx.width_blocks * ctx.height_blocks * ctx.block_samples);
+    const auto padded_width = ctx.width_blocks * ctx.block_size;
+    const auto plane_area = padded_width * ctx.height_blocks * ctx.block_size;
+    bstr output(plane_area * ctx.channel_count);
     bstr arrange_buf(ctx.block_samples);
     bstr block_out(ctx.block_samples);
     bstr prev_col(ctx.height_blocks * ctx.block_stride);
@@ -434,17 +452,23 @@ bstr image::decode_lossless_pixel_data(
             prev_col.get<u8>() + y * ctx.block_stride,
             block_out);
 
-        auto *block_out_ptr = block_out.get<u8>();
+        // the block layout is already plane-major, so every block row is
+        // one contiguous copy into its channel plane
+        const auto *block_out_ptr = block_out.get<const u8>();
         for (const auto c : algo::range(ctx.channel_count))
-        for (const auto yy : algo::range(ctx.block_size))
-        for (const auto xx : algo::range(ctx.block_size))
         {
-            const auto sum_y = y * ctx.block_size + yy;
-            const auto sum_x = x * ctx.block_size + xx;
-            const auto pos = sum_y * ctx.width_blocks * ctx.block_size + sum_x;
-            output[pos * ctx.channel_count + c] = *block_out_ptr++;
+            auto *plane_ptr = output.get<u8>()
+                + c * plane_area
+                + y * ctx.block_size * padded_width
+                + x * ctx.block_size;
+            for (const auto yy : algo::range(ctx.block_size))
+            {
+                std::memcpy(plane_ptr, block_out_ptr, ctx.block_size);
+                plane_ptr += padded_width;
+                block_out_ptr += ctx.block_size;
+            }
         }
     }
 
-    return crop(output, ctx, header);
+    return crop_and_interleave(output, ctx, header);
 }
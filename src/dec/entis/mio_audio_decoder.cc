@@ -16,7 +16,11 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "dec/entis/mio_audio_decoder.h"
+#include <atomic>
+#include <cstring>
+#include <thread>
 #include "algo/format.h"
+#include "algo/range.h"
 #include "dec/entis/audio/lossless.h"
 #include "dec/entis/audio/lossy.h"
 #include "dec/entis/common/enums.h"
@@ -77,6 +81,21 @@ static std::vector<audio::MioChunk> read_chunks(
     return chunks;
 }
 
+static std::unique_ptr<audio::BaseAudioDecoder> make_decoder_impl(
+    const audio::MioHeader &header)
+{
+    if (header.transformation == common::Transformation::Lossless)
+        return std::make_unique<audio::LosslessAudioDecoder>(header);
+    if (header.transformation == common::Transformation::Lot
+        || header.transformation == common::Transformation::LotMss)
+    {
+        return std::make_unique<audio::LossyAudioDecoder>(header);
+    }
+    throw err::NotSupportedError(algo::format(
+        "Transformation type %d not supported",
+        static_cast<int>(header.transformation)));
+}
+
 bool MioAudioDecoder::is_recognized_impl(io::File &input_file) const
 {
     return input_file.stream.read(magic1.size()) == magic1
@@ -93,23 +112,89 @@ res::Audio MioAudioDecoder::decode_impl(
     const auto header = read_header(input_file.stream, section_reader);
     const auto chunks = read_chunks(input_file.stream, section_reader);
 
-    std::unique_ptr<audio::BaseAudioDecoder> impl;
-    if (header.transformation == common::Transformation::Lossless)
-        impl = std::make_unique<audio::LosslessAudioDecoder>(header);
-    else if (header.transformation == common::Transformation::Lot)
-        impl = std::make_unique<audio::LossyAudioDecoder>(header);
-    else if (header.transformation == common::Transformation::LotMss)
-        impl = std::make_unique<audio::LossyAudioDecoder>(header);
+    // this validates the transformation type before any decoding starts
+    const auto impl = make_decoder_impl(header);
+
+    // the entropy decoder model carries over between chunks and resets at
+    // chunks flagged as initial, so those are the points where the stream
+    // splits into independently decodable segments
+    std::vector<size_t> segment_starts;
+    for (const auto i : algo::range(chunks.size()))
+    {
+        if (i == 0 || chunks[i].initial)
+            segment_starts.push_back(i);
+    }
+
+    std::vector<bstr> chunk_samples(chunks.size());
+    const auto process_segment = [&](const size_t segment_index)
+    {
+        const auto local_impl
+            = segment_index ? make_decoder_impl(header) : nullptr;
+        auto &segment_impl = local_impl ? *local_impl : *impl;
+        const auto start = segment_starts[segment_index];
+        const auto end = segment_index + 1 < segment_starts.size()
+            ? segment_starts[segment_index + 1]
+            : chunks.size();
+        for (const auto i : algo::range(start, end))
+            chunk_samples[i] = segment_impl.process_chunk(chunks[i]);
+    };
 
-    if (!impl)
+    if (segment_starts.size() > 1)
     {
-        throw err::NotSupportedError(algo::format(
-            "Transformation type %d not supported", header.transformation));
+        const auto thread_count = std::min<size_t>(
+            segment_starts.size(),
+            std::max<size_t>(std::thread::hardware_concurrency(), 2));
+        std::atomic<size_t> next_segment(0);
+        std::vector<std::thread> threads;
+        std::vector<std::exception_ptr> errors(thread_count);
+        for (const auto i : algo::range(thread_count))
+        {
+            threads.emplace_back([&, i]()
+            {
+                try
+                {
+                    while (true)
+                    {
+                        const auto segment_index = next_segment++;
+                        if (segment_index >= segment_starts.size())
+                            break;
+                        process_segment(segment_index);
+                    }
+                }
+                catch (...)
+                {
+                    errors[i] = std::current_exception();
+                }
+            });
+        }
+        for (auto &thread : threads)
+            thread.join();
+        for (const auto &error : errors)
+        {
+            if (error)
+                std::rethrow_exception(error);
+        }
+    }
+    else if (!chunks.empty())
+    {
+        process_segment(0);
     }
 
-    bstr samples;
-    for (const auto chunk : chunks)
-        samples += impl->process_chunk(chunk);
+    // the PCM lands in one preallocated buffer rather than being
+    // reallocated for every appended chunk
+    size_t total_size = 0;
+    for (const auto &chunk_sample : chunk_samples)
+        total_size += chunk_sample.size();
+    bstr samples(total_size);
+    size_t offset = 0;
+    for (const auto &chunk_sample : chunk_samples)
+    {
+        std::memcpy(
+            samples.get<u8>() + offset,
+            chunk_sample.get<const u8>(),
+            chunk_sample.size());
+        offset += chunk_sample.size();
+    }
 
     res::Audio audio;
     audio.channel_count = header.channel_count;
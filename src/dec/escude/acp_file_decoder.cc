@@ -36,7 +36,7 @@ namespace
 
 bool AcpFileDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 std::unique_ptr<io::File> AcpFileDecoder::decode_impl(
@@ -66,7 +66,7 @@ static bstr do_decode(const bstr &input, size_t canvas_size)
 
 bool AcdImageDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 res::Image AcdImageDecoder::decode_impl(
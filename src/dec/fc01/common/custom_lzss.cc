@@ -16,52 +16,30 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "dec/fc01/common/custom_lzss.h"
-#include "algo/range.h"
-#include "err.h"
-#include "io/memory_byte_stream.h"
-
-// Modified LZSS routine
-// - repetition count and look behind pos differs
-// - EOF is okay
+#include "algo/pack/lzss_engine.h"
 
 using namespace au;
 using namespace au::dec::fc01;
 
-bstr common::custom_lzss_decompress(const bstr &input, size_t output_size)
+namespace
 {
-    io::MemoryByteStream input_stream(input);
-    const size_t dict_size = 0x1000;
-    size_t dict_pos = 0xFEE;
-    u8 dict[dict_size] {};
-
-    bstr output(output_size);
-    auto output_ptr = output.get<u8>();
-    auto output_end = output.end<const u8>();
-
-    u16 control = 0;
-    while (output_ptr < output_end && input_stream.left())
+    // 12-bit dictionary index in the low bits of a little-endian word,
+    // count in the top nibble
+    struct Fc01LzssSpec final
     {
-        control >>= 1;
-        if (!(control & 0x100))
-            control = input_stream.read<u8>() | 0xFF00;
+        static constexpr size_t dict_size = 0x1000;
 
-        if (control & 1)
+        static void decode_reference(
+            const u8 lo, const u8 hi,
+            size_t &look_behind_pos, size_t &repetitions)
         {
-            const auto byte = input_stream.read<u8>();
-            dict[dict_pos++] = *output_ptr++ = byte;
-            dict_pos %= dict_size;
-            continue;
+            look_behind_pos = lo | ((hi & 0xF) << 8);
+            repetitions = (hi >> 4) + 3;
         }
+    };
+}
 
-        const u16 tmp = input_stream.read_le<u16>();
-        u32 look_behind_pos = tmp % dict_size;
-        u16 repetitions = (tmp >> 12) + 3;
-        while (repetitions-- && output_ptr < output_end)
-        {
-            dict[dict_pos++] = *output_ptr++ = dict[look_behind_pos++];
-            look_behind_pos %= dict_size;
-            dict_pos %= dict_size;
-        }
-    }
-    return output;
+bstr common::custom_lzss_decompress(const bstr &input, size_t output_size)
+{
+    return algo::pack::lzss_decompress<Fc01LzssSpec>(input, output_size, 0xFEE);
 }
@@ -21,12 +21,6 @@
 using namespace au;
 using namespace au::dec::fc01;
 
-u8 common::rol8(const u8 x, size_t n)
-{
-    n &= 7;
-    return (x << n) | (x >> (8 - n));
-}
-
 bstr common::fix_stride(
     const bstr &input,
     const size_t width,
@@ -24,7 +24,13 @@ namespace dec {
 namespace fc01 {
 namespace common {
 
-    u8 rol8(const u8 x, const size_t n);
+    // inline so that bulk decryption loops compile down to plain
+    // rotate-and-XOR the optimizer can widen
+    inline u8 rol8(const u8 x, const size_t n)
+    {
+        const auto k = n & 7;
+        return (x << k) | (x >> (8 - k));
+    }
 
     bstr fix_stride(
         const bstr &input,
@@ -68,7 +68,7 @@ McaArchiveDecoder::McaArchiveDecoder()
 
 bool McaArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> McaArchiveDecoder::read_meta_impl(
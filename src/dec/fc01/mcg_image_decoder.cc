@@ -33,48 +33,67 @@ static const bstr magic = "MCG "_b;
 static bstr decrypt_v101(const bstr &input, size_t output_size, u8 initial_key)
 {
     auto data = input;
+
+    // the key stream does not depend on the data, so generating it up
+    // front leaves the decryption itself a flat rotate-and-XOR pass
+    bstr key_stream(data.size());
     auto key = initial_key;
     for (const auto i : algo::range(data.size()))
     {
-        data[i] = common::rol8(data[i], 1) ^ key;
+        key_stream[i] = key;
         key += data.size() - 1 - i;
     }
+
+    auto data_ptr = data.get<u8>();
+    const auto key_ptr = key_stream.get<const u8>();
+    for (const auto i : algo::range(data.size()))
+        data_ptr[i] = common::rol8(data_ptr[i], 1) ^ key_ptr[i];
+
     return common::custom_lzss_decompress(data, output_size);
 }
 
 static bstr transform_v200(
     bstr planes[3], const size_t width, const size_t height)
 {
-    for (const auto y : algo::range(height - 1))
-    for (const auto x : algo::range(width - 1))
+    // the planes predict independently, so running the filter one plane
+    // at a time keeps a single plane's rows hot in cache
     for (const auto i : algo::range(3))
     {
-        const auto pos = y * width + x;
-        int p00 = planes[i][pos];
-        int p10 = planes[i][pos + width] - p00;
-        int p01 = planes[i][pos + 1] - p00;
-        p00 = std::abs(p01 + p10);
-        p01 = std::abs(p01);
-        p10 = std::abs(p10);
-        s8 p11a;
-        if (p00 >= p01 && p10 >= p01)
-            p11a = planes[i][pos + width];
-        else if (p00 < p10)
-            p11a = planes[i][pos];
-        else
-            p11a = planes[i][pos + 1];
-        planes[i][pos + width + 1] += p11a + 0x80;
+        auto plane = planes[i].get<u8>();
+        for (const auto y : algo::range(height - 1))
+        {
+            const auto row = plane + y * width;
+            const auto next_row = row + width;
+            for (const auto x : algo::range(width - 1))
+            {
+                int p00 = row[x];
+                int p10 = next_row[x] - p00;
+                int p01 = row[x + 1] - p00;
+                p00 = std::abs(p01 + p10);
+                p01 = std::abs(p01);
+                p10 = std::abs(p10);
+                s8 p11a;
+                if (p00 >= p01 && p10 >= p01)
+                    p11a = next_row[x];
+                else if (p00 < p10)
+                    p11a = row[x];
+                else
+                    p11a = row[x + 1];
+                next_row[x + 1] += p11a + 0x80;
+            }
+        }
     }
 
     bstr output(width * height * 3);
     auto output_ptr = output.get<u8>();
-    for (const auto y : algo::range(height))
-    for (const auto x : algo::range(width))
+    const auto plane0 = planes[0].get<const u8>();
+    const auto plane1 = planes[1].get<const u8>();
+    const auto plane2 = planes[2].get<const u8>();
+    for (const auto pos : algo::range(width * height))
     {
-        const auto pos = y * width + x;
-        s8 b = -128 + static_cast<s8>(planes[2][pos]);
-        s8 r = -128 + static_cast<s8>(planes[1][pos]);
-        s8 g = planes[0][pos] - ((b + r) >> 2);
+        s8 b = -128 + static_cast<s8>(plane2[pos]);
+        s8 r = -128 + static_cast<s8>(plane1[pos]);
+        s8 g = plane0[pos] - ((b + r) >> 2);
         *output_ptr++ = r + g;
         *output_ptr++ = g;
         *output_ptr++ = b + g;
@@ -101,7 +120,7 @@ McgImageDecoder::McgImageDecoder()
 
 bool McgImageDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 res::Image McgImageDecoder::decode_impl(
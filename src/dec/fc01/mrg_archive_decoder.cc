@@ -57,7 +57,7 @@ static u8 guess_key(const bstr &table_data, size_t file_size)
 
 bool MrgArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> MrgArchiveDecoder::read_meta_impl(
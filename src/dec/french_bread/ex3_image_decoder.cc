@@ -27,7 +27,7 @@ static const bstr magic = "LLIF"_b;
 
 bool Ex3ImageDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 res::Image Ex3ImageDecoder::decode_impl(
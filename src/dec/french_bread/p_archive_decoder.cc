@@ -18,6 +18,7 @@
 #include "dec/french_bread/p_archive_decoder.h"
 #include "algo/range.h"
 #include "err.h"
+#include "io/memory_byte_stream.h"
 
 using namespace au;
 using namespace au::dec::french_bread;
@@ -79,3 +80,20 @@ std::vector<std::string> PArchiveDecoder::get_linked_formats() const
 }
 
 static auto _ = dec::register_decoder<PArchiveDecoder>("french-bread/p");
+
+// No magic beyond a 0/1 version word; full recognition decrypts every
+// table entry. The decrypted entry count has to fit 68-byte records in
+// the file before that work starts.
+static auto _2 = dec::register_gate(
+    "french-bread/p",
+    8,
+    [](const bstr &prefix, const uoff_t file_size)
+    {
+        if (prefix.size() < 8)
+            return false;
+        io::MemoryByteStream header(prefix);
+        const auto magic = header.read_le<u32>();
+        const auto file_count = header.read_le<u32>() ^ 0xE3DF59AC;
+        return magic <= 1
+            && 8 + file_count * (60 + 4 + 4ull) <= file_size;
+    });
@@ -31,7 +31,7 @@ bool NvsgImageDecoder::is_recognized_impl(io::File &input_file) const
     if (input_file.stream.read(hzc1_magic.size()) != hzc1_magic)
         return false;
     input_file.stream.skip(8);
-    return input_file.stream.read(nvsg_magic.size()) == nvsg_magic;
+    return input_file.stream.matches(nvsg_magic);
 }
 
 res::Image NvsgImageDecoder::decode_impl(
@@ -72,11 +72,14 @@ res::Image NvsgImageDecoder::decode_impl(
             break;
 
         case 4:
+        {
+            auto data_ptr = data.get<u8>();
             for (const auto i : algo::range(data.size()))
-                if (data.get<u8>()[i])
-                    data.get<u8>()[i] = 255;
+                if (data_ptr[i])
+                    data_ptr[i] = 255;
             pixel_format = res::PixelFormat::Gray8;
             break;
+        }
 
         default:
             throw err::NotSupportedError("Unexpected pixel format");
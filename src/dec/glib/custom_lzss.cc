@@ -16,57 +16,47 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "dec/glib/custom_lzss.h"
-#include "algo/range.h"
-#include "io/memory_byte_stream.h"
+#include "algo/pack/lzss_engine.h"
 
 // Modified LZSS routines (repetition count is negated)
 
 using namespace au;
 using namespace au::dec;
 
-bstr glib::custom_lzss_decompress(const bstr &input, const size_t output_size)
+namespace
 {
-    io::MemoryByteStream output_stream(input);
-    return glib::custom_lzss_decompress(output_stream, output_size);
-}
-
-bstr glib::custom_lzss_decompress(
-    io::BaseByteStream &input_stream, const size_t output_size)
-{
-    const size_t dict_size = 0x1000;
-    size_t dict_pos = 0xFEE;
-    u8 dict[dict_size] {};
-
-    bstr output(output_size);
-    auto output_ptr = output.get<u8>();
-    auto output_end = output.end<const u8>();
-
-    u16 control = 0;
-    while (output_ptr < output_end)
+    struct GlibLzssSpec final
     {
-        control >>= 1;
-        if (!(control & 0x100))
-            control = input_stream.read<u8>() | 0xFF00;
+        static constexpr size_t dict_size = 0x1000;
 
-        if (control & 1)
+        static void decode_reference(
+            const u8 lo, const u8 hi,
+            size_t &look_behind_pos, size_t &repetitions)
         {
-            auto byte = input_stream.read<u8>();
-            dict[dict_pos++] = *output_ptr++ = byte;
-            dict_pos %= dict_size;
-            continue;
+            look_behind_pos = ((hi & 0xF0) << 4) | lo;
+            repetitions = (~hi & 0xF) + 3;
         }
+    };
+}
 
-        u32 tmp1 = input_stream.read<u8>();
-        u32 tmp2 = input_stream.read<u8>();
+static const size_t dict_start = 0xFEE;
 
-        u32 look_behind_pos = (((tmp2 & 0xF0) << 4) | tmp1) % dict_size;
-        u16 repetitions = (~tmp2 & 0xF) + 3;
-        while (repetitions-- && output_ptr < output_end)
-        {
-            dict[dict_pos++] = *output_ptr++ = dict[look_behind_pos++];
-            look_behind_pos %= dict_size;
-            dict_pos %= dict_size;
-        }
-    }
+bstr glib::custom_lzss_decompress(const bstr &input, const size_t output_size)
+{
+    return algo::pack::lzss_decompress<GlibLzssSpec>(
+        input, output_size, dict_start);
+}
+
+bstr glib::custom_lzss_decompress(
+    io::BaseByteStream &input_stream, const size_t output_size)
+{
+    // the stream position must land exactly past the consumed input, so
+    // decode from the remaining bytes and seek by what the engine ate
+    const auto start = input_stream.pos();
+    const auto input = input_stream.read_to_eof();
+    const u8 *input_ptr = input.get<const u8>();
+    auto output = algo::pack::lzss_decompress<GlibLzssSpec>(
+        input_ptr, input_ptr + input.size(), output_size, dict_start);
+    input_stream.seek(start + (input_ptr - input.get<const u8>()));
     return output;
 }
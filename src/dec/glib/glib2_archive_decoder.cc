@@ -45,6 +45,23 @@ namespace
         std::array<u32, 4> content_keys[4];
         bool is_file;
     };
+
+    // Both plugins' func1/func2 depend on the position only through its
+    // low byte, so a decoder's whole byte transform collapses into a
+    // 256x256 table indexed by (position & 0xFF, byte). Building it once
+    // per content key removes two std::function calls per byte.
+    struct DecoderTable final
+    {
+        DecoderTable(const glib2::Decoder &decoder)
+        {
+            for (const auto phase : algo::range(0x100))
+            for (const auto byte : algo::range(0x100))
+                table[phase][byte] = decoder.func2(
+                    decoder.func1(byte, phase), phase);
+        }
+
+        u8 table[0x100][0x100];
+    };
 }
 
 static const bstr table_magic = "CDBD"_b;
@@ -73,6 +90,33 @@ static bstr decode(const bstr &input, const glib2::Decoder &decoder)
     return output;
 }
 
+static bstr decode_chunk(
+    const bstr &input,
+    const glib2::Decoder &decoder,
+    const DecoderTable &decoder_table)
+{
+    bstr output(input.size());
+    const auto input_ptr = input.get<const u8>();
+    const auto output_ptr = output.get<u8>();
+    u32 acc = 0;
+    while (acc < (input.size() & (~3)))
+    {
+        const auto src_index
+            = (acc & (~3)) + decoder.src_permutation[acc & 3];
+        const auto dst_index
+            = (acc & (~3)) + decoder.dst_permutation[acc & 3];
+        output_ptr[dst_index]
+            = decoder_table.table[acc & 0xFF][input_ptr[src_index]];
+        acc++;
+    }
+    while (acc < input.size())
+    {
+        output_ptr[acc] = decoder_table.table[acc & 0xFF][input_ptr[acc]];
+        acc++;
+    }
+    return output;
+}
+
 static Header read_header(
     io::BaseByteStream &input_stream, const glib2::IPlugin &plugin)
 {
@@ -236,6 +280,11 @@ std::unique_ptr<io::File> Glib2ArchiveDecoder::read_file_impl(
         }
     }
 
+    std::vector<std::unique_ptr<DecoderTable>> decoder_tables(4);
+    for (const auto i : algo::range(4))
+        if (decoders[i])
+            decoder_tables[i] = std::make_unique<DecoderTable>(*decoders[i]);
+
     auto key_id = 0;
     for (const auto written : algo::range(0, entry->size, chunk_size))
     {
@@ -243,7 +292,8 @@ std::unique_ptr<io::File> Glib2ArchiveDecoder::read_file_impl(
             chunk_size, entry->size - written);
         auto buffer = input_file.stream.read(current_chunk_size);
         if (decoders[key_id])
-            buffer = decode(buffer, *decoders[key_id]);
+            buffer = decode_chunk(
+                buffer, *decoders[key_id], *decoder_tables[key_id]);
         output_file->stream.write(buffer);
         key_id++;
         key_id %= 4;
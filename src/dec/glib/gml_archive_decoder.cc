@@ -40,7 +40,7 @@ namespace
 
 bool GmlArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> GmlArchiveDecoder::read_meta_impl(
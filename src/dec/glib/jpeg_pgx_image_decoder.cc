@@ -58,7 +58,7 @@ bool JpegPgxImageDecoder::is_recognized_impl(io::File &input_file) const
         return false;
     if (input_file.stream.read_be<u16>() < magic.size())
         return false;
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 res::Image JpegPgxImageDecoder::decode_impl(
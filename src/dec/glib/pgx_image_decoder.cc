@@ -26,7 +26,7 @@ static const bstr magic = "PGX\x00"_b;
 
 bool PgxImageDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 res::Image PgxImageDecoder::decode_impl(
@@ -63,7 +63,14 @@ namespace
 bool GzipArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
     input_file.stream.seek(0);
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
+}
+
+bool GzipArchiveDecoder::entries_are_independent() const
+{
+    // each member inflates from its own slice of the input; log and
+    // script bundles with hundreds of members then scale with cores
+    return true;
 }
 
 std::unique_ptr<dec::ArchiveMeta> GzipArchiveDecoder::read_meta_impl(
@@ -89,7 +96,7 @@ std::unique_ptr<dec::ArchiveMeta> GzipArchiveDecoder::read_meta_impl(
             input_file.stream.skip(extra_field_size);
         }
 
-        auto entry = std::make_unique<PlainArchiveEntry>();
+        auto entry = std::make_unique<CompressedArchiveEntry>();
         entry->path = "";
 
         if (flags & Flags::FileName)
@@ -101,11 +108,19 @@ std::unique_ptr<dec::ArchiveMeta> GzipArchiveDecoder::read_meta_impl(
         if (flags & Flags::Crc)
             input_file.stream.skip(2);
 
+        // deflate members carry no length field, so locating the next
+        // member still costs one inflate with the output discarded; the
+        // per-member decodes themselves run as independent entry tasks
         entry->offset = input_file.stream.pos();
-        const auto data = algo::pack::zlib_inflate(
-            input_file.stream, algo::pack::ZlibKind::RawDeflate);
-        entry->size = input_file.stream.pos() - entry->offset;
-        input_file.stream.skip(8);
+        algo::pack::zlib_inflate(
+            input_file.stream,
+            [](const bstr &) {},
+            algo::pack::ZlibKind::RawDeflate);
+        entry->size_comp = input_file.stream.pos() - entry->offset;
+        input_file.stream.skip(4);
+        // ISIZE: decompressed size modulo 2^32 - a scheduling and
+        // allocation hint, not a promise
+        entry->size_orig = input_file.stream.read_le<u32>();
 
         meta->entries.push_back(std::move(entry));
     }
@@ -119,12 +134,13 @@ std::unique_ptr<io::File> GzipArchiveDecoder::read_file_impl(
     const dec::ArchiveMeta &m,
     const dec::ArchiveEntry &e) const
 {
-    const auto entry = static_cast<const PlainArchiveEntry*>(&e);
+    const auto entry = static_cast<const CompressedArchiveEntry*>(&e);
     input_file.stream.seek(entry->offset);
     return std::make_unique<io::File>(
         entry->path,
         algo::pack::zlib_inflate(
-            input_file.stream.read(entry->size),
+            input_file.stream.read(entry->size_comp),
+            entry->size_orig,
             algo::pack::ZlibKind::RawDeflate));
 }
 
@@ -25,6 +25,9 @@ namespace gnu {
 
     class GzipArchiveDecoder final : public BaseArchiveDecoder
     {
+    public:
+        bool entries_are_independent() const override;
+
     protected:
         bool is_recognized_impl(io::File &input_file) const override;
 
@@ -44,23 +44,20 @@ res::Image WebpImageDecoder::decode_impl(
         throw err::CorruptDataError("Corrupt WEBP data");
     }
 
-    bstr output_data(width * height * 4);
+    // res::Pixel is laid out as BGRA, so libwebp can decode straight into
+    // the image's pixel storage - no staging buffer, no conversion pass
+    res::Image image(width, height);
+    const auto output_size = width * height * sizeof(res::Pixel);
     if (!WebPDecodeBGRAInto(
             input_data.get<const u8>(),
             input_data.size(),
-            output_data.get<u8>(),
-            output_data.size(),
-            width * 4))
+            reinterpret_cast<u8*>(image.data()),
+            output_size,
+            width * sizeof(res::Pixel)))
     {
         throw err::CorruptDataError("Corrupt WEBP data");
     }
 
-    res::Image image(
-        width,
-        height,
-        output_data,
-        res::PixelFormat::BGRA8888);
-
     return image;
 #else
     throw err::NotSupportedError("webp image decoder is not available.");
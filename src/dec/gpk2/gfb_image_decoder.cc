@@ -27,7 +27,7 @@ static const bstr magic = "GFB\x20"_b;
 
 bool GfbImageDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 res::Image GfbImageDecoder::decode_impl(
@@ -25,7 +25,7 @@ static const bstr magic = "GPK2"_b;
 
 bool Gpk2ArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> Gpk2ArchiveDecoder::read_meta_impl(
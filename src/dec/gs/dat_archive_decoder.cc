@@ -28,7 +28,7 @@ static const bstr magic = "GsSYMBOL5BINDATA"_b;
 
 bool DatArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> DatArchiveDecoder::read_meta_impl(
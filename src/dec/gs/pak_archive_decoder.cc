@@ -27,7 +27,7 @@ static const bstr magic = "DataPack5\x00\x00\x00\x00\x00\x00\x00"_b;
 
 bool PakArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> PakArchiveDecoder::read_meta_impl(
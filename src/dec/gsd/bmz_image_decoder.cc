@@ -26,7 +26,7 @@ static const bstr magic = "ZLC3"_b;
 
 bool BmzImageDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 res::Image BmzImageDecoder::decode_impl(
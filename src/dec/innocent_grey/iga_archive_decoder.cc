@@ -46,7 +46,7 @@ static u32 read_integer(io::BaseByteStream &input_stream)
 
 bool IgaArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> IgaArchiveDecoder::read_meta_impl(
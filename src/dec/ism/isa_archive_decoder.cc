@@ -26,7 +26,7 @@ static const bstr magic = "ISM ARCHIVED"_b;
 
 bool IsaArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> IsaArchiveDecoder::read_meta_impl(
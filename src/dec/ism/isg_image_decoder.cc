@@ -89,7 +89,7 @@ static void unpack_v21(
 
 bool IsgImageDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 res::Image IsgImageDecoder::decode_impl(
@@ -115,7 +115,7 @@ static bstr decode_pixels(const bstr &source, size_t width, size_t height)
 
 bool PrsImageDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 res::Image PrsImageDecoder::decode_impl(
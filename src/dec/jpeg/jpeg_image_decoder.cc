@@ -27,12 +27,21 @@ static const bstr magic = "\xFF\xD8\xFF"_b;
 
 bool JpegImageDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
-res::Image JpegImageDecoder::decode_impl(
-    const Logger &logger, io::File &input_file) const
+static res::Image decode(
+    io::File &input_file, const unsigned int scale_denominator)
 {
+    if (scale_denominator != 1
+        && scale_denominator != 2
+        && scale_denominator != 4
+        && scale_denominator != 8)
+    {
+        throw err::UsageError("Scale denominator must be 1, 2, 4 or 8");
+    }
+
+    input_file.stream.seek(0);
     bstr source = input_file.stream.read_to_eof();
 
     jpeg_decompress_struct info;
@@ -41,6 +50,8 @@ res::Image JpegImageDecoder::decode_impl(
     jpeg_create_decompress(&info);
     jpeg_mem_src(&info, source.get<u8>(), source.size());
     jpeg_read_header(&info, TRUE);
+    info.scale_num = 1;
+    info.scale_denom = scale_denominator;
     jpeg_start_decompress(&info);
 
     const auto width = info.output_width;
@@ -73,4 +84,39 @@ res::Image JpegImageDecoder::decode_impl(
     return res::Image(width, height, raw_data, format);
 }
 
+JpegImageDecoder::Metadata JpegImageDecoder::read_metadata(
+    io::File &input_file) const
+{
+    input_file.stream.seek(0);
+    bstr source = input_file.stream.read_to_eof();
+
+    jpeg_decompress_struct info;
+    jpeg_error_mgr err;
+    info.err = jpeg_std_error(&err);
+    jpeg_create_decompress(&info);
+    jpeg_mem_src(&info, source.get<u8>(), source.size());
+    jpeg_read_header(&info, TRUE);
+
+    Metadata metadata;
+    metadata.width = info.image_width;
+    metadata.height = info.image_height;
+    metadata.channels = info.num_components;
+    jpeg_destroy_decompress(&info);
+    return metadata;
+}
+
+res::Image JpegImageDecoder::decode(
+    const Logger &logger,
+    io::File &input_file,
+    const unsigned int scale_denominator) const
+{
+    return ::decode(input_file, scale_denominator);
+}
+
+res::Image JpegImageDecoder::decode_impl(
+    const Logger &logger, io::File &input_file) const
+{
+    return ::decode(input_file, 1);
+}
+
 static auto _ = dec::register_decoder<JpegImageDecoder>("jpeg/jpeg");
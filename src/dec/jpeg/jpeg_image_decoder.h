@@ -25,6 +25,30 @@ namespace jpeg {
 
     class JpegImageDecoder final : public BaseImageDecoder
     {
+    public:
+        // Answers dimension checks without entropy decoding: only the
+        // headers are parsed, so probing costs microseconds regardless of
+        // image size.
+        struct Metadata final
+        {
+            size_t width;
+            size_t height;
+            size_t channels;
+        };
+
+        Metadata read_metadata(io::File &input_file) const;
+
+        using BaseImageDecoder::decode;
+
+        // Decodes at 1/scale_denominator of the full resolution using
+        // libjpeg's DCT scaling; valid denominators are 1, 2, 4 and 8.
+        // Thumbnailing at 1/8 skips most of the IDCT work, which is far
+        // cheaper than decoding fully and downscaling afterwards.
+        res::Image decode(
+            const Logger &logger,
+            io::File &input_file,
+            const unsigned int scale_denominator) const;
+
     protected:
         bool is_recognized_impl(io::File &input_file) const override;
         res::Image decode_impl(
@@ -42,7 +42,7 @@ algo::NamingStrategy An10ImageArchiveDecoder::naming_strategy() const
 
 bool An10ImageArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.seek(0).read(magic.size()) == magic;
+    return input_file.stream.seek(0).matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> An10ImageArchiveDecoder::read_meta_impl(
@@ -43,7 +43,7 @@ algo::NamingStrategy An20ImageArchiveDecoder::naming_strategy() const
 
 bool An20ImageArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.seek(0).read(magic.size()) == magic;
+    return input_file.stream.seek(0).matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> An20ImageArchiveDecoder::read_meta_impl(
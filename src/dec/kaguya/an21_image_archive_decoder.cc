@@ -16,6 +16,7 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "dec/kaguya/an21_image_archive_decoder.h"
+#include <algorithm>
 #include "algo/range.h"
 #include "dec/kaguya/common/rle.h"
 #include "enc/png/png_image_encoder.h"
@@ -44,7 +45,7 @@ algo::NamingStrategy An21ImageArchiveDecoder::naming_strategy() const
 
 bool An21ImageArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.seek(0).read(magic.size()) == magic;
+    return input_file.stream.seek(0).matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> An21ImageArchiveDecoder::read_meta_impl(
@@ -100,8 +101,13 @@ std::unique_ptr<dec::ArchiveMeta> An21ImageArchiveDecoder::read_meta_impl(
         auto output = common::decompress_rle(
             input_file.stream.read(size_comp), size_orig, bands);
 
-        for (const auto i : algo::range(output.size()))
-            output[i] += last_entry->data[i];
+        // accumulate onto the previous frame through raw pointers; the
+        // checked accessors cost two calls per byte here
+        const auto run = std::min(output.size(), last_entry->data.size());
+        auto output_ptr = output.get<u8>();
+        const auto prev_ptr = last_entry->data.get<const u8>();
+        for (const auto i : algo::range(run))
+            output_ptr[i] += prev_ptr[i];
 
         auto sub_entry = std::make_unique<CustomArchiveEntry>();
         sub_entry->x = last_entry->x;
@@ -109,7 +115,7 @@ std::unique_ptr<dec::ArchiveMeta> An21ImageArchiveDecoder::read_meta_impl(
         sub_entry->width = last_entry->width;
         sub_entry->height = last_entry->height;
         sub_entry->channels = last_entry->channels;
-        sub_entry->data = output;
+        sub_entry->data = std::move(output);
         last_entry = sub_entry.get();
         meta->entries.push_back(std::move(sub_entry));
     }
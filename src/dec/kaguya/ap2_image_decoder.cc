@@ -25,7 +25,7 @@ static const bstr magic = "AP-2"_b;
 
 bool Ap2ImageDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 res::Image Ap2ImageDecoder::decode_impl(
@@ -39,7 +39,7 @@ static bstr decompress(const bstr &input, const size_t size_orig)
 
 bool Aps3ImageDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.seek(0).read(magic.size()) == magic;
+    return input_file.stream.seek(0).matches(magic);
 }
 
 res::Image Aps3ImageDecoder::decode_impl(
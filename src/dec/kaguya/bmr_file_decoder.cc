@@ -164,7 +164,7 @@ static bstr descramble(const bstr &input)
 
 bool BmrFileDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 std::unique_ptr<io::File> BmrFileDecoder::decode_impl(
@@ -35,7 +35,7 @@ namespace
 
 bool Link2ArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.seek(0).read(magic.size()) == magic;
+    return input_file.stream.seek(0).matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> Link2ArchiveDecoder::read_meta_impl(
@@ -24,7 +24,7 @@ static const auto magic = "LINK6"_b;
 
 bool Link6ArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.seek(0).read(magic.size()) == magic;
+    return input_file.stream.seek(0).matches(magic);
 }
 
 int Link6ArchiveDecoder::get_version() const
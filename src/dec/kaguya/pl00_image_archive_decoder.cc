@@ -44,7 +44,7 @@ algo::NamingStrategy Pl00ImageArchiveDecoder::naming_strategy() const
 
 bool Pl00ImageArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.seek(0).read(magic.size()) == magic;
+    return input_file.stream.seek(0).matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> Pl00ImageArchiveDecoder::read_meta_impl(
@@ -47,7 +47,7 @@ static bstr decompress(const bstr &input, const size_t size_orig)
 
 bool WflArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.seek(0).read(magic.size()) == magic;
+    return input_file.stream.seek(0).matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> WflArchiveDecoder::read_meta_impl(
@@ -58,7 +58,7 @@ static bstr decrypt(
 
 bool CpsFileDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 std::unique_ptr<io::File> CpsFileDecoder::decode_impl(
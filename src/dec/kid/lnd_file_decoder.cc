@@ -101,7 +101,7 @@ bstr LndFileDecoder::decompress_raw_data(const bstr &input, size_t size_orig)
 
 bool LndFileDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 std::unique_ptr<io::File> LndFileDecoder::decode_impl(
@@ -36,7 +36,7 @@ namespace
 
 bool LnkArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> LnkArchiveDecoder::read_meta_impl(
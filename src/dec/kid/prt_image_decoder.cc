@@ -27,7 +27,7 @@ static const bstr magic = "PRT\x00"_b;
 
 bool PrtImageDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 res::Image PrtImageDecoder::decode_impl(
@@ -24,7 +24,7 @@ static const bstr magic = "WAF\x00\x00\x00"_b;
 
 bool WafAudioDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 res::Audio WafAudioDecoder::decode_impl(
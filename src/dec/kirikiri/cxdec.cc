@@ -16,6 +16,8 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "dec/kirikiri/cxdec.h"
+#include <map>
+#include <mutex>
 #include "algo/range.h"
 #include "err.h"
 #include "io/file_byte_stream.h"
@@ -64,6 +66,15 @@ namespace
         size_t parameter;
         u32 control_block_addr;
     };
+
+    // The derivation is a pure function of (seed, parameter) for fixed
+    // settings, and the same inputs recur constantly within one archive,
+    // so derived keys are memoized across the tasks unpacking it.
+    struct KeyCache final
+    {
+        std::map<u64, u32> entries;
+        std::mutex mutex;
+    };
 }
 
 static bstr u32_to_string(u32 value)
@@ -425,8 +436,30 @@ u32 KeyDeriver::run_stage_strategy_1(size_t stage)
     return eax;
 }
 
+static u32 derive_cached(
+    KeyDeriver &key_deriver,
+    KeyCache &key_cache,
+    const u32 seed,
+    const u32 parameter)
+{
+    const auto cache_key = (static_cast<u64>(seed) << 32) | parameter;
+    {
+        std::unique_lock<std::mutex> lock(key_cache.mutex);
+        const auto it = key_cache.entries.find(cache_key);
+        if (it != key_cache.entries.end())
+            return it->second;
+    }
+    // derived outside of the lock, so a slow derivation doesn't stall the
+    // other decryption tasks
+    const auto derived = key_deriver.derive(seed, parameter);
+    std::unique_lock<std::mutex> lock(key_cache.mutex);
+    key_cache.entries[cache_key] = derived;
+    return derived;
+}
+
 static void decrypt_chunk(
     KeyDeriver &key_deriver,
+    KeyCache &key_cache,
     bstr &data,
     u32 hash,
     size_t base_offset,
@@ -434,8 +467,9 @@ static void decrypt_chunk(
 {
     const auto seed = hash & 0x7F;
     hash >>= 7;
-    const auto ret0 = key_deriver.derive(seed, hash);
-    const auto ret1 = key_deriver.derive(seed, hash ^ 0xFFFFFFFF);
+    const auto ret0 = derive_cached(key_deriver, key_cache, seed, hash);
+    const auto ret1 = derive_cached(
+        key_deriver, key_cache, seed, hash ^ 0xFFFFFFFF);
 
     const auto xor0 = (ret0 >> 8) & 0xFF;
     const auto xor1 = (ret0 >> 16) & 0xFF;
@@ -492,20 +526,21 @@ Xp3Plugin au::dec::kirikiri::create_cxdec_plugin(
     const std::array<size_t, 3> key_derivation_order1,
     const std::array<size_t, 8> key_derivation_order2,
     const std::array<size_t, 6> key_derivation_order3,
-    const bstr &control_block)
+    const std::function<bstr()> control_block_loader)
 {
     Xp3Plugin plugin;
     plugin.create_decrypt_func = [=](const io::path &arc_path)
         -> std::function<void(bstr &, u32)> // fixes crash in clang
     {
         CxdecSettings settings;
-        settings.control_block = control_block.empty()
-            ? find_control_block(arc_path)
-            : control_block;
+        settings.control_block = control_block_loader
+            ? control_block_loader()
+            : find_control_block(arc_path);
         settings.key_derivation_order1 = key_derivation_order1;
         settings.key_derivation_order2 = key_derivation_order2;
         settings.key_derivation_order3 = key_derivation_order3;
 
+        const auto key_cache = std::make_shared<KeyCache>();
         return [=](bstr &data, u32 adlr_key)
         {
             KeyDeriver key_deriver(settings);
@@ -514,9 +549,15 @@ Xp3Plugin au::dec::kirikiri::create_cxdec_plugin(
             const auto offset1 = 0;
             const auto offset2 = std::min<size_t>(
                 data.size(), (adlr_key & key1) + key2);
-            decrypt_chunk(key_deriver, data, hash1, offset1, offset2);
             decrypt_chunk(
-                key_deriver, data, hash2, offset2, data.size() - offset2);
+                key_deriver, *key_cache, data, hash1, offset1, offset2);
+            decrypt_chunk(
+                key_deriver,
+                *key_cache,
+                data,
+                hash2,
+                offset2,
+                data.size() - offset2);
         };
     };
     return plugin;
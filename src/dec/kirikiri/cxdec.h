@@ -18,18 +18,23 @@
 #pragma once
 
 #include <array>
+#include <functional>
 #include "dec/kirikiri/xp3_plugin.h"
 
 namespace au {
 namespace dec {
 namespace kirikiri {
 
+    // The loader is invoked only when the plugin is actually selected for
+    // decryption, so plugins whose control block ships as an asset file
+    // don't touch the disk at decoder construction time. Without a loader
+    // the control block is searched for in TPM files next to the archive.
     Xp3Plugin create_cxdec_plugin(
         const u16 key1,
         const u16 key2,
         const std::array<size_t, 3> key_derivation_order1,
         const std::array<size_t, 8> key_derivation_order2,
         const std::array<size_t, 6> key_derivation_order3,
-        const bstr &control_block = ""_b);
+        const std::function<bstr()> control_block_loader = nullptr);
 
 } } }
@@ -16,6 +16,8 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "dec/kirikiri/tlg/tlg5_decoder.h"
+#include <atomic>
+#include <thread>
 #include "algo/range.h"
 #include "dec/kirikiri/tlg/lzss_decompressor.h"
 #include "err.h"
@@ -23,6 +25,9 @@
 using namespace au;
 using namespace au::dec::kirikiri::tlg;
 
+// images below this pixel count are reconstructed inline
+static const size_t parallel_threshold = 1024 * 1024;
+
 namespace
 {
     struct Header final
@@ -33,69 +38,71 @@ namespace
         u32 block_height;
     };
 
-    struct BlockInfo final
+    struct Strip final
     {
-        BlockInfo(io::BaseByteStream &input_stream);
-        void decompress(LzssDecompressor &decompressor, const Header &header);
-
-        bool mark;
-        size_t block_size;
-        bstr data;
+        size_t base_y;
+        std::vector<bstr> channels;
     };
 }
 
-BlockInfo::BlockInfo(io::BaseByteStream &input_stream)
-{
-    mark = input_stream.read<u8>() > 0;
-    const auto block_size = input_stream.read_le<u32>();
-    data = input_stream.read(block_size);
-}
-
-void BlockInfo::decompress(LzssDecompressor &decompressor, const Header &header)
-{
-    size_t output_size = header.image_width * header.block_height;
-    data = decompressor.decompress(data, output_size);
-}
-
-static void load_pixel_block_row(
-    res::Image &image,
-    std::vector<std::unique_ptr<BlockInfo>> channel_data,
-    const Header &header,
-    int block_y)
+// Applies the horizontal predictor of one strip: channel deltas are summed
+// along each row into the image. Rows start from zero, so strips do not
+// depend on each other and can run on separate threads; the vertical sum
+// is added in a later pass.
+static void reconstruct_strip(
+    res::Image &image, const Strip &strip, const Header &header)
 {
-    size_t max_y = std::min(block_y + header.block_height, header.image_height);
-    bool use_alpha = header.channel_count == 4;
+    const auto max_y = std::min<size_t>(
+        strip.base_y + header.block_height, header.image_height);
+    const bool use_alpha = header.channel_count == 4;
 
-    for (const auto y : algo::range(block_y, max_y))
+    for (const auto y : algo::range(strip.base_y, max_y))
     {
-        size_t block_y_shift = (y - block_y) * header.image_width;
-        u8 prev_pixel[4] = {0, 0, 0, 0};
+        const auto row_shift = (y - strip.base_y) * header.image_width;
+        const u8 *b_ptr = strip.channels[0].get<const u8>() + row_shift;
+        const u8 *g_ptr = strip.channels[1].get<const u8>() + row_shift;
+        const u8 *r_ptr = strip.channels[2].get<const u8>() + row_shift;
+        const u8 *a_ptr = use_alpha
+            ? strip.channels[3].get<const u8>() + row_shift
+            : nullptr;
 
+        auto *row = image.row(y);
+        u8 prev_b = 0, prev_g = 0, prev_r = 0, prev_a = 0;
         for (const auto x : algo::range(header.image_width))
         {
-            res::Pixel pixel;
-            pixel.b = channel_data[0]->data.get<u8>()[block_y_shift + x];
-            pixel.g = channel_data[1]->data.get<u8>()[block_y_shift + x];
-            pixel.r = channel_data[2]->data.get<u8>()[block_y_shift + x];
+            const u8 g = g_ptr[x];
+            prev_b += b_ptr[x] + g;
+            prev_g += g;
+            prev_r += r_ptr[x] + g;
             if (use_alpha)
-                pixel.a = channel_data[3]->data.get<u8>()[block_y_shift + x];
-            else
-                pixel.a = 0xFF;
-            pixel.b += pixel.g;
-            pixel.r += pixel.g;
-
-            for (const auto c : algo::range(header.channel_count))
-            {
-                prev_pixel[c] += pixel[c];
-                image.at(x, y)[c] = prev_pixel[c];
-                image.at(x, y)[c] += y > 0 ? image.at(x, y - 1)[c] : 0;
-            }
-            if (!use_alpha)
-                image.at(x, y).a = 0xFF;
+                prev_a += a_ptr[x];
+            row[x].b = prev_b;
+            row[x].g = prev_g;
+            row[x].r = prev_r;
+            row[x].a = prev_a;
         }
     }
 }
 
+// Adds each row to the one below it; the byte-wise loop over contiguous
+// rows is what the autovectorizer turns into wide adds.
+static void accumulate_rows(res::Image &image, const Header &header)
+{
+    for (const auto y : algo::range(1, header.image_height))
+    {
+        u8 *row = reinterpret_cast<u8*>(image.row(y));
+        const u8 *prev_row = reinterpret_cast<const u8*>(image.row(y - 1));
+        for (const auto i : algo::range(header.image_width * 4))
+            row[i] += prev_row[i];
+    }
+
+    if (header.channel_count == 3)
+    {
+        for (auto &pixel : image)
+            pixel.a = 0xFF;
+    }
+}
+
 static void read_image(
     io::BaseByteStream &input_stream, res::Image &image, const Header &header)
 {
@@ -103,20 +110,62 @@ static void read_image(
     size_t block_count = (header.image_height - 1) / header.block_height + 1;
     input_stream.skip(4 * block_count);
 
+    // the LZSS dictionary carries over from strip to strip, so the
+    // decompression pass is inherently sequential
     LzssDecompressor decompressor;
+    std::vector<Strip> strips;
     for (const auto y
         : algo::range(0, header.image_height, header.block_height))
     {
-        std::vector<std::unique_ptr<BlockInfo>> channel_data;
+        Strip strip;
+        strip.base_y = y;
         for (const auto channel : algo::range(header.channel_count))
         {
-            auto block_info = std::make_unique<BlockInfo>(input_stream);
-            if (!block_info->mark)
-                block_info->decompress(decompressor, header);
-            channel_data.push_back(std::move(block_info));
+            const auto mark = input_stream.read<u8>() > 0;
+            const auto block_size = input_stream.read_le<u32>();
+            auto data = input_stream.read(block_size);
+            if (!mark)
+            {
+                data = decompressor.decompress(
+                    data, header.image_width * header.block_height);
+            }
+            strip.channels.push_back(std::move(data));
         }
-        load_pixel_block_row(image, std::move(channel_data), header, y);
+        strips.push_back(std::move(strip));
     }
+
+    const auto pixel_count
+        = static_cast<size_t>(header.image_width) * header.image_height;
+    if (strips.size() > 1 && pixel_count >= parallel_threshold)
+    {
+        const auto thread_count = std::min<size_t>(
+            strips.size(),
+            std::max<size_t>(std::thread::hardware_concurrency(), 2));
+        std::atomic<size_t> next_strip(0);
+        std::vector<std::thread> threads;
+        for (const auto i : algo::range(thread_count))
+        {
+            threads.emplace_back([&]()
+            {
+                while (true)
+                {
+                    const auto strip_index = next_strip++;
+                    if (strip_index >= strips.size())
+                        break;
+                    reconstruct_strip(image, strips[strip_index], header);
+                }
+            });
+        }
+        for (auto &thread : threads)
+            thread.join();
+    }
+    else
+    {
+        for (const auto &strip : strips)
+            reconstruct_strip(image, strip, header);
+    }
+
+    accumulate_rows(image, header);
 }
 
 res::Image Tlg5Decoder::decode(io::File &file)
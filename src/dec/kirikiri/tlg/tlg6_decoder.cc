@@ -89,6 +89,16 @@ static inline u32 to_bgra(res::Pixel p)
     return p.b | (p.g << 8) | (p.r << 16) | (p.a << 24);
 }
 
+static inline res::Pixel to_pixel(const u32 v)
+{
+    res::Pixel p;
+    p.b = v;
+    p.g = v >> 8;
+    p.r = v >> 16;
+    p.a = v >> 24;
+    return p;
+}
+
 static void transformer0(res::Pixel &)
 {
 }
@@ -184,14 +194,6 @@ static void transformerF(res::Pixel &p)
     p.r += (p.b << 1);
 }
 
-static void (*transformers[16])(res::Pixel &p) =
-{
-    &transformer0, &transformer1, &transformer2, &transformer3,
-    &transformer4, &transformer5, &transformer6, &transformer7,
-    &transformer8, &transformer9, &transformerA, &transformerB,
-    &transformerC, &transformerD, &transformerE, &transformerF,
-};
-
 static inline u32 make_gt_mask(u32 a, u32 b)
 {
     u32 tmp2 = ~b;
@@ -224,6 +226,74 @@ static inline u32 avg(u32 a, u32 b, u32, u32 v)
         + ((a ^ b) & 0x01010101), v);
 }
 
+// Each filter type gets its own instantiation of the block loop, so the
+// filter and the color transformer inline into one straight-line body
+// rather than costing two indirect calls per pixel.
+template<u32 (*filter)(u32, u32, u32, u32), void (*transformer)(res::Pixel &)>
+static void process_block(
+    const res::Pixel *&prev_line,
+    res::Pixel *&current_line,
+    const u32 *&in,
+    u32 &left,
+    u32 &top_left,
+    int w,
+    const int step,
+    const bool opaque)
+{
+    do
+    {
+        res::Pixel inn;
+        inn.a = *in >> 24;
+        inn.r = *in >> 16;
+        inn.g = *in >> 8;
+        inn.b = *in;
+        transformer(inn);
+
+        const u32 top = to_bgra(*prev_line);
+        auto result = filter(left, top, top_left, to_bgra(inn));
+        if (opaque)
+            result |= 0xFF000000;
+        left = result;
+        top_left = top;
+        *current_line++ = to_pixel(result);
+        prev_line++;
+        in += step;
+    }
+    while (--w);
+}
+
+using BlockKernel = void (*)(
+    const res::Pixel *&prev_line,
+    res::Pixel *&current_line,
+    const u32 *&in,
+    u32 &left,
+    u32 &top_left,
+    int w,
+    const int step,
+    const bool opaque);
+
+// indexed directly with the filter type byte: bit 0 picks the filter,
+// the remaining bits pick the transformer
+static BlockKernel block_kernels[32] =
+{
+    &process_block<&med, &transformer0>, &process_block<&avg, &transformer0>,
+    &process_block<&med, &transformer1>, &process_block<&avg, &transformer1>,
+    &process_block<&med, &transformer2>, &process_block<&avg, &transformer2>,
+    &process_block<&med, &transformer3>, &process_block<&avg, &transformer3>,
+    &process_block<&med, &transformer4>, &process_block<&avg, &transformer4>,
+    &process_block<&med, &transformer5>, &process_block<&avg, &transformer5>,
+    &process_block<&med, &transformer6>, &process_block<&avg, &transformer6>,
+    &process_block<&med, &transformer7>, &process_block<&avg, &transformer7>,
+    &process_block<&med, &transformer8>, &process_block<&avg, &transformer8>,
+    &process_block<&med, &transformer9>, &process_block<&avg, &transformer9>,
+    &process_block<&med, &transformerA>, &process_block<&avg, &transformerA>,
+    &process_block<&med, &transformerB>, &process_block<&avg, &transformerB>,
+    &process_block<&med, &transformerC>, &process_block<&avg, &transformerC>,
+    &process_block<&med, &transformerD>, &process_block<&avg, &transformerD>,
+    &process_block<&med, &transformerE>, &process_block<&avg, &transformerE>,
+    &process_block<&med, &transformerF>, &process_block<&avg, &transformerF>,
+};
+
 static void init_table()
 {
     static bool initialized = false;
@@ -398,24 +468,24 @@ static void decode_line(
     int dir,
     const Header &header)
 {
-    res::Pixel left, top_left;
+    const bool opaque = header.channel_count == 3;
+    u32 left, top_left;
     int step;
 
     if (start_block)
     {
         prev_line += start_block * w_block_size;
         current_line += start_block * w_block_size;
-        left = current_line[-1];
-        top_left = prev_line[-1];
+        left = to_bgra(current_line[-1]);
+        top_left = to_bgra(prev_line[-1]);
     }
     else
     {
-        left.r = left.g = left.b = 0;
-        top_left.r = top_left.g = top_left.b = 0;
-        left.a = top_left.a = header.channel_count == 3 ? 0xFF : 0;
+        left = top_left = opaque ? 0xFF000000 : 0;
     }
 
-    in += skip_block_bytes * start_block;
+    const res::Pixel *prev_ptr = prev_line;
+    const u32 *in_ptr = in + skip_block_bytes * start_block;
     step = (dir & 1) ? 1 : -1;
 
     for (const auto i : algo::range(start_block, block_limit))
@@ -426,47 +496,18 @@ static void decode_line(
 
         int ww = w;
         if (step == -1)
-            in += ww - 1;
+            in_ptr += ww - 1;
 
         if (i & 1)
-            in += odd_skip * ww;
-
-        auto filter = filter_types[i] & 1 ? &avg : &med;
-        auto transformer = transformers[filter_types[i] >> 1];
+            in_ptr += odd_skip * ww;
 
-        do
-        {
-            res::Pixel inn;
-            inn.a = *in >> 24;
-            inn.r = *in >> 16;
-            inn.g = *in >> 8;
-            inn.b = *in;
-            transformer(inn);
-
-            res::Pixel top = *prev_line;
-            auto result = filter(
-                to_bgra(left),
-                to_bgra(top),
-                to_bgra(top_left),
-                to_bgra(inn));
-            left.a = result >> 24;
-            left.r = result >> 16;
-            left.g = result >> 8;
-            left.b = result;
-            if (header.channel_count == 3)
-                left.a = 0xFF;
-
-            top_left = top;
-            *current_line++ = left;
-
-            prev_line++;
-            in += step;
-        }
-        while (--w);
+        const auto kernel = block_kernels[filter_types[i] & 0x1F];
+        kernel(
+            prev_ptr, current_line, in_ptr, left, top_left, w, step, opaque);
 
-        in += skip_block_bytes + (step == 1 ? - ww : 1);
+        in_ptr += skip_block_bytes + (step == 1 ? - ww : 1);
         if (i & 1)
-            in -= odd_skip * ww;
+            in_ptr -= odd_skip * ww;
     }
 }
 
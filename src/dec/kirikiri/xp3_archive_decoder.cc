@@ -16,6 +16,8 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "dec/kirikiri/xp3_archive_decoder.h"
+#include <atomic>
+#include <thread>
 #include "algo/locale.h"
 #include "algo/pack/zlib.h"
 #include "algo/range.h"
@@ -68,6 +70,10 @@ namespace
 }
 
 static const bstr xp3_magic = "XP3\r\n\x20\x0A\x1A\x8B\x67\x01"_b;
+
+// entries smaller than this inflate their segments sequentially; the
+// threading overhead only pays off on big video and voice pack entries
+static const size_t parallel_inflate_threshold = 4 * 1024 * 1024;
 static const bstr hnfn_entry_magic = "hnfn"_b;
 static const bstr file_entry_magic = "File"_b;
 static const bstr elif_entry_magic = "eliF"_b;
@@ -216,7 +222,7 @@ static std::unique_ptr<CustomArchiveEntry> read_file_entry(
 
 bool Xp3ArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(xp3_magic.size()) == xp3_magic;
+    return input_file.stream.matches(xp3_magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> Xp3ArchiveDecoder::read_meta_impl(
@@ -234,7 +240,7 @@ std::unique_ptr<dec::ArchiveMeta> Xp3ArchiveDecoder::read_meta_impl(
 
     auto table_data = input_file.stream.read(table_size_comp);
     if (table_is_compressed)
-        table_data = algo::pack::zlib_inflate(table_data);
+        table_data = algo::pack::zlib_inflate(table_data, table_size_orig);
     io::MemoryByteStream table_stream(table_data);
 
     auto meta = std::make_unique<CustomArchiveMeta>();
@@ -270,16 +276,77 @@ std::unique_ptr<io::File> Xp3ArchiveDecoder::read_file_impl(
     const auto meta = static_cast<const CustomArchiveMeta*>(&m);
     const auto entry = static_cast<const CustomArchiveEntry*>(&e);
 
-    bstr data;
-    for (const auto &segm_chunk : entry->segm_chunks)
+    // the raw segments are read sequentially (the input stream is not
+    // shareable), but large multi-segment entries get their zlib streams
+    // inflated on separate threads and stitched in order
+    std::vector<bstr> segments(entry->segm_chunks.size());
+    std::vector<size_t> compressed_segments;
+    size_t total_size_orig = 0;
+    for (const auto i : algo::range(entry->segm_chunks.size()))
     {
+        const auto &segm_chunk = entry->segm_chunks[i];
         const auto data_is_compressed = segm_chunk->flags & 7;
         input_file.stream.seek(segm_chunk->offset);
-        data += data_is_compressed
-            ? algo::pack::zlib_inflate(
-                input_file.stream.read(segm_chunk->size_comp))
-            : input_file.stream.read(segm_chunk->size_orig);
+        segments[i] = input_file.stream.read(
+            data_is_compressed
+                ? segm_chunk->size_comp
+                : segm_chunk->size_orig);
+        if (data_is_compressed)
+            compressed_segments.push_back(i);
+        total_size_orig += segm_chunk->size_orig;
+    }
+
+    if (compressed_segments.size() > 1
+        && total_size_orig >= parallel_inflate_threshold)
+    {
+        const auto thread_count = std::min<size_t>(
+            compressed_segments.size(),
+            std::max<size_t>(std::thread::hardware_concurrency(), 2));
+        std::atomic<size_t> next_segment(0);
+        std::atomic<bool> failed(false);
+        std::vector<std::thread> threads;
+        for (const auto i : algo::range(thread_count))
+        {
+            threads.emplace_back([&]()
+            {
+                while (true)
+                {
+                    const auto pos = next_segment++;
+                    if (pos >= compressed_segments.size())
+                        return;
+                    const auto segment_index = compressed_segments[pos];
+                    try
+                    {
+                        segments[segment_index] = algo::pack::zlib_inflate(
+                            segments[segment_index],
+                            entry->segm_chunks[segment_index]->size_orig);
+                    }
+                    catch (...)
+                    {
+                        failed = true;
+                    }
+                }
+            });
+        }
+        for (auto &thread : threads)
+            thread.join();
+        if (failed)
+            throw err::CorruptDataError("Failed to inflate SEGM chunk");
     }
+    else
+    {
+        for (const auto segment_index : compressed_segments)
+        {
+            segments[segment_index] = algo::pack::zlib_inflate(
+                segments[segment_index],
+                entry->segm_chunks[segment_index]->size_orig);
+        }
+    }
+
+    bstr data;
+    data.reserve(total_size_orig);
+    for (const auto &segment : segments)
+        data += segment;
 
     if (meta->decrypt_func)
         meta->decrypt_func(data, entry->adlr_chunk->key);
@@ -293,3 +360,4 @@ std::vector<std::string> Xp3ArchiveDecoder::get_linked_formats() const
 }
 
 static auto _ = dec::register_decoder<Xp3ArchiveDecoder>("kirikiri/xp3");
+static auto _2 = dec::register_signature("kirikiri/xp3", xp3_magic);
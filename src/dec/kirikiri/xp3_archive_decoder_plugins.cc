@@ -164,7 +164,7 @@ Xp3ArchiveDecoder::Xp3ArchiveDecoder()
         "karakara", "Karakara",
         create_cxdec_plugin(
             0x190, 0x4A7, {1,0,2}, {2,0,7,3,5,1,4,6}, {2,1,0,5,4,3},
-            read_etc_file("karakara.dat")));
+            []() { return read_etc_file("karakara.dat"); }));
 
     plugin_manager.add(
         "waremete", "Ushinawareta Mirai o Motomete",
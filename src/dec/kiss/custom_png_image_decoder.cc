@@ -27,7 +27,7 @@ static const bstr magic = "\x89PNG"_b;
 
 bool CustomPngImageDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 res::Image CustomPngImageDecoder::decode_impl(
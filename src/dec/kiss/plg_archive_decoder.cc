@@ -27,7 +27,7 @@ static const bstr magic = "LIB\x00\x00\x00\x01\x00"_b;
 bool PlgArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
     input_file.stream.seek(0);
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> PlgArchiveDecoder::read_meta_impl(
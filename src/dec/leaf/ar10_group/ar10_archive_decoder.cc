@@ -34,7 +34,7 @@ namespace
 
 bool Ar10ArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.seek(0).read(magic.size()) == magic;
+    return input_file.stream.seek(0).matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> Ar10ArchiveDecoder::read_meta_impl(
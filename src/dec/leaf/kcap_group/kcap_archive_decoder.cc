@@ -35,12 +35,34 @@ namespace
         CompressedFile = 0x00000001,
     };
 
-    struct CustomArchiveEntry final : dec::PlainArchiveEntry
+    struct CustomArchiveEntry final : dec::CompressedArchiveEntry
     {
-        bool compressed;
+        bool compressed = false;
     };
 }
 
+// Compressed entries open with their packed and unpacked sizes. Reading
+// the pair while the table is parsed lets extraction start decompressing
+// without a second look at the entry header, and gives the parallel
+// adapter real size hints to admit entries by.
+static void read_entry_sizes(
+    io::File &input_file, CustomArchiveEntry &entry, const size_t raw_size)
+{
+    if (entry.compressed)
+    {
+        input_file.stream.peek(entry.offset, [&]()
+        {
+            entry.size_comp = input_file.stream.read_le<u32>();
+            entry.size_orig = input_file.stream.read_le<u32>();
+        });
+    }
+    else
+    {
+        entry.size_comp = raw_size;
+        entry.size_orig = raw_size;
+    }
+}
+
 static size_t detect_version(io::File &input_file, const size_t file_count)
 {
     size_t version = 0;
@@ -76,7 +98,8 @@ static std::unique_ptr<dec::ArchiveMeta> read_meta_v1(
         entry->path = algo::sjis_to_utf8(
             input_file.stream.read_to_zero(24)).str();
         entry->offset = input_file.stream.read_le<u32>();
-        entry->size = input_file.stream.read_le<u32>();
+        const auto raw_size = input_file.stream.read_le<u32>();
+        read_entry_sizes(input_file, *entry, raw_size);
         meta->entries.push_back(std::move(entry));
     }
     return meta;
@@ -94,17 +117,18 @@ static std::unique_ptr<dec::ArchiveMeta> read_meta_v2(
         entry->path = algo::sjis_to_utf8(
             input_file.stream.read_to_zero(24)).str();
         entry->offset = input_file.stream.read_le<u32>();
-        entry->size = input_file.stream.read_le<u32>();
+        const auto raw_size = input_file.stream.read_le<u32>();
         if (type == EntryType::RegularFile)
             entry->compressed = false;
         else if (type == EntryType::CompressedFile)
             entry->compressed = true;
         else
         {
-            if (!entry->size)
+            if (!raw_size)
                 continue;
             logger.warn("Unknown entry type: %08x\n", type);
         }
+        read_entry_sizes(input_file, *entry, raw_size);
         meta->entries.push_back(std::move(entry));
     }
     return meta;
@@ -112,7 +136,12 @@ static std::unique_ptr<dec::ArchiveMeta> read_meta_v2(
 
 bool KcapArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
+}
+
+bool KcapArchiveDecoder::entries_are_independent() const
+{
+    return true;
 }
 
 std::unique_ptr<dec::ArchiveMeta> KcapArchiveDecoder::read_meta_impl(
@@ -136,17 +165,18 @@ std::unique_ptr<io::File> KcapArchiveDecoder::read_file_impl(
     const dec::ArchiveEntry &e) const
 {
     const auto entry = static_cast<const CustomArchiveEntry*>(&e);
-    input_file.stream.seek(entry->offset);
     bstr data;
     if (entry->compressed)
     {
-        const auto size_comp = input_file.stream.read_le<u32>();
-        const auto size_orig = input_file.stream.read_le<u32>();
-        data = input_file.stream.read(size_comp - 8);
-        data = algo::pack::lzss_decompress(data, size_orig);
+        input_file.stream.seek(entry->offset + 8);
+        data = input_file.stream.read(entry->size_comp - 8);
+        data = algo::pack::lzss_decompress(data, entry->size_orig);
     }
     else
-        data = input_file.stream.read(entry->size);
+    {
+        input_file.stream.seek(entry->offset);
+        data = input_file.stream.read(entry->size_orig);
+    }
     return std::make_unique<io::File>(entry->path, data);
 }
 
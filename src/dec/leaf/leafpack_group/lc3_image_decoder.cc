@@ -25,7 +25,7 @@ static const bstr magic = "LEAFC64\x00"_b;
 
 bool Lc3ImageDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 res::Image Lc3ImageDecoder::decode_impl(
@@ -50,7 +50,7 @@ LeafpackArchiveDecoder::LeafpackArchiveDecoder()
 
 bool LeafpackArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> LeafpackArchiveDecoder::read_meta_impl(
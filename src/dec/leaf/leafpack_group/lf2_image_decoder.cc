@@ -25,7 +25,7 @@ static const bstr magic = "LEAF256\x00"_b;
 
 bool Lf2ImageDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 res::Image Lf2ImageDecoder::decode_impl(
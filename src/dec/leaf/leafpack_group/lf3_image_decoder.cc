@@ -25,7 +25,7 @@ static const bstr magic = "LEAF64K\x00"_b;
 
 bool Lf3ImageDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 res::Image Lf3ImageDecoder::decode_impl(
@@ -79,7 +79,7 @@ static void move_output_ptr(
 
 bool LfgImageDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 res::Image LfgImageDecoder::decode_impl(
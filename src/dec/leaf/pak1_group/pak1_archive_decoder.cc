@@ -19,6 +19,7 @@
 #include <map>
 #include "algo/locale.h"
 #include "algo/range.h"
+#include "algo/scratch_arena.h"
 #include "algo/str.h"
 #include "dec/leaf/pak1_group/grp_image_decoder.h"
 #include "err.h"
@@ -41,7 +42,7 @@ namespace
 static bstr custom_lzss_decompress(
     const bstr &input, size_t output_size, const size_t dict_capacity)
 {
-    std::vector<u8> dict(dict_capacity);
+    algo::ScratchBuffer dict(dict_capacity);
     size_t dict_size = 0;
     size_t dict_pos = 0;
 
@@ -75,7 +75,7 @@ static bstr decompress(const bstr &src, const size_t size_orig)
 
 bool Pak2CompressedFileDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.seek(4).read(magic.size()) == magic;
+    return input_file.stream.seek(4).matches(magic);
 }
 
 std::unique_ptr<io::File> Pak2CompressedFileDecoder::decode_impl(
@@ -40,7 +40,7 @@ namespace
 
 bool Pak2ImageArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.seek(4).read(magic.size()) == magic;
+    return input_file.stream.seek(4).matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> Pak2ImageArchiveDecoder::read_meta_impl(
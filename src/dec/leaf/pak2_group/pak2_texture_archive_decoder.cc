@@ -46,7 +46,7 @@ namespace
 
 bool Pak2TextureArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.seek(4).read(magic.size()) == magic;
+    return input_file.stream.seek(4).matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> Pak2TextureArchiveDecoder::read_meta_impl(
@@ -81,7 +81,7 @@ static bstr decrypt_3(const bstr &input, const u8 key)
 
 bool AArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.seek(0).read(magic.size()) == magic;
+    return input_file.stream.seek(0).matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> AArchiveDecoder::read_meta_impl(
@@ -18,12 +18,53 @@
 #include "dec/liar_soft/cg_decompress.h"
 #include "algo/range.h"
 #include "err.h"
-#include "io/memory_byte_stream.h"
-#include "io/msb_bit_stream.h"
 
 using namespace au;
 using namespace au::dec::liar_soft;
 
+namespace
+{
+    // The decompressor reads several small variable-width fields per code;
+    // a local MSB-first cache over the compressed block keeps each read a
+    // couple of shifts rather than a virtual stream call.
+    class BitCache final
+    {
+    public:
+        BitCache(const bstr &input) :
+            input_ptr(input.get<const u8>()),
+            input_end(input.end<const u8>()),
+            buffer(0),
+            bits_available(0)
+        {
+        }
+
+        inline size_t left() const
+        {
+            return bits_available + ((input_end - input_ptr) << 3);
+        }
+
+        inline u32 read(const size_t bits)
+        {
+            while (bits_available < bits)
+            {
+                if (input_ptr == input_end)
+                    throw err::EofError();
+                buffer = (buffer << 8) | *input_ptr++;
+                bits_available += 8;
+            }
+            const auto mask = (1ull << bits) - 1;
+            bits_available -= bits;
+            return (buffer >> bits_available) & mask;
+        }
+
+    private:
+        const u8 *input_ptr;
+        const u8 *input_end;
+        u64 buffer;
+        size_t bits_available;
+    };
+}
+
 void dec::liar_soft::cg_decompress(
     bstr &output,
     const size_t output_offset,
@@ -50,7 +91,9 @@ void dec::liar_soft::cg_decompress(
     const size_t unk1 = table_size < 0x1000 ? 6 : 0xE;
     const size_t unk2 = table_size < 0x1000 ? 3 : 4;
 
-    io::MsbBitStream bit_stream(input_stream.read(size_comp));
+    const auto compressed = input_stream.read(size_comp);
+    BitCache bit_stream(compressed);
+    const auto table_ptr = table.get<const u8>();
     while (output_ptr < output_end)
     {
         try
@@ -86,17 +129,29 @@ void dec::liar_soft::cg_decompress(
             if ((table_offset + 1) * input_shift > table.size())
                 throw err::BadDataOffsetError();
 
-            const auto input_chunk = table.substr(
-                table_offset * input_shift, input_shift);
-            for (const auto i : algo::range(sequence_size))
+            const auto input_chunk = table_ptr + table_offset * input_shift;
+            if (output_ptr + (sequence_size - 1) * output_shift + input_shift
+                <= output_end)
+            {
+                for (const auto i : algo::range(sequence_size))
+                {
+                    for (const auto j : algo::range(input_shift))
+                        output_ptr[j] = input_chunk[j];
+                    output_ptr += output_shift;
+                }
+            }
+            else
             {
-                for (const auto j : algo::range(input_shift))
+                for (const auto i : algo::range(sequence_size))
                 {
-                    if (output_ptr >= output_end)
-                        break;
-                    *output_ptr++ = input_chunk[j];
+                    for (const auto j : algo::range(input_shift))
+                    {
+                        if (output_ptr >= output_end)
+                            break;
+                        *output_ptr++ = input_chunk[j];
+                    }
+                    output_ptr += output_shift - input_shift;
                 }
-                output_ptr += output_shift - input_shift;
             }
         }
         catch (const err::EofError)
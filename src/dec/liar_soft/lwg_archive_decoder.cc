@@ -27,7 +27,7 @@ static const bstr magic = "LG\x01\x00"_b;
 
 bool LwgArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> LwgArchiveDecoder::read_meta_impl(
@@ -25,7 +25,7 @@ static const bstr magic = "\x48\x48\x36\x10\x0E\x00\x00\x00\x00\x00"_b;
 
 bool MncImageDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 res::Image MncImageDecoder::decode_impl(
@@ -277,7 +277,7 @@ static bstr read_mono(
 
 bool ElgImageDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 res::Image ElgImageDecoder::decode_impl(
@@ -58,12 +58,25 @@ namespace
 
 static void decrypt_table(bstr &data, u32 key, u32 rotate_pattern)
 {
-    auto data_ptr = algo::make_ptr(data.get<u32>(), data.size() / 4);
-    while (data_ptr.left())
+    // the key sequence does not depend on the data, so it is generated in
+    // batches and applied in a separate loop that the compiler can widen
+    static const size_t batch_size = 256;
+    u32 keys[batch_size];
+    auto data_ptr = data.get<u32>();
+    auto words_left = data.size() / 4;
+    while (words_left)
     {
-        *data_ptr++ ^= key;
-        rotate_pattern = algo::rotl<u32>(rotate_pattern, 4);
-        key = algo::rotr<u32>(key, rotate_pattern);
+        const auto run = std::min<size_t>(words_left, batch_size);
+        for (const auto i : algo::range(run))
+        {
+            keys[i] = key;
+            rotate_pattern = algo::rotl<u32>(rotate_pattern, 4);
+            key = algo::rotr<u32>(key, rotate_pattern);
+        }
+        for (const auto i : algo::range(run))
+            data_ptr[i] ^= keys[i];
+        data_ptr += run;
+        words_left -= run;
     }
 }
 
@@ -81,13 +94,25 @@ static void decrypt_content_1(bstr &data, u32 key, u32 rotate_pattern)
 
 static void decrypt_content_2(bstr &data, const u8 key)
 {
-    for (auto &c : data)
-        c = algo::rotr<u8>(c ^ key, 4);
+    // rotating a byte by 4 is a nibble swap, which applies to eight bytes
+    // at once over a broadcast key
+    const u64 wide_key = key * 0x0101010101010101ull;
+    u64 *word_ptr = data.get<u64>();
+    const auto word_count = data.size() / 8;
+    for (const auto i : algo::range(word_count))
+    {
+        const u64 x = word_ptr[i] ^ wide_key;
+        word_ptr[i]
+            = ((x & 0x0F0F0F0F0F0F0F0Full) << 4)
+            | ((x >> 4) & 0x0F0F0F0F0F0F0F0Full);
+    }
+    for (const auto i : algo::range(word_count * 8, data.size()))
+        data[i] = algo::rotr<u8>(data[i] ^ key, 4);
 }
 
 bool LpkArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.seek(0).read(magic.size()) == magic;
+    return input_file.stream.seek(0).matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> LpkArchiveDecoder::read_meta_impl(
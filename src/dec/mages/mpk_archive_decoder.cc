@@ -25,7 +25,7 @@ static const bstr magic = "MPK\0"_b;
 
 bool MpkArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.seek(0).read(magic.size()) == magic;
+    return input_file.stream.seek(0).matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> MpkArchiveDecoder::read_meta_impl(
@@ -29,7 +29,7 @@ static const bstr magic = "MajiroArcV"_b;
 
 bool ArcArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> ArcArchiveDecoder::read_meta_impl(
@@ -84,3 +84,4 @@ std::vector<std::string> ArcArchiveDecoder::get_linked_formats() const
 }
 
 static auto _ = dec::register_decoder<ArcArchiveDecoder>("majiro/arc");
+static auto _2 = dec::register_signature("majiro/arc", magic);
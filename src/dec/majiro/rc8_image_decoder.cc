@@ -78,7 +78,7 @@ static bstr uncompress(const bstr &input, size_t width, size_t height)
 
 bool Rc8ImageDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 res::Image Rc8ImageDecoder::decode_impl(
@@ -16,6 +16,8 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "dec/majiro/rct_image_decoder.h"
+#include <algorithm>
+#include <cstring>
 #include "algo/range.h"
 #include "algo/str.h"
 #include "dec/majiro/rc8_image_decoder.h"
@@ -48,9 +50,17 @@ static bstr decrypt(const bstr &input, const bstr &key)
     for (const auto i : algo::range(0x100))
         derived_key.get<u32>()[i] = checksum ^ crc_table[(i + checksum) & 0xFF];
 
+    // applying the key one full period at a time keeps the modulo out of
+    // the inner loop and leaves a plain XOR the compiler can widen
     bstr output(input);
-    for (const auto i : algo::range(output.size()))
-        output[i] ^= derived_key[i % derived_key.size()];
+    size_t pos = 0;
+    while (pos < output.size())
+    {
+        const auto run = std::min(derived_key.size(), output.size() - pos);
+        for (const auto i : algo::range(run))
+            output[pos + i] ^= derived_key[i];
+        pos += run;
+    }
     return output;
 }
 
@@ -87,7 +97,7 @@ static bstr uncompress(const bstr &input, size_t width, size_t height)
         auto flag = input_stream.read<u8>();
         if (flag & 0x80)
         {
-            auto size = flag & 3;
+            size_t size = flag & 3;
             auto look_behind = (flag >> 2) & 0x1F;
             size = size == 3
                 ? (input_stream.read_le<u16>() + 4) * 3
@@ -95,16 +105,28 @@ static bstr uncompress(const bstr &input, size_t width, size_t height)
             auto source_ptr = &output_ptr[shift_table[look_behind]];
             if (source_ptr < output_start || source_ptr + size >= output_end)
                 return output;
-            while (size-- && output_ptr < output_end)
-                *output_ptr++ = *source_ptr++;
+            size = std::min<size_t>(size, output_end - output_ptr);
+            // spans that do not reach into the area being written copy in
+            // bulk; overlapping ones repeat bytes and must stay byte-wise
+            if (source_ptr + size <= output_ptr)
+            {
+                std::memcpy(output_ptr, source_ptr, size);
+                output_ptr += size;
+            }
+            else
+            {
+                while (size--)
+                    *output_ptr++ = *source_ptr++;
+            }
         }
         else
         {
-            auto size = flag == 0x7F
+            size_t size = flag == 0x7F
                 ? (input_stream.read_le<u16>() + 0x80) * 3
                 : flag * 3 + 3;
-            while (size-- && output_ptr < output_end)
-                *output_ptr++ = input_stream.read<u8>();
+            size = std::min<size_t>(size, output_end - output_ptr);
+            input_stream.read(output_ptr, size);
+            output_ptr += size;
         }
     }
 
@@ -143,7 +165,7 @@ RctImageDecoder::RctImageDecoder()
 
 bool RctImageDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 res::Image RctImageDecoder::decode_impl(
@@ -16,13 +16,15 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "dec/malie/common/camellia_stream.h"
+#include <algorithm>
 #include <cstring>
-#include "algo/range.h"
-#include "io/memory_byte_stream.h"
+#include "err.h"
 
 using namespace au;
 using namespace au::dec::malie::common;
 
+static const size_t cache_chunk_size = 0x2000;
+
 CamelliaStream::CamelliaStream(
     io::BaseByteStream &parent_stream, const std::vector<u32> &key)
         : CamelliaStream(parent_stream, key, 0, parent_stream.size())
@@ -37,7 +39,8 @@ CamelliaStream::CamelliaStream(
         key(key),
         parent_stream(parent_stream.clone()),
         parent_stream_offset(offset),
-        parent_stream_size(size)
+        parent_stream_size(size),
+        cache_start(0)
 {
     if (key.size())
         camellia = std::make_unique<algo::crypt::Camellia>(key);
@@ -69,25 +72,56 @@ void CamelliaStream::read_impl(void *destination, const size_t size)
     if (block_count == 0)
         return;
 
-    parent_stream->seek(parent_stream_offset
-        + ((parent_stream->pos() - parent_stream_offset) - offset_pad));
+    // reads already covered by the cached span cost just a copy
+    if (!cache.empty()
+        && offset_start >= cache_start
+        && offset_start + aligned_size <= cache_start + cache.size())
+    {
+        std::memcpy(
+            destination,
+            cache.get<const u8>() + (old_pos - cache_start),
+            size);
+        parent_stream->seek(old_pos + size);
+        return;
+    }
 
-    io::MemoryByteStream output_stream;
-    output_stream.resize(block_count * 16);
-    output_stream.seek(0);
-    for (const auto i : algo::range(block_count))
+    if (aligned_size >= cache_chunk_size)
     {
-        u32 input_block[4];
-        u32 output_block[4];
-        for (const auto j : algo::range(4))
-            input_block[j] = parent_stream->read_le<u32>();
-        camellia->decrypt_block_128(
-            offset_start + i * 0x10, input_block, output_block);
-        for (const auto j : algo::range(4))
-            output_stream.write_be<u32>(output_block[j]);
+        // large reads bypass the cache and decrypt in one batch
+        parent_stream->seek(parent_stream_offset
+            + ((parent_stream->pos() - parent_stream_offset) - offset_pad));
+
+        const auto encrypted = parent_stream->read(block_count * 0x10);
+        bstr decrypted(block_count * 0x10);
+        camellia->decrypt_blocks_128(
+            offset_start,
+            encrypted.get<const u8>(),
+            decrypted.get<u8>(),
+            block_count);
+        std::memcpy(
+            destination, decrypted.get<const u8>() + offset_pad, size);
+        parent_stream->seek(old_pos + size);
+        return;
     }
-    const auto chunk = output_stream.seek(offset_pad).read(size);
-    std::memcpy(destination, chunk.get<u8>(), size);
+
+    // decrypt a whole aligned chunk ahead of the request, clipped to the
+    // end of the parent stream
+    uoff_t chunk_size = cache_chunk_size;
+    if (offset_start + chunk_size > parent_stream->size())
+        chunk_size = (parent_stream->size() - offset_start) & ~0xFull;
+    chunk_size = std::max<uoff_t>(chunk_size, aligned_size);
+
+    parent_stream->seek(offset_start);
+    const auto encrypted = parent_stream->read(chunk_size);
+    cache.resize(chunk_size);
+    camellia->decrypt_blocks_128(
+        offset_start,
+        encrypted.get<const u8>(),
+        cache.get<u8>(),
+        chunk_size / 0x10);
+    cache_start = offset_start;
+
+    std::memcpy(destination, cache.get<const u8>() + offset_pad, size);
     parent_stream->seek(old_pos + size);
 }
 
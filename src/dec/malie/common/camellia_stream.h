@@ -55,6 +55,11 @@ namespace common {
         std::unique_ptr<io::BaseByteStream> parent_stream;
         const uoff_t parent_stream_offset;
         const uoff_t parent_stream_size;
+
+        // aligned span of decrypted blocks kept around so that a run of
+        // small reads decrypts each block exactly once
+        bstr cache;
+        uoff_t cache_start;
     };
 
 } } } }
@@ -84,7 +84,7 @@ static res::Image get_texture_image(
 
 bool DziImageArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.seek(0).read(magic.size()) == magic;
+    return input_file.stream.seek(0).matches(magic);
 }
 
 algo::NamingStrategy DziImageArchiveDecoder::naming_strategy() const
@@ -25,7 +25,7 @@ static const bstr magic = "MalieGF\x00"_b;
 
 bool MgfImageDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.seek(0).read(magic.size()) == magic;
+    return input_file.stream.seek(0).matches(magic);
 }
 
 res::Image MgfImageDecoder::decode_impl(
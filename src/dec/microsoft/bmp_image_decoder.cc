@@ -16,6 +16,7 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "dec/microsoft/bmp_image_decoder.h"
+#include <algorithm>
 #include <cstdlib>
 #include "algo/format.h"
 #include "algo/range.h"
@@ -294,6 +295,67 @@ static res::Image get_image_without_palette(
     return *image;
 }
 
+bool BmpImageDecoder::supports_banded_decode() const
+{
+    return true;
+}
+
+void BmpImageDecoder::decode_banded_impl(
+    const Logger &logger, io::File &input_file, dec::ImageBandSink &sink) const
+{
+    input_file.stream.seek(10);
+    const auto header = read_header(input_file.stream);
+
+    // plain 24-bit BGR rows are already in the layout the rest of the
+    // pipeline consumes, so they can be passed through band by band
+    // without ever materializing the whole image. Everything else needs
+    // a whole-image pass anyway (bit unpacking, palettes, or the 32-bit
+    // alpha normalization that inspects every pixel), so it takes the
+    // whole-image fallback.
+    const bool plain_bgr24 = header.planes == 1
+        && header.compression == 0
+        && !header.palette_size
+        && header.depth == 24
+        && header.masks[0] == 0xFF0000
+        && header.masks[1] == 0xFF00
+        && header.masks[2] == 0xFF
+        && header.masks[3] == 0
+        && header.width > 0
+        && header.height > 0;
+    if (!plain_bgr24)
+    {
+        input_file.stream.seek(0);
+        BaseImageDecoder::decode_banded_impl(logger, input_file, sink);
+        return;
+    }
+
+    sink.start(header.width, header.height);
+
+    const auto row_size = header.width * 3;
+    static const size_t band_row_count = 256;
+    size_t y = 0;
+    while (y < header.height)
+    {
+        const auto band_height
+            = std::min<size_t>(band_row_count, header.height - y);
+        bstr data(row_size * band_height);
+        for (const auto band_y : algo::range(band_height))
+        {
+            // the source stores rows bottom-up when flipped; fold the
+            // flip into the row seeks so bands still arrive top to bottom
+            const auto source_y = header.flip
+                ? header.height - 1 - (y + band_y)
+                : y + band_y;
+            input_file.stream
+                .seek(header.data_offset + header.stride * source_y)
+                .read(data.get<u8>() + band_y * row_size, row_size);
+        }
+        sink.band(res::Image(
+            header.width, band_height, data, res::PixelFormat::BGR888));
+        y += band_height;
+    }
+}
+
 bool BmpImageDecoder::is_recognized_impl(io::File &input_file) const
 {
     input_file.stream.seek(0);
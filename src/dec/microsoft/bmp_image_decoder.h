@@ -25,10 +25,17 @@ namespace microsoft {
 
     class BmpImageDecoder final : public BaseImageDecoder
     {
+    public:
+        bool supports_banded_decode() const override;
+
     protected:
         bool is_recognized_impl(io::File &input_file) const override;
         res::Image decode_impl(
             const Logger &logger, io::File &input_file) const override;
+        void decode_banded_impl(
+            const Logger &logger,
+            io::File &input_file,
+            ImageBandSink &sink) const override;
     };
 
 } } }
@@ -150,7 +150,7 @@ static std::unique_ptr<DdsHeaderDx10> read_header_dx10(
 
 bool DdsImageDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 res::Image DdsImageDecoder::decode_impl(
@@ -16,6 +16,7 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "dec/microsoft/dxt/dxt_decoders.h"
+#include <cstring>
 #include "algo/range.h"
 
 using namespace au;
@@ -27,13 +28,11 @@ static std::unique_ptr<res::Image> create_image(
 }
 
 static void decode_dxt1_block(
-    io::BaseByteStream &input_stream, res::Pixel output_colors[4][4])
+    const u8 *input_ptr, res::Pixel output_colors[4][4])
 {
     res::Pixel colors[4];
-    const auto tmp = input_stream.read(4);
-    const auto *tmp_ptr = tmp.get<const u8>();
-    colors[0] = res::read_pixel<res::PixelFormat::BGR565>(tmp_ptr);
-    colors[1] = res::read_pixel<res::PixelFormat::BGR565>(tmp_ptr);
+    colors[0] = res::read_pixel<res::PixelFormat::BGR565>(input_ptr);
+    colors[1] = res::read_pixel<res::PixelFormat::BGR565>(input_ptr);
     const auto transparent
         = colors[0].b <= colors[1].b
         && colors[0].g <= colors[1].g
@@ -54,7 +53,11 @@ static void decode_dxt1_block(
         }
     }
 
-    auto lookup = input_stream.read_le<u32>();
+    u32 lookup
+        = input_ptr[0]
+        | (input_ptr[1] << 8)
+        | (input_ptr[2] << 16)
+        | (input_ptr[3] << 24);
     for (const auto y : algo::range(4))
     for (const auto x : algo::range(4))
     {
@@ -64,12 +67,11 @@ static void decode_dxt1_block(
     }
 }
 
-static void decode_dxt5_block(
-    io::BaseByteStream &input_stream, u8 output_alpha[4][4])
+static void decode_dxt5_block(const u8 *input_ptr, u8 output_alpha[4][4])
 {
     u8 alpha[8];
-    alpha[0] = input_stream.read<u8>();
-    alpha[1] = input_stream.read<u8>();
+    alpha[0] = input_ptr[0];
+    alpha[1] = input_ptr[1];
 
     if (alpha[0] > alpha[1])
     {
@@ -86,9 +88,10 @@ static void decode_dxt5_block(
 
     for (const auto i : algo::range(2))
     {
-        u32 lookup = input_stream.read<u8>();
-        lookup |= input_stream.read<u8>() << 8;
-        lookup |= input_stream.read<u8>() << 16;
+        u32 lookup
+            = input_ptr[2 + i * 3]
+            | (input_ptr[3 + i * 3] << 8)
+            | (input_ptr[4 + i * 3] << 16);
         for (const auto j : algo::range(8))
         {
             const auto index = lookup & 7;
@@ -101,18 +104,35 @@ static void decode_dxt5_block(
     }
 }
 
+// Padded block rows always fit inside the image, so decoded 4x4 tiles can
+// be written as flat row spans through the raw Grid rows.
+static void write_block(
+    res::Image &image,
+    const size_t block_x,
+    const size_t block_y,
+    const res::Pixel colors[4][4])
+{
+    for (const auto y : algo::range(4))
+    {
+        std::memcpy(
+            image.row(block_y + y) + block_x,
+            colors[y],
+            4 * sizeof(res::Pixel));
+    }
+}
+
 std::unique_ptr<res::Image> dec::microsoft::dxt::decode_dxt1(
     io::BaseByteStream &input_stream, size_t width, size_t height)
 {
     auto image = create_image(width, height);
+    u8 block[8];
     for (const auto block_y : algo::range(0, height, 4))
     for (const auto block_x : algo::range(0, width, 4))
     {
+        input_stream.read(block, sizeof(block));
         res::Pixel colors[4][4];
-        decode_dxt1_block(input_stream, colors);
-        for (const auto y : algo::range(4))
-        for (const auto x : algo::range(4))
-            image->at(block_x + x, block_y + y) = colors[y][x];
+        decode_dxt1_block(block, colors);
+        write_block(*image, block_x, block_y, colors);
     }
     return image;
 }
@@ -121,26 +141,28 @@ std::unique_ptr<res::Image> dec::microsoft::dxt::decode_dxt3(
     io::BaseByteStream &input_stream, size_t width, size_t height)
 {
     auto image = create_image(width, height);
+    u8 block[16];
     for (const auto block_y : algo::range(0, height, 4))
     for (const auto block_x : algo::range(0, width, 4))
     {
+        input_stream.read(block, sizeof(block));
+
         u8 alpha[4][4];
+        auto alpha_ptr = block;
         for (const auto y : algo::range(4))
         for (const auto x : algo::range(0, 4, 2))
         {
-            const auto b = input_stream.read<u8>();
+            const auto b = *alpha_ptr++;
             alpha[y][x + 0] = b & 0xF0;
             alpha[y][x + 1] = (b & 0x0F) << 4;
         }
 
         res::Pixel colors[4][4];
-        decode_dxt1_block(input_stream, colors);
+        decode_dxt1_block(block + 8, colors);
         for (const auto y : algo::range(4))
         for (const auto x : algo::range(4))
-        {
             colors[y][x].a = alpha[y][x];
-            image->at(block_x + x, block_y + y) = colors[y][x];
-        }
+        write_block(*image, block_x, block_y, colors);
     }
     return image;
 }
@@ -149,20 +171,21 @@ std::unique_ptr<res::Image> dec::microsoft::dxt::decode_dxt5(
     io::BaseByteStream &input_stream, size_t width, size_t height)
 {
     auto image = create_image(width, height);
+    u8 block[16];
     for (const auto block_y : algo::range(0, height, 4))
     for (const auto block_x : algo::range(0, width, 4))
     {
+        input_stream.read(block, sizeof(block));
+
         u8 alpha[4][4];
-        decode_dxt5_block(input_stream, alpha);
+        decode_dxt5_block(block, alpha);
 
         res::Pixel colors[4][4];
-        decode_dxt1_block(input_stream, colors);
+        decode_dxt1_block(block + 8, colors);
         for (const auto y : algo::range(4))
         for (const auto x : algo::range(4))
-        {
             colors[y][x].a = alpha[y][x];
-            image->at(block_x + x, block_y + y) = colors[y][x];
-        }
+        write_block(*image, block_x, block_y, colors);
     }
     return image;
 }
@@ -193,13 +193,15 @@ namespace
             const RvaHelper &rva_helper,
             const uoff_t base_offset,
             io::BaseByteStream &input_stream,
-            dec::ArchiveMeta &meta);
+            dec::ArchiveMeta &meta,
+            const dec::BaseArchiveDecoder::EntryFilter &entry_filter);
 
         const Logger &logger;
         const RvaHelper &rva_helper;
         const uoff_t base_offset;
         io::BaseByteStream &input_stream;
         dec::ArchiveMeta &meta;
+        const dec::BaseArchiveDecoder::EntryFilter &entry_filter;
     };
 
     class ResourceCrawler final
@@ -407,12 +409,14 @@ ResourceCrawlerArgs::ResourceCrawlerArgs(
     const RvaHelper &helper,
     const uoff_t base_offset,
     io::BaseByteStream &input_stream,
-    dec::ArchiveMeta &meta) :
+    dec::ArchiveMeta &meta,
+    const dec::BaseArchiveDecoder::EntryFilter &entry_filter) :
         logger(logger),
         rva_helper(helper),
         base_offset(base_offset),
         input_stream(input_stream),
-        meta(meta)
+        meta(meta),
+        entry_filter(entry_filter)
 {
 }
 
@@ -445,9 +449,18 @@ void ResourceCrawler::process_dir(const uoff_t offset, const std::string path)
                     entry_path = path + path_sep + entry_path;
 
                 if (entry.data_is_dir)
+                {
                     process_dir(entry.offset_to_data, entry_path);
+                }
                 else
+                {
+                    // rejected leaves are dropped right here - their data
+                    // entries are never seeked to and nothing is allocated
+                    // for them
+                    if (args.entry_filter && !args.entry_filter(entry_path))
+                        return;
                     process_entry(entry.offset_to_data, entry_path);
+                }
             });
         }
         catch (const std::exception &e)
@@ -517,6 +530,14 @@ bool ExeArchiveDecoder::is_recognized_impl(io::File &input_file) const
 
 std::unique_ptr<dec::ArchiveMeta> ExeArchiveDecoder::read_meta_impl(
     const Logger &logger, io::File &input_file) const
+{
+    return read_meta_impl(logger, input_file, EntryFilter());
+}
+
+std::unique_ptr<dec::ArchiveMeta> ExeArchiveDecoder::read_meta_impl(
+    const Logger &logger,
+    io::File &input_file,
+    const EntryFilter &entry_filter) const
 {
     DosHeader dos_header(input_file.stream);
     input_file.stream.seek(dos_header.e_lfanew);
@@ -546,7 +567,8 @@ std::unique_ptr<dec::ArchiveMeta> ExeArchiveDecoder::read_meta_impl(
         = rva_helper.rva_to_offset(resource_dir.virtual_address);
     auto meta = std::make_unique<ArchiveMeta>();
     ResourceCrawler::crawl(ResourceCrawlerArgs(
-        logger, rva_helper, base_offset, input_file.stream, *meta));
+        logger, rva_helper, base_offset, input_file.stream, *meta,
+        entry_filter));
 
     soff_t extra_data_offset = -1;
     for (const auto &section : sections)
@@ -556,7 +578,8 @@ std::unique_ptr<dec::ArchiveMeta> ExeArchiveDecoder::read_meta_impl(
         extra_data_offset = std::max(section_end, extra_data_offset);
     }
     const auto extra_data_size = input_file.stream.size() - extra_data_offset;
-    if (extra_data_offset != -1 && extra_data_size > 0)
+    if (extra_data_offset != -1 && extra_data_size > 0
+        && (!entry_filter || entry_filter("extra_data")))
     {
         auto entry = std::make_unique<dec::PlainArchiveEntry>();
         entry->path = "extra_data";
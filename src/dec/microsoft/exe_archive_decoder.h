@@ -32,6 +32,11 @@ namespace microsoft {
             const Logger &logger,
             io::File &input_file) const override;
 
+        std::unique_ptr<ArchiveMeta> read_meta_impl(
+            const Logger &logger,
+            io::File &input_file,
+            const EntryFilter &entry_filter) const override;
+
         std::unique_ptr<io::File> read_file_impl(
             const Logger &logger,
             io::File &input_file,
@@ -69,7 +69,7 @@ static bstr decompress_table(const bstr &input, size_t output_size)
 
 bool PacArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> PacArchiveDecoder::read_meta_impl(
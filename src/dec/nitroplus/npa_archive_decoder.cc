@@ -45,6 +45,7 @@ namespace
     struct CustomArchiveEntry final : dec::CompressedArchiveEntry
     {
         bstr path_orig;
+        u8 data_key;
     };
 
     struct TableEntry final
@@ -54,9 +55,8 @@ namespace
 }
 
 static void decrypt_file_name(
-    const CustomArchiveMeta &meta, bstr &name, size_t file_index)
+    const u32 tmp, bstr &name, size_t file_index)
 {
-    u32 tmp = meta.plugin->file_name_key(meta.key1, meta.key2);
     for (const auto char_pos : algo::range(name.size()))
     {
         u32 key = 0xFC * char_pos;
@@ -72,8 +72,8 @@ static void decrypt_file_name(
     }
 }
 
-static void decrypt_file_data(
-    const CustomArchiveMeta &meta, const CustomArchiveEntry &entry, bstr &data)
+static u8 derive_data_key(
+    const CustomArchiveMeta &meta, const CustomArchiveEntry &entry)
 {
     u32 key = meta.plugin->data_key;
     for (const auto i : algo::range(entry.path_orig.size()))
@@ -81,17 +81,27 @@ static void decrypt_file_data(
     key *= entry.path_orig.size();
     key += meta.key1 * meta.key2;
     key *= entry.size_orig;
-    key &= 0xFF;
+    return key & 0xFF;
+}
+
+static void decrypt_file_data(
+    const CustomArchiveMeta &meta, const CustomArchiveEntry &entry, bstr &data)
+{
+    // folding the per-entry key into the permutation leaves only one table
+    // lookup and one subtraction per byte
+    u8 table[256];
+    for (const auto i : algo::range(256))
+        table[i] = meta.plugin->permutation[i] - entry.data_key;
 
     u8 *data_ptr = data.get<u8>();
     const auto size = 0x1000 + entry.path_orig.size();
     for (const auto i : algo::range(std::min(size, data.size())))
-        data_ptr[i] = meta.plugin->permutation[data_ptr[i]] - key - i;
+        data_ptr[i] = table[data_ptr[i]] - i;
 }
 
 bool NpaArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> NpaArchiveDecoder::read_meta_impl(
@@ -112,13 +122,14 @@ std::unique_ptr<dec::ArchiveMeta> NpaArchiveDecoder::read_meta_impl(
     const auto table_size = input_file.stream.read_le<u32>();
     const auto data_offset = input_file.stream.pos() + table_size;
 
+    const auto name_key = meta->plugin->file_name_key(meta->key1, meta->key2);
     for (const auto i : algo::range(total_entry_count))
     {
         auto entry = std::make_unique<CustomArchiveEntry>();
 
         const auto name_size = input_file.stream.read_le<u32>();
         entry->path_orig = input_file.stream.read(name_size);
-        decrypt_file_name(*meta, entry->path_orig, i);
+        decrypt_file_name(name_key, entry->path_orig, i);
         entry->path = algo::sjis_to_utf8(entry->path_orig).str();
 
         const auto entry_type = input_file.stream.read<EntryType>();
@@ -127,6 +138,7 @@ std::unique_ptr<dec::ArchiveMeta> NpaArchiveDecoder::read_meta_impl(
         entry->offset = input_file.stream.read_le<u32>() + data_offset;
         entry->size_comp = input_file.stream.read_le<u32>();
         entry->size_orig = input_file.stream.read_le<u32>();
+        entry->data_key = derive_data_key(*meta, *entry);
 
         if (entry_type == EntryType::Directory)
             continue;
@@ -56,7 +56,7 @@ static bstr decrypt(const bstr &input, const CustomArchiveMeta &meta)
 
 bool Npk2ArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.seek(0).read(magic.size()) == magic;
+    return input_file.stream.seek(0).matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> Npk2ArchiveDecoder::read_meta_impl(
@@ -17,20 +17,18 @@
 
 #include "dec/nscripter/nsa_encrypted_stream.h"
 #include <array>
-#include <cstring>
 #include "algo/binary.h"
 #include "algo/crypt/hmac.h"
 #include "algo/crypt/md5.h"
 #include "algo/crypt/sha1.h"
 #include "algo/range.h"
-#include "err.h"
 
 using namespace au;
 using namespace au::dec::nscripter;
 
-static const auto block_size = 1024;
+static const auto nsa_block_size = 1024;
 
-static void transform_block(const bstr &key, size_t block_num, bstr &block)
+static void transform_block(const bstr &key, uoff_t block_num, bstr &block)
 {
     bstr bn(8);
 
@@ -77,73 +75,23 @@ static void transform_block(const bstr &key, size_t block_num, bstr &block)
     }
 }
 
-NsaEncryptedStream::NsaEncryptedStream(
-    io::BaseByteStream &parent_stream, const bstr &key)
-    : parent_stream(parent_stream.clone()), key(key)
-{
-}
-
-NsaEncryptedStream::~NsaEncryptedStream()
-{
-}
-
-void NsaEncryptedStream::seek_impl(const uoff_t offset)
-{
-    parent_stream->seek(offset);
-}
-
-void NsaEncryptedStream::read_impl(void *destination, const size_t size)
+static io::BlockTransformByteStream::Transform make_transform(const bstr &key)
 {
     if (key.empty())
+        return io::BlockTransformByteStream::Transform();
+    return [key](const uoff_t block_num, bstr &block)
     {
-        const auto chunk = parent_stream->read(size);
-        std::memcpy(destination, chunk.get<u8>(), size);
-        return;
-    }
-
-    const auto orig_pos = parent_stream->pos();
-    const auto padded_pos = orig_pos & ~(block_size - 1);
-    const auto offset_pad = orig_pos % block_size;
-    parent_stream->seek(padded_pos);
-
-    bstr full_buffer;
-    while (full_buffer.size() < size + offset_pad)
-    {
-        const auto block_num = parent_stream->pos() / block_size;
-        auto block = parent_stream->read(
-            std::min<uoff_t>(parent_stream->left(), block_size));
         transform_block(key, block_num, block);
-        full_buffer += block;
-    }
-    if (full_buffer.size() < size)
-        throw err::BadDataSizeError();
-    std::memcpy(destination, full_buffer.get<const u8>() + offset_pad, size);
-    parent_stream->seek(orig_pos + size);
-}
-
-void NsaEncryptedStream::write_impl(const void *source, const size_t size)
-{
-    throw err::NotSupportedError("Not implemented");
-}
-
-uoff_t NsaEncryptedStream::pos() const
-{
-    return parent_stream->pos();
-}
-
-uoff_t NsaEncryptedStream::size() const
-{
-    return parent_stream->size();
+    };
 }
 
-void NsaEncryptedStream::resize_impl(const uoff_t new_size)
+NsaEncryptedStream::NsaEncryptedStream(
+    io::BaseByteStream &parent_stream, const bstr &key)
+    : io::BlockTransformByteStream(
+        parent_stream, nsa_block_size, make_transform(key))
 {
-    parent_stream->resize(new_size);
 }
 
-std::unique_ptr<io::BaseByteStream> NsaEncryptedStream::clone() const
+NsaEncryptedStream::~NsaEncryptedStream()
 {
-    auto ret = std::make_unique<NsaEncryptedStream>(*parent_stream, key);
-    ret->seek(pos());
-    return std::move(ret);
 }
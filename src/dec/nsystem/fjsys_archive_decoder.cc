@@ -25,7 +25,7 @@ static const bstr magic = "FJSYS\x00\x00\x00"_b;
 
 bool FjsysArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> FjsysArchiveDecoder::read_meta_impl(
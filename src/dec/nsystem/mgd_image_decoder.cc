@@ -236,7 +236,7 @@ static res::Image read_image(
 
 bool MgdImageDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 res::Image MgdImageDecoder::decode_impl(
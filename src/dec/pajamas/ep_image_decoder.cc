@@ -26,7 +26,7 @@ static const auto magic = "EP"_b;
 
 bool EpImageDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.seek(0).read(magic.size()) == magic;
+    return input_file.stream.seek(0).matches(magic);
 }
 
 res::Image EpImageDecoder::decode_impl(
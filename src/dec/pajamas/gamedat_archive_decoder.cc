@@ -36,7 +36,7 @@ static const auto get_version(io::BaseByteStream &input_stream)
 
 bool GamedatArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.seek(0).read(magic.size()) == magic;
+    return input_file.stream.seek(0).matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> GamedatArchiveDecoder::read_meta_impl(
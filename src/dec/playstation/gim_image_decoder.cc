@@ -164,7 +164,7 @@ static std::unique_ptr<res::Image> read_image(
 
 bool GimImageDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 res::Image GimImageDecoder::decode_impl(
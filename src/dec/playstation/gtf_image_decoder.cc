@@ -18,6 +18,7 @@
 #include "dec/playstation/gtf_image_decoder.h"
 #include "algo/range.h"
 #include "dec/microsoft/dxt/dxt_decoders.h"
+#include "dec/playstation/swizzle.h"
 #include "err.h"
 
 using namespace au;
@@ -140,7 +141,37 @@ res::Image GtfImageDecoder::decode_impl(
     if (format == CellGcmTextureType::CompressedDxt45)
         return *decode_dxt5(input_file.stream, spec.width, spec.height);
 
-    throw err::NotSupportedError("Only DXT-packed textures are supported");
+    // raw formats carry the CELL_GCM_TEXTURE_LN bit when stored in
+    // scanline order; without it the RSX keeps them in morton order
+    const bool linear = (spec.flags & 0x20) != 0;
+
+    if (format == CellGcmTextureType::B8)
+    {
+        auto data = input_file.stream.read(spec.width * spec.height);
+        if (!linear)
+            data = deswizzle_morton(data, spec.width, spec.height, 1);
+        return res::Image(
+            spec.width, spec.height, data, res::PixelFormat::Gray8);
+    }
+
+    if (format == CellGcmTextureType::A8R8G8B8)
+    {
+        auto data = input_file.stream.read(spec.width * spec.height * 4);
+        if (!linear)
+            data = deswizzle_morton(data, spec.width, spec.height, 4);
+        // A,R,G,B byte order reversed in place is exactly BGRA
+        auto *ptr = data.get<u8>();
+        for (const auto i : algo::range(spec.width * spec.height))
+        {
+            std::swap(ptr[0], ptr[3]);
+            std::swap(ptr[1], ptr[2]);
+            ptr += 4;
+        }
+        return res::Image(
+            spec.width, spec.height, data, res::PixelFormat::BGRA8888);
+    }
+
+    throw err::NotSupportedError("Unsupported texture format");
 }
 
 static auto _ = dec::register_decoder<GtfImageDecoder>("playstation/gtf");
@@ -17,6 +17,7 @@
 
 #include "dec/playstation/gxt_image_archive_decoder.h"
 #include "algo/range.h"
+#include "dec/playstation/swizzle.h"
 #include "enc/png/png_image_encoder.h"
 #include "err.h"
 
@@ -64,7 +65,7 @@ algo::NamingStrategy GxtImageArchiveDecoder::naming_strategy() const
 
 bool GxtImageArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.seek(0).read(magic.size()) == magic;
+    return input_file.stream.seek(0).matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> GxtImageArchiveDecoder::read_meta_impl(
@@ -111,10 +112,16 @@ std::unique_ptr<io::File> GxtImageArchiveDecoder::read_file_impl(
 
     if (entry->palette_index != -1)
         throw err::NotSupportedError("Paletted entries are not supported");
-    if (entry->texture_type != TextureType::Linear)
-        throw err::NotSupportedError("Only linear textures are supported");
+    if (entry->texture_type != TextureType::Linear
+        && entry->texture_type != TextureType::Swizzled)
+    {
+        throw err::NotSupportedError(
+            "Only linear and swizzled textures are supported");
+    }
 
-    const auto data = input_file.stream.seek(entry->offset).read(entry->size);
+    auto data = input_file.stream.seek(entry->offset).read(entry->size);
+    if (entry->texture_type == TextureType::Swizzled)
+        data = deswizzle_morton(data, entry->width, entry->height, 1);
     res::Image image(
         entry->width, entry->height, data, res::PixelFormat::Gray8);
     const auto encoder = enc::png::PngImageEncoder();
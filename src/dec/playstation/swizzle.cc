@@ -0,0 +1,180 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "dec/playstation/swizzle.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include "algo/cpu.h"
+#include "err.h"
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#endif
+
+using namespace au;
+using namespace au::dec::playstation;
+
+static bool is_power_of_two(const size_t value)
+{
+    return value && !(value & (value - 1));
+}
+
+// spreads the bits of value over the even bit positions
+static u32 part1by1(u32 value)
+{
+    value &= 0x0000FFFF;
+    value = (value | (value << 8)) & 0x00FF00FF;
+    value = (value | (value << 4)) & 0x0F0F0F0F;
+    value = (value | (value << 2)) & 0x33333333;
+    value = (value | (value << 1)) & 0x55555555;
+    return value;
+}
+
+// gather one output row: out[x] = in[base + x_off[x]], offsets in bytes
+template<typename T> static void gather_row(
+    u8 *out, const u8 *in, const u32 *x_off, const size_t width)
+{
+    auto *typed_out = reinterpret_cast<T*>(out);
+    for (size_t x = 0; x < width; x++)
+        typed_out[x] = *reinterpret_cast<const T*>(in + x_off[x]);
+}
+
+static void gather_rows_scalar(
+    u8 *out,
+    const u8 *in,
+    const u32 *x_off,
+    const u32 *y_off,
+    const size_t width,
+    const size_t height,
+    const size_t bytes_per_pixel)
+{
+    for (size_t y = 0; y < height; y++)
+    {
+        const u8 *row_in = in + y_off[y];
+        if (bytes_per_pixel == 1)
+            gather_row<u8>(out, row_in, x_off, width);
+        else if (bytes_per_pixel == 2)
+            gather_row<u16>(out, row_in, x_off, width);
+        else if (bytes_per_pixel == 4)
+            gather_row<u32>(out, row_in, x_off, width);
+        else if (bytes_per_pixel == 8)
+            gather_row<u64>(out, row_in, x_off, width);
+        else
+        {
+            for (size_t x = 0; x < width; x++)
+            {
+                std::memcpy(
+                    out + x * bytes_per_pixel,
+                    row_in + x_off[x],
+                    bytes_per_pixel);
+            }
+        }
+        out += width * bytes_per_pixel;
+    }
+}
+
+#if defined(__AVX2__)
+static void gather_rows_avx2(
+    u8 *out,
+    const u8 *in,
+    const u32 *x_off,
+    const u32 *y_off,
+    const size_t width,
+    const size_t height,
+    const size_t bytes_per_pixel)
+{
+    if (bytes_per_pixel != 4)
+    {
+        gather_rows_scalar(out, in, x_off, y_off, width, height,
+            bytes_per_pixel);
+        return;
+    }
+    const size_t simd_width = width & ~size_t(7);
+    for (size_t y = 0; y < height; y++)
+    {
+        const u8 *row_in = in + y_off[y];
+        auto *typed_out = reinterpret_cast<u32*>(out);
+        for (size_t x = 0; x < simd_width; x += 8)
+        {
+            const auto offsets = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(x_off + x));
+            const auto pixels = _mm256_i32gather_epi32(
+                reinterpret_cast<const int*>(row_in), offsets, 1);
+            _mm256_storeu_si256(
+                reinterpret_cast<__m256i*>(typed_out + x), pixels);
+        }
+        for (size_t x = simd_width; x < width; x++)
+            typed_out[x] = *reinterpret_cast<const u32*>(row_in + x_off[x]);
+        out += width * 4;
+    }
+}
+#endif
+
+using GatherRowsFn = void (*)(
+    u8*, const u8*, const u32*, const u32*, size_t, size_t, size_t);
+
+static const algo::CpuDispatch<GatherRowsFn> gather_rows_dispatch =
+{
+    gather_rows_scalar,
+    nullptr,
+#if defined(__AVX2__)
+    gather_rows_avx2,
+#endif
+};
+
+bstr dec::playstation::deswizzle_morton(
+    const bstr &input,
+    const size_t width,
+    const size_t height,
+    const size_t bytes_per_pixel)
+{
+    if (!is_power_of_two(width) || !is_power_of_two(height))
+        throw err::NotSupportedError(
+            "Swizzled non-power-of-two textures are not supported");
+    if (input.size() < width * height * bytes_per_pixel)
+        throw err::BadDataSizeError();
+
+    // bits below the square interleave pairwise; the excess bits of the
+    // longer axis address whole min*min squares laid out linearly
+    const size_t min_dim = std::min(width, height);
+    const size_t square = min_dim * min_dim;
+
+    std::vector<u32> x_off(width);
+    for (size_t x = 0; x < width; x++)
+    {
+        x_off[x] = (part1by1(x & (min_dim - 1))
+            + (x / min_dim) * square) * bytes_per_pixel;
+    }
+    std::vector<u32> y_off(height);
+    for (size_t y = 0; y < height; y++)
+    {
+        y_off[y] = ((part1by1(y & (min_dim - 1)) << 1)
+            + (y / min_dim) * square) * bytes_per_pixel;
+    }
+
+    bstr output(width * height * bytes_per_pixel);
+    gather_rows_dispatch.choose()(
+        output.get<u8>(),
+        input.get<const u8>(),
+        x_off.data(),
+        y_off.data(),
+        width,
+        height,
+        bytes_per_pixel);
+    return output;
+}
@@ -0,0 +1,40 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "types.h"
+
+namespace au {
+namespace dec {
+namespace playstation {
+
+    // Rearranges a morton-order (Z-order) texture into scanline order.
+    // Both dimensions must be powers of two; for non-square textures the
+    // excess bits of the longer axis stay linear above the interleaved
+    // square, matching how the PlayStation GPUs tile such layouts.
+    //
+    // The morton address is separable, so the kernel precomputes one
+    // offset table per axis and the per-pixel work reduces to a table
+    // lookup, an add and a gather of bytes_per_pixel bytes.
+    bstr deswizzle_morton(
+        const bstr &input,
+        const size_t width,
+        const size_t height,
+        const size_t bytes_per_pixel);
+
+} } }
@@ -16,6 +16,7 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "dec/png/png_image_decoder.h"
+#include <algorithm>
 #include <cstring>
 #include <png.h>
 #include "algo/range.h"
@@ -26,6 +27,10 @@ using namespace au::dec::png;
 
 static const bstr magic = "\x89PNG"_b;
 
+// enough rows for the deflate window to stay effective, small enough to
+// keep a band of a 16k-wide atlas around a dozen megabytes
+static const size_t band_row_count = 256;
+
 static void read_handler(png_structp png_ptr, png_bytep output, png_size_t size)
 {
     auto input_stream
@@ -116,7 +121,103 @@ static res::Image decode(
 
 bool PngImageDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
+}
+
+bool PngImageDecoder::supports_banded_decode() const
+{
+    return true;
+}
+
+void PngImageDecoder::decode_banded_impl(
+    const Logger &logger, io::File &input_file, dec::ImageBandSink &sink) const
+{
+    png_structp png_ptr = png_create_read_struct(
+        PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+    if (!png_ptr)
+        throw std::logic_error("Failed to create PNG read structure");
+
+    png_infop info_ptr = png_create_info_struct(png_ptr);
+    if (!info_ptr)
+        throw std::logic_error("Failed to create PNG info structure");
+
+    png_set_error_fn(
+        png_ptr,
+        png_get_error_ptr(png_ptr),
+        [](png_structp png_ptr, png_const_charp error_msg)
+        {
+            throw err::CorruptDataError(error_msg);
+        },
+        [](png_structp png_ptr, png_const_charp warning_msg)
+        {
+            Logger logger;
+            logger.warn("libpng warning: %s\n", warning_msg);
+        });
+
+    png_set_read_fn(png_ptr, &input_file.stream, &read_handler);
+    png_read_info(png_ptr, info_ptr);
+
+    // the same transformations the whole-image path requests
+    png_set_gray_to_rgb(png_ptr);
+    png_set_strip_16(png_ptr);
+    png_set_packing(png_ptr);
+    png_set_bgr(png_ptr);
+    png_set_expand(png_ptr);
+    const auto pass_count = png_set_interlace_handling(png_ptr);
+    png_read_update_info(png_ptr, info_ptr);
+
+    const size_t width = png_get_image_width(png_ptr, info_ptr);
+    const size_t height = png_get_image_height(png_ptr, info_ptr);
+    const auto bits_per_channel = png_get_bit_depth(png_ptr, info_ptr);
+    if (bits_per_channel != 8)
+        throw err::UnsupportedBitDepthError(bits_per_channel);
+
+    const size_t channels = png_get_channels(png_ptr, info_ptr);
+    res::PixelFormat format;
+    if (channels == 3)
+        format = res::PixelFormat::BGR888;
+    else if (channels == 4)
+        format = res::PixelFormat::BGRA8888;
+    else if (channels == 1)
+        format = res::PixelFormat::Gray8;
+    else
+        throw err::NotSupportedError("Bad pixel format");
+
+    sink.start(width, height);
+
+    const auto scanline_size = width * channels;
+    if (pass_count > 1)
+    {
+        // interlaced rows arrive out of order, so the whole image has to
+        // be assembled before it can be handed over
+        bstr data(scanline_size * height);
+        for (int pass = 0; pass < pass_count; pass++)
+        {
+            for (const auto y : algo::range(height))
+            {
+                png_read_row(
+                    png_ptr, data.get<u8>() + y * scanline_size, nullptr);
+            }
+        }
+        sink.band(res::Image(width, height, data, format));
+    }
+    else
+    {
+        size_t y = 0;
+        while (y < height)
+        {
+            const auto band_height = std::min(band_row_count, height - y);
+            bstr data(scanline_size * band_height);
+            for (const auto band_y : algo::range(band_height))
+            {
+                png_read_row(
+                    png_ptr, data.get<u8>() + band_y * scanline_size, nullptr);
+            }
+            sink.band(res::Image(width, band_height, data, format));
+            y += band_height;
+        }
+    }
+    png_destroy_read_struct(&png_ptr, &info_ptr, nullptr);
 }
 
 res::Image PngImageDecoder::decode_impl(
@@ -35,10 +35,16 @@ namespace png {
             io::File &input_file,
             ChunkHandler chunk_handler) const;
 
+        bool supports_banded_decode() const override;
+
     protected:
         bool is_recognized_impl(io::File &input_file) const override;
         res::Image decode_impl(
             const Logger &logger, io::File &input_file) const override;
+        void decode_banded_impl(
+            const Logger &logger,
+            io::File &input_file,
+            ImageBandSink &sink) const override;
     };
 
 } } }
@@ -174,26 +174,34 @@ void cpz5::decrypt_2(
         target[i] = table[target[i] ^ permutation_xor];
 }
 
-void cpz5::decrypt_3(
-    algo::ptr<u8> target,
+cpz5::Crypt3State cpz5::prepare_crypt_3(
     const Plugin &plugin,
     const u32 key,
     const u32 seed,
-    const std::array<u32, 4> &hash,
-    const u32 entry_key)
+    const std::array<u32, 4> &hash)
 {
-    const auto table
-        = get_table_for_crypt_2_and_3(plugin, key, seed);
-
-    u32 yet_another_table[24];
+    Crypt3State state;
+    state.table = get_table_for_crypt_2_and_3(plugin, key, seed);
     for (const auto i : algo::range(96))
     {
-        reinterpret_cast<u8*>(yet_another_table)[i]
-            = table[plugin.secret[i]] ^ (hash[1] >> 2);
+        reinterpret_cast<u8*>(state.secret_table.data())[i]
+            = state.table[plugin.secret[i]] ^ (hash[1] >> 2);
     }
+    return state;
+}
 
+void cpz5::decrypt_3(
+    algo::ptr<u8> target,
+    const Plugin &plugin,
+    const Crypt3State &state,
+    const std::array<u32, 4> &hash,
+    const u32 entry_key)
+{
+    const auto &table = state.table;
+
+    u32 yet_another_table[24];
     for (const auto i : algo::range(24))
-        yet_another_table[i] ^= entry_key;
+        yet_another_table[i] = state.secret_table[i] ^ entry_key;
 
     size_t yet_another_table_pos = plugin.crypt_3.start_pos;
     u32 yet_another_key = 0x2547A39E;
@@ -48,11 +48,26 @@ namespace cpz5 {
         const u32 seed,
         const u8 permutation_xor);
 
-    void decrypt_3(
-        algo::ptr<u8> target,
+    // Archive-level state for decrypt_3. The permutation table and the
+    // secret-derived table depend only on per-archive keys, so they are
+    // built once per archive and reused for every entry; only the
+    // entry-key mixing remains per entry.
+    struct Crypt3State final
+    {
+        std::array<u8, 256> table;
+        std::array<u32, 24> secret_table;
+    };
+
+    Crypt3State prepare_crypt_3(
         const Plugin &plugin,
         const u32 key,
         const u32 seed,
+        const std::array<u32, 4> &hash);
+
+    void decrypt_3(
+        algo::ptr<u8> target,
+        const Plugin &plugin,
+        const Crypt3State &state,
         const std::array<u32, 4> &hash,
         const u32 entry_key);
 
@@ -50,6 +50,7 @@ namespace
         cpz5::Plugin plugin;
         u32 main_key;
         std::array<u32, 4> hash;
+        cpz5::Crypt3State crypt3;
     };
 
     struct CustomArchiveEntry final : dec::PlainArchiveEntry
@@ -119,6 +120,11 @@ static std::unique_ptr<CustomArchiveMeta> read_meta(
     meta->plugin = plugin;
     meta->main_key = header.main_key;
     meta->hash = hash;
+    // the entry decryption tables derive from per-archive keys only, so
+    // build them once here instead of per entry - the entries are small
+    // and the table setup used to dwarf the payload work
+    meta->crypt3 = cpz5::prepare_crypt_3(
+        plugin, hash[3], header.main_key, hash);
 
     for (const auto &dir : dirs)
     {
@@ -211,12 +217,19 @@ Cpz5ArchiveDecoder::~Cpz5ArchiveDecoder()
 {
 }
 
+bool Cpz5ArchiveDecoder::entries_are_independent() const
+{
+    // decryption works on each entry's own bytes with the immutable
+    // archive-level tables, so the small entries can decode concurrently
+    return true;
+}
+
 bool Cpz5ArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
     if (p->version == 5)
-        return input_file.stream.seek(0).read(magic5.size()) == magic5;
+        return input_file.stream.seek(0).matches(magic5);
     else if (p->version == 6)
-        return input_file.stream.seek(0).read(magic6.size()) == magic6;
+        return input_file.stream.seek(0).matches(magic6);
     else
         throw std::logic_error("Bad version");
 }
@@ -278,8 +291,7 @@ std::unique_ptr<io::File> Cpz5ArchiveDecoder::read_file_impl(
     cpz5::decrypt_3(
         algo::make_ptr(data),
         meta->plugin,
-        meta->hash[3],
-        meta->main_key,
+        meta->crypt3,
         meta->hash,
         entry->key);
 
@@ -29,6 +29,8 @@ namespace purple_software {
         Cpz5ArchiveDecoder(const size_t version);
         ~Cpz5ArchiveDecoder();
 
+        bool entries_are_independent() const override;
+
         std::vector<std::string> get_linked_formats() const override;
 
     protected:
@@ -16,6 +16,7 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "dec/purple_software/jbp1.h"
+#include <algorithm>
 #include <array>
 #include "algo/range.h"
 #include "err.h"
@@ -72,19 +73,33 @@ CustomBitStream::CustomBitStream(const bstr &input) : io::BaseBitStream(input)
 
 u32 CustomBitStream::read(const size_t bits)
 {
-    u32 ret = 0;
-    for (const auto i : algo::range(bits))
+    // the stream is always owned here, so the 64-bit cache can be topped
+    // up several bytes at a time; the bits still leave the buffer
+    // low-bit-first to preserve the reversed bit order of the format
+    if (bits_available < bits)
     {
-        if (!bits_available)
+        const auto bytes_left = input_stream->size() - input_stream->pos();
+        const auto bytes_wanted = std::min<uoff_t>(
+            (64 - bits_available) / 8, bytes_left);
+        if (bits_available + bytes_wanted * 8 < bits)
+            throw err::EofError();
+        u8 chunk[8];
+        input_stream->read(chunk, bytes_wanted);
+        for (const auto i : algo::range(bytes_wanted))
         {
-            buffer = input_stream->read<u8>();
-            bits_available = 8;
+            buffer |= static_cast<u64>(chunk[i]) << bits_available;
+            bits_available += 8;
         }
+    }
+    u32 ret = 0;
+    for (const auto i : algo::range(bits))
+    {
         ret <<= 1;
         ret |= (buffer & 1);
         buffer >>= 1;
-        bits_available--;
     }
+    bits_available -= bits;
+    position += bits;
     return ret;
 }
 
@@ -242,6 +257,22 @@ static void dct(
 
     for (const auto i : algo::range(8))
     {
+        // rows with no AC coefficients collapse to their DC value
+        if (lp1[1] == 0 && lp1[2] == 0 && lp1[3] == 0 && lp1[4] == 0
+            && lp1[5] == 0 && lp1[6] == 0 && lp1[7] == 0)
+        {
+            lp1[0] =
+            lp1[1] =
+            lp1[2] =
+            lp1[3] =
+            lp1[4] =
+            lp1[5] =
+            lp1[6] =
+            lp1[7] = lp1[0] >> 3;
+            lp1 += 8;
+            continue;
+        }
+
         a = lp1[0];
         c = lp1[2];
         b = lp1[4];
@@ -414,7 +414,7 @@ static Header read_header(io::BaseByteStream &input_stream)
 
 bool Pb3ImageDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 res::Image Pb3ImageDecoder::decode_impl(
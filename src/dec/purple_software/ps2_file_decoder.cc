@@ -16,9 +16,8 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "dec/purple_software/ps2_file_decoder.h"
-#include <array>
 #include "algo/binary.h"
-#include "algo/ptr.h"
+#include "algo/pack/lzss_engine.h"
 #include "algo/range.h"
 
 using namespace au;
@@ -32,48 +31,25 @@ static void decrypt(bstr &data, const u32 key, const size_t shift)
         data[i] = algo::rotr<u8>((data[i] - 0x7C) ^ key, shift);
 }
 
-static bstr custom_lzss_decompress(const bstr &input, const size_t size_orig)
+namespace
 {
-    std::array<u8, 0x800> dict = {0};
-    auto dict_ptr = algo::make_cyclic_ptr(dict.data(), dict.size()) + 0x7DF;
-    bstr output(size_orig);
-    auto output_ptr = algo::make_ptr(output);
-    auto input_ptr = algo::make_ptr(input);
-    u16 control = 1;
-    while (output_ptr.left())
+    struct Ps2LzssSpec final
     {
-        if (control == 1)
-        {
-            if (!input_ptr.left()) break;
-            control = *input_ptr++ | 0x100;
-        }
-        if (control & 1)
-        {
-            if (!input_ptr.left()) break;
-            const auto b = *input_ptr++;
-            *output_ptr++ = b;
-            *dict_ptr++ = b;
-        }
-        else
+        static constexpr size_t dict_size = 0x800;
+
+        static void decode_reference(
+            const u8 lo, const u8 hi,
+            size_t &look_behind_pos, size_t &repetitions)
         {
-            if (input_ptr.left() < 2) break;
-            const auto lo = *input_ptr++;
-            const auto hi = *input_ptr++;
-            const auto look_behind_pos = lo | (hi & 0xE0) << 3;
-            auto repetitions = (hi & 0x1F) + 2;
-            auto source_ptr
-                = algo::make_cyclic_ptr(dict.data(), dict.size())
-                + look_behind_pos;
-            while (repetitions-- && output_ptr.left())
-            {
-                const auto b = *source_ptr++;
-                *output_ptr++ = b;
-                *dict_ptr++ = b;
-            }
+            look_behind_pos = lo | ((hi & 0xE0) << 3);
+            repetitions = (hi & 0x1F) + 2;
         }
-        control >>= 1;
-    }
-    return output;
+    };
+}
+
+static bstr custom_lzss_decompress(const bstr &input, const size_t size_orig)
+{
+    return algo::pack::lzss_decompress<Ps2LzssSpec>(input, size_orig, 0x7DF);
 }
 
 bool Ps2FileDecoder::is_recognized_impl(io::File &input_file) const
@@ -27,7 +27,7 @@ static const bstr magic = "DPNG"_b;
 
 bool DpngImageDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.seek(0).read(magic.size()) == magic;
+    return input_file.stream.seek(0).matches(magic);
 }
 
 res::Image DpngImageDecoder::decode_impl(
@@ -68,3 +68,4 @@ res::Image DpngImageDecoder::decode_impl(
 }
 
 static auto _ = dec::register_decoder<DpngImageDecoder>("qlie/dpng");
+static auto _2 = dec::register_signature("qlie/dpng", magic);
@@ -16,6 +16,7 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "dec/qlie/mt.h"
+#include <algorithm>
 #include "algo/range.h"
 
 using namespace au;
@@ -62,47 +63,60 @@ void CustomMersenneTwister::xor_state(const bstr &data)
         p->state[i++] ^= *data_ptr++;
 }
 
-u32 CustomMersenneTwister::get_next_integer()
+static void refill_state(u32 state[], int &mti)
 {
-    u32 y;
     static u32 mag01[2] = {0x0ul, matrix_a};
+    u32 y;
+    int kk;
 
-    if (p->mti >= n)
-    {
-        int kk;
-
-        if (p->mti == n + 1)
-            init_state(p->state, 5489ul, p->mti);
-
-        for (kk = 0; kk < n - m; kk++)
-        {
-            y = (p->state[kk] & upper_mask)
-                | ((p->state[kk + 1] & lower_mask) >> 1);
-
-            p->state[kk]
-                = p->state[kk + m] ^ y ^ mag01[p->state[kk + 1] & 0x1ul];
-        }
-
-        for (; kk < n - 1; kk++)
-        {
-            y = (p->state[kk] & upper_mask)
-                | ((p->state[kk + 1] & lower_mask) >> 1);
+    if (mti == n + 1)
+        init_state(state, 5489ul, mti);
 
-            p->state[kk]
-                = p->state[kk + (m - n)] ^ y ^ mag01[p->state[kk + 1] & 0x1ul];
-        }
+    for (kk = 0; kk < n - m; kk++)
+    {
+        y = (state[kk] & upper_mask) | ((state[kk + 1] & lower_mask) >> 1);
+        state[kk] = state[kk + m] ^ y ^ mag01[state[kk + 1] & 0x1ul];
+    }
 
-        y = (p->state[n - 1] & upper_mask) | ((p->state[0] & lower_mask) >> 1);
-        p->state[n - 1] = p->state[m - 1] ^ y ^ mag01[p->state[n - 1] & 0x1ul];
-        p->mti = 0;
+    for (; kk < n - 1; kk++)
+    {
+        y = (state[kk] & upper_mask) | ((state[kk + 1] & lower_mask) >> 1);
+        state[kk] = state[kk + (m - n)] ^ y ^ mag01[state[kk + 1] & 0x1ul];
     }
 
-    y = p->state[p->mti++];
+    y = (state[n - 1] & upper_mask) | ((state[0] & lower_mask) >> 1);
+    state[n - 1] = state[m - 1] ^ y ^ mag01[state[n - 1] & 0x1ul];
+    mti = 0;
+}
 
+static inline u32 temper(u32 y)
+{
     y ^= (y >> 11);
     y ^= (y << 7) & 0x9C4F88E3ul;
     y ^= (y << 15) & 0xE7F70000ul;
     y ^= (y >> 18);
-
     return y;
 }
+
+u32 CustomMersenneTwister::get_next_integer()
+{
+    if (p->mti >= n)
+        refill_state(p->state, p->mti);
+    return temper(p->state[p->mti++]);
+}
+
+void CustomMersenneTwister::get_next_integers(u32 *output, const size_t count)
+{
+    size_t left = count;
+    while (left)
+    {
+        if (p->mti >= n)
+            refill_state(p->state, p->mti);
+        const auto run = std::min<size_t>(left, n - p->mti);
+        for (const auto i : algo::range(run))
+            output[i] = temper(p->state[p->mti + i]);
+        p->mti += run;
+        output += run;
+        left -= run;
+    }
+}
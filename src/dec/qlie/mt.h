@@ -32,6 +32,7 @@ namespace qlie {
 
         void xor_state(const bstr &data);
         u32 get_next_integer();
+        void get_next_integers(u32 *output, const size_t count);
 
     private:
         struct Priv;
@@ -120,21 +120,25 @@ static void decrypt_file_data_with_external_keys(
     mt.xor_state(meta.key1);
     mt.xor_state(meta.key2);
 
-    std::vector<u64> table(16);
-    for (const auto i : algo::range(table.size()))
+    // the table, the discarded run, the initial mutator and the table index
+    // consume a fixed number of words, so they are drawn in a single batch
+    static const size_t table_size = 16;
+    u32 batch[table_size * 2 + 9 + 2 + 1];
+    mt.get_next_integers(batch, table_size * 2 + 9 + 2 + 1);
+
+    u64 table[table_size];
+    for (const auto i : algo::range(table_size))
     {
         table[i]
-            = mt.get_next_integer()
-            | (static_cast<u64>(mt.get_next_integer()) << 32);
+            = batch[i * 2]
+            | (static_cast<u64>(batch[i * 2 + 1]) << 32);
     }
-    for (const auto i : algo::range(9))
-        mt.get_next_integer();
 
     u64 mutator
-        = mt.get_next_integer()
-        | (static_cast<u64>(mt.get_next_integer()) << 32);
+        = batch[table_size * 2 + 9]
+        | (static_cast<u64>(batch[table_size * 2 + 10]) << 32);
 
-    auto table_index = mt.get_next_integer() % table.size();
+    auto table_index = batch[table_size * 2 + 11] % table_size;
     auto data_ptr = algo::make_ptr(data.get<u64>(), data.size() / 8);
     while (data_ptr.left())
     {
@@ -149,8 +153,7 @@ static void decrypt_file_data_with_external_keys(
         mutator &= 0xFFFFFFFEFFFFFFFE;
         mutator = algo::padw(mutator, *data_ptr);
 
-        table_index++;
-        table_index %= table.size();
+        table_index = (table_index + 1) & (table_size - 1);
         data_ptr++;
     }
 }
@@ -318,7 +321,7 @@ PackArchiveDecoder::PackArchiveDecoder()
 bool PackArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
     input_file.stream.seek(get_magic_start(input_file.stream));
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> PackArchiveDecoder::read_meta_impl(
@@ -16,8 +16,9 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "dec/real_live/g00_image_decoder.h"
-#include "algo/ptr.h"
+#include <cstring>
 #include "algo/range.h"
+#include "err.h"
 #include "io/memory_byte_stream.h"
 
 using namespace au;
@@ -42,11 +43,14 @@ static bstr decompress(
 {
     bstr output(output_size);
 
-    auto output_ptr = algo::make_ptr(output);
-    auto input_ptr = algo::make_ptr(input);
+    auto output_ptr = output.get<u8>();
+    const auto output_start = output.get<const u8>();
+    const auto output_end = output.end<const u8>();
+    auto input_ptr = input.get<const u8>();
+    const auto input_end = input.end<const u8>();
 
     u16 control = 1;
-    while (output_ptr.left() && input_ptr.left())
+    while (output_ptr < output_end && input_ptr < input_end)
     {
         control >>= 1;
         if (!(control & 0x100))
@@ -54,18 +58,42 @@ static bstr decompress(
 
         if (control & 1)
         {
-            output_ptr.append_from(input_ptr, byte_count);
+            if (static_cast<size_t>(input_end - input_ptr) < byte_count
+                || static_cast<size_t>(output_end - output_ptr) < byte_count)
+            {
+                throw err::BadDataSizeError();
+            }
+            std::memcpy(output_ptr, input_ptr, byte_count);
+            output_ptr += byte_count;
+            input_ptr += byte_count;
         }
         else
         {
-            if (input_ptr.left()
-                < 2) break;
+            if (input_end - input_ptr < 2)
+                break;
             size_t tmp = *input_ptr++;
             tmp |= *input_ptr++ << 8;
 
             const auto look_behind = (tmp >> 4) * byte_count;
             const auto size = ((tmp & 0x0F) + size_delta) * byte_count;
-            output_ptr.append_self(-look_behind, size);
+            const u8 *source_ptr = output_ptr - look_behind;
+            if (source_ptr < output_start || source_ptr + size > output_end)
+                throw err::BadDataOffsetError();
+            if (static_cast<size_t>(output_end - output_ptr) < size)
+                throw err::BadDataSizeError();
+            // close matches repeat bytes and must stay byte-wise; anything
+            // else is a straight block copy
+            if (source_ptr + size <= output_ptr)
+            {
+                std::memcpy(output_ptr, source_ptr, size);
+                output_ptr += size;
+            }
+            else
+            {
+                auto left = size;
+                while (left--)
+                    *output_ptr++ = *source_ptr++;
+            }
         }
     }
     return output;
@@ -163,9 +191,11 @@ static res::Image decode_v2(
                 throw err::CorruptDataError("Region out of bounds");
             }
             for (const auto y : algo::range(part_height))
-            for (const auto x : algo::range(part_width))
             {
-                image.at(target_x + x, target_y + y) = part.at(x, y);
+                std::memcpy(
+                    image.row(target_y + y) + target_x,
+                    part.row(y),
+                    part_width * sizeof(res::Pixel));
             }
         }
     }
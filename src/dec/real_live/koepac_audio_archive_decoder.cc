@@ -108,7 +108,7 @@ static s8 koe_ad_trans_tbl[256] =
 
 bool KoepacAudioArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.seek(0).read(magic.size()) == magic;
+    return input_file.stream.seek(0).matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> KoepacAudioArchiveDecoder::read_meta_impl(
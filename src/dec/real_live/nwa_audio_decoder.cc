@@ -16,6 +16,9 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "dec/real_live/nwa_audio_decoder.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
 #include "algo/range.h"
 #include "err.h"
 #include "io/lsb_bit_stream.h"
@@ -42,36 +45,31 @@ namespace
     };
 }
 
-static bstr decode_block(
+// decodes one block straight into the preallocated sample buffer; each
+// block starts with its own predictor seed, so blocks are independent
+static void decode_block(
     const NwaHeader &header,
     size_t current_block,
-    io::BaseByteStream &input_stream,
-    const std::vector<u32> &offsets)
+    const bstr &block_data,
+    u8 *output_ptr)
 {
     const auto bytes_per_sample = header.bits_per_sample >> 3;
     const auto current_block_size = current_block != header.block_count - 1
         ? header.block_size * bytes_per_sample
         : header.rest_size * bytes_per_sample;
     const auto output_size = current_block_size / bytes_per_sample;
-    const auto input_size = current_block != offsets.size() - 1
-        ? offsets.at(current_block + 1) - offsets.at(current_block)
-        : input_stream.size() - offsets.at(current_block);
 
-    io::MemoryByteStream output_stream(output_size);
-
-    input_stream.seek(offsets.at(current_block));
+    io::MemoryByteStream block_stream(block_data);
     s16 d[2];
     for (const auto i : algo::range(header.channel_count))
     {
         if (header.bits_per_sample == 8)
-            d[i] = input_stream.read<u8>();
+            d[i] = block_stream.read<u8>();
         else
-            d[i] = input_stream.read_le<u16>();
+            d[i] = block_stream.read_le<u16>();
     }
 
-    const auto input = input_stream.read(
-        input_size - bytes_per_sample * header.channel_count);
-    io::LsbBitStream bit_stream(input);
+    io::LsbBitStream bit_stream(block_stream.read_to_eof());
 
     auto current_channel = 0;
     auto run_length = 0;
@@ -141,15 +139,18 @@ static bstr decode_block(
         }
 
         if (header.bits_per_sample == 8)
-            output_stream.write<u8>(d[current_channel]);
+        {
+            *output_ptr++ = d[current_channel];
+        }
         else
-            output_stream.write_le<u16>(d[current_channel]);
+        {
+            *output_ptr++ = d[current_channel];
+            *output_ptr++ = d[current_channel] >> 8;
+        }
 
         if (header.channel_count == 2)
             current_channel ^= 1;
     }
-
-    return output_stream.seek(0).read_to_eof();
 }
 
 static bstr read_compressed_samples(
@@ -187,9 +188,66 @@ static bstr read_compressed_samples(
     for (const auto i : algo::range(header.block_count))
         offsets.push_back(input_stream.read_le<u32>());
 
-    bstr output;
+    // slice the compressed blocks up front so the workers never touch
+    // the shared stream
+    std::vector<bstr> block_data(header.block_count);
     for (const auto i : algo::range(header.block_count))
-        output += decode_block(header, i, input_stream, offsets);
+    {
+        const auto input_size = i != offsets.size() - 1
+            ? offsets.at(i + 1) - offsets.at(i)
+            : input_stream.size() - offsets.at(i);
+        block_data[i] = input_stream.seek(offsets.at(i)).read(input_size);
+    }
+
+    // the header cross-checks above guarantee the blocks add up to
+    // exactly size_orig bytes, so the buffer can be allocated up front
+    // and every block writes to a known disjoint range
+    bstr output(header.size_orig);
+    auto *output_start = output.get<u8>();
+    const auto bytes_per_sample = header.bits_per_sample >> 3;
+    const auto block_stride = header.block_size * bytes_per_sample;
+
+    if (header.block_count > 1)
+    {
+        const auto thread_count = std::min<size_t>(
+            header.block_count,
+            std::max<size_t>(std::thread::hardware_concurrency(), 2));
+        std::atomic<size_t> next_block(0);
+        std::vector<std::exception_ptr> errors(thread_count);
+        std::vector<std::thread> threads;
+        for (const auto t : algo::range(thread_count))
+        {
+            threads.emplace_back(
+                [&, t]()
+                {
+                    try
+                    {
+                        size_t i;
+                        while ((i = next_block++) < header.block_count)
+                        {
+                            decode_block(
+                                header,
+                                i,
+                                block_data[i],
+                                output_start + i * block_stride);
+                        }
+                    }
+                    catch (...)
+                    {
+                        errors[t] = std::current_exception();
+                    }
+                });
+        }
+        for (auto &thread : threads)
+            thread.join();
+        for (const auto &error : errors)
+            if (error)
+                std::rethrow_exception(error);
+    }
+    else
+    {
+        decode_block(header, 0, block_data[0], output_start);
+    }
     return output;
 }
 
@@ -204,12 +262,8 @@ bool NwaAudioDecoder::is_recognized_impl(io::File &input_file) const
     return input_file.path.has_extension("nwa");
 }
 
-res::Audio NwaAudioDecoder::decode_impl(
-    const Logger &logger, io::File &input_file) const
+static NwaHeader read_header(io::BaseByteStream &input_stream)
 {
-    // buffer the file in memory for performance
-    io::MemoryByteStream input_stream(input_file.stream.seek(0).read_to_eof());
-
     NwaHeader header;
     header.channel_count = input_stream.read_le<u16>();
     header.bits_per_sample = input_stream.read_le<u16>();
@@ -222,8 +276,17 @@ res::Audio NwaAudioDecoder::decode_impl(
     header.sample_count = input_stream.read_le<u32>();
     header.block_size = input_stream.read_le<u32>();
     header.rest_size = input_stream.read_le<u32>();
+    return header;
+}
+
+res::Audio NwaAudioDecoder::decode_impl(
+    const Logger &logger, io::File &input_file) const
+{
+    // buffer the file in memory for performance
+    io::MemoryByteStream input_stream(input_file.stream.seek(0).read_to_eof());
 
-    const auto samples = header.compression_level == -1
+    const auto header = read_header(input_stream);
+    auto samples = header.compression_level == -1
         ? read_uncompressed_samples(input_stream, header)
         : read_compressed_samples(input_stream, header);
 
@@ -231,8 +294,43 @@ res::Audio NwaAudioDecoder::decode_impl(
     audio.channel_count = header.channel_count;
     audio.bits_per_sample = header.bits_per_sample;
     audio.sample_rate = header.sample_rate;
-    audio.samples = samples;
+    audio.samples = std::move(samples);
     return audio;
 }
 
+bool NwaAudioDecoder::supports_streamed_decode() const
+{
+    return true;
+}
+
+// uncompressed tracks stream straight from the file in fixed chunks;
+// compressed ones keep the parallel block decode of the plain path,
+// which needs the whole track resident anyway, and arrive as one block
+void NwaAudioDecoder::decode_streamed_impl(
+    const Logger &logger, io::File &input_file, AudioBlockSink &sink) const
+{
+    const auto header = read_header(input_file.stream);
+    if (header.compression_level != -1)
+    {
+        input_file.stream.seek(0);
+        BaseAudioDecoder::decode_streamed_impl(logger, input_file, sink);
+        return;
+    }
+
+    res::Audio spec;
+    spec.channel_count = header.channel_count;
+    spec.bits_per_sample = header.bits_per_sample;
+    spec.sample_rate = header.sample_rate;
+    sink.start(spec);
+
+    static const size_t chunk_size = 0x100000;
+    auto left = header.size_orig;
+    while (left)
+    {
+        const auto chunk = std::min<size_t>(left, chunk_size);
+        sink.block(input_file.stream.read(chunk));
+        left -= chunk;
+    }
+}
+
 static auto _ = dec::register_decoder<NwaAudioDecoder>("real-live/nwa");
@@ -25,10 +25,17 @@ namespace real_live {
 
     class NwaAudioDecoder final : public BaseAudioDecoder
     {
+    public:
+        bool supports_streamed_decode() const override;
+
     protected:
         bool is_recognized_impl(io::File &input_file) const override;
         res::Audio decode_impl(
             const Logger &logger, io::File &input_file) const override;
+        void decode_streamed_impl(
+            const Logger &logger,
+            io::File &input_file,
+            AudioBlockSink &sink) const override;
     };
 
 } } }
@@ -29,7 +29,7 @@ static const bstr magic = "PDT10\x00\x00\x00"_b;
 
 bool Pdt10ImageDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.seek(0).read(magic.size()) == magic;
+    return input_file.stream.seek(0).matches(magic);
 }
 
 static bstr decompress_rgb(
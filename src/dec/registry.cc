@@ -17,17 +17,62 @@
 
 #include "dec/registry.h"
 #include <algorithm>
+#include <cstring>
 #include <map>
+#include <mutex>
 #include "dec/idecoder.h"
 #include "err.h"
+#include "io/file.h"
 
+using namespace au;
 using namespace au::dec;
 
+namespace
+{
+    struct Signature final
+    {
+        bstr magic;
+        uoff_t offset;
+    };
+
+    struct Gate final
+    {
+        uoff_t prefix_size;
+        Registry::RecognitionGate fn;
+    };
+}
+
 struct Registry::Priv final
 {
+    void flush_pending_decoders();
+
+    std::vector<std::pair<std::string, DecoderCreator>> pending_decoders;
+    std::mutex pending_decoders_mutex;
     std::map<std::string, DecoderCreator> decoder_map;
+    std::map<std::string, std::vector<Signature>> signature_map;
+    std::map<std::string, Gate> gate_map;
+    uoff_t max_prefix_size = 0;
+    std::map<std::string, std::shared_ptr<IDecoder>> decoder_pool;
+    std::mutex decoder_pool_mutex;
 };
 
+void Registry::Priv::flush_pending_decoders()
+{
+    // registration happens in static initializers, but the first query may
+    // arrive from any of several probing threads
+    std::unique_lock<std::mutex> lock(pending_decoders_mutex);
+    for (auto &item : pending_decoders)
+    {
+        if (decoder_map.find(item.first) != decoder_map.end())
+        {
+            throw std::logic_error(
+                "Decoder with name " + item.first + " was already registered.");
+        }
+        decoder_map[item.first] = std::move(item.second);
+    }
+    pending_decoders.clear();
+}
+
 Registry::Registry() : p(new Priv)
 {
 }
@@ -38,6 +83,7 @@ Registry::~Registry()
 
 const std::vector<std::string> Registry::get_decoder_names() const
 {
+    p->flush_pending_decoders();
     std::vector<std::string> names;
     for (auto &item : p->decoder_map)
         names.push_back(item.first);
@@ -47,6 +93,7 @@ const std::vector<std::string> Registry::get_decoder_names() const
 
 bool Registry::has_decoder(const std::string &name) const
 {
+    p->flush_pending_decoders();
     return p->decoder_map.find(name) != p->decoder_map.end();
 }
 
@@ -60,12 +107,94 @@ std::shared_ptr<IDecoder>
 
 void Registry::add_decoder(const std::string &name, DecoderCreator creator)
 {
-    if (has_decoder(name))
+    // this runs once per decoder before main(); the name collision check
+    // and map construction wait until the registry is first queried so
+    // that process startup only pays for plain appends
+    std::unique_lock<std::mutex> lock(p->pending_decoders_mutex);
+    p->pending_decoders.emplace_back(name, std::move(creator));
+}
+
+std::shared_ptr<IDecoder>
+    Registry::get_pooled_decoder(const std::string &name) const
+{
+    {
+        std::unique_lock<std::mutex> lock(p->decoder_pool_mutex);
+        const auto it = p->decoder_pool.find(name);
+        if (it != p->decoder_pool.end())
+            return it->second;
+    }
+    // construction happens outside of the lock so that slow constructors
+    // don't stall other threads pooling unrelated decoders
+    auto decoder = create_decoder(name);
+    std::unique_lock<std::mutex> lock(p->decoder_pool_mutex);
+    const auto it = p->decoder_pool.find(name);
+    if (it != p->decoder_pool.end())
+        return it->second;
+    p->decoder_pool[name] = decoder;
+    return decoder;
+}
+
+void Registry::add_signature(
+    const std::string &name, const bstr &magic, const uoff_t offset)
+{
+    p->signature_map[name].push_back({magic, offset});
+    p->max_prefix_size
+        = std::max<uoff_t>(p->max_prefix_size, offset + magic.size());
+}
+
+void Registry::add_gate(
+    const std::string &name,
+    const uoff_t prefix_size,
+    RecognitionGate gate)
+{
+    p->gate_map[name] = {prefix_size, std::move(gate)};
+    p->max_prefix_size = std::max(p->max_prefix_size, prefix_size);
+}
+
+const std::set<std::string> Registry::get_candidate_decoder_names(
+    io::File &input_file) const
+{
+    p->flush_pending_decoders();
+    const auto file_size = input_file.stream.size();
+    const auto prefix_size = std::min<uoff_t>(p->max_prefix_size, file_size);
+    const auto prefix = input_file.stream.seek(0).read(prefix_size);
+
+    std::set<std::string> candidates;
+    for (const auto &item : p->decoder_map)
     {
-        throw std::logic_error(
-            "Decoder with name " + name + " was already registered.");
+        const auto signatures = p->signature_map.find(item.first);
+        if (signatures != p->signature_map.end())
+        {
+            bool matched = false;
+            for (const auto &signature : signatures->second)
+            {
+                if (signature.offset + signature.magic.size() <= prefix.size()
+                    && !std::memcmp(
+                        prefix.get<const u8>() + signature.offset,
+                        signature.magic.get<const u8>(),
+                        signature.magic.size()))
+                {
+                    matched = true;
+                    break;
+                }
+            }
+            if (!matched)
+                continue;
+        }
+        const auto gate = p->gate_map.find(item.first);
+        if (gate != p->gate_map.end()
+            && !gate->second.fn(
+                prefix.substr(
+                    0, std::min<uoff_t>(gate->second.prefix_size, prefix.size())),
+                file_size))
+        {
+            continue;
+        }
+        // decoders publishing neither signatures nor gates must always be
+        // probed
+        candidates.insert(item.first);
     }
-    p->decoder_map[name] = creator;
+    return candidates;
 }
 
 Registry &Registry::instance()
@@ -19,9 +19,17 @@
 
 #include <functional>
 #include <memory>
+#include <set>
 #include <vector>
+#include "types.h"
 
 namespace au {
+
+    namespace io
+    {
+        class File;
+    }
+
 namespace dec {
 
     class IDecoder;
@@ -39,9 +47,54 @@ namespace dec {
 
         const std::vector<std::string> get_decoder_names() const;
         bool has_decoder(const std::string &name) const;
+        // Registration is a plain append so that the static initializers
+        // running before main() stay cheap; creators are lazy factories
+        // whose decoders (and any heavy plugin state they carry)
+        // materialize on first use.
         void add_decoder(const std::string &name, DecoderCreator creator);
         std::shared_ptr<IDecoder> create_decoder(const std::string &name) const;
 
+        // Returns a cached decoder instance, constructing it on first use.
+        // Some decoders carry heavy construction state (plugin tables), so
+        // probing shouldn't pay for it once per file. Pooled instances are
+        // shared - use them only for const queries such as is_recognized or
+        // get_linked_formats and create a fresh instance for actual decoding,
+        // where CLI argument parsing mutates the decoder.
+        std::shared_ptr<IDecoder> get_pooled_decoder(
+            const std::string &name) const;
+
+        // Decoders may publish magic byte signatures so that format guessing
+        // can discard them without instantiating the decoder at all. A
+        // signature is a necessary condition, not a sufficient one - matching
+        // files still go through is_recognized.
+        void add_signature(
+            const std::string &name,
+            const bstr &magic,
+            const uoff_t offset = 0);
+
+        // Formats without magic bytes can still be ruled out cheaply from
+        // header arithmetic - entry counts that don't fit the file size,
+        // table sizes larger than the file, and the like. A recognition
+        // gate is a pure predicate over the file's first bytes and its
+        // size; returning false removes the decoder from the candidate
+        // set before its full recognition (which may parse the whole
+        // index) ever runs. Like signatures, gates are a necessary
+        // condition only. The prefix passed to the gate may be shorter
+        // than prefix_size when the file itself is.
+        using RecognitionGate
+            = std::function<bool(const bstr &prefix, const uoff_t file_size)>;
+        void add_gate(
+            const std::string &name,
+            const uoff_t prefix_size,
+            RecognitionGate gate);
+
+        // Returns the names of decoders that could possibly recognize given
+        // file: decoders without published signatures or gates, plus those
+        // whose signature matches the file's first bytes and whose gate
+        // accepts the file.
+        const std::set<std::string> get_candidate_decoder_names(
+            io::File &input_file) const;
+
     private:
         Registry();
 
@@ -57,4 +110,20 @@ namespace dec {
         return true;
     }
 
+    inline bool register_signature(
+        const std::string &name, const bstr &magic, const uoff_t offset = 0)
+    {
+        Registry::instance().add_signature(name, magic, offset);
+        return true;
+    }
+
+    inline bool register_gate(
+        const std::string &name,
+        const uoff_t prefix_size,
+        Registry::RecognitionGate gate)
+    {
+        Registry::instance().add_gate(name, prefix_size, std::move(gate));
+        return true;
+    }
+
 } }
@@ -16,11 +16,11 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "dec/renpy/rpa_archive_decoder.h"
+#include <algorithm>
 #include "algo/format.h"
 #include "algo/pack/zlib.h"
 #include "algo/range.h"
 #include "err.h"
-#include "io/memory_byte_stream.h"
 
 using namespace au;
 using namespace au::dec::renpy;
@@ -89,10 +89,18 @@ namespace
 
 namespace
 {
+    // View into the inflated index; the strings are only copied once they
+    // land in their final place inside an entry
+    struct StringView final
+    {
+        const u8 *data;
+        size_t size;
+    };
+
     struct UnpickleContext final
     {
-        std::vector<bstr> strings;
-        std::vector<int> numbers;
+        std::vector<StringView> strings;
+        std::vector<u32> numbers;
     };
 
     struct CustomArchiveEntry final : dec::PlainArchiveEntry
@@ -101,87 +109,97 @@ namespace
     };
 }
 
-static void unpickle_handle_string(bstr str, UnpickleContext *context)
-{
-    context->strings.push_back(str);
-}
-
-static void unpickle_handle_number(size_t number, UnpickleContext *context)
-{
-    context->numbers.push_back(number);
-}
-
-static void unpickle(io::BaseByteStream &table_stream, UnpickleContext *context)
+static void unpickle(const bstr &table_data, UnpickleContext *context)
 {
     // Stupid unpickle "implementation" ahead: instead of twiddling with stack,
     // arrays, dictionaries and all that jazz, just remember all pushed strings
     // and integers for later interpretation. We also take advantage of RenPy
     // using Pickle's HIGHEST_PROTOCOL, which means there's no need to parse
     // 90% of the opcodes (such as "S" with escape stuff).
-    const auto table_size = table_stream.size();
-    while (table_stream.pos() < table_size)
+    //
+    // The walk runs over raw pointers into the inflated buffer and records
+    // views rather than copies; 100k-entry indexes are opcode-bound, not
+    // data-bound.
+    const u8 *ptr = table_data.get<const u8>();
+    const u8 *end = ptr + table_data.size();
+    const auto want = [&](const size_t size)
+    {
+        if (static_cast<size_t>(end - ptr) < size)
+            throw err::EofError();
+    };
+    while (ptr < end)
     {
-        PickleOpcode c = static_cast<PickleOpcode>(table_stream.read<u8>());
+        const auto c = static_cast<PickleOpcode>(*ptr++);
         switch (c)
         {
             case PickleOpcode::ShortBinString:
             {
-                char size = table_stream.read<u8>();
-                unpickle_handle_string(table_stream.read(size), context);
+                want(1);
+                const size_t size = *ptr++;
+                want(size);
+                context->strings.push_back({ptr, size});
+                ptr += size;
                 break;
             }
 
             case PickleOpcode::BinUnicode:
             {
-                const auto size = table_stream.read_le<u32>();
-                unpickle_handle_string(table_stream.read(size), context);
+                want(4);
+                size_t size = ptr[0] | (ptr[1] << 8) | (ptr[2] << 16)
+                    | (static_cast<u32>(ptr[3]) << 24);
+                ptr += 4;
+                want(size);
+                context->strings.push_back({ptr, size});
+                ptr += size;
                 break;
             }
 
             case PickleOpcode::BinInt1:
             {
-                unpickle_handle_number(table_stream.read<u8>(), context);
+                want(1);
+                context->numbers.push_back(*ptr++);
                 break;
             }
 
             case PickleOpcode::BinInt2:
             {
-                unpickle_handle_number(table_stream.read_le<u16>(), context);
+                want(2);
+                context->numbers.push_back(ptr[0] | (ptr[1] << 8));
+                ptr += 2;
                 break;
             }
 
             case PickleOpcode::BinInt4:
             {
-                unpickle_handle_number(table_stream.read_le<u32>(), context);
+                want(4);
+                context->numbers.push_back(ptr[0] | (ptr[1] << 8)
+                    | (ptr[2] << 16) | (static_cast<u32>(ptr[3]) << 24));
+                ptr += 4;
                 break;
             }
 
             case PickleOpcode::Long1:
             {
-                const auto size = table_stream.read<u8>();
+                want(1);
+                const size_t size = *ptr++;
+                want(size);
                 u32 number = 0;
-                const auto pos = table_stream.pos();
-                for (const auto i : algo::range(size))
-                {
-                    table_stream.seek(pos + size - 1 - i);
-                    number *= 256;
-                    number += table_stream.read<u8>();
-                }
-                unpickle_handle_number(number, context);
-                table_stream.seek(pos + size);
+                for (const auto i : algo::range(std::min<size_t>(size, 4)))
+                    number |= static_cast<u32>(ptr[i]) << (i * 8);
+                context->numbers.push_back(number);
+                ptr += size;
                 break;
             }
 
             case PickleOpcode::Proto:
-                table_stream.skip(1);
-                break;
-
             case PickleOpcode::BinPut:
-                table_stream.skip(1);
+                want(1);
+                ptr++;
                 break;
 
             case PickleOpcode::LongBinPut:
-                table_stream.skip(4);
+                want(4);
+                ptr += 4;
                 break;
 
             case PickleOpcode::Append:
@@ -270,10 +288,10 @@ std::unique_ptr<dec::ArchiveMeta> RpaArchiveDecoder::read_meta_impl(
     }
 
     input_file.stream.seek(table_offset);
-    io::MemoryByteStream table_stream(read_raw_table(input_file.stream));
+    const auto table_data = read_raw_table(input_file.stream);
 
     UnpickleContext context;
-    unpickle(table_stream, &context);
+    unpickle(table_data, &context);
 
     // Suspicion: reading renpy sources leaves me under impression that
     // older games might not embed prefixes at all. This means that there
@@ -290,8 +308,12 @@ std::unique_ptr<dec::ArchiveMeta> RpaArchiveDecoder::read_meta_impl(
     for (const auto i : algo::range(file_count))
     {
         auto entry = std::make_unique<CustomArchiveEntry>();
-        entry->path = context.strings[i * 2 ].str();
-        entry->prefix = context.strings[i * 2 + 1];
+        const auto &name = context.strings[i * 2];
+        const auto &prefix = context.strings[i * 2 + 1];
+        entry->path = std::string(
+            reinterpret_cast<const char*>(name.data), name.size);
+        entry->prefix = bstr(
+            reinterpret_cast<const char*>(prefix.data), prefix.size);
         entry->offset = context.numbers[i * 2] ^ key;
         entry->size = context.numbers[i * 2 + 1] ^ key;
         meta->entries.push_back(std::move(entry));
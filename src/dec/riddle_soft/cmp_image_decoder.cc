@@ -26,7 +26,7 @@ static const bstr magic = "CMP1"_b;
 
 bool CmpImageDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 res::Image CmpImageDecoder::decode_impl(
@@ -17,7 +17,6 @@
 
 #include "dec/rpgmaker/rgs/common.h"
 #include "algo/range.h"
-#include "io/memory_byte_stream.h"
 
 using namespace au;
 using namespace au::dec::rpgmaker;
@@ -30,22 +29,24 @@ u32 rgs::advance_key(const u32 key)
 std::unique_ptr<io::File> rgs::read_file_impl(
     io::File &arc_file, const CustomArchiveEntry &entry)
 {
-    auto output_file = std::make_unique<io::File>();
-    output_file->path = entry.path;
-    arc_file.stream.seek(entry.offset);
-
-    io::MemoryByteStream tmp_stream;
-    tmp_stream.write(arc_file.stream.read(entry.size));
-    tmp_stream.write("\x00\x00\x00\x00"_b);
-    tmp_stream.seek(0);
-
+    // the key chain is inherently serial, so the keystream gets expanded
+    // into a scratch buffer first and applied in one flat XOR pass
+    bstr key_stream((entry.size + 3) & ~static_cast<size_t>(3));
+    auto key_stream_ptr = key_stream.get<u8>();
     u32 key = entry.key;
-    for (const auto i : algo::range(0, entry.size, 4))
+    for (size_t i = 0; i < key_stream.size(); i += 4)
     {
-        const auto chunk = tmp_stream.read_le<u32>() ^ key;
+        key_stream_ptr[i] = key;
+        key_stream_ptr[i + 1] = key >> 8;
+        key_stream_ptr[i + 2] = key >> 16;
+        key_stream_ptr[i + 3] = key >> 24;
         key = rgs::advance_key(key);
-        output_file->stream.write_le<u32>(chunk);
     }
-    output_file->stream.resize(entry.size);
-    return output_file;
+
+    auto data = arc_file.stream.seek(entry.offset).read(entry.size);
+    auto data_ptr = data.get<u8>();
+    for (const auto i : algo::range(entry.size))
+        data_ptr[i] ^= key_stream_ptr[i];
+
+    return std::make_unique<io::File>(entry.path, data);
 }
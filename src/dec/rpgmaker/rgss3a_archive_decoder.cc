@@ -26,7 +26,7 @@ static const bstr magic = "RGSSAD\x00\x03"_b;
 
 bool Rgss3aArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> Rgss3aArchiveDecoder::read_meta_impl(
@@ -27,7 +27,7 @@ static const u32 initial_key = 0xDEADCAFE;
 
 bool RgssadArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> RgssadArchiveDecoder::read_meta_impl(
@@ -27,7 +27,7 @@ static const bstr magic = "XYZ1"_b;
 
 bool XyzImageDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 res::Image XyzImageDecoder::decode_impl(
@@ -204,7 +204,7 @@ static bstr read_incremental(
 
 bool S25ImageArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> S25ImageArchiveDecoder::read_meta_impl(
@@ -104,20 +104,25 @@ static inline u32 mix_colors(const u32 c1, const u32 c2, const u32 alpha)
 
 static u32 calculate_crc32(const bstr &data)
 {
-    const u32 xor_value = 0x6DB88320;
-    u32 table[0x100];
-    for (const auto i : algo::range(0x100))
+    // the polynomial is fixed, so the table is shared by all entries
+    static const auto table = []()
     {
-        u32 poly = i;
-        for (const auto j : algo::range(8))
+        const u32 xor_value = 0x6DB88320;
+        std::array<u32, 0x100> t;
+        for (const auto i : algo::range(0x100))
         {
-            const bool bit = poly & 1;
-            poly = (poly >> 1) | (poly << 31);
-            if (bit == 1)
-                poly ^= xor_value;
+            u32 poly = i;
+            for (const auto j : algo::range(8))
+            {
+                const bool bit = poly & 1;
+                poly = (poly >> 1) | (poly << 31);
+                if (bit == 1)
+                    poly ^= xor_value;
+            }
+            t[i] = poly;
         }
-        table[i] = poly;
-    }
+        return t;
+    }();
     u32 checksum = 0xFFFFFFFF;
     for (const auto c : data)
         checksum = (checksum >> 8) ^ table[(c ^ (checksum & 0xFF)) & 0xFF];
@@ -527,20 +532,25 @@ void warc::decrypt_essential(
     auto key_pos2 = 0;
     key_pos1 %= essential_crypt_key.size();
 
+    // the <=1.2 case has already thrown above, and the next key position
+    // feeds on the decrypted byte, so the loop stays serial but can run
+    // over raw pointers with the branch and modulo lifted out
+    const auto key_size = essential_crypt_key.size();
+    const auto key_ptr = essential_crypt_key.get<const u8>();
+    auto data_ptr = data.get<u8>();
     for (const auto i : algo::range(
         essential_crypt_start + 2, essential_crypt_end))
     {
-        u8 d = data[i];
-        if (warc_version > 120)
-            d ^= static_cast<u8>(lcg.next<u32>() / 16777216.0);
-        else
-            throw err::NotSupportedError("WARC <=1.2 is not implemented");
+        u8 d = data_ptr[i];
+        d ^= static_cast<u8>(lcg.next<u32>() / 16777216.0);
         d = (d >> 1) | (d << 7);
-        d ^= essential_crypt_key[key_pos1];
-        d ^= essential_crypt_key[key_pos2];
-        data[i] = d;
-        key_pos1 = d % essential_crypt_key.size();
-        key_pos2 = (key_pos2 + 1) % essential_crypt_key.size();
+        d ^= key_ptr[key_pos1];
+        d ^= key_ptr[key_pos2];
+        data_ptr[i] = d;
+        key_pos1 = d % key_size;
+        key_pos2++;
+        if (key_pos2 == static_cast<int>(key_size))
+            key_pos2 = 0;
     }
 }
 
@@ -561,8 +571,9 @@ void warc::decrypt_table_data(
     if (warc_version >= 170)
     {
         const u8 key = warc_version ^ 0xFF;
+        auto table_data_bytes = table_data.get<u8>();
         for (const auto i : algo::range(8, table_data.size()))
-            table_data[i] ^= key;
+            table_data_bytes[i] ^= key;
         table_data = algo::pack::zlib_inflate(table_data.substr(8));
     }
     else
@@ -574,18 +585,20 @@ void warc::crc_crypt(bstr &data, const bstr &table)
     if (data.size() < 0x400 || !table.size())
         return;
 
+    const auto data_ptr = data.get<u8>();
     u32 crc = 0xFFFFFFFF;
     for (const auto i : algo::range(0x100))
     {
-        crc ^= data[i] << 24;
+        crc ^= data_ptr[i] << 24;
         for (const auto j : algo::range(8))
             crc = (crc << 1) ^ (crc & 0x80000000 ? 0x04C11DB7 : 0);
     }
+    auto data_words = data.get<u32>();
+    const auto table_words = table.get<const u32>();
     for (const auto i : algo::range(0x40))
     {
-        const auto idx = data.get<u32>()[0x40 + i] % table.size();
-        const u32 src = table.get<u32>()[idx / 4];
-        const u32 key = src ^ crc;
-        data.get<u32>()[0x80 + i] ^= key;
+        const auto idx = data_words[0x40 + i] % table.size();
+        const u32 key = table_words[idx / 4] ^ crc;
+        data_words[0x80 + i] ^= key;
     }
 }
@@ -56,7 +56,7 @@ CustomArchiveMeta::CustomArchiveMeta(
 
 bool WarcArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> WarcArchiveDecoder::read_meta_impl(
@@ -136,7 +136,7 @@ std::unique_ptr<io::File> WarcArchiveDecoder::read_file_impl(
         warc::crc_crypt(data, meta->plugin->crc_crypt_source);
     }
 
-    std::function<bstr(const bstr &, const size_t, const bool)> decompressor;
+    bstr (*decompressor)(const bstr &, const size_t, const bool) = nullptr;
     if (file_magic == "YH1"_b)
         decompressor = warc::decompress_yh1;
     else if (file_magic == "YLZ"_b)
@@ -16,6 +16,7 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "dec/silky/akb_image_decoder.h"
+#include <algorithm>
 #include "algo/pack/lzss.h"
 #include "algo/range.h"
 #include "err.h"
@@ -76,21 +77,23 @@ res::Image AkbImageDecoder::decode_impl(
     auto data = algo::pack::lzss_decompress(
         input_file.stream.read_to_eof(), canvas_stride * canvas_height);
 
-    for (const auto y1 : algo::range(canvas_height / 2))
+    // the flip, the left-delta seed row and the per-row delta all run over
+    // raw pointers; the row addition has no intra-row dependency, so it
+    // compiles down to wide element-wise adds
+    auto data_ptr = data.get<u8>();
+    for (const auto y : algo::range(canvas_height / 2))
     {
-        const auto y2 = canvas_height - 1 - y1;
-        auto source_ptr = &data[y1 * canvas_stride];
-        auto target_ptr = &data[y2 * canvas_stride];
-        for (const auto x : algo::range(canvas_stride))
-            std::swap(source_ptr[x], target_ptr[x]);
+        auto *top_row = data_ptr + y * canvas_stride;
+        auto *bottom_row = data_ptr + (canvas_height - 1 - y) * canvas_stride;
+        std::swap_ranges(top_row, top_row + canvas_stride, bottom_row);
     }
 
     for (const auto x : algo::range(channels, canvas_stride))
-        data[x] += data[x - channels];
+        data_ptr[x] += data_ptr[x - channels];
     for (const auto y : algo::range(1, canvas_height))
     {
-        auto source_ptr = &data[(y - 1) * canvas_stride];
-        auto target_ptr = &data[y * canvas_stride];
+        const auto *source_ptr = data_ptr + (y - 1) * canvas_stride;
+        auto *target_ptr = data_ptr + y * canvas_stride;
         for (const auto x : algo::range(canvas_stride))
             target_ptr[x] += source_ptr[x];
     }
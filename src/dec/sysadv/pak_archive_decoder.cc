@@ -26,7 +26,7 @@ static const bstr magic = "\x05PACK2"_b;
 
 bool PakArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> PakArchiveDecoder::read_meta_impl(
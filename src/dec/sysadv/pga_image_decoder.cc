@@ -25,7 +25,7 @@ static const bstr magic = "PGAPGAH\x0A"_b;
 
 bool PgaImageDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 res::Image PgaImageDecoder::decode_impl(
@@ -35,7 +35,7 @@ namespace
 
 bool PackdatArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> PackdatArchiveDecoder::read_meta_impl(
@@ -29,7 +29,7 @@ static u8 transform_table[256][256];
 
 bool GwdImageDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.seek(4).read(magic.size()) == magic;
+    return input_file.stream.seek(4).matches(magic);
 }
 
 namespace
@@ -216,7 +216,7 @@ ArcArchiveDecoder::ArcArchiveDecoder()
 
 bool ArcArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> ArcArchiveDecoder::read_meta_impl(
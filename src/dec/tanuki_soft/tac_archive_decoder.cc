@@ -53,9 +53,11 @@ namespace
 static const bstr magic_100 = "TArc1.00\x00\x00\x00\x00"_b;
 static const bstr magic_110 = "TArc1.10\x00\x00\x00\x00"_b;
 
-static bstr decrypt(const bstr &input, size_t size, const bstr &key)
+// takes a prepared cipher so that callers decrypting several ranges with
+// the same key run the Blowfish key schedule only once
+static bstr decrypt(
+    const algo::crypt::Blowfish &bf, const bstr &input, const size_t size)
 {
-    algo::crypt::Blowfish bf(key);
     const auto left = (size / bf.block_size()) * bf.block_size();
     return bf.decrypt(input.substr(0, left)) + input.substr(left);
 }
@@ -89,18 +91,20 @@ std::unique_ptr<dec::ArchiveMeta> TacArchiveDecoder::read_meta_impl(
     const auto file_data_start = input_file.stream.pos() + table_size;
 
     auto table_data = input_file.stream.read(table_size);
-    table_data = decrypt(table_data, table_size, "TLibArchiveData"_b);
+    const algo::crypt::Blowfish table_bf("TLibArchiveData"_b);
+    table_data = decrypt(table_bf, table_data, table_size);
     table_data = algo::pack::zlib_inflate(table_data);
     io::MemoryByteStream table_stream(table_data);
 
-    std::vector<std::unique_ptr<Directory>> dirs;
+    std::vector<Directory> dirs;
+    dirs.reserve(dir_count);
     for (const auto i : algo::range(dir_count))
     {
-        auto dir = std::make_unique<Directory>();
-        dir->hash = table_stream.read_le<u16>();
-        dir->entry_count = table_stream.read_le<u16>();
-        dir->start_index = table_stream.read_le<u32>();
-        dirs.push_back(std::move(dir));
+        Directory dir;
+        dir.hash = table_stream.read_le<u16>();
+        dir.entry_count = table_stream.read_le<u16>();
+        dir.start_index = table_stream.read_le<u32>();
+        dirs.push_back(dir);
     }
 
     auto meta = std::make_unique<ArchiveMeta>();
@@ -116,21 +120,28 @@ std::unique_ptr<dec::ArchiveMeta> TacArchiveDecoder::read_meta_impl(
         meta->entries.push_back(std::move(entry));
     }
 
-    for (auto &dir : dirs)
+    for (const auto &dir : dirs)
     {
-        for (const auto i : algo::range(dir->entry_count))
+        for (const auto i : algo::range(dir.entry_count))
         {
-            if (i + dir->start_index >= meta->entries.size())
+            if (i + dir.start_index >= meta->entries.size())
                 throw err::CorruptDataError("Corrupt file table");
             auto entry = static_cast<CustomArchiveEntry*>(
-                meta->entries[dir->start_index + i].get());
-            entry->hash = (entry->hash << 16) | dir->hash;
+                meta->entries[dir.start_index + i].get());
+            entry->hash = (entry->hash << 16) | dir.hash;
         }
     }
 
     return meta;
 }
 
+bool TacArchiveDecoder::entries_are_independent() const
+{
+    // each entry's Blowfish key derives from its own hash stored in the
+    // table, so extraction only touches the entry's own byte range
+    return true;
+}
+
 std::unique_ptr<io::File> TacArchiveDecoder::read_file_impl(
     const Logger &logger,
     io::File &input_file,
@@ -146,19 +157,22 @@ std::unique_ptr<io::File> TacArchiveDecoder::read_file_impl(
 
     if (!entry->compressed)
     {
-        const auto key = algo::format("%llu_tlib_secure_", entry->hash);
+        const auto key = algo::format(
+            "%llu_tlib_secure_",
+            static_cast<unsigned long long>(entry->hash));
+        const algo::crypt::Blowfish bf(key);
         auto bytes_to_decrypt = std::min<size_t>(10240, data.size());
 
         {
             const auto header = decrypt(
+                bf,
                 data.substr(0, algo::crypt::Blowfish::block_size()),
-                algo::crypt::Blowfish::block_size(),
-                key).substr(0, 4);
+                algo::crypt::Blowfish::block_size()).substr(0, 4);
             if (header == "RIFF"_b || header == "TArc"_b)
                 bytes_to_decrypt = data.size();
         }
 
-        data = decrypt(data, bytes_to_decrypt, key);
+        data = decrypt(bf, data, bytes_to_decrypt);
     }
 
     auto output_file = std::make_unique<io::File>(entry->path, data);
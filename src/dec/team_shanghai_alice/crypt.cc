@@ -16,8 +16,9 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "dec/team_shanghai_alice/crypt.h"
+#include <algorithm>
+#include <cstring>
 #include "algo/range.h"
-#include "io/memory_byte_stream.h"
 
 using namespace au;
 using namespace au::dec::team_shanghai_alice;
@@ -30,12 +31,19 @@ bool DecryptorContext::operator ==(const DecryptorContext &other) const
         && limit == other.limit;
 }
 
-static void decrypt(
-    io::BaseByteStream &input_stream,
-    io::BaseByteStream &output_stream,
-    const DecryptorContext &context)
+bstr au::dec::team_shanghai_alice::decrypt(
+    const bstr &input, const DecryptorContext &context)
 {
-    int left = input_stream.size();
+    // the transform only ever shuffles bytes within one block, so it can
+    // run over raw pointers on a single preallocated buffer rather than
+    // allocating a stream plus two bstr's per block
+    bstr output(input.size());
+    const auto input_start = input.get<const u8>();
+    const auto input_end = input_start + input.size();
+    auto input_ptr = input_start;
+    const auto output_start = output.get<u8>();
+
+    int left = input.size();
     size_t current_block_size = context.block_size;
     u8 key = context.key;
 
@@ -45,41 +53,34 @@ static void decrypt(
     shift += (left & 1);
     left -= shift;
 
-    while (left > 0 && output_stream.pos() < context.limit)
+    size_t output_pos = 0;
+    while (left > 0 && output_pos < context.limit)
     {
         if (left < static_cast<int>(current_block_size))
             current_block_size = left;
-        auto input_block = input_stream.read(current_block_size);
-        auto *input_block_ptr = input_block.get<const char>();
-        bstr output_block(current_block_size);
+        const auto block_start = output_start + output_pos;
         for (const auto j : algo::range(2))
         {
-            u8 *output_block_ptr = &output_block[current_block_size - j - 1];
+            auto output_ptr = block_start + current_block_size - j - 1;
             for (const auto i : algo::range((current_block_size - j + 1) >> 1))
             {
-                *output_block_ptr = *input_block_ptr++ ^ key;
-                output_block_ptr -= 2;
+                *output_ptr = *input_ptr++ ^ key;
+                output_ptr -= 2;
                 key += context.step;
             }
         }
-
-        output_stream.write(output_block);
+        output_pos += current_block_size;
         left -= current_block_size;
     }
 
     left += shift;
-    left = std::min(left, static_cast<int>(
-        input_stream.size() - input_stream.pos()));
+    left = std::min(left, static_cast<int>(input_end - input_ptr));
     if (left > 0)
-        output_stream.write(input_stream.read(left));
-    output_stream.seek(0);
-}
-
-bstr au::dec::team_shanghai_alice::decrypt(
-    const bstr &input, const DecryptorContext &context)
-{
-    io::MemoryByteStream input_stream(input);
-    io::MemoryByteStream output_stream;
-    ::decrypt(input_stream, output_stream, context);
-    return output_stream.read_to_eof();
+    {
+        std::memcpy(output_start + output_pos, input_ptr, left);
+        output_pos += left;
+    }
+    if (output_pos != output.size())
+        return output.substr(0, output_pos);
+    return output;
 }
@@ -16,10 +16,10 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "dec/team_shanghai_alice/pbg3_archive_decoder.h"
-#include "algo/pack/lzss.h"
+#include <algorithm>
 #include "algo/range.h"
-#include "io/memory_byte_stream.h"
-#include "io/msb_bit_stream.h"
+#include "algo/scratch_arena.h"
+#include "err.h"
 
 using namespace au;
 using namespace au::dec::team_shanghai_alice;
@@ -32,45 +32,84 @@ namespace
     {
         u32 checksum;
     };
+
+    // MSB-first bit reader over a contiguous buffer. Both the entry
+    // table and the LZSS payloads are consumed bit by bit, so the bits
+    // come from a local 64-bit cache instead of a virtual stream call
+    // per read. The buffer must outlive the reader.
+    struct BitCache final
+    {
+        BitCache(const bstr &input) :
+            input_ptr(input.get<const u8>()),
+            input_end(input_ptr + input.size())
+        {
+        }
+
+        u32 read(const size_t bits)
+        {
+            while (cached_bits < bits)
+            {
+                if (input_ptr >= input_end)
+                    throw err::EofError();
+                cache = (cache << 8) | *input_ptr++;
+                cached_bits += 8;
+            }
+            cached_bits -= bits;
+            return (cache >> cached_bits) & ((1ull << bits) - 1);
+        }
+
+        const u8 *input_ptr;
+        const u8 *input_end;
+        u64 cache = 0;
+        size_t cached_bits = 0;
+    };
 }
 
-static unsigned int read_integer(io::BaseBitStream &bit_stream)
+static unsigned int read_integer(BitCache &bit_cache)
 {
-    const auto integer_size = bit_stream.read(2) + 1;
-    return bit_stream.read(integer_size << 3);
+    const auto integer_size = bit_cache.read(2) + 1;
+    return bit_cache.read(integer_size << 3);
 }
 
 bool Pbg3ArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
+}
+
+bool Pbg3ArchiveDecoder::entries_are_independent() const
+{
+    return true;
 }
 
 std::unique_ptr<dec::ArchiveMeta> Pbg3ArchiveDecoder::read_meta_impl(
     const Logger &logger, io::File &input_file) const
 {
+    // two variable-width integers, at most 68 bits
     input_file.stream.seek(magic.size());
-
-    io::MsbBitStream header_bit_stream(input_file.stream);
-    const auto file_count = read_integer(header_bit_stream);
-    const auto table_offset = read_integer(header_bit_stream);
+    const auto header_data = input_file.stream.read(std::min<uoff_t>(
+        9, input_file.stream.size() - magic.size()));
+    BitCache header_bits(header_data);
+    const auto file_count = read_integer(header_bits);
+    const auto table_offset = read_integer(header_bits);
 
     input_file.stream.seek(table_offset);
-    io::MsbBitStream table_bit_stream(input_file.stream);
+    const auto table_data = input_file.stream.read_to_eof();
+    BitCache table_bits(table_data);
 
     CustomArchiveEntry *last_entry = nullptr;
     auto meta = std::make_unique<ArchiveMeta>();
     for (const auto i : algo::range(file_count))
     {
         auto entry = std::make_unique<CustomArchiveEntry>();
-        read_integer(table_bit_stream);
-        read_integer(table_bit_stream);
-        entry->checksum = read_integer(table_bit_stream);
-        entry->offset = read_integer(table_bit_stream);
-        entry->size_orig = read_integer(table_bit_stream);
+        read_integer(table_bits);
+        read_integer(table_bits);
+        entry->checksum = read_integer(table_bits);
+        entry->offset = read_integer(table_bits);
+        entry->size_orig = read_integer(table_bits);
         std::string name;
         for (const auto j : algo::range(256))
         {
-            char c = table_bit_stream.read(8);
+            char c = table_bits.read(8);
             if (c == 0)
                 break;
             name += c;
@@ -94,16 +133,40 @@ std::unique_ptr<io::File> Pbg3ArchiveDecoder::read_file_impl(
 {
     const auto entry = static_cast<const CustomArchiveEntry*>(&e);
     input_file.stream.seek(entry->offset);
-    io::MsbBitStream bit_stream(input_file.stream.read(entry->size_comp));
-
-    algo::pack::BitwiseLzssSettings settings;
-    settings.position_bits = 13;
-    settings.size_bits = 4;
-    settings.min_match_size = 3;
-    settings.initial_dictionary_pos = 1;
-    const auto data = algo::pack::lzss_decompress(
-        bit_stream, entry->size_orig, settings);
-    return std::make_unique<io::File>(entry->path, data);
+    const auto input = input_file.stream.read(entry->size_comp);
+    BitCache bits(input);
+
+    // bitwise LZSS with a 13-bit window, inlined over the local cache
+    algo::ScratchBuffer dict(1 << 13);
+    size_t dict_pos = 1;
+
+    bstr output(entry->size_orig);
+    u8 *output_ptr = output.get<u8>();
+    const u8 *output_end = output_ptr + output.size();
+    while (output_ptr < output_end)
+    {
+        if (bits.read(1))
+        {
+            const u8 b = bits.read(8);
+            *output_ptr++ = b;
+            dict[dict_pos] = b;
+            dict_pos = (dict_pos + 1) & 0x1FFF;
+        }
+        else
+        {
+            auto look_behind_pos = bits.read(13);
+            auto repetitions = bits.read(4) + 3;
+            while (repetitions-- && output_ptr < output_end)
+            {
+                const u8 b = dict[look_behind_pos];
+                look_behind_pos = (look_behind_pos + 1) & 0x1FFF;
+                *output_ptr++ = b;
+                dict[dict_pos] = b;
+                dict_pos = (dict_pos + 1) & 0x1FFF;
+            }
+        }
+    }
+    return std::make_unique<io::File>(entry->path, output);
 }
 
 std::vector<std::string> Pbg3ArchiveDecoder::get_linked_formats() const
@@ -37,7 +37,7 @@ static bstr decompress(const bstr &data, size_t size_orig)
 
 bool Pbg4ArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> Pbg4ArchiveDecoder::read_meta_impl(
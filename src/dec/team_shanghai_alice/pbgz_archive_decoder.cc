@@ -113,7 +113,7 @@ static size_t detect_encryption_version(
 
 bool PbgzArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> PbgzArchiveDecoder::read_meta_impl(
@@ -29,14 +29,9 @@ static const bstr magic = "THA1"_b;
 
 namespace
 {
-    struct CustomArchiveMeta final : dec::ArchiveMeta
-    {
-        size_t encryption_version;
-    };
-
     struct CustomArchiveEntry  final : dec::CompressedArchiveEntry
     {
-        u8 decryptor_id;
+        DecryptorContext crypt;
     };
 }
 
@@ -128,7 +123,7 @@ bool Tha1ArchiveDecoder::is_recognized_impl(io::File &input_file) const
     auto header_data = input_file.stream.read(16);
     header_data = decrypt(header_data, {0x1B, 0x37, 0x10, 0x400});
     io::MemoryByteStream header_stream(header_data);
-    return header_stream.read(magic.size()) == magic;
+    return header_stream.matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> Tha1ArchiveDecoder::read_meta_impl(
@@ -150,8 +145,12 @@ std::unique_ptr<dec::ArchiveMeta> Tha1ArchiveDecoder::read_meta_impl(
     table_data = decompress(table_data, table_size_orig);
     io::MemoryByteStream table_stream(table_data);
 
+    // resolving the crypt parameters here keeps extraction independent
+    // of anything but the entry itself
+    const auto encryption_version = detect_encryption_version(input_file);
+
     CustomArchiveEntry *last_entry = nullptr;
-    auto meta = std::make_unique<CustomArchiveMeta>();
+    auto meta = std::make_unique<dec::ArchiveMeta>();
     for (const auto i : algo::range(file_count))
     {
         auto entry = std::make_unique<CustomArchiveEntry>();
@@ -159,10 +158,10 @@ std::unique_ptr<dec::ArchiveMeta> Tha1ArchiveDecoder::read_meta_impl(
         entry->path = table_stream.read_to_zero().str();
         table_stream.skip(3 - entry->path.str().size() % 4);
 
-        entry->decryptor_id = 0;
+        u8 decryptor_id = 0;
         for (const auto &c : entry->path.str())
-            entry->decryptor_id += c;
-        entry->decryptor_id %= 8;
+            decryptor_id += c;
+        entry->crypt = decryptors[encryption_version][decryptor_id % 8];
 
         entry->offset = table_stream.read_le<u32>();
         entry->size_orig = table_stream.read_le<u32>();
@@ -176,8 +175,14 @@ std::unique_ptr<dec::ArchiveMeta> Tha1ArchiveDecoder::read_meta_impl(
     if (last_entry)
         last_entry->size_comp = table_offset - last_entry->offset;
 
-    meta->encryption_version = detect_encryption_version(input_file);
-    return std::move(meta);
+    return meta;
+}
+
+bool Tha1ArchiveDecoder::entries_are_independent() const
+{
+    // each entry carries its own crypt context and reads only its own
+    // byte range
+    return true;
 }
 
 std::unique_ptr<io::File> Tha1ArchiveDecoder::read_file_impl(
@@ -186,12 +191,10 @@ std::unique_ptr<io::File> Tha1ArchiveDecoder::read_file_impl(
     const dec::ArchiveMeta &m,
     const dec::ArchiveEntry &e) const
 {
-    const auto meta = static_cast<const CustomArchiveMeta*>(&m);
     const auto entry = static_cast<const CustomArchiveEntry*>(&e);
 
     auto data = input_file.stream.seek(entry->offset).read(entry->size_comp);
-    data = decrypt(
-        data, decryptors[meta->encryption_version][entry->decryptor_id]);
+    data = decrypt(data, entry->crypt);
     if (entry->size_comp != entry->size_orig)
         data = decompress(data, entry->size_orig);
 
@@ -27,6 +27,7 @@ namespace team_shanghai_alice {
     {
     public:
         std::vector<std::string> get_linked_formats() const override;
+        bool entries_are_independent() const override;
 
     protected:
         bool is_recognized_impl(io::File &input_file) const override;
@@ -16,6 +16,7 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "dec/team_shanghai_alice/thbgm_audio_archive_decoder.h"
+#include <algorithm>
 #include "algo/range.h"
 #include "algo/str.h"
 #include "dec/team_shanghai_alice/pbg4_archive_decoder.h"
@@ -24,6 +25,7 @@
 #include "enc/microsoft/wav_audio_encoder.h"
 #include "err.h"
 #include "io/file_system.h"
+#include "io/slice_byte_stream.h"
 
 using namespace au;
 using namespace au::dec::team_shanghai_alice;
@@ -81,7 +83,7 @@ static std::unique_ptr<io::File> grab_definitions_file(
 
 bool ThbgmAudioArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> ThbgmAudioArchiveDecoder::read_meta_impl(
@@ -116,6 +118,14 @@ std::unique_ptr<dec::ArchiveMeta> ThbgmAudioArchiveDecoder::read_meta_impl(
     return meta;
 }
 
+bool ThbgmAudioArchiveDecoder::entries_are_independent() const
+{
+    // each track reads only its own PCM range of the dat through the
+    // stream view it is handed, so the tracks can be extracted in
+    // parallel and the dat's bytes are touched about once in total
+    return true;
+}
+
 std::unique_ptr<io::File> ThbgmAudioArchiveDecoder::read_file_impl(
     const Logger &logger,
     io::File &input_file,
@@ -123,19 +133,28 @@ std::unique_ptr<io::File> ThbgmAudioArchiveDecoder::read_file_impl(
     const dec::ArchiveEntry &e) const
 {
     const auto entry = static_cast<const CustomArchiveEntry*>(&e);
-    const auto samples = input_file.stream
-        .seek(entry->offset)
-        .read(entry->size);
-
-    res::Audio audio;
-    audio.channel_count = entry->channel_count;
-    audio.bits_per_sample = entry->bits_per_sample;
-    audio.sample_rate = entry->sample_rate;
-    audio.samples = samples;
-    audio.loops.push_back(res::AudioLoopInfo
+
+    res::Audio spec;
+    spec.channel_count = entry->channel_count;
+    spec.bits_per_sample = entry->bits_per_sample;
+    spec.sample_rate = entry->sample_rate;
+    spec.loops.push_back(res::AudioLoopInfo
         {entry->intro_size, entry->size - entry->intro_size, 0});
-    const auto encoder = enc::microsoft::WavAudioEncoder();
-    return encoder.encode(logger, audio, entry->path);
+
+    // the track is a plain PCM range of the monolithic dat; stream it
+    // through the WAV encoder in bounded chunks over a read-only view
+    // instead of assembling the whole track in memory first
+    auto output_file = std::make_unique<io::File>(entry->path, ""_b);
+    enc::microsoft::WavBlockEncoder encoder(output_file->stream, spec);
+    io::SliceByteStream segment(
+        input_file.stream, entry->offset, entry->size);
+    segment.seek(0);
+    static const uoff_t chunk_size = 0x100000;
+    while (segment.left())
+        encoder.write_block(segment.read(std::min(chunk_size, segment.left())));
+    encoder.finish();
+    output_file->path.change_extension("wavloop");
+    return output_file;
 }
 
 static auto _ = dec::register_decoder<ThbgmAudioArchiveDecoder>(
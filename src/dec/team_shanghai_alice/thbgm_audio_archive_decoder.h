@@ -28,6 +28,8 @@ namespace team_shanghai_alice {
     public:
         bool is_recognized_impl(io::File &input_file) const override;
 
+        bool entries_are_independent() const override;
+
         std::unique_ptr<ArchiveMeta> read_meta_impl(
             const Logger &logger,
             io::File &input_file) const override;
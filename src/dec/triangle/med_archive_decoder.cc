@@ -26,7 +26,7 @@ static const auto magic = "MD"_b;
 
 bool MedArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.seek(0).read(magic.size()) == magic;
+    return input_file.stream.seek(0).matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> MedArchiveDecoder::read_meta_impl(
@@ -61,7 +61,7 @@ static bstr decode_audio(
 
 bool WadyAudioDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 res::Audio WadyAudioDecoder::decode_impl(
@@ -27,7 +27,7 @@ static const bstr magic = "YB"_b;
 
 bool YbImageDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.seek(0).read(magic.size()) == magic;
+    return input_file.stream.seek(0).matches(magic);
 }
 
 res::Image YbImageDecoder::decode_impl(
@@ -117,3 +117,20 @@ std::vector<std::string> Pak1ArchiveDecoder::get_linked_formats() const
 
 static auto _ = dec::register_decoder<Pak1ArchiveDecoder>(
     "twilight-frontier/pak1");
+
+// There is no magic; full recognition decrypts and walks the whole entry
+// table. The header arithmetic alone rules out most foreign files: the
+// entry count must leave room for an 0x6C-byte table record apiece.
+static auto _2 = dec::register_gate(
+    "twilight-frontier/pak1",
+    2,
+    [](const bstr &prefix, const uoff_t file_size)
+    {
+        if (prefix.size() < 2)
+            return false;
+        io::MemoryByteStream header(prefix);
+        const auto file_count = header.read_le<u16>();
+        if (!file_count)
+            return file_size == 6;
+        return 2 + file_count * 0x6Cull <= file_size;
+    });
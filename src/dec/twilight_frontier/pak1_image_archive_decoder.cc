@@ -76,7 +76,7 @@ std::unique_ptr<dec::ArchiveMeta> Pak1ImageArchiveDecoder::read_meta_impl(
         input_file.stream.skip(4);
         entry->depth = input_file.stream.read<u8>();
         entry->size = input_file.stream.read_le<u32>();
-        entry->path = algo::format("%04d", i++);
+        entry->path = algo::format("%04d", static_cast<int>(i++));
         entry->offset = input_file.stream.pos();
         input_file.stream.skip(entry->size);
         meta->entries.push_back(std::move(entry));
@@ -16,6 +16,7 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "dec/twilight_frontier/pak2_archive_decoder.h"
+#include <algorithm>
 #include "algo/binary.h"
 #include "algo/crypt/mt.h"
 #include "algo/locale.h"
@@ -31,12 +32,20 @@ using namespace au::dec::twilight_frontier;
 static void decrypt(bstr &buffer, u32 mt_seed, u8 a, u8 b, u8 delta)
 {
     auto mt = algo::crypt::MersenneTwister::Improved(mt_seed);
-    for (const auto i : algo::range(buffer.size()))
+    u32 keystream[1024];
+    size_t pos = 0;
+    while (pos < buffer.size())
     {
-        buffer[i] ^= mt->next_u32();
-        buffer[i] ^= a;
-        a += b;
-        b += delta;
+        const auto run = std::min<size_t>(buffer.size() - pos, 1024);
+        mt->next_u32_batch(keystream, run);
+        for (const auto i : algo::range(run))
+        {
+            buffer[pos + i] ^= keystream[i];
+            buffer[pos + i] ^= a;
+            a += b;
+            b += delta;
+        }
+        pos += run;
     }
 }
 
@@ -107,3 +116,22 @@ std::vector<std::string> Pak2ArchiveDecoder::get_linked_formats() const
 
 static auto _ = dec::register_decoder<Pak2ArchiveDecoder>(
     "twilight-frontier/pak2");
+
+// No magic; recognition otherwise decrypts the whole file table. The
+// declared table size must fit both the file and the per-entry maximum
+// before that is worth doing.
+static auto _2 = dec::register_gate(
+    "twilight-frontier/pak2",
+    6,
+    [](const bstr &prefix, const uoff_t file_size)
+    {
+        if (prefix.size() < 6)
+            return false;
+        io::MemoryByteStream header(prefix);
+        const auto file_count = header.read_le<u16>();
+        if (!file_count)
+            return file_size == 6;
+        const auto table_size = header.read_le<u32>();
+        return table_size <= file_size - 6
+            && table_size <= file_count * (4 + 4 + 256 + 1ull);
+    });
@@ -16,11 +16,13 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "dec/twilight_frontier/tfbm_image_decoder.h"
+#include <cstring>
+#include <map>
+#include <mutex>
 #include "algo/format.h"
 #include "algo/pack/zlib.h"
 #include "algo/range.h"
 #include "err.h"
-#include "io/memory_byte_stream.h"
 #include "virtual_file_system.h"
 
 using namespace au;
@@ -29,9 +31,47 @@ using namespace au::dec::twilight_frontier;
 static const bstr pal_magic = "TFPA\x00"_b;
 static const bstr magic = "TFBM\x00"_b;
 
+// Frame archives point thousands of images at the same palette file, and
+// fetching it through the virtual file system re-extracts it from the
+// parent archive every time. Parsed palettes are therefore shared for the
+// lifetime of the run, keyed by the VFS path (which includes the parent
+// archive's base name). Missing palettes are not cached so that every
+// affected image still gets its warning.
+static std::shared_ptr<const res::Palette> get_palette(
+    const Logger &logger, const io::path &palette_path)
+{
+    static std::mutex mutex;
+    static std::map<io::path, std::shared_ptr<const res::Palette>> cache;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        const auto it = cache.find(palette_path);
+        if (it != cache.end())
+            return it->second;
+    }
+
+    auto palette_file = VirtualFileSystem::get_by_path(palette_path);
+    if (!palette_file)
+    {
+        logger.warn("Palette %s not found\n", palette_path.c_str());
+        return std::make_shared<res::Palette>(256);
+    }
+
+    palette_file->stream.seek(0);
+    if (palette_file->stream.read(pal_magic.size()) != pal_magic)
+        throw err::RecognitionError();
+    const auto pal_size = palette_file->stream.read_le<u32>();
+    const auto pal_data = palette_file->stream.read(pal_size);
+    auto palette = std::make_shared<const res::Palette>(
+        256, algo::pack::zlib_inflate(pal_data), res::PixelFormat::BGRA5551);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    cache[palette_path] = palette;
+    return palette;
+}
+
 bool TfbmImageDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 res::Image TfbmImageDecoder::decode_impl(
@@ -44,64 +84,53 @@ res::Image TfbmImageDecoder::decode_impl(
     const auto stride = input_file.stream.read_le<u32>();
     const auto pix_size = input_file.stream.read_le<u32>();
     const auto pix_data = input_file.stream.read(pix_size);
-    io::MemoryByteStream source_stream(algo::pack::zlib_inflate(pix_data));
+    const auto source = algo::pack::zlib_inflate(pix_data);
+
+    size_t bytes_per_pixel;
+    switch (bit_depth)
+    {
+        case 32: bytes_per_pixel = 4; break;
+        case 16: bytes_per_pixel = 2; break;
+        case 8: bytes_per_pixel = 1; break;
+        default: throw err::UnsupportedBitDepthError(bit_depth);
+    }
+    if (source.size() < height * stride * bytes_per_pixel)
+        throw err::BadDataSizeError();
+    const auto *source_ptr = source.get<const u8>();
 
-    std::shared_ptr<res::Palette> palette;
     if (bit_depth == 8)
     {
         const auto palette_path = input_file.path.parent()
             / algo::format("palette000.bmp");
-        auto palette_file = VirtualFileSystem::get_by_path(palette_path);
-        if (!palette_file)
+        const auto palette = get_palette(logger, palette_path);
+        if (stride == width)
+            return res::Image(width, height, source, *palette);
+        bstr indices(width * height);
+        for (const auto y : algo::range(height))
         {
-            logger.warn("Palette %s not found\n", palette_path.c_str());
-            palette = std::make_shared<res::Palette>(256);
-        }
-        else
-        {
-            palette_file->stream.seek(0);
-            if (palette_file->stream.read(pal_magic.size()) != pal_magic)
-                throw err::RecognitionError();
-            const auto pal_size = palette_file->stream.read_le<u32>();
-            const auto pal_data = palette_file->stream.read(pal_size);
-            palette = std::make_shared<res::Palette>(
-                256,
-                algo::pack::zlib_inflate(pal_data),
-                res::PixelFormat::BGRA5551);
+            std::memcpy(
+                indices.get<u8>() + y * width, source_ptr + y * stride, width);
         }
+        return res::Image(width, height, indices, *palette);
     }
 
+    // rows are padded to the source stride; convert each row's used span
+    // in place rather than filtering padding out pixel by pixel
     res::Image image(width, height);
-    auto *pixels_ptr = &image.at(0, 0);
-    for (const size_t y : algo::range(height))
-    for (const size_t x : algo::range(stride))
+    for (const auto y : algo::range(height))
     {
-        res::Pixel pixel;
-
-        switch (bit_depth)
+        const auto *row_src = source_ptr + y * stride * bytes_per_pixel;
+        auto *row_dst = image.row(y);
+        if (bit_depth == 32)
         {
-            case 32:
-                pixel = res::read_pixel<res::PixelFormat::BGRA8888>(
-                    source_stream);
-                break;
-
-            case 16:
-                pixel = res::read_pixel<res::PixelFormat::BGR565>(
-                    source_stream);
-                break;
-
-            case 8:
-                pixel = (*palette)[source_stream.read<u8>()];
-                break;
-
-            default:
-                throw err::UnsupportedBitDepthError(bit_depth);
+            std::memcpy(row_dst, row_src, width * sizeof(res::Pixel));
+        }
+        else
+        {
+            for (const auto x : algo::range(width))
+                row_dst[x] = res::read_pixel<res::PixelFormat::BGR565>(row_src);
         }
-
-        if (x < width)
-            *pixels_ptr++ = pixel;
     }
-
     return image;
 }
 
@@ -37,7 +37,7 @@ static void write_cell(io::BaseByteStream &output_stream, std::string cell)
 
 bool TfcsFileDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 std::unique_ptr<io::File> TfcsFileDecoder::decode_impl(
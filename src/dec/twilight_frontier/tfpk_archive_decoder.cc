@@ -147,11 +147,12 @@ RsaReader::RsaReader(io::BaseByteStream &input_stream)
 
     for (const auto &rsa_key : rsa_keys)
     {
-        algo::crypt::Rsa tester(rsa_key);
+        auto tester = std::make_unique<algo::crypt::Rsa>(rsa_key);
         try
         {
-            tester.decrypt(test_chunk);
-            rsa = std::make_unique<algo::crypt::Rsa>(rsa_key);
+            tester->decrypt(test_chunk);
+            // keep the tester - its key context is already warmed up
+            rsa = std::move(tester);
             return;
         }
         catch (...)
@@ -193,24 +194,30 @@ static bstr read_file_content(
     input_file.stream.seek(entry.offset);
     auto data = input_file.stream.read(std::min<size_t>(max_size, entry.size));
     const auto key_size = entry.key.size();
+    auto *key = entry.key.get<const u8>();
+    auto *buf = data.get<u8>();
     if (meta.version == TfpkVersion::Th135)
     {
-        for (const auto i : algo::range(data.size()))
-            data[i] ^= entry.key[i % key_size];
+        // apply the key one period at a time so the modulo stays out of
+        // the inner loop
+        size_t pos = 0;
+        while (pos < data.size())
+        {
+            const auto run = std::min(key_size, data.size() - pos);
+            for (const auto i : algo::range(run))
+                buf[pos + i] ^= key[i];
+            pos += run;
+        }
     }
     else
     {
-        auto *key = entry.key.get<const u8>();
-        auto *buf = data.get<u8>();
-        u8 aux[4];
-        for (const auto i : algo::range(4))
-            aux[i] = key[i];
-        for (const auto i : algo::range(data.size()))
-        {
-            const auto tmp = buf[i];
-            buf[i] = tmp ^ key[i % key_size] ^ aux[i & 3];
-            aux[i & 3] = tmp;
-        }
+        // each lane feeds on the previous ciphertext byte of that lane;
+        // running the loop backwards makes every store depend on input
+        // bytes only, cutting the serial chain
+        for (auto i = data.size(); i-- > 4; )
+            buf[i] ^= key[i % key_size] ^ buf[i - 4];
+        for (auto i = std::min<size_t>(4, data.size()); i-- > 0; )
+            buf[i] ^= key[i % key_size] ^ key[i];
     }
     return data;
 }
@@ -453,6 +460,13 @@ std::unique_ptr<dec::ArchiveMeta> TfpkArchiveDecoder::read_meta_impl(
     return std::move(meta);
 }
 
+bool TfpkArchiveDecoder::entries_are_independent() const
+{
+    // the per-entry keys are resolved at meta time, so extraction only
+    // touches the entry's own byte range
+    return true;
+}
+
 std::unique_ptr<io::File> TfpkArchiveDecoder::read_file_impl(
     const Logger &logger,
     io::File &input_file,
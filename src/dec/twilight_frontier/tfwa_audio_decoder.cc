@@ -24,7 +24,7 @@ static const bstr magic = "TFWA\x00"_b;
 
 bool TfwaAudioDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 res::Audio TfwaAudioDecoder::decode_impl(
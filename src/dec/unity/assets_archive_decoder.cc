@@ -68,7 +68,9 @@ std::unique_ptr<dec::ArchiveMeta> AssetsArchiveDecoder::read_meta_impl(
     if (header.version > 5)
         custom_stream.set_endianness(algo::Endianness::LittleEndian);
 
-    Meta assets_meta(custom_stream, header.version);
+    // only the object headers matter for extraction; the object id and
+    // file id tables that follow them are never consulted
+    Meta assets_meta(custom_stream, header.version, true);
     const auto &object_info_map = *assets_meta.object_info_table;
     const auto &type_tree_map = *assets_meta.type_tree;
 
@@ -87,6 +89,12 @@ std::unique_ptr<dec::ArchiveMeta> AssetsArchiveDecoder::read_meta_impl(
     return meta;
 }
 
+bool AssetsArchiveDecoder::entries_are_independent() const
+{
+    // objects are plain disjoint slices of the data section
+    return true;
+}
+
 std::unique_ptr<io::File> AssetsArchiveDecoder::read_file_impl(
     const Logger &logger,
     io::File &input_file,
@@ -31,7 +31,8 @@ template<typename TTypeTree, typename TType> static auto get_w_reader(
         });
 }
 
-Meta::Meta(CustomStream &input_stream, const int version)
+Meta::Meta(
+    CustomStream &input_stream, const int version, const bool objects_only)
 {
     // tree
     if (version > 13)
@@ -58,6 +59,9 @@ Meta::Meta(CustomStream &input_stream, const int version)
             = get_w_reader<ObjectInfoTableV1, ObjectInfoV1>(input_stream);
     }
 
+    if (objects_only)
+        return;
+
     // object ids
     if (version > 10)
         object_id_table = std::make_unique<ObjectIdTable>(input_stream);
@@ -30,7 +30,14 @@ namespace unity {
 
     struct Meta final
     {
-        Meta(CustomStream &input_stream, const int version);
+        // the sections are stored back to back with no offset table, so
+        // everything up to and including the object table has to be
+        // walked; objects_only stops there and leaves the object id and
+        // file id tables unparsed
+        Meta(
+            CustomStream &input_stream,
+            const int version,
+            const bool objects_only = false);
 
         // DataBlock type_tree_block;
         // DataBlock object_info_block;
@@ -16,6 +16,7 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "dec/vorbis/packed_ogg_audio_decoder.h"
+#include <cstring>
 #include "algo/range.h"
 #include "err.h"
 #include "io/memory_byte_stream.h"
@@ -25,52 +26,32 @@ using namespace au::dec::vorbis;
 
 namespace
 {
-    struct OggPage final
+    // Kept pages are copied to the output verbatim, so only the location
+    // of each page and its stream affiliation need to survive the parse.
+    struct OggPageSpan final
     {
-        u8 version;
-        u8 header_type;
-        bstr granule_position;
+        uoff_t offset;
+        size_t size;
         u32 bitstream_serial_number;
-        u32 page_sequence_number;
-        u32 checksum;
-        std::vector<bstr> segments;
     };
 }
 
 static const bstr ogg_magic = "OggS"_b;
 
-static OggPage read_ogg_page(io::BaseByteStream &input_stream)
+static OggPageSpan read_ogg_page_span(io::BaseByteStream &input_stream)
 {
-    OggPage page;
-    page.version = input_stream.read<u8>();
-    page.header_type = input_stream.read<u8>();
-    page.granule_position = input_stream.read(8);
-    page.bitstream_serial_number = input_stream.read_le<u32>();
-    page.page_sequence_number = input_stream.read_le<u32>();
-    page.checksum = input_stream.read_le<u32>();
-    std::vector<size_t> sizes(input_stream.read<u8>());
-    for (auto &size : sizes)
-        size = input_stream.read<u8>();
-    for (auto &size : sizes)
-        page.segments.push_back(input_stream.read(size));
-    return page;
-}
-
-static void write_ogg_page(
-    io::BaseByteStream &output_stream, const OggPage &page)
-{
-    output_stream.write(ogg_magic);
-    output_stream.write<u8>(page.version);
-    output_stream.write<u8>(page.header_type);
-    output_stream.write(page.granule_position);
-    output_stream.write_le<u32>(page.bitstream_serial_number);
-    output_stream.write_le<u32>(page.page_sequence_number);
-    output_stream.write_le<u32>(page.checksum);
-    output_stream.write<u8>(page.segments.size());
-    for (auto &page_segment : page.segments)
-        output_stream.write<u8>(page_segment.size());
-    for (auto &page_segment : page.segments)
-        output_stream.write(page_segment);
+    OggPageSpan span;
+    span.offset = input_stream.pos() - ogg_magic.size();
+    input_stream.skip(10); // version, header type, granule position
+    span.bitstream_serial_number = input_stream.read_le<u32>();
+    input_stream.skip(8); // page sequence number, checksum
+    const auto segment_count = input_stream.read<u8>();
+    size_t payload_size = 0;
+    for (const auto i : algo::range(segment_count))
+        payload_size += input_stream.read<u8>();
+    input_stream.skip(payload_size);
+    span.size = input_stream.pos() - span.offset;
+    return span;
 }
 
 bool PackedOggAudioDecoder::is_recognized_impl(io::File &input_file) const
@@ -85,24 +66,29 @@ bool PackedOggAudioDecoder::is_recognized_impl(io::File &input_file) const
 
 static void rewrite_ogg_stream(
     const Logger &logger,
-    io::BaseByteStream &input_stream,
+    io::MemoryByteStream &input_stream,
     io::BaseByteStream &output_stream)
 {
     // The OGG files used by LiarSoft may contain multiple streams, out of
     // which only the first one contains actual audio data.
 
+    // The parse pass touches only page headers; payload bytes stay in the
+    // input buffer until the copy pass moves each kept page in one go.
+    // Since pages are copied bit for bit, their checksums remain valid.
+    std::vector<OggPageSpan> spans;
+    size_t total_size = 0;
     u32 initial_serial_number = 0;
     auto pages = 0;
     auto serial_number_known = false;
     while (input_stream.left())
     {
-        OggPage page;
+        OggPageSpan span;
         try
         {
             if (input_stream.read(4) != ogg_magic)
                 throw err::CorruptDataError("Expected OGG signature");
 
-            page = read_ogg_page(input_stream);
+            span = read_ogg_page_span(input_stream);
         }
         catch (const err::IoError)
         {
@@ -113,18 +99,30 @@ static void rewrite_ogg_stream(
 
         if (!serial_number_known)
         {
-            initial_serial_number = page.bitstream_serial_number;
+            initial_serial_number = span.bitstream_serial_number;
             serial_number_known = true;
         }
 
         // The extra streams cause problems with popular (notably, all
         // ffmpeg-based) audio players, so we discard these streams here.
-        if (page.bitstream_serial_number == initial_serial_number)
+        if (span.bitstream_serial_number == initial_serial_number)
         {
-            write_ogg_page(output_stream, page);
+            spans.push_back(span);
+            total_size += span.size;
             pages++;
         }
     }
+
+    const auto source = input_stream.shared_buffer();
+    bstr output(total_size);
+    auto output_ptr = output.get<u8>();
+    for (const auto &span : spans)
+    {
+        std::memcpy(
+            output_ptr, source->get<const u8>() + span.offset, span.size);
+        output_ptr += span.size;
+    }
+    output_stream.write(output);
 }
 
 std::unique_ptr<io::File> PackedOggAudioDecoder::decode_impl(
@@ -24,7 +24,7 @@ static const bstr magic = "$SYG"_b;
 
 bool SygImageDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 res::Image SygImageDecoder::decode_impl(
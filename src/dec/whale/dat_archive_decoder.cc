@@ -16,6 +16,7 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "dec/whale/dat_archive_decoder.h"
+#include <algorithm>
 #include <cmath>
 #include <map>
 #include "algo/format.h"
@@ -40,6 +41,7 @@ namespace
     {
         bstr game_title;
         bstr game_key;
+        u64 game_key_hash;
     };
 
     struct CustomArchiveEntry final : dec::CompressedArchiveEntry
@@ -127,11 +129,13 @@ static u64 CRC_TABLE[0x100] =
 
 static u64 crc64(const bstr &buffer)
 {
+    // hashing runs once per candidate name, so it reads through a raw
+    // pointer rather than the out-of-line bstr accessor
     u64 crc = 0xFFFFFFFFFFFFFFFF;
+    const auto buffer_ptr = buffer.get<const u8>();
     for (const auto i : algo::range(buffer.size()))
     {
-        const auto c = static_cast<u8>(buffer[i]);
-        const auto tab_index = ((crc >> 56) ^ c) & 0xFF;
+        const auto tab_index = ((crc >> 56) ^ buffer_ptr[i]) & 0xFF;
         crc = CRC_TABLE[tab_index] ^ ((crc << 8) & 0xFFFFFFFFFFFFFFFF);
     }
     return crc ^ 0xFFFFFFFFFFFFFFFF;
@@ -140,23 +144,27 @@ static u64 crc64(const bstr &buffer)
 static void transform_regular_content(
     bstr &buffer, const bstr &file_name)
 {
-    auto block_size = static_cast<size_t>(
+    const auto block_size = static_cast<size_t>(
         std::floor(buffer.size() / static_cast<float>(file_name.size())));
     u8 *buffer_ptr = buffer.get<u8>();
     u8 *buffer_end = buffer_ptr + buffer.size();
+    const auto key_ptr = file_name.get<const u8>();
     for (const auto j : algo::range(file_name.size() - 1))
-    for (const auto k : algo::range(block_size))
     {
-        if (buffer_ptr >= buffer_end)
-            return;
-        *buffer_ptr++ ^= file_name[j];
+        // whole blocks XOR against one key byte, so each block is a
+        // flat span the compiler can widen
+        const auto run = std::min<size_t>(block_size, buffer_end - buffer_ptr);
+        const auto key = key_ptr[j];
+        for (const auto k : algo::range(run))
+            buffer_ptr[k] ^= key;
+        buffer_ptr += run;
     }
 }
 
 static void transform_script_content(
-    bstr &buffer, const u64 hash, const bstr &game_key)
+    bstr &buffer, const u64 hash, const u64 game_key_hash)
 {
-    const u32 xor_value = (hash ^ crc64(game_key)) & 0xFFFFFFFF;
+    const u32 xor_value = (hash ^ game_key_hash) & 0xFFFFFFFF;
     for (const auto i : algo::range(buffer.size() / 4))
         buffer.get<u32>()[i] ^= xor_value;
 }
@@ -182,7 +190,9 @@ static void dump(
         if (entry->name_valid)
             stream.write(entry->path.str() + "\n");
         else
-            stream.write(algo::format("unk:%016llx\n", entry->hash));
+            stream.write(algo::format(
+                "unk:%016llx\n",
+                static_cast<unsigned long long>(entry->hash)));
 
         logger.info(
             "%d 0x%016llxull 0x%08x/%d 0x%08x/%d 0x%08x/%d %s\n",
@@ -257,6 +267,9 @@ std::unique_ptr<dec::ArchiveMeta> DatArchiveDecoder::read_meta_impl(
     auto meta = std::make_unique<CustomArchiveMeta>();
     meta->game_key = game_key;
     meta->game_title = game_title;
+    // the key hash is constant per archive; scripts used to rehash it
+    // on every extracted file
+    meta->game_key_hash = crc64(game_key);
 
     const auto file_count = read_file_count(input_file.stream);
     for (const auto i : algo::range(file_count))
@@ -385,7 +398,7 @@ std::unique_ptr<io::File> DatArchiveDecoder::read_file_impl(
     auto data = input_file.stream.seek(entry->offset).read(entry->size_comp);
     if (entry->type == TableEntryType::Compressed)
     {
-        transform_script_content(data, entry->hash, game_key);
+        transform_script_content(data, entry->hash, meta->game_key_hash);
         data = algo::pack::zlib_inflate(data);
     }
     else
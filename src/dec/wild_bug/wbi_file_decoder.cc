@@ -26,7 +26,7 @@ static const bstr magic = "WPX\x1A""EX2\x00"_b;
 
 bool WbiFileDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 std::unique_ptr<io::File> WbiFileDecoder::decode_impl(
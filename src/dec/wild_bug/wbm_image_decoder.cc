@@ -83,7 +83,7 @@ static res::Image get_image(
 
 bool WbmImageDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 res::Image WbmImageDecoder::decode_impl(
@@ -26,7 +26,7 @@ static const bstr magic = "ARCFORM4\x20WBUG\x20"_b;
 
 bool WbpArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> WbpArchiveDecoder::read_meta_impl(
@@ -37,7 +37,7 @@ namespace
 
 bool WpnAudioDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 res::Audio WpnAudioDecoder::decode_impl(
@@ -121,6 +121,72 @@ bstr Decoder::read_compressed_section(u8 section_id)
     return read_compressed_section(section_id, -1, {0, 0, 0, 0, 0, 0, 0, 0});
 }
 
+// the strategy pair is fixed for the whole section, so the main loop is
+// instantiated per concrete combination; both strategy classes are final
+// and the calls devirtualize instead of dispatching twice per element
+template<typename TTranscriptor, typename TRetriever>
+static void transcribe(
+    DecoderContext &context,
+    TTranscriptor &transcriptor,
+    TRetriever &retriever,
+    const u8 *output_start,
+    u8 *output_ptr,
+    const u8 *output_end)
+{
+    while (output_ptr < output_end)
+    {
+        if (context.bit_stream.read(1))
+        {
+            *output_ptr = retriever.fetch_byte(context, output_ptr);
+            output_ptr++;
+        }
+        else
+        {
+            auto spec = transcriptor.get_spec(context);
+            auto source_ptr = &output_ptr[-spec.look_behind];
+            if (source_ptr >= output_start)
+                while (spec.size-- && output_ptr < output_end)
+                    *output_ptr++ = *source_ptr++;
+        }
+    }
+}
+
+// the retriever constructors read their code tables off the bit stream,
+// so they must run right before the main loop, after the transcriptor
+// has been picked
+template<typename TTranscriptor>
+static void transcribe(
+    DecoderContext &context,
+    TTranscriptor &transcriptor,
+    const u32 data_format,
+    const s8 quant_size,
+    const u8 *output_start,
+    u8 *output_ptr,
+    const u8 *output_end)
+{
+    if (data_format & 4)
+    {
+        RetrievalStrategy1 retriever(context.bit_stream, quant_size);
+        transcribe(
+            context, transcriptor, retriever,
+            output_start, output_ptr, output_end);
+    }
+    else if (data_format & 2)
+    {
+        RetrievalStrategy2 retriever(context.bit_stream);
+        transcribe(
+            context, transcriptor, retriever,
+            output_start, output_ptr, output_end);
+    }
+    else
+    {
+        RetrievalStrategy3 retriever(context.bit_stream);
+        transcribe(
+            context, transcriptor, retriever,
+            output_start, output_ptr, output_end);
+    }
+}
+
 bstr Decoder::read_compressed_section(
     u8 section_id, s8 quant_size, const std::array<size_t, 8> &offsets)
 {
@@ -149,52 +215,31 @@ bstr Decoder::read_compressed_section(
     section_stream.seek((-quant_size & 3) + quant_size);
     io::MsbBitStream bit_stream(section_stream);
 
-    std::unique_ptr<ITranscriptionStrategy> transcriptor;
+    DecoderContext context {section_stream, bit_stream};
     if (use_plain_transcriptors)
     {
         if (section.data_format & 8)
             throw err::NotSupportedError("Unknown compression type");
-        else
-            transcriptor.reset(new TranscriptionStrategy3());
+        TranscriptionStrategy3 transcriptor;
+        transcribe(
+            context, transcriptor, section.data_format, quant_size,
+            output_start, output_ptr, output_end);
     }
-    else
+    else if (section.data_format & 1)
     {
-        if (section.data_format & 1)
-        {
-            if (section.data_format & 8)
-                throw err::NotSupportedError("Unknown compression type");
-            else
-                transcriptor.reset(new TranscriptionStrategy1(
-                    offsets, quant_size));
-        }
-        else
-            transcriptor.reset(new TranscriptionStrategy2(offsets, quant_size));
+        if (section.data_format & 8)
+            throw err::NotSupportedError("Unknown compression type");
+        TranscriptionStrategy1 transcriptor(offsets, quant_size);
+        transcribe(
+            context, transcriptor, section.data_format, quant_size,
+            output_start, output_ptr, output_end);
     }
-
-    std::unique_ptr<IRetrievalStrategy> retriever;
-    if (section.data_format & 4)
-        retriever.reset(new RetrievalStrategy1(bit_stream, quant_size));
-    else if (section.data_format & 2)
-        retriever.reset(new RetrievalStrategy2(bit_stream));
     else
-        retriever.reset(new RetrievalStrategy3(bit_stream));
-
-    DecoderContext context {section_stream, bit_stream};
-    while (output_ptr < output_end)
     {
-        if (context.bit_stream.read(1))
-        {
-            *output_ptr = retriever->fetch_byte(context, output_ptr);
-            output_ptr++;
-        }
-        else
-        {
-            auto spec = transcriptor->get_spec(context);
-            auto source_ptr = &output_ptr[-spec.look_behind];
-            if (source_ptr >= output_start)
-                while (spec.size-- && output_ptr < output_end)
-                    *output_ptr++ = *source_ptr++;
-        }
+        TranscriptionStrategy2 transcriptor(offsets, quant_size);
+        transcribe(
+            context, transcriptor, section.data_format, quant_size,
+            output_start, output_ptr, output_end);
     }
 
     return output;
@@ -26,7 +26,7 @@ static const bstr magic = "WPX\x1AWAV\x00"_b;
 
 bool WwaAudioDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 res::Audio WwaAudioDecoder::decode_impl(
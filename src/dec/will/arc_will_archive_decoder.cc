@@ -20,6 +20,7 @@
 #include "algo/range.h"
 #include "dec/will/wipf_image_archive_decoder.h"
 #include "err.h"
+#include "io/memory_byte_stream.h"
 
 using namespace au;
 using namespace au::dec::will;
@@ -124,3 +125,19 @@ std::vector<std::string> ArcWillArchiveDecoder::get_linked_formats() const
 }
 
 static auto _ = dec::register_decoder<ArcWillArchiveDecoder>("will/arc-will");
+
+// No magic; recognition otherwise parses the full file table twice (for
+// both known name sizes). The directory count is bounded and must leave
+// room for its 12-byte records.
+static auto _2 = dec::register_gate(
+    "will/arc-will",
+    4,
+    [](const bstr &prefix, const uoff_t file_size)
+    {
+        if (prefix.size() < 4)
+            return false;
+        io::MemoryByteStream header(prefix);
+        const auto dir_count = header.read_le<u32>();
+        return dir_count <= 100
+            && 4 + dir_count * 12ull <= file_size;
+    });
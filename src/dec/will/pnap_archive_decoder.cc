@@ -26,7 +26,7 @@ static const bstr magic = "PNAP"_b;
 
 bool PnapArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.seek(0).read(magic.size()) == magic;
+    return input_file.stream.seek(0).matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> PnapArchiveDecoder::read_meta_impl(
@@ -16,10 +16,10 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "dec/will/wipf_image_archive_decoder.h"
+#include "algo/pack/lzss_engine.h"
 #include "algo/range.h"
 #include "enc/png/png_image_encoder.h"
 #include "err.h"
-#include "io/memory_byte_stream.h"
 #include "virtual_file_system.h"
 
 using namespace au;
@@ -42,46 +42,25 @@ namespace
 // - repetition count and look behind pos differs
 // - non-standard initial dictionary pos
 // - non-standard minimal match size
-static bstr custom_lzss_decompress(const bstr &input, size_t output_size)
+namespace
 {
-    io::MemoryByteStream input_stream(input);
-    const size_t dict_size = 0x1000;
-    size_t dict_pos = 1;
-    u8 dict[dict_size] {};
-    bstr output(output_size);
-    auto output_ptr = output.get<u8>();
-    auto output_end = output.end<const u8>();
-    u16 control = 0;
-    while (output_ptr < output_end && input_stream.left())
+    struct WipfLzssSpec final
     {
-        control >>= 1;
-        if (!(control & 0x100))
-            control = input_stream.read<u8>() | 0xFF00;
-        if (control & 1)
-        {
-            if (!input_stream.left())
-                break;
-            auto byte = input_stream.read<u8>();
-            dict[dict_pos++] = *output_ptr++ = byte;
-            dict_pos %= dict_size;
-            continue;
-        }
-        if (!input_stream.left())
-            break;
-        u8 di = input_stream.read<u8>();
-        if (!input_stream.left())
-            break;
-        u8 tmp = input_stream.read<u8>();
-        u32 look_behind_pos = (((di << 8) | tmp) >> 4);
-        u16 repetitions = (tmp & 0xF) + 2;
-        while (repetitions-- && output_ptr < output_end)
+        static constexpr size_t dict_size = 0x1000;
+
+        static void decode_reference(
+            const u8 lo, const u8 hi,
+            size_t &look_behind_pos, size_t &repetitions)
         {
-            dict[dict_pos++] = *output_ptr++ = dict[look_behind_pos++];
-            look_behind_pos %= dict_size;
-            dict_pos %= dict_size;
+            look_behind_pos = ((lo << 8) | hi) >> 4;
+            repetitions = (hi & 0xF) + 2;
         }
-    }
-    return output;
+    };
+}
+
+static bstr custom_lzss_decompress(const bstr &input, size_t output_size)
+{
+    return algo::pack::lzss_decompress<WipfLzssSpec>(input, output_size, 1);
 }
 
 static std::unique_ptr<res::Image> read_image(
@@ -157,7 +136,7 @@ algo::NamingStrategy WipfImageArchiveDecoder::naming_strategy() const
 
 bool WipfImageArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> WipfImageArchiveDecoder::read_meta_impl(
@@ -103,7 +103,7 @@ static res::Image decode_png(
 
 bool YkgImageDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 res::Image YkgImageDecoder::decode_impl(
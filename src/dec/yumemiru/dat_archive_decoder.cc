@@ -31,7 +31,7 @@ bool DatArchiveDecoder::is_recognized_impl(io::File &input_file) const
     if (input_file.stream.read(magic1.size()) == magic1)
         return true;
     input_file.stream.seek(0);
-    return input_file.stream.read(magic2.size()) == magic2;
+    return input_file.stream.matches(magic2);
 }
 
 std::unique_ptr<dec::ArchiveMeta> DatArchiveDecoder::read_meta_impl(
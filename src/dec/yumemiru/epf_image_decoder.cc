@@ -26,7 +26,7 @@ static const bstr magic = "yga\x00"_b;
 
 bool EpfImageDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.seek(0).read(magic.size()) == magic;
+    return input_file.stream.seek(0).matches(magic);
 }
 
 res::Image EpfImageDecoder::decode_impl(
@@ -26,7 +26,7 @@ static const bstr magic = "YCG\x00"_b;
 
 bool YcgImageDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 res::Image YcgImageDecoder::decode_impl(
@@ -142,7 +142,7 @@ static u8 guess_key(const std::vector<bstr> &names)
 
 bool YpfArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.seek(0).read(magic.size()) == magic;
+    return input_file.stream.seek(0).matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> YpfArchiveDecoder::read_meta_impl(
@@ -189,6 +189,13 @@ std::unique_ptr<dec::ArchiveMeta> YpfArchiveDecoder::read_meta_impl(
     return meta;
 }
 
+bool YpfArchiveDecoder::entries_are_independent() const
+{
+    // the key and name table guesses resolve at meta time; extraction is
+    // a plain read plus optional inflate of the entry's own byte range
+    return true;
+}
+
 std::unique_ptr<io::File> YpfArchiveDecoder::read_file_impl(
     const Logger &logger,
     io::File &input_file,
@@ -25,6 +25,9 @@ namespace yuris {
 
     class YpfArchiveDecoder final : public BaseArchiveDecoder
     {
+    public:
+        bool entries_are_independent() const override;
+
     protected:
         bool is_recognized_impl(io::File &input_file) const override;
         std::vector<std::string> get_linked_formats() const override;
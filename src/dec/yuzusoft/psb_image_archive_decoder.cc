@@ -263,7 +263,7 @@ algo::NamingStrategy PsbImageArchiveDecoder::naming_strategy() const
 
 bool PsbImageArchiveDecoder::is_recognized_impl(io::File &input_file) const
 {
-    return input_file.stream.read(magic.size()) == magic;
+    return input_file.stream.matches(magic);
 }
 
 std::unique_ptr<dec::ArchiveMeta> PsbImageArchiveDecoder::read_meta_impl(
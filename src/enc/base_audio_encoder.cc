@@ -29,3 +29,11 @@ std::unique_ptr<io::File> BaseAudioEncoder::encode(
     encode_impl(logger, input_audio, *output_file);
     return output_file;
 }
+
+void BaseAudioEncoder::encode(
+    const Logger &logger,
+    const res::Audio &input_audio,
+    io::File &output_file) const
+{
+    encode_impl(logger, input_audio, output_file);
+}
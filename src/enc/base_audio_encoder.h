@@ -34,6 +34,13 @@ namespace enc {
             const res::Audio &input_audio,
             const io::path &name) const;
 
+        // Encodes straight into the given file, which may be backed by
+        // disk rather than memory, so that writing overlaps encoding.
+        void encode(
+            const Logger &logger,
+            const res::Audio &input_audio,
+            io::File &output_file) const;
+
     protected:
         virtual void encode_impl(
             const Logger &logger,
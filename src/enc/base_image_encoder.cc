@@ -29,3 +29,11 @@ std::unique_ptr<io::File> BaseImageEncoder::encode(
     encode_impl(logger, input_image, *output_file);
     return output_file;
 }
+
+void BaseImageEncoder::encode(
+    const Logger &logger,
+    const res::Image &input_image,
+    io::File &output_file) const
+{
+    encode_impl(logger, input_image, output_file);
+}
@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include "algo/pack/compression_level.h"
 #include "io/file.h"
 #include "logger.h"
 #include "res/image.h"
@@ -29,11 +30,24 @@ namespace enc {
     public:
         virtual ~BaseImageEncoder() {}
 
+        // How hard the encoder should squeeze its output; encoders whose
+        // container has no compression are free to ignore it.
+        algo::pack::CompressionLevel compression_level
+            = algo::pack::CompressionLevel::Fast;
+
         std::unique_ptr<io::File> encode(
             const Logger &logger,
             const res::Image &input_image,
             const io::path &name) const;
 
+        // Encodes straight into the given file, which may be backed by
+        // disk rather than memory - encoders write row by row, so this
+        // keeps peak memory at O(row) beyond the input image.
+        void encode(
+            const Logger &logger,
+            const res::Image &input_image,
+            io::File &output_file) const;
+
     protected:
         virtual void encode_impl(
             const Logger &logger,
@@ -50,17 +50,21 @@ void BmpImageEncoder::encode_impl(
     output_file.stream.write_le<u32>(0);        // biClrUsed
     output_file.stream.write_le<u32>(0);        // biClrImportant
 
+    // stage one row at a time, so the output sink can be a plain file
+    // stream without per-pixel write overhead
+    bstr row_buffer(stride);
     for (const auto y : algo::range(height))
     {
+        auto row_ptr = row_buffer.get<u8>();
+        const auto *pixels = input_image.row(y);
         for (const auto x : algo::range(width))
         {
-            const auto &c = input_image.at(x, y);
-            output_file.stream.write<u8>(c.b);
-            output_file.stream.write<u8>(c.g);
-            output_file.stream.write<u8>(c.r);
-            output_file.stream.write<u8>(c.a);
+            *row_ptr++ = pixels[x].b;
+            *row_ptr++ = pixels[x].g;
+            *row_ptr++ = pixels[x].r;
+            *row_ptr++ = pixels[x].a;
         }
-        output_file.stream.write(bstr(stride - 4 * width));
+        output_file.stream.write(row_buffer);
     }
 
     output_file.path.change_extension("bmp");
@@ -17,69 +17,104 @@
 
 #include "enc/microsoft/wav_audio_encoder.h"
 #include "algo/range.h"
+#include "res/audio.h"
 
 using namespace au;
 using namespace au::enc::microsoft;
 
-void WavAudioEncoder::encode_impl(
-    const Logger &logger,
-    const res::Audio &input_audio,
-    io::File &output_file) const
+struct WavBlockEncoder::Priv final
+{
+    io::BaseByteStream &output_stream;
+    std::vector<res::AudioLoopInfo> loops;
+    uoff_t riff_base;
+    uoff_t data_size_pos;
+    uoff_t data_size;
+};
+
+WavBlockEncoder::WavBlockEncoder(
+    io::BaseByteStream &output_stream, const res::Audio &spec)
+    : p(new Priv {output_stream, spec.loops, output_stream.pos(), 0, 0})
 {
     const auto block_align
-        = input_audio.channel_count * input_audio.bits_per_sample / 8;
-    const auto byte_rate = input_audio.sample_rate * block_align;
+        = spec.channel_count * spec.bits_per_sample / 8;
+    const auto byte_rate = spec.sample_rate * block_align;
 
-    output_file.stream.write("RIFF"_b);
-    output_file.stream.write("\x00\x00\x00\x00"_b);
-    output_file.stream.write("WAVE"_b);
+    p->output_stream.write("RIFF"_b);
+    p->output_stream.write("\x00\x00\x00\x00"_b);
+    p->output_stream.write("WAVE"_b);
 
-    output_file.stream.write("fmt "_b);
-    output_file.stream.write_le<u32>(
-        18 + input_audio.extra_codec_headers.size());
-    output_file.stream.write_le<u16>(input_audio.codec);
-    output_file.stream.write_le<u16>(input_audio.channel_count);
-    output_file.stream.write_le<u32>(input_audio.sample_rate);
-    output_file.stream.write_le<u32>(byte_rate);
-    output_file.stream.write_le<u16>(block_align);
-    output_file.stream.write_le<u16>(input_audio.bits_per_sample);
-    output_file.stream.write_le<u16>(input_audio.extra_codec_headers.size());
-    output_file.stream.write(input_audio.extra_codec_headers);
+    p->output_stream.write("fmt "_b);
+    p->output_stream.write_le<u32>(18 + spec.extra_codec_headers.size());
+    p->output_stream.write_le<u16>(spec.codec);
+    p->output_stream.write_le<u16>(spec.channel_count);
+    p->output_stream.write_le<u32>(spec.sample_rate);
+    p->output_stream.write_le<u32>(byte_rate);
+    p->output_stream.write_le<u16>(block_align);
+    p->output_stream.write_le<u16>(spec.bits_per_sample);
+    p->output_stream.write_le<u16>(spec.extra_codec_headers.size());
+    p->output_stream.write(spec.extra_codec_headers);
 
-    output_file.stream.write("data"_b);
-    output_file.stream.write_le<u32>(input_audio.samples.size());
-    output_file.stream.write(input_audio.samples);
+    p->output_stream.write("data"_b);
+    p->data_size_pos = p->output_stream.pos();
+    p->output_stream.write("\x00\x00\x00\x00"_b);
+}
 
-    if (!input_audio.loops.empty())
+WavBlockEncoder::~WavBlockEncoder()
+{
+}
+
+void WavBlockEncoder::write_block(const bstr &samples)
+{
+    p->output_stream.write(samples);
+    p->data_size += samples.size();
+}
+
+void WavBlockEncoder::finish()
+{
+    if (!p->loops.empty())
     {
         const auto extra_data = ""_b;
-        output_file.stream.write("smpl"_b);
-        output_file.stream.write_le<u32>(36
-            + (24 * input_audio.loops.size()) + extra_data.size());
-        output_file.stream.write_le<u32>(0); // manufacturer
-        output_file.stream.write_le<u32>(0); // product
-        output_file.stream.write_le<u32>(0); // sample period
-        output_file.stream.write_le<u32>(0); // midi unity note
-        output_file.stream.write_le<u32>(0); // midi pitch fraction
-        output_file.stream.write_le<u32>(0); // smpte format
-        output_file.stream.write_le<u32>(0); // smpte offset
-        output_file.stream.write_le<u32>(input_audio.loops.size());
-        output_file.stream.write_le<u32>(extra_data.size());
-        for (const auto i : algo::range(input_audio.loops.size()))
+        p->output_stream.write("smpl"_b);
+        p->output_stream.write_le<u32>(36
+            + (24 * p->loops.size()) + extra_data.size());
+        p->output_stream.write_le<u32>(0); // manufacturer
+        p->output_stream.write_le<u32>(0); // product
+        p->output_stream.write_le<u32>(0); // sample period
+        p->output_stream.write_le<u32>(0); // midi unity note
+        p->output_stream.write_le<u32>(0); // midi pitch fraction
+        p->output_stream.write_le<u32>(0); // smpte format
+        p->output_stream.write_le<u32>(0); // smpte offset
+        p->output_stream.write_le<u32>(p->loops.size());
+        p->output_stream.write_le<u32>(extra_data.size());
+        for (const auto i : algo::range(p->loops.size()))
         {
-            const auto loop = input_audio.loops[i];
-            output_file.stream.write_le<u32>(i);
-            output_file.stream.write_le<u32>(0); // type
-            output_file.stream.write_le<u32>(loop.start);
-            output_file.stream.write_le<u32>(loop.end);
-            output_file.stream.write_le<u32>(0); // fraction
-            output_file.stream.write_le<u32>(loop.play_count);
+            const auto loop = p->loops[i];
+            p->output_stream.write_le<u32>(i);
+            p->output_stream.write_le<u32>(0); // type
+            p->output_stream.write_le<u32>(loop.start);
+            p->output_stream.write_le<u32>(loop.end);
+            p->output_stream.write_le<u32>(0); // fraction
+            p->output_stream.write_le<u32>(loop.play_count);
         }
-        output_file.stream.write(extra_data);
+        p->output_stream.write(extra_data);
     }
 
-    output_file.stream.seek(4);
-    output_file.stream.write_le<u32>(output_file.stream.size() - 8);
+    const auto end_pos = p->output_stream.pos();
+    p->output_stream.seek(p->data_size_pos);
+    p->output_stream.write_le<u32>(p->data_size);
+    p->output_stream.seek(p->riff_base + 4);
+    p->output_stream.write_le<u32>(end_pos - p->riff_base - 8);
+    p->output_stream.seek(end_pos);
+}
+
+void WavAudioEncoder::encode_impl(
+    const Logger &logger,
+    const res::Audio &input_audio,
+    io::File &output_file) const
+{
+    WavBlockEncoder encoder(output_file.stream, input_audio);
+    encoder.write_block(input_audio.samples);
+    encoder.finish();
 
     if (!input_audio.loops.empty())
         output_file.path.change_extension("wavloop");
@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include <memory>
 #include "enc/base_audio_encoder.h"
 
 namespace au {
@@ -32,4 +33,26 @@ namespace microsoft {
             io::File &output_file) const override;
     };
 
+    // Streams a track into a WAV as PCM blocks, so only the current
+    // block is ever resident. The format comes from the spec's metadata
+    // (its samples member is ignored); the RIFF and data sizes are
+    // patched in when finished, which requires a seekable output stream.
+    class WavBlockEncoder final
+    {
+    public:
+        WavBlockEncoder(
+            io::BaseByteStream &output_stream, const res::Audio &spec);
+        ~WavBlockEncoder();
+
+        void write_block(const bstr &samples);
+
+        // Patches the sizes and writes the trailing chunks; must be
+        // called exactly once, after the last block.
+        void finish();
+
+    private:
+        struct Priv;
+        std::unique_ptr<Priv> p;
+    };
+
 } } }
@@ -16,7 +16,13 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "enc/png/png_image_encoder.h"
+#include <cstring>
 #include <png.h>
+#include <thread>
+#include <zlib.h>
+#include <unordered_map>
+#include "algo/copy_stats.h"
+#include "algo/pack/compression_level.h"
 #include "algo/range.h"
 #include "err.h"
 #include "io/memory_byte_stream.h"
@@ -24,6 +30,35 @@
 using namespace au;
 using namespace au::enc::png;
 
+// images at least this large get their rows deflated in parallel bands
+static const size_t parallel_pixel_threshold = 0x40000;
+static const size_t min_rows_per_band = 64;
+
+namespace
+{
+    // one horizontal slice of the image, filtered and deflated
+    // independently of its neighbors
+    struct Band final
+    {
+        size_t y_start;
+        size_t y_end;
+        size_t raw_size;
+        unsigned long adler;
+        bstr compressed;
+        bool ok;
+    };
+
+    // what one cheap pass over the pixels learned about the image
+    struct ColorAnalysis final
+    {
+        bool gray;
+        bool opaque;
+        bool palettized; // at most 256 distinct colors
+        std::vector<res::Pixel> palette;
+        std::unordered_map<u32, u8> color_to_index;
+    };
+}
+
 static void write_handler(
     png_structp png_ptr, png_bytep input, png_size_t size)
 {
@@ -36,10 +71,135 @@ static void flush_handler(png_structp)
 {
 }
 
-void PngImageEncoder::encode_impl(
-    const Logger &logger,
+static int to_zlib_level(const algo::pack::CompressionLevel compression_level)
+{
+    switch (compression_level)
+    {
+        case algo::pack::CompressionLevel::Store: return 0;
+        case algo::pack::CompressionLevel::Fast: return 1;
+        case algo::pack::CompressionLevel::Good: return 6;
+        default: return 9;
+    }
+}
+
+// the retro formats that dominate the file counts decode to grayscale
+// or low-color images; writing those as gray or palette PNG instead of
+// truecolor deflates a quarter of the bytes. The pass stops as soon as
+// the image has proven itself truecolor.
+static ColorAnalysis analyze_colors(const res::Image &input_image)
+{
+    ColorAnalysis analysis;
+    analysis.gray = true;
+    analysis.opaque = true;
+    analysis.palettized = true;
+    analysis.color_to_index.reserve(256);
+    for (const auto &c : input_image)
+    {
+        if (c.a != 0xFF)
+            analysis.opaque = false;
+        if (c.r != c.g || c.g != c.b)
+            analysis.gray = false;
+        if (analysis.palettized)
+        {
+            const auto packed = res::read_packed(&c);
+            if (!analysis.color_to_index.count(packed))
+            {
+                if (analysis.palette.size() == 256)
+                {
+                    analysis.palettized = false;
+                    analysis.palette.clear();
+                    analysis.color_to_index.clear();
+                }
+                else
+                {
+                    analysis.color_to_index[packed] = analysis.palette.size();
+                    analysis.palette.push_back(c);
+                }
+            }
+        }
+        if (!analysis.palettized && !(analysis.gray && analysis.opaque))
+            break;
+    }
+    return analysis;
+}
+
+// gray and palette images carry one byte per pixel; the rows are built
+// into a temporary index buffer and handed to plain libpng, which is
+// plenty fast at a quarter of the data
+static void encode_reduced_with_libpng(
     const res::Image &input_image,
-    io::File &output_file) const
+    io::File &output_file,
+    const int zlib_level,
+    const ColorAnalysis &analysis)
+{
+    png_structp png_ptr = png_create_write_struct(
+        PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+    if (!png_ptr)
+        throw std::logic_error("Failed to create PNG write structure");
+
+    png_infop info_ptr = png_create_info_struct(png_ptr);
+    if (!info_ptr)
+        throw std::logic_error("Failed to create PNG info structure");
+
+    const auto width = input_image.width();
+    const auto height = input_image.height();
+    const auto gray = analysis.gray && analysis.opaque;
+
+    png_set_IHDR(
+        png_ptr, info_ptr, width, height, 8,
+        gray ? PNG_COLOR_TYPE_GRAY : PNG_COLOR_TYPE_PALETTE,
+        PNG_INTERLACE_NONE,
+        PNG_COMPRESSION_TYPE_BASE,
+        PNG_FILTER_TYPE_BASE);
+
+    png_color plte[256];
+    png_byte trns[256];
+    if (!gray)
+    {
+        for (const auto i : algo::range(analysis.palette.size()))
+        {
+            plte[i].red = analysis.palette[i].r;
+            plte[i].green = analysis.palette[i].g;
+            plte[i].blue = analysis.palette[i].b;
+            trns[i] = analysis.palette[i].a;
+        }
+        png_set_PLTE(png_ptr, info_ptr, plte, analysis.palette.size());
+        if (!analysis.opaque)
+        {
+            png_set_tRNS(
+                png_ptr, info_ptr, trns, analysis.palette.size(), nullptr);
+        }
+    }
+
+    png_set_filter(png_ptr, 0, PNG_FILTER_NONE);
+    png_set_compression_level(png_ptr, zlib_level);
+
+    bstr indexed(width * height);
+    if (algo::CopyStats::enabled())
+        algo::CopyStats::record_copy("enc::png indexed rows", indexed.size());
+    auto indexed_ptr = indexed.get<u8>();
+    for (const auto &c : input_image)
+    {
+        *indexed_ptr++ = gray
+            ? c.b
+            : analysis.color_to_index.find(res::read_packed(&c))->second;
+    }
+
+    // png_write_png writes the info chunks itself; writing them here too
+    // would duplicate the PLTE chunk
+    png_set_write_fn(
+        png_ptr, &output_file.stream, &write_handler, &flush_handler);
+
+    auto rows = std::make_unique<const u8*[]>(height);
+    for (const auto y : algo::range(height))
+        rows.get()[y] = indexed.get<const u8>() + y * width;
+    png_set_rows(png_ptr, info_ptr, const_cast<u8**>(rows.get()));
+    png_write_png(png_ptr, info_ptr, PNG_TRANSFORM_IDENTITY, nullptr);
+    png_destroy_write_struct(&png_ptr, &info_ptr);
+}
+
+static void encode_with_libpng(
+    const res::Image &input_image, io::File &output_file, const int zlib_level)
 {
     png_structp png_ptr = png_create_write_struct(
         PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
@@ -52,9 +212,6 @@ void PngImageEncoder::encode_impl(
 
     const auto width = input_image.width();
     const auto height = input_image.height();
-    if (!width || !height)
-        throw err::BadDataSizeError();
-    const auto bpp = 4;
     const auto color_type = PNG_COLOR_TYPE_RGBA;
     int transformations = PNG_TRANSFORM_BGR;
 
@@ -65,9 +222,9 @@ void PngImageEncoder::encode_impl(
         PNG_FILTER_TYPE_BASE);
 
     // 0 = no compression, 9 = max compression
-    // 1 produces good file size and is still fast.
+    // the default level 1 produces good file size and is still fast.
     png_set_filter(png_ptr, 0, PNG_FILTER_NONE);
-    png_set_compression_level(png_ptr, 1);
+    png_set_compression_level(png_ptr, zlib_level);
 
     png_set_write_fn(
         png_ptr, &output_file.stream, &write_handler, &flush_handler);
@@ -79,6 +236,221 @@ void PngImageEncoder::encode_impl(
     png_set_rows(png_ptr, info_ptr, const_cast<u8**>(rows.get()));
     png_write_png(png_ptr, info_ptr, transformations, nullptr);
     png_destroy_write_struct(&png_ptr, &info_ptr);
+}
+
+// filters the band's rows (filter type 0, matching the libpng path) into
+// RGBA scanlines and deflates them as a raw stream ending on a byte
+// boundary, so that the bands can be concatenated into one zlib stream
+static void compress_band(
+    const res::Image &input_image, const int zlib_level, Band &band)
+{
+    const auto width = input_image.width();
+    const auto scanline_size = 1 + width * 4;
+    bstr raw(scanline_size * (band.y_end - band.y_start));
+    if (algo::CopyStats::enabled())
+        algo::CopyStats::record_copy("enc::png raw scanlines", raw.size());
+    auto raw_ptr = raw.get<u8>();
+    for (const auto y : algo::range(band.y_start, band.y_end))
+    {
+        *raw_ptr++ = 0;
+        const auto *pixels = input_image.row(y);
+        for (const auto x : algo::range(width))
+        {
+            *raw_ptr++ = pixels[x].r;
+            *raw_ptr++ = pixels[x].g;
+            *raw_ptr++ = pixels[x].b;
+            *raw_ptr++ = pixels[x].a;
+        }
+    }
+
+    band.raw_size = raw.size();
+    band.adler = adler32(
+        adler32(0, Z_NULL, 0), raw.get<const u8>(), raw.size());
+
+    z_stream s;
+    std::memset(&s, 0, sizeof(s));
+    if (deflateInit2(
+        &s, zlib_level, Z_DEFLATED, -15, 9, Z_DEFAULT_STRATEGY) != Z_OK)
+        return;
+    s.next_in = const_cast<Bytef*>(raw.get<const Bytef>());
+    s.avail_in = raw.size();
+    // Z_FULL_FLUSH pads the last block to a byte boundary without
+    // setting the final-block bit; the extra margin covers the flush
+    band.compressed.resize(deflateBound(&s, raw.size()) + 16);
+    s.next_out = band.compressed.get<Bytef>();
+    s.avail_out = band.compressed.size();
+    const auto ret = deflate(&s, Z_FULL_FLUSH);
+    band.ok = ret == Z_OK && s.avail_in == 0;
+    band.compressed.resize(s.total_out);
+    deflateEnd(&s);
+}
+
+static void write_chunk(
+    io::BaseByteStream &output_stream, const bstr &type, const bstr &data)
+{
+    output_stream.write_be<u32>(data.size());
+    output_stream.write(type);
+    output_stream.write(data);
+    auto checksum = crc32(0, Z_NULL, 0);
+    checksum = crc32(checksum, type.get<const u8>(), type.size());
+    checksum = crc32(checksum, data.get<const u8>(), data.size());
+    output_stream.write_be<u32>(checksum);
+}
+
+static void encode_parallel(
+    const res::Image &input_image, io::File &output_file, const int zlib_level)
+{
+    const auto width = input_image.width();
+    const auto height = input_image.height();
+
+    // at least two bands, so the stitching logic is exercised (and
+    // tested) even on single-core machines
+    auto band_count = std::max<size_t>(
+        std::thread::hardware_concurrency(), 2);
+    band_count = std::min(band_count, height / min_rows_per_band);
+    std::vector<Band> bands(band_count);
+    for (const auto i : algo::range(band_count))
+    {
+        bands[i].y_start = height * i / band_count;
+        bands[i].y_end = height * (i + 1) / band_count;
+        bands[i].ok = false;
+    }
+
+    std::vector<std::thread> threads;
+    for (auto &band : bands)
+    {
+        threads.emplace_back(
+            compress_band, std::cref(input_image), zlib_level, std::ref(band));
+    }
+    for (auto &thread : threads)
+        thread.join();
+    for (const auto &band : bands)
+    {
+        if (!band.ok)
+            throw std::logic_error("Failed to deflate PNG image data");
+    }
+
+    output_file.stream.write("\x89PNG\x0D\x0A\x1A\x0A"_b);
+
+    io::MemoryByteStream ihdr;
+    ihdr.write_be<u32>(width);
+    ihdr.write_be<u32>(height);
+    ihdr.write<u8>(8); // bit depth
+    ihdr.write<u8>(6); // color type: RGBA
+    ihdr.write<u8>(0); // compression method
+    ihdr.write<u8>(0); // filter method
+    ihdr.write<u8>(0); // interlace method
+    write_chunk(output_file.stream, "IHDR"_b, ihdr.seek(0).read_to_eof());
+
+    io::MemoryByteStream idat;
+    // the zlib header's FLEVEL bits are informational only
+    idat.write(zlib_level >= 7 ? "\x78\xDA"_b : "\x78\x01"_b);
+    auto adler = bands[0].adler;
+    for (const auto i : algo::range(band_count))
+    {
+        idat.write(bands[i].compressed);
+        if (i)
+            adler = adler32_combine(adler, bands[i].adler, bands[i].raw_size);
+    }
+    idat.write("\x03\x00"_b); // final empty deflate block
+    idat.write_be<u32>(adler);
+    write_chunk(output_file.stream, "IDAT"_b, idat.seek(0).read_to_eof());
+
+    write_chunk(output_file.stream, "IEND"_b, ""_b);
+}
+
+struct PngBandEncoder::Priv final
+{
+    io::BaseByteStream &output_stream;
+    int zlib_level;
+    unsigned long adler;
+};
+
+PngBandEncoder::PngBandEncoder(
+    io::BaseByteStream &output_stream,
+    const size_t width,
+    const size_t height,
+    const algo::pack::CompressionLevel compression_level)
+    : p(new Priv {
+        output_stream,
+        to_zlib_level(compression_level),
+        adler32(0, Z_NULL, 0)})
+{
+    p->output_stream.write("\x89PNG\x0D\x0A\x1A\x0A"_b);
+
+    io::MemoryByteStream ihdr;
+    ihdr.write_be<u32>(width);
+    ihdr.write_be<u32>(height);
+    ihdr.write<u8>(8); // bit depth
+    ihdr.write<u8>(6); // color type: RGBA
+    ihdr.write<u8>(0); // compression method
+    ihdr.write<u8>(0); // filter method
+    ihdr.write<u8>(0); // interlace method
+    write_chunk(p->output_stream, "IHDR"_b, ihdr.seek(0).read_to_eof());
+
+    // the zlib header's FLEVEL bits are informational only
+    write_chunk(
+        p->output_stream,
+        "IDAT"_b,
+        p->zlib_level >= 7 ? "\x78\xDA"_b : "\x78\x01"_b);
+}
+
+PngBandEncoder::~PngBandEncoder()
+{
+}
+
+void PngBandEncoder::write_band(const res::Image &image_band)
+{
+    Band band;
+    band.y_start = 0;
+    band.y_end = image_band.height();
+    band.ok = false;
+    compress_band(image_band, p->zlib_level, band);
+    if (!band.ok)
+        throw std::logic_error("Failed to deflate PNG image data");
+    write_chunk(p->output_stream, "IDAT"_b, band.compressed);
+    p->adler = adler32_combine(p->adler, band.adler, band.raw_size);
+}
+
+void PngBandEncoder::finish()
+{
+    io::MemoryByteStream idat;
+    idat.write("\x03\x00"_b); // final empty deflate block
+    idat.write_be<u32>(p->adler);
+    write_chunk(p->output_stream, "IDAT"_b, idat.seek(0).read_to_eof());
+    write_chunk(p->output_stream, "IEND"_b, ""_b);
+}
+
+void PngImageEncoder::encode_impl(
+    const Logger &logger,
+    const res::Image &input_image,
+    io::File &output_file) const
+{
+    const auto width = input_image.width();
+    const auto height = input_image.height();
+    if (!width || !height)
+        throw err::BadDataSizeError();
+
+    // grayscale and low-color images are written as gray or palette
+    // PNG; truecolor small images go through plain libpng, and truecolor
+    // large ones get filtered and deflated in concurrent row bands
+    // stitched into one zlib stream, which decodes like any other PNG
+    const auto zlib_level = to_zlib_level(compression_level);
+    const auto analysis = analyze_colors(input_image);
+    if (analysis.palettized || (analysis.gray && analysis.opaque))
+    {
+        encode_reduced_with_libpng(
+            input_image, output_file, zlib_level, analysis);
+    }
+    else if (width * height >= parallel_pixel_threshold
+        && height >= 2 * min_rows_per_band)
+    {
+        encode_parallel(input_image, output_file, zlib_level);
+    }
+    else
+    {
+        encode_with_libpng(input_image, output_file, zlib_level);
+    }
 
     output_file.path.change_extension("png");
 }
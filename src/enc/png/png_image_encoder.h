@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include <memory>
 #include "enc/base_image_encoder.h"
 
 namespace au {
@@ -32,4 +33,29 @@ namespace png {
             io::File &output_file) const override;
     };
 
+    // Streams an image into a PNG as top-to-bottom bands, one IDAT chunk
+    // per band, so only the current band is ever resident. The chunks
+    // carry slices of a single deflate stream, so the result decodes
+    // like any other PNG.
+    class PngBandEncoder final
+    {
+    public:
+        PngBandEncoder(
+            io::BaseByteStream &output_stream,
+            const size_t width,
+            const size_t height,
+            const algo::pack::CompressionLevel compression_level);
+        ~PngBandEncoder();
+
+        void write_band(const res::Image &image_band);
+
+        // Closes the deflate stream and writes the trailing chunks; must
+        // be called exactly once, after the last band.
+        void finish();
+
+    private:
+        struct Priv;
+        std::unique_ptr<Priv> p;
+    };
+
 } } }
@@ -53,6 +53,10 @@ BadDataOffsetError::BadDataOffsetError() : DataError("Bad data offset")
 {
 }
 
+QuotaError::QuotaError(const std::string &desc) : GeneralError(desc)
+{
+}
+
 IoError::IoError(const std::string &desc) : GeneralError(desc)
 {
 }
@@ -71,13 +75,14 @@ NotSupportedError::NotSupportedError(const std::string &desc)
 }
 
 UnsupportedBitDepthError::UnsupportedBitDepthError(size_t bit_depth)
-    : NotSupportedError(algo::format("Unsupported bit depth: %d", bit_depth))
+    : NotSupportedError(algo::format(
+        "Unsupported bit depth: %d", static_cast<int>(bit_depth)))
 {
 }
 
 UnsupportedChannelCountError::UnsupportedChannelCountError(size_t channel_count)
     : NotSupportedError(algo::format(
-        "Unsupported channel count: %d", channel_count))
+        "Unsupported channel count: %d", static_cast<int>(channel_count)))
 {
 }
 
@@ -61,6 +61,11 @@ namespace err {
         BadDataOffsetError();
     };
 
+    struct QuotaError final : public GeneralError
+    {
+        QuotaError(const std::string &description);
+    };
+
     struct IoError : public GeneralError
     {
         virtual ~IoError() {}
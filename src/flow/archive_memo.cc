@@ -0,0 +1,35 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "flow/archive_memo.h"
+
+using namespace au;
+using namespace au::flow;
+
+bool ArchiveMemo::find_or_store(
+    const bstr &key, const io::path &base_name, io::path &prior_name)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    const auto it = unpacked.find(key);
+    if (it != unpacked.end())
+    {
+        prior_name = it->second;
+        return true;
+    }
+    unpacked[key] = base_name;
+    return false;
+}
@@ -0,0 +1,49 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <map>
+#include <mutex>
+#include "io/path.h"
+#include "types.h"
+
+namespace au {
+namespace flow {
+
+    // Run-wide memo of unpacked archives, keyed by a fingerprint of
+    // their entry table. Series releases ship the same system archives
+    // (fonts, UI sprites) in every volume; when a later archive's
+    // fingerprint matches one unpacked earlier this run, its entire
+    // decode can be skipped and the earlier output pointed at instead.
+    class ArchiveMemo final
+    {
+    public:
+        // Returns true when an identical archive was unpacked earlier
+        // this run; prior_name is then set to the name it was unpacked
+        // under. Otherwise records this archive as the first of its kind.
+        bool find_or_store(
+            const bstr &key,
+            const io::path &base_name,
+            io::path &prior_name);
+
+    private:
+        mutable std::mutex mutex;
+        std::map<bstr, io::path> unpacked;
+    };
+
+} }
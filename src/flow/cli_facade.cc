@@ -17,15 +17,31 @@
 
 #include "flow/cli_facade.h"
 #include <algorithm>
+#include <chrono>
+#include <ctime>
 #include <map>
+#include "algo/alloc_stats.h"
+#include "algo/copy_stats.h"
+#include "algo/format.h"
+#include "algo/pack/compression_level.h"
+#include "algo/quota.h"
 #include "algo/range.h"
+#include "algo/startup_probe.h"
 #include "algo/str.h"
+#include "algo/trace.h"
 #include "arg_parser.h"
+#include "dec/base_archive_decoder.h"
 #include "dec/idecoder.h"
 #include "dec/registry.h"
+#include "err.h"
+#include "flow/file_saver_cas.h"
 #include "flow/file_saver_hdd.h"
+#include "flow/file_saver_tar.h"
 #include "flow/parallel_unpacker.h"
+#include "flow/perf_tracker.h"
+#include "flow/recognition_cache.h"
 #include "io/file_system.h"
+#include "io/stream_stats.h"
 #include "version.h"
 #include "virtual_file_system.h"
 
@@ -34,19 +50,45 @@ using namespace au::flow;
 
 namespace
 {
+    struct InputPath final
+    {
+        io::path path;
+        io::path base_name;
+    };
+
     struct Options final
     {
         std::string decoder;
         io::path output_dir;
-        std::vector<io::path> input_paths;
+        std::vector<InputPath> input_paths;
         bool overwrite;
         bool enable_nested_decoding;
         bool enable_virtual_file_system;
         bool should_show_help;
         bool should_show_version;
         bool should_list_decoders;
+        bool list_entries;
         int verbosity = 3;
         unsigned int thread_count;
+        u64 memory_limit;
+        bool dedup;
+        bool dedup_archives;
+        bool resume;
+        bool perf;
+        bool io_stats;
+        bool alloc_stats;
+        bool copy_stats;
+        bool startup_profile;
+        std::vector<std::string> include_patterns;
+        std::vector<std::string> exclude_patterns;
+        io::path tar_path;
+        io::path cas_path;
+        io::path index_cache_path;
+        io::path report_path;
+        io::path trace_path;
+        algo::pack::CompressionLevel compression_level;
+        flow::ShardSpec shard;
+        flow::ImageOutputFormat image_output_format;
     };
 }
 
@@ -61,6 +103,7 @@ private:
     void print_decoder_list() const;
     void print_cli_help() const;
     void parse_cli_options();
+    int run_list_mode(const std::set<std::string> &available_decoders) const;
 
     Logger &logger;
     const std::vector<std::string> arguments;
@@ -175,10 +218,36 @@ void CliFacade::Priv::register_cli_options()
     arg_parser.register_flag({"-l", "--list-decoders"})
         ->set_description("Lists available DECODER values.");
 
+    arg_parser.register_flag({"--list"})
+        ->set_description(
+            "Lists archive entries (path, offset, size) as tab separated "
+            "values without extracting anything. Offsets and sizes are "
+            "printed as - when the decoder does not expose them.");
+
     arg_parser.register_switch({"-t", "--threads"})
         ->set_value_name("NUM")
         ->set_description("Sets worker thread count.");
 
+    arg_parser.register_switch({"--memory-limit"})
+        ->set_value_name("MEGABYTES")
+        ->set_description(
+            "Caps the estimated total size of simultaneously decoded "
+            "files. By default, no cap is applied.");
+
+    arg_parser.register_switch({"--max-output-size"})
+        ->set_value_name("MEGABYTES")
+        ->set_description(
+            "Caps the output size of a single decoded file; corrupt "
+            "entries claiming absurd sizes fail cleanly instead of "
+            "exhausting memory. By default, no cap is applied.");
+
+    arg_parser.register_switch({"--max-decode-time"})
+        ->set_value_name("SECONDS")
+        ->set_description(
+            "Caps the wall time spent decoding a single file; runaway "
+            "decodes of corrupt entries fail cleanly instead of stalling "
+            "the run. By default, no cap is applied.");
+
     {
         auto sw = arg_parser.register_switch({"-v", "--verbosity"})
             ->set_description(
@@ -196,6 +265,161 @@ void CliFacade::Priv::register_cli_options()
             ->hide_possible_values();
     }
 
+    {
+        auto sw = arg_parser.register_switch({"--compression"})
+            ->set_value_name("LEVEL")
+            ->set_description(
+                "Sets how hard the converted files (e.g. PNG images) are "
+                "compressed (defaults to fast).\n"
+                "store: no compression, largest output\n"
+                "fast: cheap compression, good for bulk extraction\n"
+                "good: balanced compression\n"
+                "best: strongest compression, slowest")
+            ->hide_possible_values();
+        sw->add_possible_value("store");
+        sw->add_possible_value("fast");
+        sw->add_possible_value("good");
+        sw->add_possible_value("best");
+    }
+
+    {
+        auto sw = arg_parser.register_switch({"--image-format"})
+            ->set_value_name("FORMAT")
+            ->set_description(
+                "Sets the container decoded images are written as "
+                "(defaults to png).\n"
+                "png: compressed, honors --compression\n"
+                "bmp: raw rows, next to no CPU; good for intermediate "
+                "storage that gets post-processed anyway")
+            ->hide_possible_values();
+        sw->add_possible_value("png");
+        sw->add_possible_value("bmp");
+    }
+
+    arg_parser.register_switch({"--index-cache"})
+        ->set_value_name("FILE")
+        ->set_description(
+            "Remembers in the given file which decoder recognized each "
+            "input, so later runs over unchanged inputs skip the decoder "
+            "guessing pass.");
+
+    arg_parser.register_flag({"--resume"})
+        ->set_description(
+            "Keeps output files that already exist from a previous run "
+            "and skips extracting the entries that would produce them.");
+
+    arg_parser.register_flag({"--dedup"})
+        ->set_description(
+            "Saves files with already seen content as hard links to the "
+            "first copy instead of writing the bytes again.");
+
+    arg_parser.register_flag({"--dedup-archives"})
+        ->set_description(
+            "Skips archives whose entry table matches an archive already "
+            "unpacked this run; their contents are identical to that "
+            "archive's output.");
+
+    arg_parser.register_switch({"--include"})
+        ->set_value_name("GLOB")
+        ->set_description(
+            "Extracts only the archive entries whose paths match one of "
+            "the given comma separated wildcard patterns. Non-matching "
+            "entries are never read or decoded.");
+
+    arg_parser.register_switch({"--exclude"})
+        ->set_value_name("GLOB")
+        ->set_description(
+            "Skips the archive entries whose paths match one of the given "
+            "comma separated wildcard patterns.");
+
+    arg_parser.register_switch({"--shard"})
+        ->set_value_name("K/N")
+        ->set_description(
+            "Processes only the K-th of N deterministic partitions of the "
+            "inputs, so N machines given the same command cover a corpus "
+            "together with no coordination. Input files are dealt to the "
+            "partitions balancing their total byte counts.");
+
+    arg_parser.register_flag({"--shard-entries"})
+        ->set_description(
+            "Makes --shard partition the entries of the given archives "
+            "instead of whole input files, so several machines can share "
+            "one huge archive. Every machine still reads every entry "
+            "table.");
+
+    arg_parser.register_switch({"--tar"})
+        ->set_value_name("FILE")
+        ->set_description(
+            "Streams all output files into a single tar archive instead "
+            "of creating them on disk individually.");
+
+    arg_parser.register_switch({"--cas"})
+        ->set_value_name("DIR")
+        ->set_description(
+            "Writes output files into a content addressed store at DIR: "
+            "blobs named by content hash plus a manifest mapping logical "
+            "paths to hashes. Content already present in the store - from "
+            "this run, other games or previous runs - is never written "
+            "twice.");
+
+    arg_parser.register_flag({"--perf"})
+        ->set_description(
+            "Collects per-decoder timing counters for the recognize, "
+            "meta, decode and encode stages and prints a summary sorted "
+            "by total time after the run.");
+
+    arg_parser.register_flag({"--io-stats"})
+        ->set_description(
+            "Counts stream reads, writes and seeks per decoder, with a "
+            "histogram of read sizes, and prints the totals after the "
+            "run. Tells which decoders issue many tiny reads and would "
+            "benefit from buffering.");
+
+    arg_parser.register_flag({"--alloc-stats"})
+        ->set_description(
+            "Counts bstr and pixel grid buffer allocations per decoder "
+            "and prints the totals after the run, along with the "
+            "process-wide live and peak buffer footprint. Tells which "
+            "decoders churn through buffers without rebuilding with a "
+            "heap profiler.");
+
+    arg_parser.register_flag({"--copy-stats"})
+        ->set_description(
+            "Counts buffer copies of 64 KB and up across the pipeline - "
+            "bstr copies, stream slurps, pixel conversions, encoder "
+            "buffer builds - per call site, and prints the totals after "
+            "the run along with the copied-bytes-per-output-byte ratio. "
+            "Tells where a format's bytes get duplicated on their way "
+            "from archive to disk.");
+
+    arg_parser.register_flag({"--startup-profile"})
+        ->set_description(
+            "Prints the process startup budget - loader, static "
+            "initializers and command line setup - and exits. Scripted "
+            "invocations pay this cost on every run.");
+
+    arg_parser.register_switch({"--report"})
+        ->set_value_name("FILE")
+        ->set_description(
+            "Writes a machine readable JSON run report to the given file: "
+            "success and error counts, wall and CPU time, per-decoder "
+            "stage timings with duration percentiles, the slowest files "
+            "and the estimated memory peak.");
+
+    arg_parser.register_switch({"--trace"})
+        ->set_value_name("FILE")
+        ->set_description(
+            "Writes a Chrome trace of the run to the given file: one "
+            "span per decoder stage and saved file, per thread, loadable "
+            "in chrome://tracing or Perfetto. Long runs keep the most "
+            "recent spans of every thread.");
+
+    arg_parser.register_flag({"--quiet-hot-path"})
+        ->set_description(
+            "Disables per-file progress and success lines; the final "
+            "summary still reports totals. Useful when console output "
+            "throttles many decode threads.");
+
     arg_parser.register_flag({"--no-color", "--no-colors"})
         ->set_description("Disables colors in console output.");
 
@@ -216,6 +440,8 @@ void CliFacade::Priv::parse_cli_options()
 
     options.should_show_version = arg_parser.has_flag("--version");
 
+    options.list_entries = arg_parser.has_flag("--list");
+
     options.should_list_decoders
         = arg_parser.has_flag("-l") || arg_parser.has_flag("--list-decoders");
 
@@ -225,6 +451,12 @@ void CliFacade::Priv::parse_cli_options()
     if (arg_parser.has_flag("--no-color") || arg_parser.has_flag("--no-colors"))
         logger.disable_colors();
 
+    if (arg_parser.has_flag("--quiet-hot-path"))
+    {
+        logger.mute(Logger::MessageType::Info);
+        logger.mute(Logger::MessageType::Success);
+    }
+
     if (arg_parser.has_switch("-v"))
         options.verbosity = algo::from_string<int>(arg_parser.get_switch("-v"));
     if (arg_parser.has_switch("--verbosity"))
@@ -235,6 +467,66 @@ void CliFacade::Priv::parse_cli_options()
 
     options.enable_nested_decoding = !arg_parser.has_flag("--no-recurse");
 
+    options.dedup = arg_parser.has_flag("--dedup");
+
+    options.dedup_archives = arg_parser.has_flag("--dedup-archives");
+
+    options.resume = arg_parser.has_flag("--resume");
+
+    options.perf = arg_parser.has_flag("--perf");
+
+    options.io_stats = arg_parser.has_flag("--io-stats");
+
+    options.alloc_stats = arg_parser.has_flag("--alloc-stats");
+
+    options.copy_stats = arg_parser.has_flag("--copy-stats");
+
+    options.startup_profile = arg_parser.has_flag("--startup-profile");
+
+    if (arg_parser.has_switch("--include"))
+    {
+        options.include_patterns
+            = algo::split(arg_parser.get_switch("--include"), ',', false);
+    }
+
+    if (arg_parser.has_switch("--exclude"))
+    {
+        options.exclude_patterns
+            = algo::split(arg_parser.get_switch("--exclude"), ',', false);
+    }
+
+    if (arg_parser.has_switch("--shard"))
+    {
+        const auto spec = arg_parser.get_switch("--shard");
+        const auto parts = algo::split(spec, '/', false);
+        int index = 0, count = 0;
+        if (parts.size() == 2)
+        {
+            index = algo::from_string<int>(parts[0]);
+            count = algo::from_string<int>(parts[1]);
+        }
+        if (count < 1 || index < 1 || index > count)
+            throw err::UsageError("Bad shard specification: " + spec);
+        options.shard.index = index - 1;
+        options.shard.count = count;
+        options.shard.by_entries = arg_parser.has_flag("--shard-entries");
+    }
+
+    if (arg_parser.has_switch("--tar"))
+        options.tar_path = arg_parser.get_switch("--tar");
+
+    if (arg_parser.has_switch("--cas"))
+        options.cas_path = arg_parser.get_switch("--cas");
+
+    if (arg_parser.has_switch("--index-cache"))
+        options.index_cache_path = arg_parser.get_switch("--index-cache");
+
+    if (arg_parser.has_switch("--report"))
+        options.report_path = arg_parser.get_switch("--report");
+
+    if (arg_parser.has_switch("--trace"))
+        options.trace_path = arg_parser.get_switch("--trace");
+
     if (arg_parser.has_switch("-t"))
         options.thread_count = algo::from_string<int>(
             arg_parser.get_switch("-t"));
@@ -244,6 +536,57 @@ void CliFacade::Priv::parse_cli_options()
     else
         options.thread_count = 0;
 
+    if (arg_parser.has_switch("--memory-limit"))
+    {
+        options.memory_limit = static_cast<u64>(algo::from_string<int>(
+            arg_parser.get_switch("--memory-limit"))) * 1024 * 1024;
+    }
+    else
+    {
+        options.memory_limit = 0;
+    }
+
+    if (arg_parser.has_switch("--max-output-size"))
+    {
+        algo::DecodeQuota::set_output_limit(
+            static_cast<u64>(algo::from_string<int>(
+                arg_parser.get_switch("--max-output-size"))) * 1024 * 1024);
+    }
+    if (arg_parser.has_switch("--max-decode-time"))
+    {
+        algo::DecodeQuota::set_time_limit(
+            static_cast<u64>(algo::from_string<int>(
+                arg_parser.get_switch("--max-decode-time"))) * 1000);
+    }
+
+    options.compression_level = algo::pack::CompressionLevel::Fast;
+    if (arg_parser.has_switch("--compression"))
+    {
+        const auto value = arg_parser.get_switch("--compression");
+        if (value == "store")
+            options.compression_level = algo::pack::CompressionLevel::Store;
+        else if (value == "fast")
+            options.compression_level = algo::pack::CompressionLevel::Fast;
+        else if (value == "good")
+            options.compression_level = algo::pack::CompressionLevel::Good;
+        else if (value == "best")
+            options.compression_level = algo::pack::CompressionLevel::Best;
+        else
+            throw err::UsageError("Bad compression level: " + value);
+    }
+
+    options.image_output_format = flow::ImageOutputFormat::Png;
+    if (arg_parser.has_switch("--image-format"))
+    {
+        const auto value = arg_parser.get_switch("--image-format");
+        if (value == "png")
+            options.image_output_format = flow::ImageOutputFormat::Png;
+        else if (value == "bmp")
+            options.image_output_format = flow::ImageOutputFormat::Bmp;
+        else
+            throw err::UsageError("Bad image format: " + value);
+    }
+
     if (arg_parser.has_flag("--no-vfs"))
         VirtualFileSystem::disable();
 
@@ -263,19 +606,182 @@ void CliFacade::Priv::parse_cli_options()
     {
         if (io::is_directory(stray))
         {
+            // keep the position inside the walked tree in the base name,
+            // so that same-named archives in different subdirectories do
+            // not collide in the output directory
             for (const auto &path : io::recursive_directory_range(stray))
-                if (!io::is_directory(path))
-                    options.input_paths.push_back(path);
+            {
+                if (io::is_directory(path))
+                    continue;
+                auto base_name = io::path(stray).make_relative(path);
+                base_name.change_stem(base_name.stem() + "~");
+                options.input_paths.push_back({path, base_name});
+            }
         }
         else
         {
-            options.input_paths.push_back(stray);
+            const io::path path(stray);
+            options.input_paths.push_back(
+                {path,
+                 io::path(path).change_stem(path.stem() + "~").name()});
+        }
+    }
+
+    if (options.shard.active() && !options.shard.by_entries)
+    {
+        // every machine sorts the same corpus into the same canonical
+        // order and deals each file to the currently lightest shard, so
+        // the shards agree on the partition - and balance their byte
+        // counts - without any coordination
+        const auto &input_paths = options.input_paths;
+        std::vector<u64> sizes;
+        std::vector<size_t> order;
+        for (const auto i : algo::range(input_paths.size()))
+        {
+            sizes.push_back(
+                io::is_regular_file(input_paths[i].path)
+                    ? io::file_size(input_paths[i].path)
+                    : 0);
+            order.push_back(i);
+        }
+        std::sort(
+            order.begin(),
+            order.end(),
+            [&](const size_t a, const size_t b)
+            {
+                if (sizes[a] != sizes[b])
+                    return sizes[a] > sizes[b];
+                return input_paths[a].path.str() < input_paths[b].path.str();
+            });
+        std::vector<u64> shard_sizes(options.shard.count, 0);
+        std::vector<InputPath> kept;
+        for (const auto i : order)
+        {
+            const auto lightest = std::min_element(
+                shard_sizes.begin(), shard_sizes.end())
+                - shard_sizes.begin();
+            shard_sizes[lightest] += sizes[i];
+            if (static_cast<size_t>(lightest) == options.shard.index)
+                kept.push_back(input_paths[i]);
         }
+        options.input_paths = std::move(kept);
     }
 }
 
+// inventory mode: recognizes each input and dumps the entry table that
+// read_meta provides, without ever touching the entry payloads
+int CliFacade::Priv::run_list_mode(
+    const std::set<std::string> &available_decoders) const
+{
+    Logger meta_logger(logger);
+    meta_logger.mute(Logger::MessageType::Info);
+
+    auto failures = false;
+    for (const auto &input_path : options.input_paths)
+    {
+        io::File input_file(io::absolute(input_path.path), io::FileMode::Read);
+        std::shared_ptr<dec::IDecoder> decoder;
+        for (const auto &name
+            : registry.get_candidate_decoder_names(input_file))
+        {
+            if (available_decoders.find(name) == available_decoders.end())
+                continue;
+            if (!registry.get_pooled_decoder(name)
+                ->is_recognized(input_file))
+            {
+                continue;
+            }
+            // decoding arguments can affect the entry table, so give the
+            // decoder the same CLI arguments the unpacker would
+            decoder = registry.create_decoder(name);
+            ArgParser decoder_arg_parser;
+            const auto decorators = decoder->get_arg_parser_decorators();
+            for (const auto &decorator : decorators)
+                decorator.register_cli_options(decoder_arg_parser);
+            decoder_arg_parser.parse(arguments);
+            for (const auto &decorator : decorators)
+                decorator.parse_cli_options(decoder_arg_parser);
+            break;
+        }
+
+        if (!decoder)
+        {
+            logger.err(
+                "%s: not recognized by any decoder.\n",
+                input_path.path.c_str());
+            failures = true;
+            continue;
+        }
+
+        const auto archive_decoder
+            = dynamic_cast<const dec::BaseArchiveDecoder*>(decoder.get());
+        if (!archive_decoder)
+        {
+            logger.err(
+                "%s: not an archive.\n", input_path.path.c_str());
+            failures = true;
+            continue;
+        }
+
+        try
+        {
+            const auto meta
+                = archive_decoder->read_meta(meta_logger, input_file);
+            for (const auto &entry : meta->entries)
+            {
+                std::string offset = "-", size = "-";
+                if (const auto plain_entry
+                    = dynamic_cast<const dec::PlainArchiveEntry*>(
+                        entry.get()))
+                {
+                    offset = algo::format(
+                        "%llu",
+                        static_cast<unsigned long long>(plain_entry->offset));
+                    size = algo::format(
+                        "%zu", static_cast<size_t>(plain_entry->size));
+                }
+                else if (const auto compressed_entry
+                    = dynamic_cast<const dec::CompressedArchiveEntry*>(
+                        entry.get()))
+                {
+                    offset = algo::format(
+                        "%llu",
+                        static_cast<unsigned long long>(
+                            compressed_entry->offset));
+                    size = algo::format(
+                        "%zu",
+                        static_cast<size_t>(compressed_entry->size_orig));
+                }
+                logger.info(
+                    "%s\t%s\t%s\t%s\n",
+                    input_path.path.c_str(),
+                    entry->path.c_str(),
+                    offset.c_str(),
+                    size.c_str());
+            }
+        }
+        catch (const std::exception &e)
+        {
+            logger.err(
+                "%s: error reading metadata (%s)\n",
+                input_path.path.c_str(),
+                e.what());
+            failures = true;
+        }
+    }
+    return failures ? 1 : 0;
+}
+
 int CliFacade::Priv::run() const
 {
+    if (options.startup_profile)
+    {
+        // runs after argument parsing, so the main-to-here line covers
+        // the whole command line setup
+        algo::StartupProbe::dump(logger);
+        return 0;
+    }
+
     if (options.should_show_help)
     {
         print_cli_help();
@@ -306,29 +812,120 @@ int CliFacade::Priv::run() const
         ? std::set<std::string>(name_list.begin(), name_list.end())
         : std::set<std::string>{options.decoder};
 
-    FileSaverHdd file_saver(options.output_dir, options.overwrite);
+    if (options.list_entries)
+        return run_list_mode(available_decoders);
+
+    std::unique_ptr<IFileSaver> file_saver;
+    if (!options.tar_path.str().empty())
+    {
+        file_saver = std::make_unique<FileSaverTar>(options.tar_path);
+    }
+    else if (!options.cas_path.str().empty())
+    {
+        file_saver = std::make_unique<FileSaverCas>(options.cas_path);
+    }
+    else
+    {
+        file_saver = std::make_unique<FileSaverHdd>(
+            options.output_dir,
+            options.overwrite,
+            true,
+            options.dedup,
+            options.resume);
+    }
+    std::unique_ptr<RecognitionCache> recognition_cache;
+    if (!options.index_cache_path.str().empty())
+    {
+        recognition_cache
+            = std::make_unique<RecognitionCache>(options.index_cache_path);
+    }
+    std::unique_ptr<PerfTracker> perf_tracker;
+    if (options.perf || !options.report_path.str().empty())
+        perf_tracker = std::make_unique<PerfTracker>();
     ParallelUnpackerContext context(
         logger,
-        file_saver,
+        *file_saver,
         registry,
         options.enable_nested_decoding,
+        options.compression_level,
         arguments,
-        available_decoders);
+        available_decoders,
+        recognition_cache.get(),
+        perf_tracker.get(),
+        options.include_patterns,
+        options.exclude_patterns,
+        options.shard,
+        options.image_output_format,
+        options.dedup_archives);
 
     ParallelUnpacker unpacker(context);
+    unpacker.set_memory_limit(options.memory_limit);
     for (const auto &input_path : options.input_paths)
     {
         unpacker.add_input_file(
-            io::path(input_path).change_stem(input_path.stem() + "~").name(),
+            input_path.base_name,
             [&]()
             {
                 VirtualFileSystem::register_directory(
-                    io::absolute(input_path).parent());
+                    io::absolute(input_path.path).parent());
                 return std::make_shared<io::File>(
-                    io::absolute(input_path), io::FileMode::Read);
-            });
+                    io::absolute(input_path.path), io::FileMode::Read);
+            },
+            io::is_regular_file(input_path.path)
+                ? io::file_size(input_path.path)
+                : 0);
+    }
+    if (options.io_stats)
+        io::StreamStats::enable();
+    if (options.alloc_stats)
+        algo::AllocStats::enable();
+    if (options.copy_stats)
+        algo::CopyStats::enable();
+    if (!options.trace_path.str().empty())
+        algo::Trace::enable();
+    const auto wall_start = std::chrono::steady_clock::now();
+    const auto cpu_start = std::clock();
+    const auto success = unpacker.run(options.thread_count);
+    if (options.perf && perf_tracker)
+        perf_tracker->dump(logger);
+    if (options.io_stats)
+        io::StreamStats::dump(logger);
+    if (options.alloc_stats)
+        algo::AllocStats::dump(logger);
+    if (options.copy_stats)
+        algo::CopyStats::dump(logger);
+    if (!options.report_path.str().empty())
+    {
+        RunSummary summary;
+        const auto result = unpacker.get_result();
+        summary.success_count = result.success_count;
+        summary.error_count = result.error_count;
+        summary.saved_file_count = file_saver->get_saved_file_count();
+        summary.wall_nanoseconds = std::chrono::duration_cast<
+            std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - wall_start).count();
+        // std::clock sums the CPU time of all threads, so this can exceed
+        // the wall time on multi-core runs
+        summary.cpu_seconds
+            = (std::clock() - cpu_start) / static_cast<double>(CLOCKS_PER_SEC);
+        summary.memory_limit = options.memory_limit;
+        summary.memory_peak = unpacker.get_memory_peak();
+        if (options.copy_stats)
+        {
+            summary.copied_bytes = algo::CopyStats::get_total_copied_bytes();
+            summary.output_bytes = algo::CopyStats::get_output_bytes();
+        }
+        summary.workers = unpacker.get_worker_utilization();
+        io::File report_file(options.report_path, io::FileMode::Write);
+        perf_tracker->write_json_report(report_file.stream, summary);
+    }
+    if (!options.trace_path.str().empty())
+    {
+        algo::Trace::disable();
+        io::File trace_file(options.trace_path, io::FileMode::Write);
+        algo::Trace::write_chrome_trace(trace_file.stream);
     }
-    return unpacker.run(options.thread_count) ? 0 : 1;
+    return success ? 0 : 1;
 }
 
 CliFacade::CliFacade(Logger &logger, const std::vector<std::string> &arguments)
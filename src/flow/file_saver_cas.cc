@@ -0,0 +1,101 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "flow/file_saver_cas.h"
+#include <mutex>
+#include <set>
+#include "algo/crypt/sha1.h"
+#include "algo/str.h"
+#include "io/file_byte_stream.h"
+#include "io/file_system.h"
+
+using namespace au;
+using namespace au::flow;
+
+static std::mutex mutex;
+
+static const std::string manifest_name = "manifest.tsv";
+
+struct FileSaverCas::Priv final
+{
+    io::path store_dir;
+    std::unique_ptr<io::FileByteStream> manifest_stream;
+    std::set<std::string> manifest_lines;
+    size_t saved_file_count;
+};
+
+FileSaverCas::FileSaverCas(const io::path &store_dir) : p(new Priv)
+{
+    p->store_dir = store_dir;
+    p->saved_file_count = 0;
+    io::create_directories(store_dir / "objects");
+
+    // the manifest accumulates across runs; reloading it keeps repeated
+    // extractions of the same archives from duplicating its lines
+    const auto manifest_path = store_dir / manifest_name;
+    if (io::exists(manifest_path))
+    {
+        io::FileByteStream old_manifest(manifest_path, io::FileMode::Read);
+        for (const auto &line : algo::split(
+            old_manifest.read_to_eof().str(), '\n', false))
+        {
+            p->manifest_lines.insert(line);
+        }
+    }
+    // opening for writing truncates, so the loaded lines are written back
+    // before any new ones are appended
+    p->manifest_stream = std::make_unique<io::FileByteStream>(
+        manifest_path, io::FileMode::Write);
+    for (const auto &line : p->manifest_lines)
+        p->manifest_stream->write(bstr(line + "\n"));
+}
+
+FileSaverCas::~FileSaverCas()
+{
+}
+
+io::path FileSaverCas::save(std::shared_ptr<io::File> file) const
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    const auto content = file->stream.seek(0).read_to_eof();
+    const auto digest = algo::hex(algo::crypt::sha1(content));
+
+    // a size mismatch means a previous run was cut short mid-write; the
+    // blob is then written again rather than trusted
+    const auto object_path
+        = p->store_dir / "objects" / digest.substr(0, 2) / digest;
+    if (!io::exists(object_path)
+        || io::file_size(object_path) != content.size())
+    {
+        io::create_directories(object_path.parent());
+        io::FileByteStream object_stream(object_path, io::FileMode::Write);
+        object_stream.write(content);
+    }
+
+    const auto line = digest + "\t" + file->path.str();
+    if (p->manifest_lines.insert(line).second)
+        p->manifest_stream->write(bstr(line + "\n"));
+
+    ++p->saved_file_count;
+    return object_path;
+}
+
+size_t FileSaverCas::get_saved_file_count() const
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    return p->saved_file_count;
+}
@@ -0,0 +1,46 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <memory>
+#include "flow/ifile_saver.h"
+
+namespace au {
+namespace flow {
+
+    // Writes file contents into a content addressed store: blobs named by
+    // their SHA-1 under objects/ with one level of fanout, plus a
+    // manifest mapping the logical paths the decoders produced to those
+    // hashes. Content that is already in the store is never written
+    // again, so identical assets shared across games - and re-runs with
+    // updated decoders - cost only a manifest line.
+    class FileSaverCas final : public IFileSaver
+    {
+    public:
+        FileSaverCas(const io::path &store_dir);
+        ~FileSaverCas();
+
+        io::path save(std::shared_ptr<io::File> file) const override;
+        size_t get_saved_file_count() const override;
+
+    private:
+        struct Priv;
+        std::unique_ptr<Priv> p;
+    };
+
+} }
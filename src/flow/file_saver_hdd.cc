@@ -16,9 +16,19 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "flow/file_saver_hdd.h"
+#include <condition_variable>
+#include <cstring>
+#include <deque>
 #include <mutex>
 #include <set>
+#include <thread>
+#include <map>
+#include "algo/copy_stats.h"
+#include "algo/crypt/sha1.h"
 #include "algo/format.h"
+#include "algo/str.h"
+#include "algo/trace.h"
+#include "err.h"
 #include "io/file_byte_stream.h"
 #include "io/file_system.h"
 
@@ -27,41 +37,367 @@ using namespace au::flow;
 
 static std::mutex mutex;
 
+// The write-behind queue is bounded by byte size rather than entry count to
+// keep memory predictable when large extracted files pile up faster than
+// the disk drains them.
+static const size_t max_queued_bytes = 256 * 1024 * 1024;
+
+// Journal of completed writes, kept in the output directory. A crashed
+// run leaves it behind, and a later run with --resume trusts it over the
+// bare existence of output files - the asynchronous writer creates files
+// before their data lands, so existence alone cannot distinguish a
+// finished write from a truncated one.
+static const std::string journal_name = ".arc_unpacker.journal";
+
+// zero-run detection works on whole chunks; smaller zero islands are not
+// worth the seek
+static const size_t write_chunk_size = 256 * 1024;
+
+namespace
+{
+    struct QueuedWrite final
+    {
+        std::unique_ptr<io::FileByteStream> output_stream;
+        std::shared_ptr<io::File> file;
+        io::path full_path;
+        size_t size;
+    };
+}
+
+// Bytes that cannot appear in file names on at least one supported
+// filesystem: ASCII control bytes plus the Windows-reserved set. The
+// table turns sanitization into a single pass over the path bytes.
+namespace
+{
+    struct InvalidNameBytes final
+    {
+        InvalidNameBytes()
+        {
+            for (auto i = 0; i < 0x20; i++)
+                table[i] = true;
+            table[0x7F] = true;
+            for (const u8 c : {':', '*', '?', '"', '<', '>', '|'})
+                table[c] = true;
+        }
+
+        bool operator [](const u8 c) const
+        {
+            return table[c];
+        }
+
+        bool table[256] = {false};
+    };
+}
+
+static const InvalidNameBytes invalid_name_bytes;
+
+static void sanitize_name_bytes(std::string &input)
+{
+    for (auto &c : input)
+        if (invalid_name_bytes[static_cast<u8>(c)])
+            c = '_';
+}
+
+static bool is_all_zeros(const bstr &data)
+{
+    if (data.empty())
+        return true;
+    const auto data_ptr = data.get<const u8>();
+    return !data_ptr[0]
+        && !std::memcmp(data_ptr, data_ptr + 1, data.size() - 1);
+}
+
+// Extracted audio is often padded with long runs of silence, and looped
+// sections materialize as yet more zeros. Chunks that are entirely zero
+// are seeked over rather than written - a fresh file reads zeros in the
+// unwritten regions either way - which skips their disk bandwidth, and
+// zero-heavy files additionally forgo extent preallocation so that the
+// skipped regions stay holes on filesystems that support them.
+static void write_output_stream(
+    io::FileByteStream &output_stream, io::BaseByteStream &input_stream)
+{
+    const uoff_t size = input_stream.size();
+    if (algo::CopyStats::enabled())
+        algo::CopyStats::record_output(size);
+    bstr buffer;
+    uoff_t zero_bytes = 0;
+    input_stream.seek(0);
+    while (input_stream.left())
+    {
+        const auto chunk = std::min<uoff_t>(
+            write_chunk_size, input_stream.left());
+        input_stream.read_into(buffer, chunk);
+        if (is_all_zeros(buffer))
+            zero_bytes += chunk;
+    }
+    const bool sparse = zero_bytes * 4 >= size;
+    output_stream.reserve(size, sparse);
+
+    input_stream.seek(0);
+    while (input_stream.left())
+    {
+        const auto chunk = std::min<uoff_t>(
+            write_chunk_size, input_stream.left());
+        input_stream.read_into(buffer, chunk);
+        // the last chunk is always written so that the file ends at the
+        // right size even where the size could not be established up front
+        if (input_stream.left() && is_all_zeros(buffer))
+            output_stream.skip(chunk);
+        else
+            output_stream.write(buffer);
+    }
+}
+
 struct FileSaverHdd::Priv final
 {
     Priv(
         const io::path &output_dir,
-        const bool overwrite);
+        const bool overwrite,
+        const bool async,
+        const bool dedup,
+        const bool resume);
+    ~Priv();
 
     io::path make_path_unique(const io::path &path);
+    io::path sanitize_output_path(const io::path &path);
+    void enqueue(QueuedWrite write);
+    void writer_loop();
+    void wait_until_drained();
+    void rethrow_pending_error();
+    void journal(const io::path &path);
+    bool is_journaled(const io::path &path);
 
     io::path output_dir;
     bool overwrite;
+    bool async;
+    bool dedup;
+    bool resume;
+    bool journal_loaded;
     size_t saved_file_count;
     std::set<io::path> paths;
+    std::map<std::string, std::string> sanitized_parents;
+    std::map<io::path, int> suffix_counters;
+    std::map<bstr, io::path> content_hashes;
+    std::set<io::path> journaled_paths;
+    std::unique_ptr<io::FileByteStream> journal_stream;
+    std::mutex journal_mutex;
+
+    std::deque<QueuedWrite> queue;
+    size_t queued_bytes;
+    bool write_in_progress;
+    bool terminating;
+    std::string pending_error;
+    std::mutex queue_mutex;
+    std::condition_variable queue_not_empty;
+    std::condition_variable queue_not_full;
+    std::condition_variable queue_drained;
+    std::thread writer_thread;
 };
 
-FileSaverHdd::Priv::Priv(const io::path &output_dir, const bool overwrite)
-    : output_dir(output_dir), overwrite(overwrite), saved_file_count(0)
+FileSaverHdd::Priv::Priv(
+    const io::path &output_dir,
+    const bool overwrite,
+    const bool async,
+    const bool dedup,
+    const bool resume)
+    : output_dir(output_dir),
+        overwrite(overwrite),
+        async(async),
+        dedup(dedup),
+        resume(resume),
+        journal_loaded(false),
+        saved_file_count(0),
+        queued_bytes(0),
+        write_in_progress(false),
+        terminating(false)
 {
+    if (resume)
+    {
+        const auto journal_path = output_dir / journal_name;
+        if (io::exists(journal_path))
+        {
+            io::FileByteStream old_journal(journal_path, io::FileMode::Read);
+            const auto lines = algo::split(
+                old_journal.read_to_eof().str(), '\n', false);
+            for (const auto &line : lines)
+                journaled_paths.insert(io::path(line));
+            journal_loaded = true;
+        }
+        // opening for writing truncates, so the loaded entries are written
+        // back before any new ones are appended
+        io::create_directories(output_dir);
+        journal_stream = std::make_unique<io::FileByteStream>(
+            journal_path, io::FileMode::Write);
+        for (const auto &path : journaled_paths)
+            journal_stream->write(bstr(path.str() + "\n"));
+    }
+    if (async)
+        writer_thread = std::thread([this]() { writer_loop(); });
+}
+
+FileSaverHdd::Priv::~Priv()
+{
+    if (!async)
+        return;
+    {
+        std::unique_lock<std::mutex> lock(queue_mutex);
+        terminating = true;
+        queue_not_empty.notify_all();
+    }
+    writer_thread.join();
 }
 
 io::path FileSaverHdd::Priv::make_path_unique(const io::path &path)
 {
+    // the counter remembers where the numbering left off for each base
+    // name, so a run emitting thousands of same-stem files tries each
+    // suffix once instead of rescanning from (1) - and stats the disk
+    // only for candidates not yet claimed during this run
     io::path new_path = path;
-    int i = 1;
+    auto &counter = suffix_counters[path];
     while (paths.find(new_path) != paths.end()
         || (!overwrite && io::exists(new_path)))
     {
-        new_path.change_stem(path.stem() + algo::format("(%d)", i++));
+        new_path.change_stem(path.stem() + algo::format("(%d)", ++counter));
     }
     paths.insert(new_path);
     return new_path;
 }
 
+// Entry paths come straight out of archives and cannot be trusted with
+// the filesystem: absolute paths and ".." components would escape the
+// output directory, and reserved bytes make unopenable names. Archives
+// repeat the same few directory prefixes across thousands of entries,
+// so the sanitized parent is cached and only the leaf gets processed
+// per entry.
+io::path FileSaverHdd::Priv::sanitize_output_path(const io::path &path)
+{
+    const auto parent = path.parent().str();
+    auto cached = sanitized_parents.find(parent);
+    if (cached == sanitized_parents.end())
+    {
+        std::string sanitized;
+        for (const auto &part : algo::split(parent, '/', false))
+        {
+            auto component = part;
+            if (component == ".")
+                continue;
+            if (component == "..")
+                component = "_";
+            else
+                sanitize_name_bytes(component);
+            if (!sanitized.empty())
+                sanitized += '/';
+            sanitized += component;
+        }
+        cached = sanitized_parents.emplace(parent, sanitized).first;
+    }
+
+    auto leaf = path.name();
+    if (leaf == "..")
+        leaf = "_";
+    else
+        sanitize_name_bytes(leaf);
+    return io::path(cached->second) / leaf;
+}
+
+void FileSaverHdd::Priv::enqueue(QueuedWrite write)
+{
+    std::unique_lock<std::mutex> lock(queue_mutex);
+    rethrow_pending_error();
+    queue_not_full.wait(
+        lock,
+        [&]() { return queued_bytes < max_queued_bytes || queue.empty(); });
+    queued_bytes += write.size;
+    queue.push_back(std::move(write));
+    queue_not_empty.notify_one();
+}
+
+void FileSaverHdd::Priv::writer_loop()
+{
+    while (true)
+    {
+        QueuedWrite write;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex);
+            queue_not_empty.wait(
+                lock, [&]() { return !queue.empty() || terminating; });
+            if (queue.empty())
+                return;
+            write = std::move(queue.front());
+            queue.pop_front();
+            write_in_progress = true;
+        }
+        std::string error;
+        try
+        {
+            AU_TRACE_SPAN("save " + write.full_path.str(), "FileSaverHdd");
+            write_output_stream(*write.output_stream, write.file->stream);
+        }
+        catch (const std::exception &e)
+        {
+            error = e.what() ? e.what() : "unknown error";
+        }
+        if (error.empty())
+            journal(write.full_path);
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex);
+            queued_bytes -= write.size;
+            write_in_progress = false;
+            if (error.empty())
+                ++saved_file_count;
+            else if (pending_error.empty())
+                pending_error = error;
+            queue_not_full.notify_all();
+            if (queue.empty())
+                queue_drained.notify_all();
+        }
+    }
+}
+
+void FileSaverHdd::Priv::wait_until_drained()
+{
+    std::unique_lock<std::mutex> lock(queue_mutex);
+    queue_drained.wait(
+        lock, [&]() { return queue.empty() && !write_in_progress; });
+}
+
+// a path is appended only after its bytes are fully on disk, so on resume
+// the journal never vouches for a write that was cut short
+void FileSaverHdd::Priv::journal(const io::path &path)
+{
+    if (!journal_stream)
+        return;
+    std::unique_lock<std::mutex> lock(journal_mutex);
+    if (!journaled_paths.insert(path).second)
+        return;
+    journal_stream->write(bstr(path.str() + "\n"));
+}
+
+bool FileSaverHdd::Priv::is_journaled(const io::path &path)
+{
+    std::unique_lock<std::mutex> lock(journal_mutex);
+    return journaled_paths.find(path) != journaled_paths.end();
+}
+
+void FileSaverHdd::Priv::rethrow_pending_error()
+{
+    // errors from background writes surface on the next save() call
+    if (!pending_error.empty())
+    {
+        const auto error = pending_error;
+        pending_error.clear();
+        throw err::IoError(error);
+    }
+}
+
 FileSaverHdd::FileSaverHdd(
-    const io::path &output_dir, const bool overwrite)
-    : p(new Priv(output_dir, overwrite))
+    const io::path &output_dir,
+    const bool overwrite,
+    const bool async,
+    const bool dedup,
+    const bool resume)
+    : p(new Priv(output_dir, overwrite, async, dedup, resume))
 {
 }
 
@@ -72,16 +408,91 @@ FileSaverHdd::~FileSaverHdd()
 io::path FileSaverHdd::save(std::shared_ptr<io::File> file) const
 {
     std::unique_lock<std::mutex> lock(mutex);
-    const auto full_path = p->make_path_unique(p->output_dir / file->path);
+    const auto rel_path = p->sanitize_output_path(file->path);
+    if (p->resume)
+    {
+        const auto existing_path = p->output_dir / rel_path;
+        if (p->paths.find(existing_path) == p->paths.end())
+        {
+            // a previous run completed this file if the journal says so;
+            // output directories predating the journal fall back to the
+            // existence check
+            if (p->is_journaled(existing_path)
+                || (!p->journal_loaded && io::exists(existing_path)))
+            {
+                p->paths.insert(existing_path);
+                ++p->saved_file_count;
+                p->journal(existing_path);
+                return existing_path;
+            }
+            // an existing but unjournaled file is a write the crashed run
+            // never finished; its name is reclaimed instead of being
+            // numbered around
+            if (p->journal_loaded && io::exists(existing_path))
+                io::remove(existing_path);
+        }
+    }
+    const auto full_path = p->make_path_unique(p->output_dir / rel_path);
     io::create_directories(full_path.parent());
-    io::FileByteStream output_stream(full_path, io::FileMode::Write);
-    file->stream.seek(0);
-    output_stream.write(file->stream);
-    ++p->saved_file_count;
+
+    if (p->dedup)
+    {
+        const auto content = file->stream.seek(0).read_to_eof();
+        const auto digest = algo::crypt::sha1(content);
+        const auto known = p->content_hashes.find(digest);
+        if (known != p->content_hashes.end())
+        {
+            try
+            {
+                io::create_hard_link(known->second, full_path);
+                ++p->saved_file_count;
+                p->journal(full_path);
+                return full_path;
+            }
+            catch (const std::exception &)
+            {
+                // filesystems without hard link support fall back to a
+                // regular write below
+            }
+        }
+        else
+        {
+            p->content_hashes[digest] = full_path;
+        }
+    }
+
+    // the target file is created synchronously in both modes, so name
+    // collision checks against the disk stay meaningful
+    auto output_stream = std::make_unique<io::FileByteStream>(
+        full_path, io::FileMode::Write);
+    if (!p->async)
+    {
+        write_output_stream(*output_stream, file->stream);
+        ++p->saved_file_count;
+        p->journal(full_path);
+        return full_path;
+    }
+    const auto size = file->stream.size();
+    p->enqueue({std::move(output_stream), std::move(file), full_path, size});
     return full_path;
 }
 
+bool FileSaverHdd::is_already_saved(const io::path &path) const
+{
+    if (!p->resume)
+        return false;
+    std::unique_lock<std::mutex> lock(mutex);
+    const auto full_path = p->output_dir / p->sanitize_output_path(path);
+    if (p->paths.find(full_path) != p->paths.end())
+        return false;
+    return p->is_journaled(full_path)
+        || (!p->journal_loaded && io::exists(full_path));
+}
+
 size_t FileSaverHdd::get_saved_file_count() const
 {
+    if (p->async)
+        p->wait_until_drained();
+    std::unique_lock<std::mutex> lock(p->queue_mutex);
     return p->saved_file_count;
 }
@@ -26,11 +26,29 @@ namespace flow {
     class FileSaverHdd final : public IFileSaver
     {
     public:
-        FileSaverHdd(const io::path &output_dir, const bool overwrite);
+        // When async is set, save() creates the target file and hands the
+        // data write to a background writer thread (bounded by a byte
+        // budget), so decode threads do not stall on disk latency.
+        // When dedup is set, files whose content was already saved during
+        // this run become hard links to the first copy instead of being
+        // written again.
+        // When resume is set, output files left behind by a previous run
+        // are kept as they are and reported via is_already_saved(), so
+        // that the unpacker can skip re-extracting them. Completed writes
+        // are recorded in a journal inside the output directory; when one
+        // is found on startup it is trusted over the bare existence of
+        // output files, so writes cut short by a crash are redone.
+        FileSaverHdd(
+            const io::path &output_dir,
+            const bool overwrite,
+            const bool async = false,
+            const bool dedup = false,
+            const bool resume = false);
         ~FileSaverHdd();
 
         io::path save(std::shared_ptr<io::File> file) const override;
         size_t get_saved_file_count() const override;
+        bool is_already_saved(const io::path &path) const override;
 
     private:
         struct Priv;
@@ -0,0 +1,164 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "flow/file_saver_tar.h"
+#include <cstring>
+#include <ctime>
+#include <mutex>
+#include <set>
+#include "algo/format.h"
+#include "algo/range.h"
+#include "io/file_byte_stream.h"
+
+using namespace au;
+using namespace au::flow;
+
+static const size_t block_size = 512;
+
+static void write_octal(
+    char *output, const size_t field_size, const u64 value)
+{
+    std::snprintf(
+        output,
+        field_size,
+        "%0*llo",
+        static_cast<int>(field_size - 1),
+        static_cast<unsigned long long>(value));
+}
+
+static bstr make_header(
+    const std::string &name, const size_t size, const char type_flag)
+{
+    bstr header(block_size);
+    auto *raw = header.get<char>();
+
+    // ustar layout: a name too long for the 100-byte field is split at a
+    // slash into the prefix field; callers handle names too long even for
+    // that with a separate GNU long name entry.
+    std::string entry_name = name;
+    if (entry_name.size() > 100)
+    {
+        const auto split = entry_name.find('/', entry_name.size() - 100);
+        if (split != std::string::npos && split <= 155)
+        {
+            std::memcpy(raw + 345, entry_name.data(), split);
+            entry_name = entry_name.substr(split + 1);
+        }
+        else
+        {
+            entry_name = entry_name.substr(entry_name.size() - 100);
+        }
+    }
+    std::memcpy(raw, entry_name.data(), entry_name.size());
+
+    write_octal(raw + 100, 8, 0644);           // mode
+    write_octal(raw + 108, 8, 0);              // uid
+    write_octal(raw + 116, 8, 0);              // gid
+    write_octal(raw + 124, 12, size);
+    write_octal(raw + 136, 12, std::time(nullptr));
+    std::memset(raw + 148, ' ', 8);            // checksum placeholder
+    raw[156] = type_flag;
+    std::memcpy(raw + 257, "ustar", 6);        // magic
+    std::memcpy(raw + 263, "00", 2);           // version
+
+    u32 checksum = 0;
+    for (const auto i : algo::range(block_size))
+        checksum += header[i];
+    write_octal(raw + 148, 7, checksum);
+    raw[155] = ' ';
+    return header;
+}
+
+struct FileSaverTar::Priv final
+{
+    Priv(const io::path &tar_path);
+
+    std::string make_name_unique(const std::string &name);
+    void write_entry(const std::string &name, io::BaseByteStream &input);
+
+    io::FileByteStream output_stream;
+    std::set<std::string> names;
+    size_t saved_file_count;
+    std::mutex mutex;
+};
+
+FileSaverTar::Priv::Priv(const io::path &tar_path)
+    : output_stream(tar_path, io::FileMode::Write), saved_file_count(0)
+{
+}
+
+std::string FileSaverTar::Priv::make_name_unique(const std::string &name)
+{
+    io::path new_path = name;
+    int i = 1;
+    while (names.find(new_path.str()) != names.end())
+        new_path.change_stem(io::path(name).stem() + algo::format("(%d)", i++));
+    names.insert(new_path.str());
+    return new_path.str();
+}
+
+void FileSaverTar::Priv::write_entry(
+    const std::string &name, io::BaseByteStream &input)
+{
+    if (name.size() > 100)
+    {
+        // GNU long name entry: the real name travels as the content of a
+        // synthetic 'L' entry preceding the actual file.
+        output_stream.write(make_header("././@LongLink", name.size(), 'L'));
+        output_stream.write(name);
+        const auto padding = (block_size - name.size() % block_size)
+            % block_size;
+        output_stream.write(bstr(padding));
+    }
+    const auto size = input.seek(0).size();
+    output_stream.write(make_header(name, size, '0'));
+    input.seek(0);
+    output_stream.write(input);
+    const auto padding = (block_size - size % block_size) % block_size;
+    output_stream.write(bstr(padding));
+}
+
+FileSaverTar::FileSaverTar(const io::path &tar_path) : p(new Priv(tar_path))
+{
+}
+
+FileSaverTar::~FileSaverTar()
+{
+    try
+    {
+        // the end-of-archive marker is two zeroed blocks
+        p->output_stream.write(bstr(2 * block_size));
+    }
+    catch (...)
+    {
+    }
+}
+
+io::path FileSaverTar::save(std::shared_ptr<io::File> file) const
+{
+    std::unique_lock<std::mutex> lock(p->mutex);
+    const auto name = p->make_name_unique(file->path.str());
+    p->write_entry(name, file->stream);
+    ++p->saved_file_count;
+    return name;
+}
+
+size_t FileSaverTar::get_saved_file_count() const
+{
+    std::unique_lock<std::mutex> lock(p->mutex);
+    return p->saved_file_count;
+}
@@ -28,6 +28,13 @@ namespace flow {
         virtual ~IFileSaver() {}
         virtual io::path save(std::shared_ptr<io::File> file) const = 0;
         virtual size_t get_saved_file_count() const = 0;
+
+        // Whether a file at the given path was left behind by a previous
+        // run, so that producing it again can be skipped entirely.
+        virtual bool is_already_saved(const io::path &path) const
+        {
+            return false;
+        }
     };
 
 } }
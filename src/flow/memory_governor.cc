@@ -0,0 +1,74 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "flow/memory_governor.h"
+
+using namespace au;
+using namespace au::flow;
+
+static thread_local u64 held_by_current_thread = 0;
+
+MemoryGovernor::MemoryGovernor(const u64 limit)
+    : limit(limit), used(0), peak(0)
+{
+}
+
+void MemoryGovernor::set_limit(const u64 limit)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    this->limit = limit;
+    budget_freed.notify_all();
+}
+
+u64 MemoryGovernor::get_limit() const
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    return limit;
+}
+
+void MemoryGovernor::acquire(const u64 bytes)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    // a thread that already holds part of the budget is admitted without
+    // waiting - it cannot release what it holds until this acquisition
+    // returns, so blocking it on other threads could deadlock now that
+    // small nested units run inline on their parent's worker
+    if (limit && !held_by_current_thread)
+    {
+        budget_freed.wait(
+            lock, [&]() { return !limit || used + bytes <= limit || !used; });
+    }
+    used += bytes;
+    held_by_current_thread += bytes;
+    if (used > peak)
+        peak = used;
+}
+
+void MemoryGovernor::release(const u64 bytes)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    used = bytes > used ? 0 : used - bytes;
+    held_by_current_thread = bytes > held_by_current_thread
+        ? 0 : held_by_current_thread - bytes;
+    budget_freed.notify_all();
+}
+
+u64 MemoryGovernor::get_peak() const
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    return peak;
+}
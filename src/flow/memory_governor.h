@@ -0,0 +1,72 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include "types.h"
+
+namespace au {
+namespace flow {
+
+    // Caps the total estimated footprint of in-flight decode tasks. Workers
+    // declare their footprint before decoding and block until the budget
+    // has room; a limit of 0 disables the accounting entirely. A single
+    // oversized task is always admitted when nothing else is in flight so
+    // that progress is guaranteed.
+    class MemoryGovernor final
+    {
+    public:
+        MemoryGovernor(const u64 limit = 0);
+
+        void set_limit(const u64 limit);
+        u64 get_limit() const;
+
+        void acquire(const u64 bytes);
+        void release(const u64 bytes);
+
+        // Largest total footprint seen so far; tracked even when no limit
+        // is set, so run reports can state the estimated peak.
+        u64 get_peak() const;
+
+    private:
+        u64 limit;
+        u64 used;
+        u64 peak;
+        mutable std::mutex mutex;
+        std::condition_variable budget_freed;
+    };
+
+    struct MemoryGuard final
+    {
+        MemoryGuard(MemoryGovernor &governor, const u64 bytes)
+            : governor(governor), bytes(bytes)
+        {
+            governor.acquire(bytes);
+        }
+
+        ~MemoryGuard()
+        {
+            governor.release(bytes);
+        }
+
+        MemoryGovernor &governor;
+        const u64 bytes;
+    };
+
+} }
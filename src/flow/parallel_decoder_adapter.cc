@@ -16,14 +16,167 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "flow/parallel_decoder_adapter.h"
+#include <boost/core/demangle.hpp>
+#include <chrono>
+#include <typeinfo>
+#include "algo/alloc_stats.h"
+#include "algo/crypt/sha1.h"
+#include "algo/format.h"
 #include "algo/naming_strategies.h"
+#include "algo/trace.h"
+#include "enc/microsoft/bmp_image_encoder.h"
 #include "enc/microsoft/wav_audio_encoder.h"
 #include "enc/png/png_image_encoder.h"
 #include "flow/vfs_bridge.h"
+#include "io/stream_stats.h"
 
 using namespace au;
 using namespace au::flow;
 
+
+namespace
+{
+    // Measures one stage of a decoder's work into the optional perf
+    // tracker; the category is the decoder's demangled class name.
+    struct StageTimer final
+    {
+        StageTimer(
+            PerfTracker *const perf_tracker,
+            const dec::BaseDecoder &decoder,
+            const char *stage,
+            const u64 byte_count,
+            const std::string &detail = "")
+            : perf_tracker(perf_tracker),
+            stage(stage),
+            byte_count(byte_count),
+            detail(detail),
+            start(std::chrono::steady_clock::now())
+        {
+            if (perf_tracker
+                || io::StreamStats::enabled()
+                || algo::AllocStats::enabled()
+                || algo::Trace::enabled())
+            {
+                category = boost::core::demangle(typeid(decoder).name());
+            }
+            if (algo::Trace::enabled())
+            {
+                tracing = true;
+                trace_start = algo::Trace::now_nanoseconds();
+            }
+            // the stats labels make every stream operation and buffer
+            // allocation on this thread count towards the decoder being
+            // timed
+            if (io::StreamStats::enabled())
+            {
+                previous_label = io::StreamStats::get_label();
+                io::StreamStats::set_label(category);
+                label_set = true;
+            }
+            if (algo::AllocStats::enabled())
+            {
+                previous_alloc_label = algo::AllocStats::get_label();
+                algo::AllocStats::set_label(category);
+                alloc_label_set = true;
+            }
+        }
+
+        ~StageTimer()
+        {
+            if (label_set)
+                io::StreamStats::set_label(previous_label);
+            if (alloc_label_set)
+                algo::AllocStats::set_label(previous_alloc_label);
+            if (tracing)
+            {
+                algo::Trace::record(
+                    detail.empty() ? stage : stage + (" " + detail),
+                    category,
+                    trace_start,
+                    algo::Trace::now_nanoseconds() - trace_start);
+            }
+            if (!perf_tracker)
+                return;
+            perf_tracker->add(
+                category,
+                stage,
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - start).count(),
+                byte_count,
+                detail);
+        }
+
+        PerfTracker *const perf_tracker;
+        std::string category;
+        std::string previous_label;
+        bool label_set = false;
+        std::string previous_alloc_label;
+        bool alloc_label_set = false;
+        bool tracing = false;
+        u64 trace_start = 0;
+        const char *stage;
+        const u64 byte_count;
+        const std::string detail;
+        const std::chrono::steady_clock::time_point start;
+    };
+}
+
+// Fingerprint of a parsed archive: the decoder, the file size and the
+// full entry table. Two archives agreeing on all three are the same
+// bytes for all practical purposes - the entry table pins every offset
+// and size in the file - which is exactly the case of series releases
+// bundling identical system archives in every volume.
+static bstr archive_fingerprint(
+    const dec::BaseArchiveDecoder &decoder,
+    io::File &input_file,
+    const dec::ArchiveMeta &meta)
+{
+    bstr serialized;
+    serialized += bstr(typeid(decoder).name());
+    serialized += algo::format(
+        "|%llx|%llx|",
+        static_cast<unsigned long long>(input_file.stream.size()),
+        static_cast<unsigned long long>(meta.entries.size()));
+    for (const auto &entry : meta.entries)
+    {
+        serialized += bstr(entry->path.str());
+        if (const auto compressed_entry
+            = dynamic_cast<const dec::CompressedArchiveEntry*>(entry.get()))
+        {
+            serialized += algo::format(
+                "|%llx:%llx:%llx\n",
+                static_cast<unsigned long long>(compressed_entry->offset),
+                static_cast<unsigned long long>(compressed_entry->size_comp),
+                static_cast<unsigned long long>(compressed_entry->size_orig));
+        }
+        else if (const auto plain_entry
+            = dynamic_cast<const dec::PlainArchiveEntry*>(entry.get()))
+        {
+            serialized += algo::format(
+                "|%llx:%llx\n",
+                static_cast<unsigned long long>(plain_entry->offset),
+                static_cast<unsigned long long>(plain_entry->size));
+        }
+        else
+        {
+            serialized += "|\n"_b;
+        }
+    }
+    return algo::crypt::sha1(serialized);
+}
+
+// Loose top level files cannot be split by entries, so in entry sharding
+// mode they are dealt to shards by a hash of their name. Nested files
+// are never resharded - they already belong to the shard that admitted
+// the entry they came from.
+static bool belongs_to_other_shard(const BaseParallelUnpackingTask &task)
+{
+    const auto &shard = task.task_context.unpacker_context.shard;
+    return shard.by_entries
+        && task.source_type == TaskSourceType::InitialUserInput
+        && !shard.admits(task.base_name);
+}
+
 ParallelDecoderAdapter::ParallelDecoderAdapter(
     const std::shared_ptr<const BaseParallelUnpackingTask> parent_task,
     const std::shared_ptr<io::File> input_file)
@@ -38,11 +191,53 @@ ParallelDecoderAdapter::~ParallelDecoderAdapter()
 void ParallelDecoderAdapter::visit(const dec::BaseArchiveDecoder &decoder)
 {
     auto input_file = this->input_file;
-    auto meta = std::shared_ptr<dec::ArchiveMeta>(
-        decoder.read_meta(parent_task->logger, *input_file));
+    auto *perf_tracker
+        = parent_task->task_context.unpacker_context.perf_tracker;
+    const auto &unpacker_context = parent_task->task_context.unpacker_context;
+
+    // when include/exclude patterns are active, hand the predicate to the
+    // decoder so that lazily enumerating decoders can skip rejected
+    // entries during traversal rather than after
+    dec::BaseArchiveDecoder::EntryFilter entry_filter;
+    if (!unpacker_context.include_patterns.empty()
+        || !unpacker_context.exclude_patterns.empty())
+    {
+        entry_filter = [&unpacker_context](const io::path &path)
+        {
+            return unpacker_context.should_extract(path);
+        };
+    }
+
+    std::shared_ptr<dec::ArchiveMeta> meta;
+    {
+        const StageTimer timer(
+            perf_tracker,
+            decoder,
+            "meta",
+            input_file->stream.size(),
+            input_file->path.str());
+        meta = std::shared_ptr<dec::ArchiveMeta>(
+            decoder.read_meta(parent_task->logger, *input_file, entry_filter));
+    }
     parent_task->logger.info(
         "archive contains %d files.\n", meta->entries.size());
 
+    if (unpacker_context.dedup_archives && !meta->entries.empty())
+    {
+        io::path prior_name;
+        if (parent_task->task_context.archive_memo.find_or_store(
+            archive_fingerprint(decoder, *input_file, *meta),
+            parent_task->base_name,
+            prior_name))
+        {
+            parent_task->logger.info(
+                "archive is identical to \"%s\" unpacked earlier this "
+                "run; skipping.\n",
+                prior_name.str().c_str());
+            return;
+        }
+    }
+
     const auto vfs_bridge = std::make_shared<VirtualFileSystemBridge>(
         parent_task->logger,
         decoder,
@@ -50,27 +245,125 @@ void ParallelDecoderAdapter::visit(const dec::BaseArchiveDecoder &decoder)
         input_file,
         parent_task->base_name);
 
+    // the entries of one archive overwhelmingly share a concrete type, so
+    // the dynamic_cast verdict from the first entry is reused for every
+    // entry carrying the same typeid - archives with hundreds of
+    // thousands of tiny entries pay for RTTI once instead of per entry
+    enum class SizeHintSource { None, Plain, Compressed };
+    const auto entries_independent = decoder.entries_are_independent();
+    const std::type_info *last_entry_type = nullptr;
+    auto size_hint_source = SizeHintSource::None;
+
+    // entry sharding partitions the top level archives themselves, so
+    // several machines can cover one huge archive without coordination
+    const auto &shard = parent_task->task_context.unpacker_context.shard;
+    const auto shard_entries = shard.by_entries
+        && parent_task->source_type == TaskSourceType::InitialUserInput;
+
+    size_t filtered_count = 0;
+    size_t sharded_count = 0;
     for (const auto &entry : meta->entries)
     {
+        // entries rejected by the include/exclude patterns are dropped
+        // here, before any of their data is read or decompressed
+        if (!parent_task->task_context.unpacker_context.should_extract(
+            entry->path))
+        {
+            filtered_count++;
+            continue;
+        }
+
+        if (shard_entries && !shard.admits(entry->path))
+        {
+            sharded_count++;
+            continue;
+        }
+
+        // decoders that declare their entries independent get admitted by
+        // entry size, so many entries of one large archive can be in
+        // flight at once
+        uoff_t size_hint = 0;
+        if (entries_independent)
+        {
+            const auto &entry_type = typeid(*entry);
+            if (last_entry_type != &entry_type)
+            {
+                last_entry_type = &entry_type;
+                if (dynamic_cast<const dec::CompressedArchiveEntry*>(
+                    entry.get()))
+                {
+                    size_hint_source = SizeHintSource::Compressed;
+                }
+                else if (dynamic_cast<const dec::PlainArchiveEntry*>(
+                    entry.get()))
+                {
+                    size_hint_source = SizeHintSource::Plain;
+                }
+                else
+                {
+                    size_hint_source = SizeHintSource::None;
+                }
+            }
+            if (size_hint_source == SizeHintSource::Plain)
+            {
+                size_hint = static_cast<const dec::PlainArchiveEntry&>(
+                    *entry).size;
+            }
+            else if (size_hint_source == SizeHintSource::Compressed)
+            {
+                const auto &compressed_entry
+                    = static_cast<const dec::CompressedArchiveEntry&>(*entry);
+                size_hint = compressed_entry.size_orig
+                    + compressed_entry.size_comp;
+            }
+        }
+
         parent_task->save_file(
             input_file,
-            [meta, &entry, &decoder, vfs_bridge]
+            [meta, &entry, &decoder, vfs_bridge, perf_tracker]
             (io::File &input_file_copy, const Logger &logger)
             {
+                const StageTimer timer(
+                    perf_tracker, decoder, "decode", 0, entry->path.str());
                 return decoder.read_file(
                     logger, input_file_copy, *meta, *entry);
             },
             decoder,
-            entry->path.str());
+            entry->path.str(),
+            size_hint);
+    }
+    if (filtered_count)
+    {
+        parent_task->logger.info(
+            "skipped %d files not matching the filters.\n", filtered_count);
+    }
+    if (sharded_count)
+    {
+        parent_task->logger.info(
+            "left %d files to the other shards.\n", sharded_count);
     }
 }
 
 void ParallelDecoderAdapter::visit(const dec::BaseFileDecoder &decoder)
 {
+    if (belongs_to_other_shard(*parent_task))
+    {
+        parent_task->logger.info("file belongs to another shard.\n");
+        return;
+    }
+    auto *perf_tracker
+        = parent_task->task_context.unpacker_context.perf_tracker;
     parent_task->save_file(
         input_file,
-        [&decoder](io::File &input_file_copy, const Logger &logger)
+        [&decoder, perf_tracker]
+        (io::File &input_file_copy, const Logger &logger)
         {
+            const StageTimer timer(
+                perf_tracker,
+                decoder,
+                "decode",
+                input_file_copy.stream.size(),
+                input_file_copy.path.str());
             return decoder.decode(logger, input_file_copy);
         },
         decoder);
@@ -78,26 +371,214 @@ void ParallelDecoderAdapter::visit(const dec::BaseFileDecoder &decoder)
 
 void ParallelDecoderAdapter::visit(const dec::BaseImageDecoder &decoder)
 {
-    parent_task->save_file(
+    if (belongs_to_other_shard(*parent_task))
+    {
+        parent_task->logger.info("file belongs to another shard.\n");
+        return;
+    }
+    const auto compression_level
+        = parent_task->task_context.unpacker_context.compression_level;
+    const auto image_format
+        = parent_task->task_context.unpacker_context.image_output_format;
+    auto *perf_tracker
+        = parent_task->task_context.unpacker_context.perf_tracker;
+
+    // decoders that can hand out rows incrementally stream them straight
+    // into the PNG encoder band by band, trading the decode/encode
+    // overlap for a bounded footprint: a huge atlas never has to be
+    // resident as a whole image
+    if (image_format == ImageOutputFormat::Png
+        && decoder.supports_banded_decode())
+    {
+        parent_task->save_file(
+            input_file,
+            [&decoder, compression_level, perf_tracker]
+            (io::File &input_file_copy, const Logger &logger)
+            {
+                const StageTimer timer(
+                    perf_tracker,
+                    decoder,
+                    "decode",
+                    input_file_copy.stream.size(),
+                    input_file_copy.path.str());
+
+                struct BandSink final : dec::ImageBandSink
+                {
+                    BandSink(
+                        io::BaseByteStream &output_stream,
+                        const algo::pack::CompressionLevel compression_level)
+                        : output_stream(output_stream),
+                        compression_level(compression_level)
+                    {
+                    }
+
+                    void start(
+                        const size_t width, const size_t height) override
+                    {
+                        encoder = std::make_unique<enc::png::PngBandEncoder>(
+                            output_stream, width, height, compression_level);
+                    }
+
+                    void band(const res::Image &image_band) override
+                    {
+                        encoder->write_band(image_band);
+                    }
+
+                    io::BaseByteStream &output_stream;
+                    const algo::pack::CompressionLevel compression_level;
+                    std::unique_ptr<enc::png::PngBandEncoder> encoder;
+                };
+
+                auto output_file = std::make_shared<io::File>(
+                    input_file_copy.path, ""_b);
+                BandSink sink(output_file->stream, compression_level);
+                decoder.decode_banded(logger, input_file_copy, sink);
+                sink.encoder->finish();
+                output_file->path.change_extension("png");
+                return output_file;
+            },
+            decoder);
+        return;
+    }
+
+    parent_task->save_file_pipelined(
         input_file,
-        [&decoder](io::File &input_file_copy, const Logger &logger)
+        [&decoder, compression_level, image_format, perf_tracker]
+        (io::File &input_file_copy, const Logger &logger) -> EncodeStep
         {
-            auto output_file = decoder.decode(logger, input_file_copy);
-            const auto encoder = enc::png::PngImageEncoder();
-            return encoder.encode(logger, output_file, input_file_copy.path);
+            std::shared_ptr<res::Image> image;
+            {
+                const StageTimer timer(
+                    perf_tracker,
+                    decoder,
+                    "decode",
+                    input_file_copy.stream.size(),
+                    input_file_copy.path.str());
+                image = std::make_shared<res::Image>(
+                    decoder.decode(logger, input_file_copy));
+            }
+            const auto path = input_file_copy.path;
+            return [image, path, compression_level, image_format,
+                    perf_tracker, &decoder]
+            (const Logger &logger)
+            {
+                const StageTimer timer(
+                    perf_tracker,
+                    decoder,
+                    "encode",
+                    image->width() * image->height() * 4,
+                    path.str());
+                std::unique_ptr<enc::BaseImageEncoder> encoder;
+                if (image_format == ImageOutputFormat::Bmp)
+                {
+                    encoder = std::make_unique<
+                        enc::microsoft::BmpImageEncoder>();
+                }
+                else
+                {
+                    encoder = std::make_unique<enc::png::PngImageEncoder>();
+                }
+                encoder->compression_level = compression_level;
+                return encoder->encode(logger, *image, path);
+            };
         },
         decoder);
 }
 
 void ParallelDecoderAdapter::visit(const dec::BaseAudioDecoder &decoder)
 {
-    parent_task->save_file(
+    if (belongs_to_other_shard(*parent_task))
+    {
+        parent_task->logger.info("file belongs to another shard.\n");
+        return;
+    }
+    auto *perf_tracker
+        = parent_task->task_context.unpacker_context.perf_tracker;
+
+    // decoders that can hand out PCM incrementally stream it straight
+    // into the WAV encoder block by block, trading the decode/encode
+    // overlap for a bounded footprint: a long track never has to be
+    // resident as a whole
+    if (decoder.supports_streamed_decode())
+    {
+        parent_task->save_file(
+            input_file,
+            [&decoder, perf_tracker]
+            (io::File &input_file_copy, const Logger &logger)
+            {
+                const StageTimer timer(
+                    perf_tracker,
+                    decoder,
+                    "decode",
+                    input_file_copy.stream.size(),
+                    input_file_copy.path.str());
+
+                struct BlockSink final : dec::AudioBlockSink
+                {
+                    BlockSink(io::BaseByteStream &output_stream)
+                        : output_stream(output_stream)
+                    {
+                    }
+
+                    void start(const res::Audio &spec) override
+                    {
+                        looped = !spec.loops.empty();
+                        encoder = std::make_unique<
+                            enc::microsoft::WavBlockEncoder>(
+                                output_stream, spec);
+                    }
+
+                    void block(const bstr &samples) override
+                    {
+                        encoder->write_block(samples);
+                    }
+
+                    io::BaseByteStream &output_stream;
+                    bool looped = false;
+                    std::unique_ptr<enc::microsoft::WavBlockEncoder> encoder;
+                };
+
+                auto output_file = std::make_shared<io::File>(
+                    input_file_copy.path, ""_b);
+                BlockSink sink(output_file->stream);
+                decoder.decode_streamed(logger, input_file_copy, sink);
+                sink.encoder->finish();
+                output_file->path.change_extension(
+                    sink.looped ? "wavloop" : "wav");
+                return output_file;
+            },
+            decoder);
+        return;
+    }
+
+    parent_task->save_file_pipelined(
         input_file,
-        [&decoder](io::File &input_file_copy, const Logger &logger)
+        [&decoder, perf_tracker]
+        (io::File &input_file_copy, const Logger &logger) -> EncodeStep
         {
-            auto output_file = decoder.decode(logger, input_file_copy);
-            const auto encoder = enc::microsoft::WavAudioEncoder();
-            return encoder.encode(logger, output_file, input_file_copy.path);
+            std::shared_ptr<res::Audio> audio;
+            {
+                const StageTimer timer(
+                    perf_tracker,
+                    decoder,
+                    "decode",
+                    input_file_copy.stream.size(),
+                    input_file_copy.path.str());
+                audio = std::make_shared<res::Audio>(
+                    decoder.decode(logger, input_file_copy));
+            }
+            const auto path = input_file_copy.path;
+            return [audio, path, perf_tracker, &decoder](const Logger &logger)
+            {
+                const StageTimer timer(
+                    perf_tracker,
+                    decoder,
+                    "encode",
+                    audio->samples.size(),
+                    path.str());
+                const auto encoder = enc::microsoft::WavAudioEncoder();
+                return encoder.encode(logger, *audio, path);
+            };
         },
         decoder);
 }
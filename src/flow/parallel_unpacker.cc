@@ -16,18 +16,38 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "flow/parallel_unpacker.h"
+#include <atomic>
 #include <chrono>
 #include <set>
 #include <stack>
+#include <thread>
+#include "algo/crypt/crc32.h"
+#include "algo/crypt/sha1.h"
 #include "algo/format.h"
+#include "algo/quota.h"
+#include "algo/range.h"
+#include "algo/str.h"
 #include "dec/idecoder.h"
 #include "err.h"
 #include "flow/parallel_decoder_adapter.h"
+#include "io/head_cache_byte_stream.h"
 
 using namespace au;
 using namespace au::flow;
 
 static const auto max_depth = 10;
+// probing few candidates (nested decoding with a handful of linked formats)
+// is cheaper serially than paying for thread startup
+static const size_t min_parallel_probe_count = 16;
+// small nested entries are executed inline as a continuation of their
+// parent's worker rather than scheduled: for archives with hundreds of
+// thousands of tiny files, the queue and bookkeeping traffic of a task
+// per entry rivals the decode cost. Entries of unknown size still become
+// real tasks, and the depth bound keeps chains of tiny nested archives
+// from growing the worker's stack without limit.
+static const uoff_t max_inline_size = 64 * 1024;
+static const size_t max_inline_depth = 8;
+static thread_local size_t inline_depth = 0;
 static int task_count = 0;
 static std::mutex mutex;
 
@@ -58,15 +78,19 @@ namespace
             const std::set<std::string> &decoders_to_check,
             const std::shared_ptr<io::File> input_file,
             const DecoderFileFactory file_factory,
+            const DecoderStageFactory stage_factory,
             const std::shared_ptr<const dec::IDecoder> origin_decoder,
-            const std::string &target_name);
+            const std::string &target_name,
+            const uoff_t size_hint = 0);
 
         bool work() const override;
 
         const std::shared_ptr<io::File> input_file;
         const DecoderFileFactory file_factory;
+        const DecoderStageFactory stage_factory;
         const std::shared_ptr<const dec::IDecoder> origin_decoder;
         const std::string target_name;
+        const uoff_t size_hint;
     };
 }
 
@@ -106,7 +130,7 @@ static std::set<std::string> collect_linked_decoders(
             if (known_formats.find(format) != known_formats.end())
                 continue;
             known_formats.insert(format);
-            auto linked_decoder = registry.create_decoder(format);
+            auto linked_decoder = registry.get_pooled_decoder(format);
             decoders_to_inspect.push(linked_decoder.get());
             linked_decoders.push_back(std::move(linked_decoder));
         }
@@ -114,35 +138,184 @@ static std::set<std::string> collect_linked_decoders(
     return std::set<std::string>(known_formats.begin(), known_formats.end());
 }
 
+static std::shared_ptr<dec::IDecoder> guess_decoder_impl(
+    const BaseParallelUnpackingTask &task,
+    const std::set<std::string> &decoders_to_check,
+    io::File &file,
+    const TaskSourceType source_type);
+
 static std::shared_ptr<dec::IDecoder> guess_decoder(
     const BaseParallelUnpackingTask &task,
     const std::set<std::string> &decoders_to_check,
     io::File &file,
     const TaskSourceType source_type)
+{
+    auto *perf_tracker = task.task_context.unpacker_context.perf_tracker;
+    if (!perf_tracker)
+        return guess_decoder_impl(task, decoders_to_check, file, source_type);
+    const auto start = std::chrono::steady_clock::now();
+    auto decoder
+        = guess_decoder_impl(task, decoders_to_check, file, source_type);
+    perf_tracker->add(
+        "(guessing)",
+        "recognize",
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count(),
+        file.stream.size(),
+        file.path.str());
+    return decoder;
+}
+
+static std::shared_ptr<dec::IDecoder> guess_decoder_impl(
+    const BaseParallelUnpackingTask &task,
+    const std::set<std::string> &decoders_to_check,
+    io::File &file,
+    const TaskSourceType source_type)
 {
     task.logger.info(
         "guessing decoder among %d decoders...\n", decoders_to_check.size());
 
-    std::map<std::string, std::shared_ptr<dec::IDecoder>> matching_decoders;
+    const auto &registry = task.task_context.unpacker_context.registry;
+
+    // every candidate rescans the same first bytes, so the probes run
+    // against a view that reads the head of the file once and serves the
+    // rest of the pass from memory; the real stream is touched again only
+    // when a recognized decoder actually decodes
+    io::File probe_file(
+        file.path,
+        std::make_unique<io::HeadCacheByteStream>(file.stream.clone()));
+
+    // a persistent cache can remember the outcome of a previous run's
+    // guessing pass; a quick is_recognized probe guards against stale
+    // entries and hash collisions
+    auto *cache = task.task_context.unpacker_context.recognition_cache;
+    if (cache && source_type == TaskSourceType::InitialUserInput)
+    {
+        const auto cached_name = cache->get_decoder_name(file.path);
+        if (!cached_name.empty()
+            && decoders_to_check.find(cached_name) != decoders_to_check.end()
+            && registry.get_pooled_decoder(cached_name)
+                ->is_recognized(probe_file))
+        {
+            task.logger.success(
+                "recognized as %s (cached).\n", cached_name.c_str());
+            return registry.create_decoder(cached_name);
+        }
+    }
+
+    // identical inner files recur across a collection's discs, so nested
+    // recognition verdicts are memoized for the rest of the run, keyed by
+    // content digest. The verdict also depends on which decoders were
+    // eligible, so the candidate set becomes part of the key; identical
+    // content under the same parent format shares it. The digest costs one
+    // pass over bytes that are already in memory, while a duplicate probe
+    // costs up to one is_recognized call per candidate decoder.
+    bstr memo_key;
+    if (source_type == TaskSourceType::NestedDecoding)
+    {
+        memo_key = algo::crypt::sha1(file.stream.seek(0).read_to_eof());
+        for (const auto &name : decoders_to_check)
+            memo_key += bstr(name);
+        std::string memoized_name;
+        if (task.task_context.recognition_memo.find(memo_key, memoized_name))
+        {
+            if (memoized_name.empty())
+            {
+                task.logger.info("not recognized by any decoder.\n");
+                return nullptr;
+            }
+            task.logger.success(
+                "recognized as %s (same content seen earlier).\n",
+                memoized_name.c_str());
+            return registry.create_decoder(memoized_name);
+        }
+    }
+
+    // decoders with published signatures that cannot match the file's first
+    // bytes are ruled out without even being instantiated
+    const auto candidate_names
+        = registry.get_candidate_decoder_names(probe_file);
+    std::set<std::string> filtered_decoders;
     for (const auto &name : decoders_to_check)
     {
-        const auto current_decoder
-            = task.task_context.unpacker_context.registry.create_decoder(name);
-        if (current_decoder->is_recognized(file))
-            matching_decoders[name] = std::move(current_decoder);
+        if (candidate_names.find(name) != candidate_names.end())
+            filtered_decoders.insert(name);
+    }
+
+    std::map<std::string, std::shared_ptr<dec::IDecoder>> matching_decoders;
+    if (filtered_decoders.size() < min_parallel_probe_count)
+    {
+        for (const auto &name : filtered_decoders)
+        {
+            auto current_decoder = registry.get_pooled_decoder(name);
+            if (current_decoder->is_recognized(probe_file))
+                matching_decoders[name] = std::move(current_decoder);
+        }
+    }
+    else
+    {
+        // with hundreds of registered decoders the serial probe dominates
+        // the latency of small files, so candidates are checked on several
+        // threads, each with its own clone of the input stream
+        const std::vector<std::string> names(
+            filtered_decoders.begin(), filtered_decoders.end());
+        auto thread_count = static_cast<size_t>(
+            std::thread::hardware_concurrency());
+        if (!thread_count)
+            thread_count = 1;
+        thread_count = std::min(thread_count, names.size());
+        std::atomic<size_t> next_index(0);
+        std::mutex matching_mutex;
+        std::vector<std::unique_ptr<std::thread>> threads;
+        for (const auto i : algo::range(thread_count))
+        {
+            threads.push_back(std::make_unique<std::thread>([&]()
+            {
+                io::File file_copy(probe_file);
+                while (true)
+                {
+                    const auto index = next_index++;
+                    if (index >= names.size())
+                        break;
+                    auto current_decoder
+                        = registry.get_pooled_decoder(names[index]);
+                    if (current_decoder->is_recognized(file_copy))
+                    {
+                        std::unique_lock<std::mutex> lock(matching_mutex);
+                        matching_decoders[names[index]]
+                            = std::move(current_decoder);
+                    }
+                }
+            }));
+        }
+        for (auto &thread : threads)
+            thread->join();
     }
 
     if (matching_decoders.size() == 1)
     {
         task.logger.success(
             "recognized as %s.\n", matching_decoders.begin()->first.c_str());
-        return matching_decoders.begin()->second;
+        if (cache && source_type == TaskSourceType::InitialUserInput)
+        {
+            cache->put_decoder_name(
+                file.path, matching_decoders.begin()->first);
+        }
+        if (source_type == TaskSourceType::NestedDecoding)
+        {
+            task.task_context.recognition_memo.store(
+                memo_key, matching_decoders.begin()->first);
+        }
+        // probing uses pooled instances; decoding gets a fresh one, since
+        // CLI argument parsing mutates the decoder
+        return registry.create_decoder(matching_decoders.begin()->first);
     }
 
     if (matching_decoders.empty())
     {
         if (source_type == TaskSourceType::NestedDecoding)
         {
+            task.task_context.recognition_memo.store(memo_key, "");
             task.logger.info("not recognized by any decoder.\n");
         }
         else
@@ -166,29 +339,78 @@ static std::shared_ptr<dec::IDecoder> guess_decoder(
     return nullptr;
 }
 
+bool ShardSpec::active() const
+{
+    return count > 1;
+}
+
+bool ShardSpec::admits(const io::path &path) const
+{
+    if (!active())
+        return true;
+    // crc32 of the path string rather than std::hash, so machines running
+    // different standard libraries deal the same path to the same shard
+    return algo::crypt::crc32(bstr(path.str())) % count == index;
+}
+
 ParallelUnpackerContext::ParallelUnpackerContext(
     const Logger &logger,
     const IFileSaver &file_saver,
     const dec::Registry &registry,
     const bool enable_nested_decoding,
+    const algo::pack::CompressionLevel compression_level,
     const std::vector<std::string> &arguments,
-    const std::set<std::string> &decoders_to_check) :
+    const std::set<std::string> &decoders_to_check,
+    RecognitionCache *const recognition_cache,
+    PerfTracker *const perf_tracker,
+    const std::vector<std::string> &include_patterns,
+    const std::vector<std::string> &exclude_patterns,
+    const ShardSpec &shard,
+    const ImageOutputFormat image_output_format,
+    const bool dedup_archives) :
         logger(logger),
         file_saver(file_saver),
         registry(registry),
         enable_nested_decoding(enable_nested_decoding),
+        compression_level(compression_level),
         arguments(arguments),
-        decoders_to_check(decoders_to_check)
+        decoders_to_check(decoders_to_check),
+        recognition_cache(recognition_cache),
+        perf_tracker(perf_tracker),
+        include_patterns(include_patterns),
+        exclude_patterns(exclude_patterns),
+        shard(shard),
+        image_output_format(image_output_format),
+        dedup_archives(dedup_archives)
 {
 }
 
+bool ParallelUnpackerContext::should_extract(const io::path &path) const
+{
+    for (const auto &pattern : exclude_patterns)
+        if (algo::wildcard_match(pattern, path.str()))
+            return false;
+    if (include_patterns.empty())
+        return true;
+    for (const auto &pattern : include_patterns)
+        if (algo::wildcard_match(pattern, path.str()))
+            return true;
+    return false;
+}
+
 ParallelTaskContext::ParallelTaskContext(
     ParallelUnpacker &unpacker,
     const ParallelUnpackerContext &unpacker_context,
-    TaskScheduler &task_scheduler) :
+    TaskScheduler &task_scheduler,
+    MemoryGovernor &memory_governor,
+    RecognitionMemo &recognition_memo,
+    ArchiveMemo &archive_memo) :
         unpacker(unpacker),
         unpacker_context(unpacker_context),
-        task_scheduler(task_scheduler)
+        task_scheduler(task_scheduler),
+        memory_governor(memory_governor),
+        recognition_memo(recognition_memo),
+        archive_memo(archive_memo)
 {
 }
 
@@ -210,6 +432,10 @@ BaseParallelUnpackingTask::BaseParallelUnpackingTask(
     mutex.unlock();
     logger.set_prefix(
         algo::format("[task %d] %s: ", task_id, base_name.c_str()));
+    // task loggers are thread confined; batching their lines keeps the
+    // console mutex off the decoding hot path and groups each task's
+    // output together
+    logger.enable_buffering();
 }
 
 size_t BaseParallelUnpackingTask::get_depth() const
@@ -228,6 +454,39 @@ void BaseParallelUnpackingTask::save_file(
     const std::shared_ptr<io::File> input_file,
     const DecoderFileFactory file_factory,
     const dec::BaseDecoder &origin_decoder,
+    const std::string &target_name,
+    const uoff_t size_hint) const
+{
+    auto task = std::make_shared<ProcessOutputFileTask>(
+        task_context,
+        source_type,
+        base_name,
+        shared_from_this(),
+        source_type == TaskSourceType::InitialUserInput
+            ? std::set<std::string>() : decoders_to_check,
+        input_file,
+        file_factory,
+        nullptr,
+        origin_decoder.shared_from_this(),
+        target_name,
+        size_hint);
+    if (size_hint
+        && size_hint <= max_inline_size
+        && inline_depth < max_inline_depth)
+    {
+        ++inline_depth;
+        const auto success = task->work();
+        --inline_depth;
+        task_context.task_scheduler.record_inline_task(success);
+        return;
+    }
+    task_context.task_scheduler.push_front(std::move(task));
+}
+
+void BaseParallelUnpackingTask::save_file_pipelined(
+    const std::shared_ptr<io::File> input_file,
+    const DecoderStageFactory stage_factory,
+    const dec::BaseDecoder &origin_decoder,
     const std::string &target_name) const
 {
     task_context.task_scheduler.push_front(
@@ -239,7 +498,8 @@ void BaseParallelUnpackingTask::save_file(
             source_type == TaskSourceType::InitialUserInput
                 ? std::set<std::string>() : decoders_to_check,
             input_file,
-            file_factory,
+            nullptr,
+            stage_factory,
             origin_decoder.shared_from_this(),
             target_name));
 }
@@ -283,6 +543,9 @@ bool DecodeInputFileTask::work() const
     {
         logger.info("initial recognition...\n");
 
+        const MemoryGuard memory_guard(
+            task_context.memory_governor, input_file->stream.size());
+
         const auto decoder = guess_decoder(
             *this, decoders_to_check, *input_file, source_type);
 
@@ -322,8 +585,10 @@ ProcessOutputFileTask::ProcessOutputFileTask(
     const std::set<std::string> &decoders_to_check,
     const std::shared_ptr<io::File> input_file,
     const DecoderFileFactory file_factory,
+    const DecoderStageFactory stage_factory,
     const std::shared_ptr<const dec::IDecoder> origin_decoder,
-    const std::string &target_name) :
+    const std::string &target_name,
+    const uoff_t size_hint) :
         BaseParallelUnpackingTask(
             task_context,
             source_type,
@@ -332,13 +597,34 @@ ProcessOutputFileTask::ProcessOutputFileTask(
             decoders_to_check),
         input_file(input_file),
         file_factory(file_factory),
+        stage_factory(stage_factory),
         origin_decoder(origin_decoder),
-        target_name(target_name)
+        target_name(target_name),
+        size_hint(size_hint)
 {
 }
 
 bool ProcessOutputFileTask::work() const
 {
+    // resume support: when the saver reports that a previous run already
+    // produced this entry's output, don't even decode it. This can only
+    // be predicted for entries whose path survives extraction unchanged,
+    // which covers the raw archive entries that make up the bulk of a
+    // rerun; converted entries fall through and get decoded again.
+    if (!target_name.empty())
+    {
+        const auto predicted_path = algo::apply_naming_strategy(
+            origin_decoder->naming_strategy(), base_name, target_name);
+        if (task_context.unpacker_context.file_saver.is_already_saved(
+            predicted_path))
+        {
+            logger.info(
+                "\"%s\" already extracted, skipping.\n",
+                target_name.c_str());
+            return true;
+        }
+    }
+
     logger.info(
         target_name.empty()
             ? "decoding...\n"
@@ -354,6 +640,45 @@ bool ProcessOutputFileTask::work() const
     std::shared_ptr<io::File> output_file;
     try
     {
+        const MemoryGuard memory_guard(
+            task_context.memory_governor,
+            size_hint ? size_hint : input_file_copy.stream.size());
+        const algo::DecodeQuotaGuard quota_guard;
+
+        if (stage_factory)
+        {
+            // pipelined conversion: run only the decode stage here and hand
+            // the intermediate over to a separately scheduled encode task,
+            // so that this worker is free to decode the next file while
+            // another one compresses the result
+            const auto encode_step = stage_factory(input_file_copy, logger);
+            if (!encode_step)
+            {
+                logger.info(
+                    target_name.empty()
+                        ? "decoding of \"%s\" ommitted.\n"
+                        : "decoding ommitted.\n",
+                    target_name.c_str());
+                return false;
+            }
+            task_context.task_scheduler.push_front(
+                std::make_shared<ProcessOutputFileTask>(
+                    task_context,
+                    source_type,
+                    base_name,
+                    parent_task,
+                    decoders_to_check,
+                    input_file,
+                    [encode_step](io::File &, const Logger &logger)
+                    {
+                        return encode_step(logger);
+                    },
+                    nullptr,
+                    origin_decoder,
+                    target_name));
+            return true;
+        }
+
         output_file = file_factory(input_file_copy, logger);
         if (!output_file)
         {
@@ -364,6 +689,13 @@ bool ProcessOutputFileTask::work() const
                 target_name.c_str());
             return false;
         }
+        const auto output_quota = algo::DecodeQuota::get_output_limit();
+        if (output_quota && output_file->stream.size() > output_quota)
+        {
+            throw err::QuotaError(algo::format(
+                "Output of %zu bytes exceeds the output quota",
+                static_cast<size_t>(output_file->stream.size())));
+        }
     }
     catch (const std::exception &e)
     {
@@ -428,14 +760,24 @@ struct ParallelUnpacker::Priv final
 
     const ParallelUnpackerContext &unpacker_context;
     TaskScheduler task_scheduler;
+    MemoryGovernor memory_governor;
+    RecognitionMemo recognition_memo;
+    ArchiveMemo archive_memo;
     ParallelTaskContext task_context;
+    TaskSchedulerResult last_result = {0, 0};
 };
 
 ParallelUnpacker::Priv::Priv(
     ParallelUnpacker &unpacker,
     const ParallelUnpackerContext &unpacker_context) :
         unpacker_context(unpacker_context),
-        task_context(unpacker, unpacker_context, task_scheduler)
+        task_context(
+            unpacker,
+            unpacker_context,
+            task_scheduler,
+            memory_governor,
+            recognition_memo,
+            archive_memo)
 {
 }
 
@@ -450,8 +792,12 @@ ParallelUnpacker::~ParallelUnpacker()
 }
 
 void ParallelUnpacker::add_input_file(
-    const io::path &base_name, const InputFileFactory file_factory)
+    const io::path &base_name,
+    const InputFileFactory file_factory,
+    const uoff_t size_hint)
 {
+    // the largest inputs are scheduled first so that the longest decode
+    // jobs are not left for the tail of the run
     p->task_scheduler.push_back(
         std::make_shared<DecodeInputFileTask>(
             p->task_context,
@@ -459,13 +805,98 @@ void ParallelUnpacker::add_input_file(
             base_name,
             nullptr,
             p->unpacker_context.decoders_to_check,
-            file_factory));
+            file_factory),
+        size_hint);
+}
+
+void ParallelUnpacker::set_memory_limit(const u64 limit)
+{
+    p->memory_governor.set_limit(limit);
+}
+
+TaskSchedulerStats ParallelUnpacker::get_stats() const
+{
+    return p->task_scheduler.get_stats();
+}
+
+TaskSchedulerResult ParallelUnpacker::get_result() const
+{
+    return p->last_result;
+}
+
+std::vector<WorkerUtilization> ParallelUnpacker::get_worker_utilization()
+    const
+{
+    return p->task_scheduler.get_worker_utilization();
+}
+
+u64 ParallelUnpacker::get_memory_peak() const
+{
+    return p->memory_governor.get_peak();
 }
 
 bool ParallelUnpacker::run(const size_t thread_count)
 {
     const auto begin = std::chrono::steady_clock::now();
+
+    // long runs get a periodic aggregate heartbeat between the per-file
+    // lines: completed/total tasks, throughput and a rough ETA. The task
+    // total grows as entry tables are read, so early estimates converge
+    // once the large archives have revealed their contents.
+    std::atomic<bool> scheduler_done(false);
+    std::thread progress_thread([this, begin, &scheduler_done]()
+    {
+        static const auto report_interval = std::chrono::seconds(5);
+        Logger progress_logger(p->unpacker_context.logger);
+        size_t last_finished_count = 0;
+        auto next_report = begin + report_interval;
+        while (!scheduler_done)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            const auto now = std::chrono::steady_clock::now();
+            if (now < next_report)
+                continue;
+            next_report = now + report_interval;
+            const auto stats = p->task_scheduler.get_stats();
+            if (!stats.finished_task_count
+                || stats.finished_task_count == last_finished_count)
+            {
+                continue;
+            }
+            last_finished_count = stats.finished_task_count;
+            const auto elapsed = std::chrono::duration_cast<
+                std::chrono::milliseconds>(now - begin).count() / 1000.0;
+            const auto rate = stats.finished_task_count / elapsed;
+            const auto eta = static_cast<int>(
+                (stats.total_task_count - stats.finished_task_count) / rate);
+            const auto utilization
+                = p->task_scheduler.get_worker_utilization();
+            u64 busy_nanoseconds = 0;
+            for (const auto &worker : utilization)
+                busy_nanoseconds += worker.busy_nanoseconds;
+            const auto busy_percent = utilization.empty()
+                ? 0.0
+                : 100.0 * busy_nanoseconds / 1e9
+                    / elapsed / utilization.size();
+            progress_logger.info(
+                "progress: %zu/%zu tasks (%.0f%%), %.1f tasks/s, "
+                "%zu queued, workers %.0f%% busy, ETA %02d:%02d:%02d\n",
+                stats.finished_task_count,
+                stats.total_task_count,
+                100.0 * stats.finished_task_count / stats.total_task_count,
+                rate,
+                stats.pending_task_count,
+                busy_percent,
+                eta / 3600,
+                (eta / 60) % 60,
+                eta % 60);
+        }
+    });
+
     const auto results = p->task_scheduler.run(thread_count);
+    p->last_result = results;
+    scheduler_done = true;
+    progress_thread.join();
     const auto end = std::chrono::steady_clock::now();
     const auto diff
         = std::chrono::duration_cast<std::chrono::milliseconds>(end - begin);
@@ -20,9 +20,15 @@
 #include <map>
 #include <memory>
 #include <set>
+#include "algo/pack/compression_level.h"
 #include "dec/base_decoder.h"
 #include "dec/registry.h"
+#include "flow/archive_memo.h"
 #include "flow/ifile_saver.h"
+#include "flow/memory_governor.h"
+#include "flow/perf_tracker.h"
+#include "flow/recognition_cache.h"
+#include "flow/recognition_memo.h"
 #include "flow/task_scheduler.h"
 #include "logger.h"
 
@@ -35,12 +41,49 @@ namespace flow {
         NestedDecoding,
     };
 
+    // Container the decoded images are written out as. PNG honors the
+    // compression level; BMP stores raw rows, which costs disk space but
+    // next to no CPU - useful when the output feeds a post-processing
+    // step anyway.
+    enum class ImageOutputFormat : u8
+    {
+        Png,
+        Bmp,
+    };
+
     class ParallelUnpacker;
 
     using InputFileFactory = std::function<std::shared_ptr<io::File>()>;
     using DecoderFileFactory
         = std::function<std::shared_ptr<io::File>(io::File &, const Logger &)>;
 
+    // Closure produced by the decode stage of a pipelined conversion; it
+    // carries the decoded intermediate (e.g. a res::Image) into an encode
+    // stage that is scheduled as its own task, so that the decoding and the
+    // encoding of different files overlap.
+    using EncodeStep = std::function<std::shared_ptr<io::File>(const Logger &)>;
+    using DecoderStageFactory
+        = std::function<EncodeStep(io::File &, const Logger &)>;
+
+    // Deterministic work partition for corpora split across machines:
+    // shard index out of count, with no coordination beyond agreeing on
+    // the same command line. A count of zero or one disables sharding.
+    // In entry mode the partition applies to top level archive entries
+    // instead of input files, so one huge archive can be covered by
+    // several machines at once.
+    struct ShardSpec final
+    {
+        bool active() const;
+
+        // Whether the given path is dealt to this shard; every path is
+        // admitted by exactly one of the cooperating shards.
+        bool admits(const io::path &path) const;
+
+        size_t index = 0;
+        size_t count = 0;
+        bool by_entries = false;
+    };
+
     struct ParallelUnpackerContext final
     {
         ParallelUnpackerContext(
@@ -48,15 +91,38 @@ namespace flow {
             const IFileSaver &file_saver,
             const dec::Registry &registry,
             const bool enable_nested_decoding,
+            const algo::pack::CompressionLevel compression_level,
             const std::vector<std::string> &arguments,
-            const std::set<std::string> &decoders_to_check);
+            const std::set<std::string> &decoders_to_check,
+            RecognitionCache *const recognition_cache = nullptr,
+            PerfTracker *const perf_tracker = nullptr,
+            const std::vector<std::string> &include_patterns = {},
+            const std::vector<std::string> &exclude_patterns = {},
+            const ShardSpec &shard = {},
+            const ImageOutputFormat image_output_format
+                = ImageOutputFormat::Png,
+            const bool dedup_archives = false);
+
+        // Whether an archive entry at the given path passes the include
+        // and exclude patterns; non-matching entries are never read.
+        bool should_extract(const io::path &path) const;
 
         const Logger &logger;
         const IFileSaver &file_saver;
         const dec::Registry &registry;
         const bool enable_nested_decoding;
+        const algo::pack::CompressionLevel compression_level;
         const std::vector<std::string> arguments;
         const std::set<std::string> decoders_to_check;
+        RecognitionCache *const recognition_cache;
+        PerfTracker *const perf_tracker;
+        const std::vector<std::string> include_patterns;
+        const std::vector<std::string> exclude_patterns;
+        const ShardSpec shard;
+        const ImageOutputFormat image_output_format;
+        // Skip archives whose entry table fingerprint matches one
+        // already unpacked this run.
+        const bool dedup_archives;
     };
 
     struct ParallelTaskContext final
@@ -64,11 +130,17 @@ namespace flow {
         ParallelTaskContext(
             ParallelUnpacker &unpacker,
             const ParallelUnpackerContext &unpacker_context,
-            TaskScheduler &task_scheduler);
+            TaskScheduler &task_scheduler,
+            MemoryGovernor &memory_governor,
+            RecognitionMemo &recognition_memo,
+            ArchiveMemo &archive_memo);
 
         ParallelUnpacker &unpacker;
         const ParallelUnpackerContext &unpacker_context;
         TaskScheduler &task_scheduler;
+        MemoryGovernor &memory_governor;
+        RecognitionMemo &recognition_memo;
+        ArchiveMemo &archive_memo;
     };
 
     struct BaseParallelUnpackingTask :
@@ -86,10 +158,20 @@ namespace flow {
 
         size_t get_depth() const;
 
+        // A non-zero size_hint states how much memory decoding this file is
+        // expected to pin; it replaces the whole input size in the memory
+        // governor's admission charge.
         void save_file(
             const std::shared_ptr<io::File> input_file,
             const DecoderFileFactory,
             const dec::BaseDecoder &origin_decoder,
+            const std::string &custom_name = "",
+            const uoff_t size_hint = 0) const;
+
+        void save_file_pipelined(
+            const std::shared_ptr<io::File> input_file,
+            const DecoderStageFactory,
+            const dec::BaseDecoder &origin_decoder,
             const std::string &custom_name = "") const;
 
         Logger logger;
@@ -106,7 +188,26 @@ namespace flow {
         ParallelUnpacker(const ParallelUnpackerContext &unpacker_context);
         ~ParallelUnpacker();
 
-        void add_input_file(const io::path &base_name, const InputFileFactory);
+        void add_input_file(
+            const io::path &base_name,
+            const InputFileFactory,
+            const uoff_t size_hint = 0);
+        void set_memory_limit(const u64 limit);
+
+        // Aggregate progress of the current run, safe to query from other
+        // threads while run() is in flight.
+        TaskSchedulerStats get_stats() const;
+
+        // Success and error counts of the last finished run.
+        TaskSchedulerResult get_result() const;
+
+        // Peak of the memory governor's estimated footprint.
+        u64 get_memory_peak() const;
+
+        // Per-worker busy/lock-wait/idle accounting of the current or
+        // last run.
+        std::vector<WorkerUtilization> get_worker_utilization() const;
+
         bool run(const size_t thread_count = 0);
 
     private:
@@ -0,0 +1,282 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "flow/perf_tracker.h"
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <vector>
+#include "algo/format.h"
+
+using namespace au;
+using namespace au::flow;
+
+// how many of the slowest files the JSON report lists
+static const size_t slow_file_count = 20;
+
+namespace
+{
+    struct Totals final
+    {
+        u64 call_count = 0;
+        u64 duration_nanoseconds = 0;
+        u64 byte_count = 0;
+        std::vector<u64> durations;
+    };
+
+    struct SlowFile final
+    {
+        u64 duration_nanoseconds;
+        u64 byte_count;
+        std::string detail;
+        std::string category;
+        std::string stage;
+    };
+}
+
+struct PerfTracker::Priv final
+{
+    std::map<std::pair<std::string, std::string>, Totals> totals;
+    std::vector<SlowFile> slow_files;
+    std::mutex mutex;
+};
+
+PerfTracker::PerfTracker() : p(new Priv)
+{
+}
+
+PerfTracker::~PerfTracker()
+{
+}
+
+void PerfTracker::add(
+    const std::string &category,
+    const std::string &stage,
+    const u64 duration_nanoseconds,
+    const u64 byte_count,
+    const std::string &detail)
+{
+    std::unique_lock<std::mutex> lock(p->mutex);
+    auto &totals = p->totals[{category, stage}];
+    totals.call_count++;
+    totals.duration_nanoseconds += duration_nanoseconds;
+    totals.byte_count += byte_count;
+    totals.durations.push_back(duration_nanoseconds);
+
+    if (detail.empty())
+        return;
+    if (p->slow_files.size() < slow_file_count)
+    {
+        p->slow_files.push_back(
+            {duration_nanoseconds, byte_count, detail, category, stage});
+        return;
+    }
+    const auto fastest = std::min_element(
+        p->slow_files.begin(),
+        p->slow_files.end(),
+        [](const SlowFile &a, const SlowFile &b)
+        {
+            return a.duration_nanoseconds < b.duration_nanoseconds;
+        });
+    if (fastest->duration_nanoseconds < duration_nanoseconds)
+    {
+        *fastest = {
+            duration_nanoseconds, byte_count, detail, category, stage};
+    }
+}
+
+void PerfTracker::dump(const Logger &logger) const
+{
+    std::vector<std::pair<std::pair<std::string, std::string>, Totals>> rows;
+    {
+        std::unique_lock<std::mutex> lock(p->mutex);
+        rows.assign(p->totals.begin(), p->totals.end());
+    }
+    std::sort(
+        rows.begin(),
+        rows.end(),
+        [](const decltype(rows)::value_type &a,
+            const decltype(rows)::value_type &b)
+        {
+            return a.second.duration_nanoseconds
+                > b.second.duration_nanoseconds;
+        });
+
+    logger.info("perf counters (sorted by total time):\n");
+    logger.info("seconds      calls        bytes    MB/s  stage\n");
+    for (const auto &row : rows)
+    {
+        const auto seconds = row.second.duration_nanoseconds / 1e9;
+        const auto rate = seconds > 0
+            ? row.second.byte_count / seconds / (1024.0 * 1024.0)
+            : 0.0;
+        logger.info(
+            "%7.3f %10llu %12llu %7.1f  %s: %s\n",
+            seconds,
+            static_cast<unsigned long long>(row.second.call_count),
+            static_cast<unsigned long long>(row.second.byte_count),
+            rate,
+            row.first.first.c_str(),
+            row.first.second.c_str());
+    }
+}
+
+static std::string json_escape(const std::string &input)
+{
+    std::string output;
+    for (const auto c : input)
+    {
+        if (c == '"' || c == '\\')
+        {
+            output += '\\';
+            output += c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20)
+        {
+            output += algo::format("\\u%04X", c);
+        }
+        else
+        {
+            output += c;
+        }
+    }
+    return output;
+}
+
+static u64 percentile(const std::vector<u64> &sorted, const double fraction)
+{
+    if (sorted.empty())
+        return 0;
+    const auto index = std::min(
+        sorted.size() - 1, static_cast<size_t>(fraction * sorted.size()));
+    return sorted[index];
+}
+
+void PerfTracker::write_json_report(
+    io::BaseByteStream &output_stream, const RunSummary &summary) const
+{
+    decltype(Priv::totals) totals;
+    decltype(Priv::slow_files) slow_files;
+    {
+        std::unique_lock<std::mutex> lock(p->mutex);
+        totals = p->totals;
+        slow_files = p->slow_files;
+    }
+
+    std::string out;
+    out += "{\n";
+    out += algo::format("  \"success_count\": %d,\n", summary.success_count);
+    out += algo::format("  \"error_count\": %d,\n", summary.error_count);
+    out += algo::format(
+        "  \"saved_file_count\": %llu,\n",
+        static_cast<unsigned long long>(summary.saved_file_count));
+    out += algo::format(
+        "  \"wall_seconds\": %.3f,\n", summary.wall_nanoseconds / 1e9);
+    out += algo::format("  \"cpu_seconds\": %.3f,\n", summary.cpu_seconds);
+    out += algo::format(
+        "  \"memory_limit\": %llu,\n",
+        static_cast<unsigned long long>(summary.memory_limit));
+    // the peak of the governor's estimated footprint, not of the process
+    // RSS - the two diverge when decoders overshoot their estimates
+    out += algo::format(
+        "  \"estimated_memory_peak\": %llu,\n",
+        static_cast<unsigned long long>(summary.memory_peak));
+    out += algo::format(
+        "  \"copied_bytes\": %llu,\n",
+        static_cast<unsigned long long>(summary.copied_bytes));
+    out += algo::format(
+        "  \"output_bytes\": %llu,\n",
+        static_cast<unsigned long long>(summary.output_bytes));
+    out += algo::format(
+        "  \"copied_bytes_per_output_byte\": %.3f,\n",
+        summary.output_bytes
+            ? summary.copied_bytes
+                / static_cast<double>(summary.output_bytes)
+            : 0.0);
+
+    out += "  \"workers\": [";
+    auto first = true;
+    for (const auto &worker : summary.workers)
+    {
+        out += first ? "\n" : ",\n";
+        first = false;
+        out += algo::format(
+            "    {\"busy_seconds\": %.3f, \"lock_wait_seconds\": %.3f, "
+            "\"idle_seconds\": %.3f, \"tasks\": %llu}",
+            worker.busy_nanoseconds / 1e9,
+            worker.lock_wait_nanoseconds / 1e9,
+            worker.idle_nanoseconds / 1e9,
+            static_cast<unsigned long long>(worker.executed_task_count));
+    }
+    out += "\n  ],\n";
+
+    out += "  \"stages\": [";
+    first = true;
+    for (auto &kv : totals)
+    {
+        std::sort(kv.second.durations.begin(), kv.second.durations.end());
+        const auto seconds = kv.second.duration_nanoseconds / 1e9;
+        const auto rate = seconds > 0
+            ? kv.second.byte_count / seconds / (1024.0 * 1024.0)
+            : 0.0;
+        out += first ? "\n" : ",\n";
+        first = false;
+        out += algo::format(
+            "    {\"category\": \"%s\", \"stage\": \"%s\", "
+            "\"calls\": %llu, \"bytes\": %llu, \"seconds\": %.3f, "
+            "\"mb_per_second\": %.1f, "
+            "\"p50_milliseconds\": %.3f, "
+            "\"p90_milliseconds\": %.3f, "
+            "\"p99_milliseconds\": %.3f}",
+            json_escape(kv.first.first).c_str(),
+            json_escape(kv.first.second).c_str(),
+            static_cast<unsigned long long>(kv.second.call_count),
+            static_cast<unsigned long long>(kv.second.byte_count),
+            seconds,
+            rate,
+            percentile(kv.second.durations, 0.50) / 1e6,
+            percentile(kv.second.durations, 0.90) / 1e6,
+            percentile(kv.second.durations, 0.99) / 1e6);
+    }
+    out += "\n  ],\n";
+
+    std::sort(
+        slow_files.begin(),
+        slow_files.end(),
+        [](const SlowFile &a, const SlowFile &b)
+        {
+            return a.duration_nanoseconds > b.duration_nanoseconds;
+        });
+    out += "  \"slowest_files\": [";
+    first = true;
+    for (const auto &slow_file : slow_files)
+    {
+        out += first ? "\n" : ",\n";
+        first = false;
+        out += algo::format(
+            "    {\"name\": \"%s\", \"category\": \"%s\", "
+            "\"stage\": \"%s\", \"seconds\": %.3f, \"bytes\": %llu}",
+            json_escape(slow_file.detail).c_str(),
+            json_escape(slow_file.category).c_str(),
+            json_escape(slow_file.stage).c_str(),
+            slow_file.duration_nanoseconds / 1e9,
+            static_cast<unsigned long long>(slow_file.byte_count));
+    }
+    out += "\n  ]\n";
+    out += "}\n";
+    output_stream.write(bstr(out));
+}
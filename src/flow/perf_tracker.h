@@ -0,0 +1,83 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "flow/task_scheduler.h"
+#include "io/base_byte_stream.h"
+#include "logger.h"
+#include "types.h"
+
+namespace au {
+namespace flow {
+
+    // Run-level totals that accompany the per-stage counters in the JSON
+    // report; collected by the caller once the run has finished.
+    struct RunSummary final
+    {
+        int success_count = 0;
+        int error_count = 0;
+        u64 saved_file_count = 0;
+        u64 wall_nanoseconds = 0;
+        double cpu_seconds = 0;
+        u64 memory_limit = 0;
+        u64 memory_peak = 0;
+        // filled only when copy accounting ran; both zero otherwise
+        u64 copied_bytes = 0;
+        u64 output_bytes = 0;
+        std::vector<WorkerUtilization> workers;
+    };
+
+    // Collects wall time and byte counters per (category, stage) pair,
+    // where the category is typically a decoder and the stage one of
+    // recognize/meta/decode/encode. Answers "where did the time go"
+    // after a slow run without attaching an external profiler.
+    class PerfTracker final
+    {
+    public:
+        PerfTracker();
+        ~PerfTracker();
+
+        // Thread safe; durations accumulate in nanoseconds. A non-empty
+        // detail names the processed file, feeding the slowest-files list
+        // of the JSON report.
+        void add(
+            const std::string &category,
+            const std::string &stage,
+            const u64 duration_nanoseconds,
+            const u64 byte_count,
+            const std::string &detail = "");
+
+        // Prints the collected counters sorted by total time.
+        void dump(const Logger &logger) const;
+
+        // Writes a machine readable report: the given run totals, every
+        // (category, stage) pair with call and byte counts and duration
+        // percentiles, and the files that took the longest.
+        void write_json_report(
+            io::BaseByteStream &output_stream, const RunSummary &summary)
+            const;
+
+    private:
+        struct Priv;
+        std::unique_ptr<Priv> p;
+    };
+
+} }
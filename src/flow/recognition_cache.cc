@@ -0,0 +1,109 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "flow/recognition_cache.h"
+#include <map>
+#include <mutex>
+#include "algo/format.h"
+#include "algo/str.h"
+#include "io/file_byte_stream.h"
+#include "io/file_system.h"
+
+using namespace au;
+using namespace au::flow;
+
+static std::string make_key(const io::path &input_path)
+{
+    const auto full_path = io::absolute(input_path);
+    if (!io::is_regular_file(full_path))
+        return "";
+    return algo::format(
+        "%s\t%llu\t%llu",
+        full_path.c_str(),
+        static_cast<unsigned long long>(io::last_write_time(full_path)),
+        static_cast<unsigned long long>(io::file_size(full_path)));
+}
+
+struct RecognitionCache::Priv final
+{
+    io::path cache_path;
+    std::map<std::string, std::string> entries;
+    bool dirty;
+    std::mutex mutex;
+};
+
+RecognitionCache::RecognitionCache(const io::path &cache_path) : p(new Priv)
+{
+    p->cache_path = cache_path;
+    p->dirty = false;
+    if (!io::is_regular_file(cache_path))
+        return;
+    io::FileByteStream input_stream(cache_path, io::FileMode::Read);
+    const auto content = input_stream.read_to_eof().str();
+    for (const auto &line : algo::split(content, '\n', false))
+    {
+        // each line holds path, mtime, size and decoder name; the key is
+        // everything up to the last tab
+        const auto separator = line.find_last_of('\t');
+        if (separator == std::string::npos)
+            continue;
+        p->entries[line.substr(0, separator)] = line.substr(separator + 1);
+    }
+}
+
+RecognitionCache::~RecognitionCache()
+{
+    if (!p->dirty)
+        return;
+    try
+    {
+        io::FileByteStream output_stream(p->cache_path, io::FileMode::Write);
+        for (const auto &entry : p->entries)
+            output_stream.write(
+                entry.first + "\t" + entry.second + "\n");
+    }
+    catch (const std::exception &)
+    {
+        // failing to persist the cache only costs time on the next run
+    }
+}
+
+std::string RecognitionCache::get_decoder_name(
+    const io::path &input_path) const
+{
+    const auto key = make_key(input_path);
+    if (key.empty())
+        return "";
+    std::unique_lock<std::mutex> lock(p->mutex);
+    const auto entry = p->entries.find(key);
+    return entry != p->entries.end() ? entry->second : "";
+}
+
+void RecognitionCache::put_decoder_name(
+    const io::path &input_path, const std::string &decoder_name)
+{
+    const auto key = make_key(input_path);
+    if (key.empty() || decoder_name.empty())
+        return;
+    std::unique_lock<std::mutex> lock(p->mutex);
+    auto &entry = p->entries[key];
+    if (entry != decoder_name)
+    {
+        entry = decoder_name;
+        p->dirty = true;
+    }
+}
@@ -0,0 +1,52 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include "io/path.h"
+
+namespace au {
+namespace flow {
+
+    // Persistent map from input files to the decoder that recognized them,
+    // keyed by absolute path, modification time and size, so that repeated
+    // runs over unchanged inputs skip the decoder guessing pass. Only the
+    // decoder name is cached - entry tables carry decoder-specific state
+    // that has no portable serialization.
+    class RecognitionCache final
+    {
+    public:
+        // Loads the cache from the given file if it exists; the destructor
+        // writes the updated cache back.
+        RecognitionCache(const io::path &cache_path);
+        ~RecognitionCache();
+
+        // Returns the cached decoder name for the given file, or an empty
+        // string when the file is unknown or changed since it was cached.
+        std::string get_decoder_name(const io::path &input_path) const;
+
+        void put_decoder_name(
+            const io::path &input_path, const std::string &decoder_name);
+
+    private:
+        struct Priv;
+        std::unique_ptr<Priv> p;
+    };
+
+} }
@@ -0,0 +1,37 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "flow/recognition_memo.h"
+
+using namespace au;
+using namespace au::flow;
+
+bool RecognitionMemo::find(const bstr &key, std::string &decoder_name) const
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    const auto it = verdicts.find(key);
+    if (it == verdicts.end())
+        return false;
+    decoder_name = it->second;
+    return true;
+}
+
+void RecognitionMemo::store(const bstr &key, const std::string &decoder_name)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    verdicts[key] = decoder_name;
+}
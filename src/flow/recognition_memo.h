@@ -0,0 +1,49 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <string>
+#include "types.h"
+
+namespace au {
+namespace flow {
+
+    // Run-wide memo of recognition verdicts for nested files, keyed by
+    // content. Game collections repeat identical inner files (the same
+    // system archives bundled on every disc), so when a nested file's
+    // bytes match ones examined earlier this run, the guessing pass -
+    // which may probe hundreds of decoders - is skipped and the earlier
+    // verdict reused. An empty decoder name records "nothing recognized
+    // it", the usual verdict for plain entries. Unlike the on-disk
+    // recognition cache there is no staleness to guard against.
+    class RecognitionMemo final
+    {
+    public:
+        // Returns true when this key was seen before; decoder_name is
+        // then set to the recorded verdict.
+        bool find(const bstr &key, std::string &decoder_name) const;
+        void store(const bstr &key, const std::string &decoder_name);
+
+    private:
+        mutable std::mutex mutex;
+        std::map<bstr, std::string> verdicts;
+    };
+
+} }
@@ -16,6 +16,8 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "flow/task_scheduler.h"
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <deque>
 #include <thread>
@@ -25,10 +27,56 @@
 using namespace au;
 using namespace au::flow;
 
+// Index of the worker the current thread runs as, or -1 outside of workers,
+// together with the scheduler the index belongs to.
+static thread_local int worker_index = -1;
+static thread_local const void *worker_scheduler = nullptr;
+
+namespace
+{
+    struct Entry final
+    {
+        std::shared_ptr<ITask> task;
+        u64 weight;
+    };
+
+    // Tasks spawned by a worker (nested entries) go to its own deque, so
+    // the shared queue and its lock stop being a contention point; idle
+    // workers steal from the opposite end of their victims' deques.
+    struct Worker final
+    {
+        std::deque<Entry> tasks;
+        std::mutex mutex;
+    };
+
+    // Written by one worker, read concurrently by get_worker_utilization.
+    struct WorkerCounters final
+    {
+        std::atomic<u64> busy_nanoseconds {0};
+        std::atomic<u64> lock_wait_nanoseconds {0};
+        std::atomic<u64> idle_nanoseconds {0};
+        std::atomic<u64> executed_task_count {0};
+    };
+}
+
+static u64 nanoseconds_since(
+    const std::chrono::steady_clock::time_point &start)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
 struct TaskScheduler::Priv final
 {
-    std::deque<std::shared_ptr<ITask>> tasks;
+    std::deque<Entry> global_tasks;
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::unique_ptr<WorkerCounters>> counters;
     std::vector<std::unique_ptr<std::thread>> threads;
+    std::atomic<int> pending_task_count{0};
+    std::atomic<size_t> total_task_count{0};
+    std::atomic<size_t> finished_task_count{0};
+    std::atomic<int> success_count{0};
+    std::atomic<int> error_count{0};
 };
 
 TaskScheduler::TaskScheduler() : p(new Priv())
@@ -41,14 +89,72 @@ TaskScheduler::~TaskScheduler()
 
 void TaskScheduler::push_front(std::shared_ptr<ITask> task)
 {
+    p->pending_task_count++;
+    p->total_task_count++;
+    if (worker_scheduler == p.get()
+        && worker_index >= 0
+        && worker_index < static_cast<int>(p->workers.size()))
+    {
+        auto &worker = *p->workers[worker_index];
+        std::unique_lock<std::mutex> lock(worker.mutex);
+        worker.tasks.push_front({std::move(task), 0});
+        return;
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    p->global_tasks.push_front({std::move(task), 0});
+}
+
+void TaskScheduler::push_back(std::shared_ptr<ITask> task, const u64 weight)
+{
+    p->pending_task_count++;
+    p->total_task_count++;
+    if (worker_scheduler == p.get()
+        && worker_index >= 0
+        && worker_index < static_cast<int>(p->workers.size()))
+    {
+        auto &worker = *p->workers[worker_index];
+        std::unique_lock<std::mutex> lock(worker.mutex);
+        worker.tasks.push_back({std::move(task), weight});
+        return;
+    }
     std::unique_lock<std::mutex> lock(mutex);
-    p->tasks.push_front(task);
+    auto it = p->global_tasks.begin();
+    while (it != p->global_tasks.end() && it->weight >= weight)
+        ++it;
+    p->global_tasks.insert(it, {std::move(task), weight});
 }
 
-void TaskScheduler::push_back(std::shared_ptr<ITask> task)
+TaskSchedulerStats TaskScheduler::get_stats() const
 {
+    return {
+        p->total_task_count,
+        p->finished_task_count,
+        static_cast<size_t>(std::max(0, p->pending_task_count.load())),
+    };
+}
+
+std::vector<WorkerUtilization> TaskScheduler::get_worker_utilization() const
+{
+    std::vector<WorkerUtilization> result;
     std::unique_lock<std::mutex> lock(mutex);
-    p->tasks.push_back(task);
+    for (const auto &counters : p->counters)
+    {
+        WorkerUtilization utilization;
+        utilization.busy_nanoseconds = counters->busy_nanoseconds;
+        utilization.lock_wait_nanoseconds = counters->lock_wait_nanoseconds;
+        utilization.idle_nanoseconds = counters->idle_nanoseconds;
+        utilization.executed_task_count = counters->executed_task_count;
+        result.push_back(utilization);
+    }
+    return result;
+}
+
+void TaskScheduler::record_inline_task(const bool success)
+{
+    p->total_task_count++;
+    p->finished_task_count++;
+    p->success_count += success;
+    p->error_count += !success;
 }
 
 TaskSchedulerResult TaskScheduler::run(size_t number_of_threads)
@@ -61,47 +167,107 @@ TaskSchedulerResult TaskScheduler::run(size_t number_of_threads)
     TaskSchedulerResult result;
     result.success_count = 0;
     result.error_count = 0;
-    bool still_running = true;
+    p->success_count = 0;
+    p->error_count = 0;
+
+    {
+        // progress reporters may already be polling get_worker_utilization
+        std::unique_lock<std::mutex> lock(mutex);
+        p->counters.clear();
+        for (const auto i : algo::range(number_of_threads))
+            p->counters.push_back(std::make_unique<WorkerCounters>());
+    }
+    for (const auto i : algo::range(number_of_threads))
+        p->workers.push_back(std::make_unique<Worker>());
 
     for (const auto i : algo::range(number_of_threads))
     {
-        p->threads.push_back(std::make_unique<std::thread>([&]()
+        p->threads.push_back(std::make_unique<std::thread>([&, i]()
         {
+            worker_index = i;
+            worker_scheduler = p.get();
+            auto &own_worker = *p->workers[i];
+            auto &counters = *p->counters[i];
+            // two clock reads per lock acquisition are noise next to a
+            // decode task; an uncontended acquisition registering ~0
+            // wait is exactly the signal wanted
+            const auto timed_lock = [&counters](std::mutex &mutex)
+            {
+                const auto start = std::chrono::steady_clock::now();
+                std::unique_lock<std::mutex> lock(mutex);
+                counters.lock_wait_nanoseconds += nanoseconds_since(start);
+                return lock;
+            };
             while (true)
             {
                 std::shared_ptr<ITask> task;
 
                 {
-                    std::unique_lock<std::mutex> lock(mutex);
-                    if (p->tasks.empty())
+                    const auto lock = timed_lock(own_worker.mutex);
+                    if (!own_worker.tasks.empty())
                     {
-                        if (still_running && number_of_threads > 1)
-                        {
-                            lock.unlock();
-                            std::this_thread::sleep_for(
-                                std::chrono::milliseconds(10));
+                        task = std::move(own_worker.tasks.front().task);
+                        own_worker.tasks.pop_front();
+                    }
+                }
+
+                if (!task)
+                {
+                    const auto lock = timed_lock(mutex);
+                    if (!p->global_tasks.empty())
+                    {
+                        task = std::move(p->global_tasks.front().task);
+                        p->global_tasks.pop_front();
+                    }
+                }
+
+                if (!task)
+                {
+                    for (const auto j : algo::range(p->workers.size()))
+                    {
+                        if (j == i)
                             continue;
+                        auto &victim = *p->workers[j];
+                        const auto lock = timed_lock(victim.mutex);
+                        if (!victim.tasks.empty())
+                        {
+                            task = std::move(victim.tasks.back().task);
+                            victim.tasks.pop_back();
+                            break;
                         }
-                        break;
                     }
-                    task = p->tasks.front();
-                    p->tasks.pop_front();
                 }
 
-                const auto local_success = task->work();
-
+                if (!task)
                 {
-                    std::unique_lock<std::mutex> lock(mutex);
-                    result.success_count += local_success;
-                    result.error_count += !local_success;
-                    still_running = !p->tasks.empty();
+                    if (!p->pending_task_count)
+                        break;
+                    const auto sleep_start = std::chrono::steady_clock::now();
+                    std::this_thread::sleep_for(
+                        std::chrono::milliseconds(10));
+                    counters.idle_nanoseconds
+                        += nanoseconds_since(sleep_start);
+                    continue;
                 }
+
+                const auto work_start = std::chrono::steady_clock::now();
+                const auto local_success = task->work();
+                counters.busy_nanoseconds += nanoseconds_since(work_start);
+                counters.executed_task_count++;
+                p->success_count += local_success;
+                p->error_count += !local_success;
+                p->finished_task_count++;
+                p->pending_task_count--;
             }
         }));
     }
 
     for (auto &t : p->threads)
         t->join();
+    p->threads.clear();
+    p->workers.clear();
 
+    result.success_count = p->success_count;
+    result.error_count = p->error_count;
     return result;
 }
@@ -19,6 +19,8 @@
 
 #include <memory>
 #include <mutex>
+#include <vector>
+#include "types.h"
 
 namespace au {
 namespace flow {
@@ -36,16 +38,63 @@ namespace flow {
         int error_count;
     };
 
+    // Aggregate progress counters, queryable while run() is in flight.
+    // The total grows as archives reveal their entries, so the ratio
+    // becomes meaningful once the entry tables have been read.
+    struct TaskSchedulerStats final
+    {
+        size_t total_task_count;
+        size_t finished_task_count;
+        size_t pending_task_count;
+    };
+
+    // Per-worker time accounting for a run: time spent inside tasks,
+    // time spent acquiring scheduler locks and time slept with nothing
+    // to do. The three do not add up to the wall time - dequeue
+    // bookkeeping between them is not attributed anywhere.
+    struct WorkerUtilization final
+    {
+        u64 busy_nanoseconds = 0;
+        u64 lock_wait_nanoseconds = 0;
+        u64 idle_nanoseconds = 0;
+        u64 executed_task_count = 0;
+    };
+
     class TaskScheduler final
     {
     public:
         TaskScheduler();
         ~TaskScheduler();
         TaskSchedulerResult run(const size_t number_of_threads = 0);
+
+        // Tasks pushed to the front run before everything else the worker
+        // has queued. Nested decoding relies on this LIFO discipline: the
+        // files of an inner archive are drained - and their intermediate
+        // buffers freed - before the worker returns to the archive's
+        // siblings, which keeps peak memory proportional to nesting depth
+        // rather than to archive width. Idle workers steal from the other
+        // end, picking up the shallowest queued work.
         void push_front(std::shared_ptr<ITask> task);
-        void push_back(std::shared_ptr<ITask> task);
+
+        // Tasks pushed to the back are kept ordered by descending weight,
+        // so the heaviest jobs (largest archives) start first and the
+        // critical path is not left for the tail of the run.
+        void push_back(std::shared_ptr<ITask> task, const u64 weight = 0);
+
+        // Records a task a worker executed inline without ever queueing
+        // it. Small nested units are cheaper to run as a continuation of
+        // their parent than to schedule, but they must still show up in
+        // the result and progress counts.
+        void record_inline_task(const bool success);
+
+        TaskSchedulerStats get_stats() const;
+
+        // One entry per worker of the current or last run; safe to query
+        // while run() is in flight.
+        std::vector<WorkerUtilization> get_worker_utilization() const;
+
         void join();
-        std::mutex mutex;
+        mutable std::mutex mutex;
     private:
         struct Priv;
         std::unique_ptr<Priv> p;
@@ -34,25 +34,31 @@ struct VirtualFileSystemBridge::Priv final
             base_name(base_name),
             decoder_refcount(decoder.shared_from_this())
     {
+        // one atomic publication for the whole archive, so sibling
+        // entries decoded in parallel either all find their companions
+        // or the archive is not visible yet - never a prefix
+        std::vector<VirtualFileSystem::RegisteredFile> files;
+        files.reserve(meta->entries.size());
         for (const auto &entry : meta->entries)
         {
-            VirtualFileSystem::register_file(
+            files.push_back({
                 get_target_name(entry->path),
                 [&logger, input_file, meta, &entry, &decoder]()
                 {
                     io::File file_copy(*input_file);
                     return decoder.read_file(logger, file_copy, *meta, *entry);
-                });
+                }});
         }
+        VirtualFileSystem::register_files(std::move(files));
     }
 
     ~Priv()
     {
+        std::vector<io::path> paths;
+        paths.reserve(meta->entries.size());
         for (const auto &entry : meta->entries)
-        {
-            VirtualFileSystem::unregister_file(
-                get_target_name(entry->path));
-        }
+            paths.push_back(get_target_name(entry->path));
+        VirtualFileSystem::unregister_files(paths);
     }
 
     io::path get_target_name(const io::path &input_path) const
@@ -16,23 +16,36 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "io/base_byte_stream.h"
+#include <cstring>
 #include "algo/endian.h"
 #include "algo/range.h"
 
 using namespace au;
 using namespace au::io;
 
+static const size_t scan_chunk_size = 4096;
+
 BaseByteStream::~BaseByteStream() {}
 
 bstr BaseByteStream::read_to_zero()
 {
+    // Scan whole chunks with memchr rather than pulling one byte per
+    // virtual read_impl call - metadata parsers call this thousands of
+    // times per archive.
     bstr output;
     while (left())
     {
-        const char c = read<u8>();
-        if (c == '\0')
+        const auto chunk = read(std::min<uoff_t>(scan_chunk_size, left()));
+        const auto found = std::memchr(chunk.get<char>(), '\0', chunk.size());
+        if (found)
+        {
+            const auto index
+                = reinterpret_cast<const u8*>(found) - chunk.get<const u8>();
+            output += chunk.substr(0, index);
+            skip(index + 1 - static_cast<soff_t>(chunk.size()));
             break;
-        output += c;
+        }
+        output += chunk;
     }
     return output;
 }
@@ -46,6 +59,31 @@ bstr BaseByteStream::read_to_zero(const size_t bytes)
     return output;
 }
 
+bool BaseByteStream::matches(const bstr &magic)
+{
+    if (magic.size() > left())
+        return false;
+    const auto start = pos();
+    u8 buffer[64];
+    auto magic_ptr = magic.get<const u8>();
+    auto bytes_left = magic.size();
+    while (bytes_left)
+    {
+        const auto chunk = std::min(bytes_left, sizeof(buffer));
+        if (StreamStats::enabled())
+            StreamStats::record_read(chunk);
+        read_impl(buffer, chunk);
+        if (std::memcmp(buffer, magic_ptr, chunk) != 0)
+        {
+            seek(start);
+            return false;
+        }
+        magic_ptr += chunk;
+        bytes_left -= chunk;
+    }
+    return true;
+}
+
 bstr BaseByteStream::read_to_eof()
 {
     return read(size() - pos());
@@ -53,15 +91,32 @@ bstr BaseByteStream::read_to_eof()
 
 bstr BaseByteStream::read_line()
 {
-    bstr output;
+    bstr raw;
     while (left())
     {
-        const auto c = read<u8>();
-        if (c == '\0' || c == '\n')
+        const auto chunk = read(std::min<uoff_t>(scan_chunk_size, left()));
+        const auto zero_pos = reinterpret_cast<const char*>(
+            std::memchr(chunk.get<char>(), '\0', chunk.size()));
+        const auto newline_pos = reinterpret_cast<const char*>(
+            std::memchr(chunk.get<char>(), '\n', chunk.size()));
+        auto found = zero_pos;
+        if (!found || (newline_pos && newline_pos < found))
+            found = newline_pos;
+        if (found)
+        {
+            const auto index
+                = reinterpret_cast<const u8*>(found) - chunk.get<const u8>();
+            raw += chunk.substr(0, index);
+            skip(index + 1 - static_cast<soff_t>(chunk.size()));
             break;
+        }
+        raw += chunk;
+    }
+    bstr output;
+    output.reserve(raw.size());
+    for (const auto c : raw)
         if (c != '\r')
             output += c;
-    }
     return output;
 }
 
@@ -73,12 +128,16 @@ BaseByteStream &BaseByteStream::write(io::BaseByteStream &other_stream)
 BaseByteStream &BaseByteStream::write(
     io::BaseByteStream &other_stream, const size_t size)
 {
-    const auto buffer_size = 16 * 1024;
+    // this path moves whole extracted files to disk, so it is worth
+    // copying in large chunks through one recycled buffer
+    const auto buffer_size = 256 * 1024;
+    bstr buffer;
     size_t left = size;
-    for (const auto i : algo::range(0, size, buffer_size))
+    while (left)
     {
         const auto bytes_to_transcribe = std::min<size_t>(buffer_size, left);
-        write(other_stream.read(bytes_to_transcribe));
+        other_stream.read_into(buffer, bytes_to_transcribe);
+        write(buffer);
         left -= bytes_to_transcribe;
     }
     return *this;
@@ -20,7 +20,9 @@
 #include <functional>
 #include <memory>
 #include "algo/endian.h"
+#include "algo/quota.h"
 #include "io/base_stream.h"
+#include "io/stream_stats.h"
 #include "types.h"
 
 namespace au {
@@ -40,6 +42,8 @@ namespace io {
 
         BaseByteStream &seek(const uoff_t offset) override
         {
+            if (StreamStats::enabled())
+                StreamStats::record_seek();
             seek_impl(offset);
             return *this;
         }
@@ -59,16 +63,61 @@ namespace io {
         {
             if (!bytes)
                 return ""_b;
+            if (algo::DecodeQuota::deadline_enabled())
+                algo::DecodeQuota::checkpoint();
+            if (StreamStats::enabled())
+                StreamStats::record_read(bytes);
             bstr ret(bytes);
             read_impl(&ret[0], bytes);
             return ret;
         }
 
+        // Reads into a caller-provided buffer, avoiding any allocation.
+        BaseByteStream &read(void *destination, const size_t bytes)
+        {
+            if (bytes)
+            {
+                if (algo::DecodeQuota::deadline_enabled())
+                    algo::DecodeQuota::checkpoint();
+                if (StreamStats::enabled())
+                    StreamStats::record_read(bytes);
+                read_impl(destination, bytes);
+            }
+            return *this;
+        }
+
+        // Tells whether the next bytes equal the given magic without ever
+        // throwing on short input, so that format guessing can probe
+        // hundreds of decoders against arbitrary files with exceptions
+        // reserved for actual I/O failures. On a match the magic is
+        // consumed; otherwise the position is left unchanged.
+        bool matches(const bstr &magic);
+
+        // Reads into a reusable buffer so that hot loops can recycle one
+        // allocation across iterations.
+        BaseByteStream &read_into(bstr &destination, const size_t bytes)
+        {
+            destination.resize(bytes);
+            if (bytes)
+            {
+                if (algo::DecodeQuota::deadline_enabled())
+                    algo::DecodeQuota::checkpoint();
+                if (StreamStats::enabled())
+                    StreamStats::record_read(bytes);
+                read_impl(&destination[0], bytes);
+            }
+            return *this;
+        }
+
         template<typename T> T read()
         {
             static_assert(
                 sizeof(T) == 1,
                 "For multiple bytes, must specify endianness");
+            if (algo::DecodeQuota::deadline_enabled())
+                algo::DecodeQuota::checkpoint();
+            if (StreamStats::enabled())
+                StreamStats::record_read(sizeof(T));
             T x;
             read_impl(&x, sizeof(x));
             return x;
@@ -79,6 +128,10 @@ namespace io {
             static_assert(
                 sizeof(T) > 1,
                 "Endianness does not make sense for single bytes");
+            if (algo::DecodeQuota::deadline_enabled())
+                algo::DecodeQuota::checkpoint();
+            if (StreamStats::enabled())
+                StreamStats::record_read(sizeof(T));
             T x;
             read_impl(&x, sizeof(x));
             return algo::from_little_endian(x);
@@ -89,6 +142,10 @@ namespace io {
             static_assert(
                 sizeof(T) > 1,
                 "Endianness does not make sense for single bytes");
+            if (algo::DecodeQuota::deadline_enabled())
+                algo::DecodeQuota::checkpoint();
+            if (StreamStats::enabled())
+                StreamStats::record_read(sizeof(T));
             T x;
             read_impl(&x, sizeof(x));
             return algo::from_big_endian(x);
@@ -98,6 +155,8 @@ namespace io {
         {
             if (!bytes.size())
                 return *this;
+            if (StreamStats::enabled())
+                StreamStats::record_write(bytes.size());
             write_impl(bytes.get<char>(), bytes.size());
             return *this;
         }
@@ -125,6 +184,8 @@ namespace io {
             static_assert(
                 sizeof(T) == 1,
                 "For multiple bytes, must specify endianness");
+            if (StreamStats::enabled())
+                StreamStats::record_write(sizeof(T));
             write_impl(&x, sizeof(T));
             return *this;
         }
@@ -134,6 +195,8 @@ namespace io {
             static_assert(
                 sizeof(T) > 1,
                 "Endianness does not make sense for single bytes");
+            if (StreamStats::enabled())
+                StreamStats::record_write(sizeof(T));
             const auto y = algo::to_little_endian(x);
             write_impl(&y, sizeof(T));
             return *this;
@@ -144,6 +207,8 @@ namespace io {
             static_assert(
                 sizeof(T) > 1,
                 "Endianness does not make sense for single bytes");
+            if (StreamStats::enabled())
+                StreamStats::record_write(sizeof(T));
             const auto y = algo::to_big_endian(x);
             write_impl(&y, sizeof(T));
             return *this;
@@ -0,0 +1,120 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "io/block_transform_byte_stream.h"
+#include <algorithm>
+#include <cstring>
+#include "err.h"
+
+using namespace au;
+using namespace au::io;
+
+BlockTransformByteStream::BlockTransformByteStream(
+    BaseByteStream &parent_stream,
+    const size_t block_size,
+    const Transform transform) :
+        parent_stream(parent_stream.clone()),
+        block_size(block_size),
+        transform(transform),
+        cache_start(0)
+{
+}
+
+BlockTransformByteStream::~BlockTransformByteStream()
+{
+}
+
+void BlockTransformByteStream::seek_impl(const uoff_t offset)
+{
+    parent_stream->seek(offset);
+}
+
+void BlockTransformByteStream::read_impl(
+    void *destination, const size_t size)
+{
+    if (!transform)
+    {
+        const auto chunk = parent_stream->read(size);
+        std::memcpy(destination, chunk.get<u8>(), size);
+        return;
+    }
+
+    const auto orig_pos = parent_stream->pos();
+
+    if (!cache.empty()
+        && orig_pos >= cache_start
+        && orig_pos + size <= cache_start + cache.size())
+    {
+        std::memcpy(
+            destination,
+            cache.get<const u8>() + (orig_pos - cache_start),
+            size);
+        parent_stream->seek(orig_pos + size);
+        return;
+    }
+
+    const auto offset_pad = orig_pos % block_size;
+    const auto padded_pos = orig_pos - offset_pad;
+    parent_stream->seek(padded_pos);
+
+    bstr buffer;
+    buffer.reserve(offset_pad + size);
+    while (buffer.size() < size + offset_pad)
+    {
+        if (!parent_stream->left())
+            throw err::BadDataSizeError();
+        const auto block_num = parent_stream->pos() / block_size;
+        auto block = parent_stream->read(
+            std::min<uoff_t>(parent_stream->left(), block_size));
+        transform(block_num, block);
+        buffer += block;
+    }
+
+    cache = std::move(buffer);
+    cache_start = padded_pos;
+    std::memcpy(destination, cache.get<const u8>() + offset_pad, size);
+    parent_stream->seek(orig_pos + size);
+}
+
+void BlockTransformByteStream::write_impl(
+    const void *source, const size_t size)
+{
+    throw err::NotSupportedError("Not implemented");
+}
+
+uoff_t BlockTransformByteStream::pos() const
+{
+    return parent_stream->pos();
+}
+
+uoff_t BlockTransformByteStream::size() const
+{
+    return parent_stream->size();
+}
+
+void BlockTransformByteStream::resize_impl(const uoff_t new_size)
+{
+    parent_stream->resize(new_size);
+}
+
+std::unique_ptr<io::BaseByteStream> BlockTransformByteStream::clone() const
+{
+    auto ret = std::make_unique<BlockTransformByteStream>(
+        *parent_stream, block_size, transform);
+    ret->seek(pos());
+    return std::move(ret);
+}
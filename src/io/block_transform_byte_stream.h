@@ -0,0 +1,65 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include "io/base_byte_stream.h"
+
+namespace au {
+namespace io {
+
+    // Decorator for formats that encrypt a stream in fixed-size aligned
+    // blocks. Reads pull whole blocks from the parent stream, run the
+    // supplied transform over each block in one pass and serve the request
+    // from the decoded span, which is kept around so that byte-grained
+    // reads do not re-run the cipher on blocks they already crossed.
+    class BlockTransformByteStream : public BaseByteStream
+    {
+    public:
+        // Decrypts one block in place; the block number counts from the
+        // start of the parent stream. An empty transform makes the stream
+        // a plain passthrough.
+        using Transform
+            = std::function<void(const uoff_t block_num, bstr &block)>;
+
+        BlockTransformByteStream(
+            BaseByteStream &parent_stream,
+            const size_t block_size,
+            const Transform transform);
+        virtual ~BlockTransformByteStream();
+
+        uoff_t size() const override;
+        uoff_t pos() const override;
+        std::unique_ptr<BaseByteStream> clone() const override;
+
+    protected:
+        void read_impl(void *destination, const size_t size) override;
+        void write_impl(const void *source, const size_t size) override;
+        void seek_impl(const uoff_t offset) override;
+        void resize_impl(const uoff_t new_size) override;
+
+    private:
+        std::unique_ptr<BaseByteStream> parent_stream;
+        const size_t block_size;
+        const Transform transform;
+        bstr cache;
+        uoff_t cache_start;
+    };
+
+} }
@@ -0,0 +1,124 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "io/buffered_byte_stream.h"
+#include <algorithm>
+#include <cstring>
+#include "err.h"
+
+using namespace au;
+using namespace au::io;
+
+struct BufferedByteStream::Priv final
+{
+    Priv(std::unique_ptr<BaseByteStream> parent_stream,
+        const size_t chunk_size)
+        : parent_stream(std::move(parent_stream)),
+        chunk_size(chunk_size),
+        chunk_start(0),
+        stream_pos(0)
+    {
+    }
+
+    // Refills the chunk cache with the aligned chunk containing offset.
+    void refill(const uoff_t offset)
+    {
+        chunk_start = offset - (offset % chunk_size);
+        const auto parent_size = parent_stream->size();
+        const auto size = std::min<uoff_t>(
+            chunk_size, parent_size - chunk_start);
+        parent_stream->seek(chunk_start).read_into(chunk, size);
+    }
+
+    std::unique_ptr<BaseByteStream> parent_stream;
+    size_t chunk_size;
+    bstr chunk;
+    uoff_t chunk_start;
+    uoff_t stream_pos;
+};
+
+BufferedByteStream::BufferedByteStream(
+    std::unique_ptr<BaseByteStream> parent_stream, const size_t chunk_size)
+    : p(new Priv(std::move(parent_stream), chunk_size))
+{
+}
+
+BufferedByteStream::~BufferedByteStream()
+{
+}
+
+void BufferedByteStream::seek_impl(const uoff_t offset)
+{
+    if (offset > p->parent_stream->size())
+        throw err::EofError();
+    p->stream_pos = offset;
+}
+
+void BufferedByteStream::read_impl(void *destination, const size_t size)
+{
+    // destination MUST exist and size MUST be at least 1
+    if (p->stream_pos + size > p->parent_stream->size())
+        throw err::EofError();
+    auto destination_ptr = reinterpret_cast<u8*>(destination);
+    auto left = size;
+    while (left)
+    {
+        if (p->stream_pos < p->chunk_start
+            || p->stream_pos >= p->chunk_start + p->chunk.size())
+        {
+            p->refill(p->stream_pos);
+        }
+        const auto chunk_offset = p->stream_pos - p->chunk_start;
+        const auto chunk_left = p->chunk.size() - chunk_offset;
+        const auto run = std::min<size_t>(left, chunk_left);
+        std::memcpy(
+            destination_ptr, p->chunk.get<const u8>() + chunk_offset, run);
+        destination_ptr += run;
+        p->stream_pos += run;
+        left -= run;
+    }
+}
+
+void BufferedByteStream::write_impl(const void *source, const size_t size)
+{
+    throw err::NotSupportedError("Buffered streams are read-only");
+}
+
+uoff_t BufferedByteStream::pos() const
+{
+    return p->stream_pos;
+}
+
+uoff_t BufferedByteStream::size() const
+{
+    return p->parent_stream->size();
+}
+
+void BufferedByteStream::resize_impl(const uoff_t new_size)
+{
+    if (new_size == p->parent_stream->size())
+        return;
+    throw err::NotSupportedError("Buffered streams are read-only");
+}
+
+std::unique_ptr<io::BaseByteStream> BufferedByteStream::clone() const
+{
+    auto ret = std::make_unique<BufferedByteStream>(
+        p->parent_stream->clone(), p->chunk_size);
+    ret->seek(pos());
+    return std::move(ret);
+}
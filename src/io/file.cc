@@ -17,8 +17,10 @@
 
 #include "io/file.h"
 #include <string>
+#include "err.h"
 #include "io/file_byte_stream.h"
 #include "io/memory_byte_stream.h"
+#include "io/mmap_byte_stream.h"
 
 using namespace au;
 using namespace au::io;
@@ -36,7 +38,7 @@ static const std::vector<std::pair<bstr, std::string>> magic_definitions
     {"\x00\x00\x00\x14""ftypisom"_b, "mp4"},
 };
 
-File::File(File &other_file) :
+File::File(const File &other_file) :
     stream_holder(other_file.stream.clone()),
     stream(*stream_holder),
     path(other_file.path)
@@ -50,8 +52,32 @@ File::File(const io::path &path, std::unique_ptr<BaseByteStream> stream) :
 {
 }
 
+static std::unique_ptr<BaseByteStream> open_stream(
+    const io::path &path, const FileMode mode)
+{
+    // Files opened for reading are served through a memory mapping when the
+    // platform allows it, which turns reads into plain memory accesses and
+    // makes clone() cheap; writing and exotic file systems fall back to the
+    // classic stdio-based stream.
+    if (mode == FileMode::Read)
+    {
+        try
+        {
+            return std::make_unique<MmapByteStream>(path);
+        }
+        catch (const err::FileNotFoundError &)
+        {
+            throw;
+        }
+        catch (const err::IoError &)
+        {
+        }
+    }
+    return std::make_unique<FileByteStream>(path, mode);
+}
+
 File::File(const io::path &path, const FileMode mode) :
-    File(path, std::make_unique<FileByteStream>(path, mode))
+    File(path, open_stream(path, mode))
 {
 }
 
@@ -26,7 +26,11 @@ namespace io {
     class File final
     {
     public:
-        File(File &other_file);
+        // Copies are shared views, not duplicates: the new stream is a
+        // clone of the original, which shares the memory mapping, file
+        // descriptor or refcounted buffer underneath and only carries its
+        // own cursor. Parallel workers rely on this being cheap.
+        File(const File &other_file);
         File(const io::path &path, std::unique_ptr<io::BaseByteStream> stream);
         File(const io::path &path, const io::FileMode mode);
         File(const io::path &path, const bstr &data);
@@ -17,6 +17,7 @@
 
 #include "io/file_byte_stream.h"
 #include <cstdio>
+#include <mutex>
 #include "algo/locale.h"
 #include "err.h"
 
@@ -25,11 +26,18 @@
     #include <io.h>
     #include <sys/stat.h>
     #include <sys/types.h>
+#else
+    #include <fcntl.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
 #endif
 
 using namespace au;
 using namespace au::io;
 
+// The handle is shared between clones; each stream keeps its own logical
+// position and addresses the file by absolute offset, so a thousand clones
+// over one archive cost a single open descriptor.
 struct FileByteStream::Priv final
 {
     #if _WIN32
@@ -51,71 +59,116 @@ struct FileByteStream::Priv final
             _close(fd);
         }
 
-        uoff_t tell()
-        {
-            return _telli64(fd);
-        }
-
-        void seek(const uoff_t offset, const int whence)
+        uoff_t size()
         {
-            _lseeki64(fd, offset, whence);
+            return _filelengthi64(fd);
         }
 
-        void read(void *source, const size_t size)
+        void read_at(const uoff_t offset, void *destination, const size_t size)
         {
-            const size_t ret = _read(fd, source, size);
+            // no pread here, so the seek and the transfer on the shared
+            // descriptor form one critical section - otherwise clones
+            // used from different threads race on the file pointer
+            std::unique_lock<std::mutex> lock(io_mutex);
+            _lseeki64(fd, offset, SEEK_SET);
+            const size_t ret = _read(fd, destination, size);
             if (ret != size)
                 throw err::EofError();
         }
 
-        void write(const void *destination, const size_t size)
+        void write_at(
+            const uoff_t offset, const void *source, const size_t size)
         {
-            const size_t ret = _write(fd, destination, size);
+            std::unique_lock<std::mutex> lock(io_mutex);
+            _lseeki64(fd, offset, SEEK_SET);
+            const size_t ret = _write(fd, source, size);
             if (ret != size)
                 throw err::IoError("Could not write full data");
         }
 
+        void reserve(const uoff_t size, const bool sparse)
+        {
+            _chsize_s(fd, size);
+        }
+
         int fd;
+        std::mutex io_mutex;
     #else
         Priv(const path &path, FileMode mode) : path(path), mode(mode)
         {
-            fd = std::fopen(
+            fd = open(
                 path.c_str(),
-                mode == FileMode::Write ? "w+b" : "rb");
-            if (!fd)
+                mode == FileMode::Write
+                    ? (O_RDWR | O_CREAT | O_TRUNC)
+                    : O_RDONLY,
+                0666);
+            if (fd == -1)
                 throw err::FileNotFoundError("Could not open " + path.str());
         }
 
         ~Priv()
         {
-            fclose(fd);
+            close(fd);
         }
 
-        uoff_t tell()
+        uoff_t size()
         {
-            return ftello(fd);
+            struct stat st;
+            if (fstat(fd, &st) == -1)
+                throw err::IoError("Could not stat " + path.str());
+            return st.st_size;
         }
 
-        void seek(const uoff_t offset, const int whence)
+        void read_at(const uoff_t offset, void *destination, const size_t size)
         {
-            const auto ret = fseeko(fd, offset, whence);
-            if (ret != 0)
-                throw err::EofError();
+            // pread keeps the shared descriptor stateless, so clones can be
+            // used from different threads without racing on a file pointer
+            auto destination_ptr = reinterpret_cast<u8*>(destination);
+            size_t done = 0;
+            while (done < size)
+            {
+                const auto ret = pread(
+                    fd, destination_ptr + done, size - done, offset + done);
+                if (ret <= 0)
+                    throw err::EofError();
+                done += ret;
+            }
         }
 
-        void read(void *source, const size_t size)
+        void write_at(
+            const uoff_t offset, const void *source, const size_t size)
         {
-            if (fread(source, 1, size, fd) != size)
-                throw err::EofError();
+            auto source_ptr = reinterpret_cast<const u8*>(source);
+            size_t done = 0;
+            while (done < size)
+            {
+                const auto ret = pwrite(
+                    fd, source_ptr + done, size - done, offset + done);
+                if (ret <= 0)
+                    throw err::IoError("Could not write full data");
+                done += ret;
+            }
         }
 
-        void write(const void *destination, const size_t size)
+        void reserve(const uoff_t size, const bool sparse)
         {
-            if (fwrite(destination, 1, size, fd) != size)
-                throw err::IoError("Could not write full data");
+            // fallocate reserves real extents; filesystems that lack it get
+            // a plain size update, which still spares the per-write size
+            // bumps. Sparse files only want the size update, as reserved
+            // extents would occupy the very space the holes are meant to
+            // save.
+            #if defined(__linux__)
+                if (!sparse && fallocate(fd, 0, 0, size) == 0)
+                    return;
+            #endif
+            if (ftruncate(fd, size) == -1)
+            {
+                // preallocation is purely an optimization; writes carry
+                // their own error handling
+            }
         }
 
-        FILE *fd;
+        int fd;
     #endif
 
     io::path path;
@@ -123,7 +176,12 @@ struct FileByteStream::Priv final
 };
 
 FileByteStream::FileByteStream(const path &path, const FileMode mode)
-    : p(new Priv(path, mode))
+    : p(std::make_shared<Priv>(path, mode)), stream_pos(0)
+{
+}
+
+FileByteStream::FileByteStream(const std::shared_ptr<Priv> p)
+    : p(p), stream_pos(0)
 {
 }
 
@@ -135,33 +193,38 @@ void FileByteStream::seek_impl(const uoff_t offset)
 {
     if (offset > size())
         throw err::EofError();
-    p->seek(offset, SEEK_SET);
+    stream_pos = offset;
 }
 
 void FileByteStream::read_impl(void *destination, const size_t size)
 {
     // destination MUST exist and size MUST be at least 1
-    p->read(destination, size);
+    p->read_at(stream_pos, destination, size);
+    stream_pos += size;
+}
+
+FileByteStream &FileByteStream::reserve(const uoff_t size, const bool sparse)
+{
+    if (p->mode == FileMode::Write && size > p->size())
+        p->reserve(size, sparse);
+    return *this;
 }
 
 void FileByteStream::write_impl(const void *source, const size_t size)
 {
     // source MUST exist and size MUST be at least 1
-    p->write(source, size);
+    p->write_at(stream_pos, source, size);
+    stream_pos += size;
 }
 
 uoff_t FileByteStream::pos() const
 {
-    return p->tell();
+    return stream_pos;
 }
 
 uoff_t FileByteStream::size() const
 {
-    const auto old_pos = p->tell();
-    p->seek(0, SEEK_END);
-    const auto size = p->tell();
-    p->seek(old_pos, SEEK_SET);
-    return size;
+    return p->size();
 }
 
 void FileByteStream::resize_impl(const uoff_t new_size)
@@ -173,7 +236,7 @@ void FileByteStream::resize_impl(const uoff_t new_size)
 
 std::unique_ptr<io::BaseByteStream> FileByteStream::clone() const
 {
-    auto ret = std::make_unique<FileByteStream>(p->path, p->mode);
+    auto ret = std::unique_ptr<FileByteStream>(new FileByteStream(p));
     ret->seek(pos());
     return std::move(ret);
 }
@@ -37,6 +37,14 @@ namespace io {
         FileByteStream(const path &path, const FileMode mode);
         ~FileByteStream();
 
+        // Tells the filesystem the final file size ahead of the writes, so
+        // that extents are allocated in one go and sequential writes stop
+        // extending the file one chunk at a time. With sparse set, only the
+        // size is established and no extents are reserved, so regions the
+        // caller seeks over remain holes. Best effort: filesystems without
+        // preallocation support are left alone.
+        FileByteStream &reserve(const uoff_t size, const bool sparse = false);
+
         uoff_t size() const override;
         uoff_t pos() const override;
 
@@ -50,7 +58,10 @@ namespace io {
 
     private:
         struct Priv;
-        std::unique_ptr<Priv> p;
+        FileByteStream(const std::shared_ptr<Priv> p);
+
+        std::shared_ptr<Priv> p;
+        uoff_t stream_pos;
     };
 
 } }
@@ -36,11 +36,21 @@ bool io::is_directory(const path &p)
     return boost::filesystem::is_directory(p.str());
 }
 
+u64 io::last_write_time(const path &p)
+{
+    return boost::filesystem::last_write_time(p.str());
+}
+
 path io::current_working_directory()
 {
     return boost::filesystem::current_path().string();
 }
 
+uoff_t io::file_size(const path &p)
+{
+    return boost::filesystem::file_size(p.str());
+}
+
 path io::absolute(const path &p)
 {
     return boost::filesystem::absolute(p.str()).string();
@@ -53,6 +63,11 @@ void io::create_directories(const path &p)
         boost::filesystem::create_directories(bp);
 }
 
+void io::create_hard_link(const path &existing_path, const path &link_path)
+{
+    boost::filesystem::create_hard_link(existing_path.str(), link_path.str());
+}
+
 void io::remove(const path &p)
 {
     boost::filesystem::remove(p.str());
@@ -19,6 +19,7 @@
 
 #include <boost/filesystem.hpp>
 #include "io/path.h"
+#include "types.h"
 
 namespace au {
 namespace io {
@@ -27,9 +28,12 @@ namespace io {
     bool exists(const path &p);
     bool is_directory(const path &p);
     bool is_regular_file(const path &p);
+    uoff_t file_size(const path &p);
+    u64 last_write_time(const path &p);
     path absolute(const path &p);
 
     void create_directories(const path &p);
+    void create_hard_link(const path &existing_path, const path &link_path);
     void remove(const path &p);
 
     template<typename T> class BaseDirectoryRange final
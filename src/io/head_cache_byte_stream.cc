@@ -0,0 +1,119 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "io/head_cache_byte_stream.h"
+#include <algorithm>
+#include <cstring>
+#include "err.h"
+
+using namespace au;
+using namespace au::io;
+
+struct HeadCacheByteStream::Priv final
+{
+    Priv(std::unique_ptr<BaseByteStream> parent_stream,
+        const std::shared_ptr<const bstr> head)
+        : parent_stream(std::move(parent_stream)),
+        head(head),
+        stream_pos(0)
+    {
+    }
+
+    std::unique_ptr<BaseByteStream> parent_stream;
+    std::shared_ptr<const bstr> head;
+    uoff_t stream_pos;
+};
+
+HeadCacheByteStream::HeadCacheByteStream(
+    std::unique_ptr<BaseByteStream> parent_stream, const size_t head_size)
+{
+    auto head = std::make_shared<bstr>();
+    parent_stream->seek(0).read_into(
+        *head, std::min<uoff_t>(head_size, parent_stream->size()));
+    p = std::make_unique<Priv>(std::move(parent_stream), std::move(head));
+}
+
+HeadCacheByteStream::HeadCacheByteStream(std::unique_ptr<Priv> priv)
+    : p(std::move(priv))
+{
+}
+
+HeadCacheByteStream::~HeadCacheByteStream()
+{
+}
+
+void HeadCacheByteStream::seek_impl(const uoff_t offset)
+{
+    if (offset > p->parent_stream->size())
+        throw err::EofError();
+    p->stream_pos = offset;
+}
+
+void HeadCacheByteStream::read_impl(void *destination, const size_t size)
+{
+    // destination MUST exist and size MUST be at least 1
+    if (p->stream_pos + size > p->parent_stream->size())
+        throw err::EofError();
+    auto destination_ptr = reinterpret_cast<u8*>(destination);
+    auto left = size;
+    const auto &head = *p->head;
+    if (p->stream_pos < head.size())
+    {
+        const auto run = std::min<size_t>(left, head.size() - p->stream_pos);
+        std::memcpy(
+            destination_ptr, head.get<const u8>() + p->stream_pos, run);
+        destination_ptr += run;
+        p->stream_pos += run;
+        left -= run;
+    }
+    if (left)
+    {
+        p->parent_stream->seek(p->stream_pos).read(destination_ptr, left);
+        p->stream_pos += left;
+    }
+}
+
+void HeadCacheByteStream::write_impl(const void *source, const size_t size)
+{
+    throw err::NotSupportedError("Head-cached streams are read-only");
+}
+
+uoff_t HeadCacheByteStream::pos() const
+{
+    return p->stream_pos;
+}
+
+uoff_t HeadCacheByteStream::size() const
+{
+    return p->parent_stream->size();
+}
+
+void HeadCacheByteStream::resize_impl(const uoff_t new_size)
+{
+    if (new_size == p->parent_stream->size())
+        return;
+    throw err::NotSupportedError("Head-cached streams are read-only");
+}
+
+std::unique_ptr<io::BaseByteStream> HeadCacheByteStream::clone() const
+{
+    auto priv = std::make_unique<Priv>(p->parent_stream->clone(), p->head);
+    std::unique_ptr<HeadCacheByteStream> ret(
+        new HeadCacheByteStream(std::move(priv)));
+    ret->seek(pos());
+    return std::move(ret);
+}
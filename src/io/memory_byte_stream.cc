@@ -17,6 +17,7 @@
 
 #include "io/memory_byte_stream.h"
 #include <cstring>
+#include "algo/copy_stats.h"
 #include "err.h"
 
 using namespace au;
@@ -32,8 +33,14 @@ MemoryByteStream::MemoryByteStream()
 {
 }
 
+static std::shared_ptr<bstr> copy_buffer(const bstr &buffer)
+{
+    algo::CopyStats::SiteScope site("io::MemoryByteStream(bstr)");
+    return std::make_shared<bstr>(buffer);
+}
+
 MemoryByteStream::MemoryByteStream(const bstr &buffer)
-    : MemoryByteStream(std::make_shared<bstr>(buffer))
+    : MemoryByteStream(copy_buffer(buffer))
 {
 }
 
@@ -45,21 +52,44 @@ MemoryByteStream::MemoryByteStream(const char *buffer, const size_t buffer_size)
 MemoryByteStream::MemoryByteStream(io::BaseByteStream &other, const size_t size)
     : MemoryByteStream(std::make_shared<bstr>(other.read(size)))
 {
+    // the slurp is a full copy of the source stream's bytes even though
+    // no bstr copy constructor runs (the temporary is moved in)
+    if (algo::CopyStats::enabled())
+        algo::CopyStats::record_copy("io::MemoryByteStream(stream)", size);
 }
 
 MemoryByteStream::MemoryByteStream(io::BaseByteStream &other)
     : MemoryByteStream(std::make_shared<bstr>(other.read_to_eof()))
 {
+    if (algo::CopyStats::enabled())
+        algo::CopyStats::record_copy("io::MemoryByteStream(stream)", size());
 }
 
 MemoryByteStream::~MemoryByteStream()
 {
 }
 
+std::shared_ptr<const bstr> MemoryByteStream::shared_buffer() const
+{
+    return buffer;
+}
+
+void MemoryByteStream::detach()
+{
+    if (buffer.use_count() > 1)
+    {
+        algo::CopyStats::SiteScope site("io::MemoryByteStream::detach");
+        buffer = std::make_shared<bstr>(*buffer);
+    }
+}
+
 io::BaseByteStream &MemoryByteStream::reserve(const uoff_t size)
 {
     if (buffer->size() < size)
+    {
+        detach();
         buffer->resize(size);
+    }
     return *this;
 }
 
@@ -84,6 +114,7 @@ void MemoryByteStream::read_impl(void *destination, const size_t size)
 void MemoryByteStream::write_impl(const void *source, size_t size)
 {
     // source MUST exist and size MUST be at least 1
+    detach();
     reserve(buffer_pos + size);
     auto source_ptr = reinterpret_cast<const u8*>(source);
     auto destination_ptr = buffer->get<u8>() + buffer_pos;
@@ -103,6 +134,7 @@ uoff_t MemoryByteStream::size() const
 
 void MemoryByteStream::resize_impl(const uoff_t new_size)
 {
+    detach();
     buffer->resize(new_size);
     if (buffer_pos > new_size)
         buffer_pos = new_size;
@@ -40,6 +40,10 @@ namespace io {
 
         BaseByteStream &reserve(const uoff_t count);
 
+        // Exposes the refcounted backing buffer so that views over this
+        // stream (clones, slices) can share it without copying.
+        std::shared_ptr<const bstr> shared_buffer() const;
+
         std::unique_ptr<BaseByteStream> clone() const override;
 
     protected:
@@ -51,6 +55,10 @@ namespace io {
     private:
         MemoryByteStream(const std::shared_ptr<bstr> buffer);
 
+        // Copy-on-write: clones and slices share the buffer until one of
+        // the owners mutates it.
+        void detach();
+
         std::shared_ptr<bstr> buffer;
         uoff_t buffer_pos;
     };
@@ -0,0 +1,186 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "io/mmap_byte_stream.h"
+#include <cstring>
+#include "err.h"
+
+#if _WIN32
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+using namespace au;
+using namespace au::io;
+
+struct MmapByteStream::Mapping final
+{
+    #if _WIN32
+        Mapping(const path &path) : path(path)
+        {
+            file_handle = CreateFileW(
+                path.wstr().c_str(),
+                GENERIC_READ,
+                FILE_SHARE_READ,
+                nullptr,
+                OPEN_EXISTING,
+                FILE_ATTRIBUTE_NORMAL,
+                nullptr);
+            if (file_handle == INVALID_HANDLE_VALUE)
+                throw err::FileNotFoundError("Could not open " + path.str());
+            LARGE_INTEGER file_size;
+            if (!GetFileSizeEx(file_handle, &file_size))
+            {
+                CloseHandle(file_handle);
+                throw err::IoError("Could not stat " + path.str());
+            }
+            data_size = file_size.QuadPart;
+            mapping_handle = nullptr;
+            data = nullptr;
+            if (!data_size)
+                return;
+            mapping_handle = CreateFileMappingW(
+                file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (!mapping_handle)
+            {
+                CloseHandle(file_handle);
+                throw err::IoError("Could not map " + path.str());
+            }
+            data = reinterpret_cast<const u8*>(
+                MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0));
+            if (!data)
+            {
+                CloseHandle(mapping_handle);
+                CloseHandle(file_handle);
+                throw err::IoError("Could not map " + path.str());
+            }
+        }
+
+        ~Mapping()
+        {
+            if (data)
+                UnmapViewOfFile(const_cast<u8*>(data));
+            if (mapping_handle)
+                CloseHandle(mapping_handle);
+            CloseHandle(file_handle);
+        }
+
+        HANDLE file_handle;
+        HANDLE mapping_handle;
+    #else
+        Mapping(const path &path) : path(path)
+        {
+            fd = open(path.c_str(), O_RDONLY);
+            if (fd == -1)
+                throw err::FileNotFoundError("Could not open " + path.str());
+            struct stat st;
+            if (fstat(fd, &st) == -1)
+            {
+                close(fd);
+                throw err::IoError("Could not stat " + path.str());
+            }
+            data_size = st.st_size;
+            data = nullptr;
+            if (!data_size)
+                return;
+            const auto ret = mmap(
+                nullptr, data_size, PROT_READ, MAP_SHARED, fd, 0);
+            if (ret == MAP_FAILED)
+            {
+                close(fd);
+                throw err::IoError("Could not map " + path.str());
+            }
+            data = reinterpret_cast<const u8*>(ret);
+        }
+
+        ~Mapping()
+        {
+            if (data)
+                munmap(const_cast<u8*>(data), data_size);
+            close(fd);
+        }
+
+        int fd;
+    #endif
+
+    io::path path;
+    const u8 *data;
+    uoff_t data_size;
+};
+
+MmapByteStream::MmapByteStream(const path &path)
+    : mapping(std::make_shared<Mapping>(path)), buffer_pos(0)
+{
+}
+
+MmapByteStream::MmapByteStream(const std::shared_ptr<Mapping> mapping)
+    : mapping(mapping), buffer_pos(0)
+{
+}
+
+MmapByteStream::~MmapByteStream()
+{
+}
+
+void MmapByteStream::seek_impl(const uoff_t offset)
+{
+    if (offset > mapping->data_size)
+        throw err::EofError();
+    buffer_pos = offset;
+}
+
+void MmapByteStream::read_impl(void *destination, const size_t size)
+{
+    // destination MUST exist and size MUST be at least 1
+    if (buffer_pos + size > mapping->data_size)
+        throw err::EofError();
+    std::memcpy(destination, mapping->data + buffer_pos, size);
+    buffer_pos += size;
+}
+
+void MmapByteStream::write_impl(const void *source, const size_t size)
+{
+    throw err::NotSupportedError("Memory mapped files are read-only");
+}
+
+uoff_t MmapByteStream::pos() const
+{
+    return buffer_pos;
+}
+
+uoff_t MmapByteStream::size() const
+{
+    return mapping->data_size;
+}
+
+void MmapByteStream::resize_impl(const uoff_t new_size)
+{
+    if (new_size == mapping->data_size)
+        return;
+    throw err::NotSupportedError("Memory mapped files are read-only");
+}
+
+std::unique_ptr<io::BaseByteStream> MmapByteStream::clone() const
+{
+    auto ret = std::unique_ptr<MmapByteStream>(new MmapByteStream(mapping));
+    ret->seek(pos());
+    return std::move(ret);
+}
@@ -16,6 +16,9 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "io/msb_bit_stream.h"
+#include <algorithm>
+#include "algo/range.h"
+#include "err.h"
 
 using namespace au;
 using namespace au::io;
@@ -46,6 +49,22 @@ void MsbBitStream::flush()
 
 u32 MsbBitStream::read(const size_t bits)
 {
+    if (own_stream_holder && bits_available < bits)
+    {
+        // Owned streams have no outside observers of the read position, so
+        // the 64-bit cache can be topped up with several bytes at once
+        // rather than one virtual read per byte.
+        const auto bytes_left = input_stream->size() - input_stream->pos();
+        const auto bytes_wanted = std::min<uoff_t>(
+            (64 - bits_available) / 8, bytes_left);
+        if (bits_available + bytes_wanted * 8 < bits)
+            throw err::EofError();
+        u8 chunk[8];
+        input_stream->read(chunk, bytes_wanted);
+        for (const auto i : algo::range(bytes_wanted))
+            buffer = (buffer << 8) | chunk[i];
+        bits_available += bytes_wanted * 8;
+    }
     while (bits_available < bits)
     {
         const auto tmp = input_stream->read<u8>();
@@ -16,15 +16,21 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "io/path.h"
+#include <algorithm>
 #include <boost/algorithm/string.hpp>
 #include <boost/filesystem/path.hpp>
 
 using namespace au;
 using namespace au::io;
 
-static std::string fix_slashes(const std::string &input)
+static void fix_slashes(std::string &input)
 {
-    return boost::algorithm::replace_all_copy(input, "\\", "/");
+    // boost::filesystem::path used to treat the string as NUL-terminated
+    // and decoders rely on that to trim zero-padded name fields
+    const auto zero_pos = input.find('\0');
+    if (zero_pos != std::string::npos)
+        input.resize(zero_pos);
+    std::replace(input.begin(), input.end(), '\\', '/');
 }
 
 static std::string normalize_extension(const std::string &extension)
@@ -37,16 +43,23 @@ static std::string normalize_extension(const std::string &extension)
     return output;
 }
 
-path::path() : p("")
+path::path()
 {
 }
 
-path::path(const char *s) : p(fix_slashes(s))
+path::path(const char *s) : p(s)
 {
+    fix_slashes(p);
 }
 
-path::path(const std::string &s) : p(fix_slashes(s))
+path::path(const std::string &s) : p(s)
 {
+    fix_slashes(p);
+}
+
+path::path(std::string &&s) : p(std::move(s))
+{
+    fix_slashes(p);
 }
 
 const char *path::c_str() const
@@ -56,7 +69,8 @@ const char *path::c_str() const
 
 std::string path::str() const
 {
-    return boost::filesystem::path(p).string();
+    // the stored string is already normalized to forward slashes
+    return p;
 }
 
 std::wstring path::wstr() const
@@ -97,50 +111,73 @@ path path::make_relative(const path &other_path) const
 
 path path::parent() const
 {
-    return boost::filesystem::path(p).parent_path().string();
+    const auto pos = p.find_last_of('/');
+    if (pos == std::string::npos)
+        return path();
+    if (pos == 0)
+        return path(p.size() == 1 ? "" : "/");
+    path ret;
+    ret.p = p.substr(0, pos);
+    return ret;
 }
 
 std::string path::name() const
 {
-    const auto ret = boost::filesystem::path(p).filename().string();
-    if (ret == "." || ret == ".." || ret == "/")
+    const auto pos = p.find_last_of('/');
+    auto ret = pos == std::string::npos ? p : p.substr(pos + 1);
+    if (ret == "." || ret == "..")
         return "";
     return ret;
 }
 
 std::string path::stem() const
 {
-    const auto ret = boost::filesystem::path(p).stem().string();
-    if (ret == "." || ret == ".." || ret == "/")
-        return "";
-    return ret;
+    const auto n = name();
+    const auto dot_pos = n.find_last_of('.');
+    if (dot_pos == std::string::npos)
+        return n;
+    return n.substr(0, dot_pos);
 }
 
 std::string path::extension() const
 {
-    return normalize_extension(boost::filesystem::path(p).extension().string());
+    const auto n = name();
+    const auto dot_pos = n.find_last_of('.');
+    if (dot_pos == std::string::npos)
+        return "";
+    return normalize_extension(n.substr(dot_pos));
 }
 
 bool path::operator ==(const path &other) const
 {
-    return boost::filesystem::path(p) == boost::filesystem::path(other.p);
+    // both sides are slash-normalized at construction time
+    return p == other.p;
 }
 
 bool path::operator <(const path &other) const
 {
-    return boost::filesystem::path(p) < boost::filesystem::path(other.p);
+    return p < other.p;
 }
 
 path path::operator /(const path &other) const
 {
-    const boost::filesystem::path p1(p);
-    const boost::filesystem::path p2(other.p);
-    return path((p1 / p2).string());
+    path ret(*this);
+    ret /= other;
+    return ret;
 }
 
 void path::operator /=(const path &other)
 {
-    p = (*this / other).p;
+    if (p.empty())
+    {
+        p = other.p;
+        return;
+    }
+    if (other.p.empty())
+        return;
+    if (p.back() != '/' && other.p.front() != '/')
+        p += '/';
+    p += other.p;
 }
 
 bool path::is_absolute() const
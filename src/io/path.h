@@ -28,6 +28,7 @@ namespace io {
         path();
         path(const char *s);
         path(const std::string &s);
+        path(std::string &&s);
 
         const char *c_str() const;
         std::string str() const;
@@ -17,10 +17,37 @@
 
 #include "io/slice_byte_stream.h"
 #include <cstring>
+#include "io/memory_byte_stream.h"
 
 using namespace au;
 using namespace au::io;
 
+std::shared_ptr<const bstr> SliceByteStream::resolve_buffer(
+    const io::BaseByteStream &parent_stream)
+{
+    const auto memory_parent
+        = dynamic_cast<const MemoryByteStream*>(&parent_stream);
+    if (memory_parent)
+        return memory_parent->shared_buffer();
+    const auto slice_parent
+        = dynamic_cast<const SliceByteStream*>(&parent_stream);
+    if (slice_parent)
+        return slice_parent->source_buffer;
+    return nullptr;
+}
+
+uoff_t SliceByteStream::resolve_offset(
+    const io::BaseByteStream &parent_stream, const uoff_t offset)
+{
+    // Nested slices over memory flatten to a single view over the shared
+    // buffer rather than stacking virtual calls and copies.
+    const auto slice_parent
+        = dynamic_cast<const SliceByteStream*>(&parent_stream);
+    if (slice_parent && slice_parent->source_buffer)
+        return offset + slice_parent->slice_offset;
+    return offset;
+}
+
 SliceByteStream::SliceByteStream(
     io::BaseByteStream &parent_stream, const uoff_t slice_offset)
         : SliceByteStream(
@@ -32,12 +59,26 @@ SliceByteStream::SliceByteStream(
     io::BaseByteStream &parent_stream,
     const uoff_t slice_offset,
     const uoff_t slice_size) :
-        parent_stream(parent_stream.clone()),
-        slice_offset(slice_offset),
+        source_buffer(resolve_buffer(parent_stream)),
+        buffer_pos(0),
+        slice_offset(resolve_offset(parent_stream, slice_offset)),
         slice_size(slice_size)
 {
     if (slice_size > parent_stream.size() - slice_offset)
         throw err::BadDataSizeError();
+    if (!source_buffer)
+        this->parent_stream = parent_stream.clone();
+}
+
+SliceByteStream::SliceByteStream(
+    const std::shared_ptr<const bstr> source_buffer,
+    const uoff_t slice_offset,
+    const uoff_t slice_size) :
+        source_buffer(source_buffer),
+        buffer_pos(0),
+        slice_offset(slice_offset),
+        slice_size(slice_size)
+{
 }
 
 SliceByteStream::~SliceByteStream()
@@ -46,13 +87,33 @@ SliceByteStream::~SliceByteStream()
 
 void SliceByteStream::seek_impl(const uoff_t offset)
 {
+    if (source_buffer)
+    {
+        if (offset > slice_size)
+            throw err::EofError();
+        buffer_pos = offset;
+        return;
+    }
     parent_stream->seek(slice_offset + offset);
 }
 
 void SliceByteStream::read_impl(void *destination, const size_t size)
 {
-    const auto chunk = parent_stream->read(size);
-    std::memcpy(destination, chunk.get<u8>(), size);
+    if (source_buffer)
+    {
+        if (buffer_pos + size > slice_size
+            || slice_offset + buffer_pos + size > source_buffer->size())
+        {
+            throw err::EofError();
+        }
+        std::memcpy(
+            destination,
+            source_buffer->get<const u8>() + slice_offset + buffer_pos,
+            size);
+        buffer_pos += size;
+        return;
+    }
+    parent_stream->read(destination, size);
 }
 
 void SliceByteStream::write_impl(const void *source, const size_t size)
@@ -62,6 +123,8 @@ void SliceByteStream::write_impl(const void *source, const size_t size)
 
 uoff_t SliceByteStream::pos() const
 {
+    if (source_buffer)
+        return buffer_pos;
     return parent_stream->pos() - slice_offset;
 }
 
@@ -77,6 +140,13 @@ void SliceByteStream::resize_impl(const uoff_t new_size)
 
 std::unique_ptr<io::BaseByteStream> SliceByteStream::clone() const
 {
+    if (source_buffer)
+    {
+        auto ret = std::unique_ptr<SliceByteStream>(new SliceByteStream(
+            source_buffer, slice_offset, slice_size));
+        ret->seek(pos());
+        return std::move(ret);
+    }
     auto ret = std::make_unique<SliceByteStream>(
         *parent_stream, slice_offset, slice_size);
     ret->seek(pos());
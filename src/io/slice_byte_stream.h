@@ -45,7 +45,24 @@ namespace io {
         void resize_impl(const uoff_t new_size) override;
 
     private:
+        SliceByteStream(
+            const std::shared_ptr<const bstr> source_buffer,
+            const uoff_t offset,
+            const uoff_t size);
+
+        static std::shared_ptr<const bstr> resolve_buffer(
+            const io::BaseByteStream &parent_stream);
+        static uoff_t resolve_offset(
+            const io::BaseByteStream &parent_stream, const uoff_t offset);
+
+        // Used when the parent stream is not backed by memory.
         std::unique_ptr<io::BaseByteStream> parent_stream;
+
+        // Used when the slice resolves to a raw range of a shared in-memory
+        // buffer - slicing and nested slicing are then zero-copy views.
+        std::shared_ptr<const bstr> source_buffer;
+        uoff_t buffer_pos;
+
         const uoff_t slice_offset;
         const uoff_t slice_size;
     };
@@ -0,0 +1,202 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "io/stream_stats.h"
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "algo/format.h"
+
+using namespace au;
+using namespace au::io;
+
+namespace
+{
+    struct AtomicEntry final
+    {
+        std::atomic<u64> read_count {0};
+        std::atomic<u64> read_bytes {0};
+        std::atomic<u64> write_count {0};
+        std::atomic<u64> write_bytes {0};
+        std::atomic<u64> seek_count {0};
+        std::atomic<u64> read_size_buckets[stream_stats_bucket_count] {};
+    };
+}
+
+std::atomic<bool> StreamStats::active(false);
+
+// entries are never erased, so the thread-local pointers below stay
+// valid for the lifetime of the process
+static std::mutex entries_mutex;
+static std::map<std::string, std::unique_ptr<AtomicEntry>> &get_entries()
+{
+    static std::map<std::string, std::unique_ptr<AtomicEntry>> entries;
+    return entries;
+}
+
+static thread_local AtomicEntry *current_entry = nullptr;
+static thread_local std::string current_label;
+
+static AtomicEntry &resolve(const std::string &label)
+{
+    std::unique_lock<std::mutex> lock(entries_mutex);
+    auto &entries = get_entries();
+    auto it = entries.find(label);
+    if (it == entries.end())
+        it = entries.emplace(label, std::make_unique<AtomicEntry>()).first;
+    return *it->second;
+}
+
+static AtomicEntry &current()
+{
+    if (!current_entry)
+        current_entry = &resolve(current_label);
+    return *current_entry;
+}
+
+static size_t bucket_for(const size_t size)
+{
+    size_t bucket = 0;
+    while ((static_cast<size_t>(1) << bucket) < size
+        && bucket < stream_stats_bucket_count - 1)
+    {
+        bucket++;
+    }
+    return bucket;
+}
+
+void StreamStats::enable()
+{
+    active.store(true);
+}
+
+void StreamStats::disable()
+{
+    active.store(false);
+}
+
+void StreamStats::set_label(const std::string &label)
+{
+    current_label = label;
+    current_entry = &resolve(label);
+}
+
+std::string StreamStats::get_label()
+{
+    return current_label;
+}
+
+void StreamStats::record_read(const size_t size)
+{
+    auto &entry = current();
+    entry.read_count.fetch_add(1, std::memory_order_relaxed);
+    entry.read_bytes.fetch_add(size, std::memory_order_relaxed);
+    entry.read_size_buckets[bucket_for(size)].fetch_add(
+        1, std::memory_order_relaxed);
+}
+
+void StreamStats::record_write(const size_t size)
+{
+    auto &entry = current();
+    entry.write_count.fetch_add(1, std::memory_order_relaxed);
+    entry.write_bytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+void StreamStats::record_seek()
+{
+    current().seek_count.fetch_add(1, std::memory_order_relaxed);
+}
+
+StreamStatsEntry StreamStats::get(const std::string &label)
+{
+    const auto &entry = resolve(label);
+    StreamStatsEntry result;
+    result.read_count = entry.read_count.load();
+    result.read_bytes = entry.read_bytes.load();
+    result.write_count = entry.write_count.load();
+    result.write_bytes = entry.write_bytes.load();
+    result.seek_count = entry.seek_count.load();
+    for (size_t i = 0; i < stream_stats_bucket_count; i++)
+        result.read_size_buckets[i] = entry.read_size_buckets[i].load();
+    return result;
+}
+
+void StreamStats::dump(const Logger &logger)
+{
+    std::vector<std::pair<std::string, StreamStatsEntry>> rows;
+    {
+        std::unique_lock<std::mutex> lock(entries_mutex);
+        for (const auto &kv : get_entries())
+            rows.push_back({kv.first, {}});
+    }
+    for (auto &row : rows)
+        row.second = get(row.first);
+    std::sort(
+        rows.begin(),
+        rows.end(),
+        [](const decltype(rows)::value_type &a,
+            const decltype(rows)::value_type &b)
+        {
+            return a.second.read_bytes > b.second.read_bytes;
+        });
+
+    logger.info("I/O counters (sorted by bytes read):\n");
+    logger.info("     reads      read MB     writes   write MB      "
+        "seeks  label\n");
+    for (const auto &row : rows)
+    {
+        logger.info(
+            "%10llu %12.1f %10llu %10.1f %10llu  %s\n",
+            static_cast<unsigned long long>(row.second.read_count),
+            row.second.read_bytes / (1024.0 * 1024.0),
+            static_cast<unsigned long long>(row.second.write_count),
+            row.second.write_bytes / (1024.0 * 1024.0),
+            static_cast<unsigned long long>(row.second.seek_count),
+            row.first.empty() ? "(unlabeled)" : row.first.c_str());
+
+        std::string histogram;
+        for (size_t i = 0; i < stream_stats_bucket_count; i++)
+        {
+            if (!row.second.read_size_buckets[i])
+                continue;
+            histogram += algo::format(
+                " <=%llu:%llu",
+                1ull << i,
+                static_cast<unsigned long long>(
+                    row.second.read_size_buckets[i]));
+        }
+        if (!histogram.empty())
+            logger.info("    read sizes:%s\n", histogram.c_str());
+    }
+}
+
+void StreamStats::reset()
+{
+    std::unique_lock<std::mutex> lock(entries_mutex);
+    for (const auto &kv : get_entries())
+    {
+        kv.second->read_count = 0;
+        kv.second->read_bytes = 0;
+        kv.second->write_count = 0;
+        kv.second->write_bytes = 0;
+        kv.second->seek_count = 0;
+        for (size_t i = 0; i < stream_stats_bucket_count; i++)
+            kv.second->read_size_buckets[i] = 0;
+    }
+}
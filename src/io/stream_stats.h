@@ -0,0 +1,78 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <atomic>
+#include <string>
+#include "logger.h"
+#include "types.h"
+
+namespace au {
+namespace io {
+
+    // bucket i counts reads of at most 2^i bytes
+    static const size_t stream_stats_bucket_count = 32;
+
+    struct StreamStatsEntry final
+    {
+        u64 read_count = 0;
+        u64 read_bytes = 0;
+        u64 write_count = 0;
+        u64 write_bytes = 0;
+        u64 seek_count = 0;
+        u64 read_size_buckets[stream_stats_bucket_count] = {};
+    };
+
+    // Global I/O counters fed by every byte stream, keyed by a
+    // thread-local label (the decoder working on the current thread).
+    // Off by default; when disabled, the streams pay a single relaxed
+    // load per operation and nothing else.
+    class StreamStats final
+    {
+    public:
+        static void enable();
+        static void disable();
+
+        static bool enabled()
+        {
+            return active.load(std::memory_order_relaxed);
+        }
+
+        // Attributes subsequent operations on this thread to the given
+        // label; counters of unlabeled threads land under "".
+        static void set_label(const std::string &label);
+        static std::string get_label();
+
+        static void record_read(const size_t size);
+        static void record_write(const size_t size);
+        static void record_seek();
+
+        static StreamStatsEntry get(const std::string &label);
+
+        // Prints per-label totals and read size histograms, sorted by
+        // bytes read.
+        static void dump(const Logger &logger);
+
+        // Zeroes all counters; labels stay registered.
+        static void reset();
+
+    private:
+        static std::atomic<bool> active;
+    };
+
+} }
@@ -19,6 +19,8 @@
 #include <cstdarg>
 #include <iostream>
 #include <mutex>
+#include <utility>
+#include <vector>
 #include "algo/format.h"
 #include "algo/str.h"
 
@@ -30,12 +32,16 @@ struct Logger::Priv final
 {
     Priv(Logger &logger);
     void log(
-        const MessageType type, const std::string fmt, std::va_list args) const;
+        const MessageType type, const std::string fmt, std::va_list args);
+    void write(const MessageType type, const std::string &output) const;
+    void flush_buffer();
 
     Logger &logger;
     Color colors[6];
     int muted = 0;
     bool colors_enabled = true;
+    bool buffering = false;
+    std::vector<std::pair<MessageType, std::string>> buffer;
     std::string prefix;
 };
 
@@ -50,24 +56,74 @@ Logger::Priv::Priv(Logger &logger) : logger(logger)
 }
 
 void Logger::Priv::log(
-    const MessageType type, const std::string fmt, std::va_list args) const
+    const MessageType type, const std::string fmt, std::va_list args)
 {
-    std::unique_lock<std::mutex> lock(mutex);
     if (muted & (1 << type))
         return;
+    // formatting happens before any locking so that the critical section
+    // covers only the actual console writes
+    auto output = algo::format(fmt, args);
+    if (buffering)
+    {
+        buffer.push_back({type, std::move(output)});
+        return;
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    write(type, output);
+}
+
+void Logger::Priv::write(const MessageType type, const std::string &output)
+    const
+{
     auto *out = &std::cout;
     if (type == MessageType::Warning || type == MessageType::Error)
         out = &std::cerr;
-    const auto output = algo::format(fmt, args);
-    for (const auto line : algo::split(output, '\n', true))
+    const auto use_color = colors_enabled && colors[type] != Color::Original;
+
+    if (use_color && !logger.has_inline_colors())
     {
-        (*out) << prefix;
-        if (colors_enabled && colors[type] != Color::Original)
+        // the platform switches colors with console API calls, so the
+        // stream writes must stay interleaved with them
+        for (const auto line : algo::split(output, '\n', true))
+        {
+            (*out) << prefix;
             logger.set_color(colors[type]);
-        (*out) << line;
-        if (colors_enabled && colors[type] != Color::Original)
+            (*out) << line;
             logger.set_color(Color::Original);
+        }
+        return;
+    }
+
+    // everything the message renders to - prefixes, color escapes and the
+    // text itself - lands in one buffer and one stream write
+    const auto stderr_stream = out == &std::cerr;
+    std::string assembled;
+    for (const auto line : algo::split(output, '\n', true))
+    {
+        assembled += prefix;
+        if (use_color)
+        {
+            assembled += logger.get_color_code(colors[type], stderr_stream);
+            assembled += line;
+            assembled += logger.get_color_code(
+                Color::Original, stderr_stream);
+        }
+        else
+        {
+            assembled += line;
+        }
     }
+    (*out) << assembled;
+}
+
+void Logger::Priv::flush_buffer()
+{
+    if (buffer.empty())
+        return;
+    std::unique_lock<std::mutex> lock(mutex);
+    for (const auto &entry : buffer)
+        write(entry.first, entry.second);
+    buffer.clear();
 }
 
 Logger::Logger(const Logger &other_logger) : p(new Priv(*this))
@@ -84,6 +140,7 @@ Logger::Logger() : p(new Priv(*this))
 
 Logger::~Logger()
 {
+    p->flush_buffer();
 }
 
 void Logger::set_prefix(const std::string &prefix)
@@ -142,6 +199,7 @@ void Logger::debug(const std::string fmt, ...) const
 
 void Logger::flush() const
 {
+    p->flush_buffer();
     std::cout.flush();
     // stderr should be nonbuffered
 }
@@ -180,3 +238,14 @@ void Logger::enable_colors()
 {
     p->colors_enabled = true;
 }
+
+void Logger::enable_buffering()
+{
+    p->buffering = true;
+}
+
+void Logger::disable_buffering()
+{
+    p->flush_buffer();
+    p->buffering = false;
+}
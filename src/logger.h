@@ -62,6 +62,17 @@ namespace au {
         ~Logger();
 
         void set_color(const Color c);
+
+        // Tells whether colors render through the output stream itself, so
+        // whole lines can be assembled into single writes; Win32 consoles
+        // change color with API calls between writes instead.
+        bool has_inline_colors() const;
+
+        // Returns the text embedded in the output to switch to the given
+        // color, or an empty string when the target is not a terminal.
+        // Meaningful only when has_inline_colors() returns true.
+        std::string get_color_code(
+            const Color c, const bool stderr_stream) const;
         void set_prefix(const std::string &prefix);
         void log(const MessageType type, const std::string fmt, ...) const;
         void info(const std::string str, ...) const;
@@ -80,6 +91,14 @@ namespace au {
         void disable_colors();
         void enable_colors();
 
+        // In buffered mode messages accumulate locally and hit the console
+        // only on flush() (or on destruction), so loggers owned by worker
+        // threads don't contend on the terminal lock for every line. The
+        // buffer is not synchronized - a buffered logger must stay confined
+        // to one thread at a time.
+        void enable_buffering();
+        void disable_buffering();
+
     private:
         struct Priv;
         std::unique_ptr<Priv> p;
@@ -45,10 +45,36 @@ static std::string get_ansi_color(const Logger::Color c)
     return "";
 }
 
+// isatty costs a syscall and the verdict is checked for every log line
+static bool stdout_gets_colors()
+{
+    static const bool ret = isatty(STDIN_FILENO);
+    return ret;
+}
+
+static bool stderr_gets_colors()
+{
+    static const bool ret = isatty(STDERR_FILENO);
+    return ret;
+}
+
 void Logger::set_color(const Logger::Color c)
 {
-    if (isatty(STDIN_FILENO))
+    if (stdout_gets_colors())
         std::cout << get_ansi_color(c);
-    if (isatty(STDERR_FILENO))
+    if (stderr_gets_colors())
         std::cerr << get_ansi_color(c);
 }
+
+bool Logger::has_inline_colors() const
+{
+    return true;
+}
+
+std::string Logger::get_color_code(
+    const Logger::Color c, const bool stderr_stream) const
+{
+    if (stderr_stream ? !stderr_gets_colors() : !stdout_gets_colors())
+        return "";
+    return get_ansi_color(c);
+}
@@ -22,3 +22,14 @@ using namespace au;
 void Logger::set_color(const Color c)
 {
 }
+
+bool Logger::has_inline_colors() const
+{
+    return true;
+}
+
+std::string Logger::get_color_code(
+    const Color c, const bool stderr_stream) const
+{
+    return "";
+}
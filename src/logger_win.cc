@@ -78,3 +78,14 @@ void Logger::set_color(const Logger::Color c)
     HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
     SetConsoleTextAttribute(hConsole, get_win_color(c));
 }
+
+bool Logger::has_inline_colors() const
+{
+    return false;
+}
+
+std::string Logger::get_color_code(
+    const Logger::Color c, const bool stderr_stream) const
+{
+    return "";
+}
@@ -15,6 +15,7 @@
 // You should have received a copy of the GNU General Public License
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
+#include "algo/startup_probe.h"
 #include "entry_point.h"
 #include "flow/cli_facade.h"
 #include "io/program_path.h"
@@ -23,6 +24,7 @@
 using namespace au;
 
 ENTRY_POINT(
+    algo::StartupProbe::mark_main_entry();
     Logger logger;
     try
     {
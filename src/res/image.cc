@@ -17,6 +17,8 @@
 
 #include "res/image.h"
 #include <algorithm>
+#include <cstring>
+#include "algo/copy_stats.h"
 #include "algo/format.h"
 #include "algo/range.h"
 #include "err.h"
@@ -28,6 +30,11 @@ static const Pixel transparent_pixel = {0, 0, 0, 0};
 
 Image::Image(const Image &other) : Grid(other)
 {
+    if (algo::CopyStats::enabled())
+    {
+        algo::CopyStats::record_copy(
+            "res::Image copy", content.size() * sizeof(Pixel));
+    }
 }
 
 Image::Image(const size_t width, const size_t height) : Grid(width, height)
@@ -45,6 +52,13 @@ Image::Image(
     if (!width || !height)
         throw err::BadDataSizeError();
     read_pixels(input.get<const u8>(), content, fmt);
+    // the conversion is a full pass over the image even though no bstr
+    // copy constructor runs
+    if (algo::CopyStats::enabled())
+    {
+        algo::CopyStats::record_copy(
+            "res::Image pixel conversion", content.size() * sizeof(Pixel));
+    }
 }
 
 Image::Image(
@@ -65,9 +79,34 @@ Image::Image(
     const size_t height,
     const bstr &input,
     const Palette &palette)
-        : Image(width, height, input, PixelFormat::Gray8)
+        : Image(width, height)
 {
-    apply_palette(palette);
+    if (input.size() < width * height)
+        throw err::BadDataSizeError();
+    if (!width || !height)
+        throw err::BadDataSizeError();
+
+    // single gather pass instead of expanding to grayscale first and
+    // rewriting every pixel through apply_palette
+    const auto palette_size = palette.size();
+    Pixel colors[256];
+    for (const auto i : algo::range(std::min<size_t>(palette_size, 256)))
+        colors[i] = palette[i];
+
+    const auto *input_ptr = input.get<const u8>();
+    for (const auto i : algo::range(content.size()))
+    {
+        const auto index = input_ptr[i];
+        if (index < palette_size)
+            content[i] = colors[index];
+        else
+            content[i] = {index, index, index, 0};
+    }
+    if (algo::CopyStats::enabled())
+    {
+        algo::CopyStats::record_copy(
+            "res::Image palette expansion", content.size() * sizeof(Pixel));
+    }
 }
 
 Image::Image(
@@ -75,31 +114,30 @@ Image::Image(
     const size_t height,
     io::BaseByteStream &input_stream,
     const Palette &palette)
-        : Image(width, height, input_stream, PixelFormat::Gray8)
+        : Image(width, height, input_stream.read(width * height), palette)
 {
-    apply_palette(palette);
 }
 
 Image &Image::invert()
 {
-    for (const auto y : algo::range(_height))
-    for (const auto x : algo::range(_width))
-    {
-        at(x, y).r ^= 0xFF;
-        at(x, y).g ^= 0xFF;
-        at(x, y).b ^= 0xFF;
-    }
+    // in the packed layout flipping the three color channels is a single
+    // word XOR; the alpha byte sits in the top lane and is left alone
+    for (auto &c : content)
+        write_packed(&c, read_packed(&c) ^ 0x00FF'FFFF);
     return *this;
 }
 
 Image &Image::flip_vertically()
 {
+    std::vector<Pixel> row_buffer(_width);
+    const auto row_size = _width * sizeof(Pixel);
     for (const auto y : algo::range(_height >> 1))
-    for (const auto x : algo::range(_width))
     {
-        const auto t = at(x, _height - 1 - y);
-        at(x, _height - 1 - y) = at(x, y);
-        at(x, y) = t;
+        auto *top_row = row(y);
+        auto *bottom_row = row(_height - 1 - y);
+        std::memcpy(row_buffer.data(), top_row, row_size);
+        std::memcpy(top_row, bottom_row, row_size);
+        std::memcpy(bottom_row, row_buffer.data(), row_size);
     }
     return *this;
 }
@@ -107,44 +145,114 @@ Image &Image::flip_vertically()
 Image &Image::flip_horizontally()
 {
     for (const auto y : algo::range(_height))
-    for (const auto x : algo::range(_width >> 1))
     {
-        const auto t = at(_width - 1 - x, y);
-        at(_width - 1 - x, y) = at(x, y);
-        at(x, y) = t;
+        auto *row_ptr = row(y);
+        std::reverse(row_ptr, row_ptr + _width);
     }
     return *this;
 }
 
 Image &Image::offset(const int x_offset, const int y_offset)
 {
-    res::Image old_image(*this);
-    crop(_width + x_offset, _height + y_offset);
-    for (auto &c : content)
-        c = transparent_pixel;
-    return overlay(old_image, x_offset, y_offset, OverlayKind::OverwriteAll);
+    // shift in place rather than going through a full temporary copy:
+    // leftward/upward moves happen before the crop (while the source
+    // columns and rows still exist), rightward/downward moves after it
+    // (once the destination exists); memmove covers the overlap
+    const int old_width = _width;
+    const int old_height = _height;
+
+    if (x_offset < 0 && -x_offset < old_width)
+    {
+        const auto shift = -x_offset;
+        for (const auto y : algo::range(old_height))
+        {
+            auto *row_ptr = row(y);
+            std::memmove(
+                row_ptr, row_ptr + shift, (old_width - shift) * sizeof(Pixel));
+        }
+    }
+    if (y_offset < 0 && -y_offset < old_height)
+    {
+        const auto shift = -y_offset;
+        for (const auto y : algo::range(old_height - shift))
+        {
+            std::memcpy(row(y), row(y + shift), old_width * sizeof(Pixel));
+        }
+    }
+
+    crop(old_width + x_offset, old_height + y_offset);
+
+    const int new_width = _width;
+    const int new_height = _height;
+    if (x_offset > 0)
+    {
+        const auto kept = std::max(new_width - x_offset, 0);
+        for (const auto y : algo::range(new_height))
+        {
+            auto *row_ptr = row(y);
+            std::memmove(row_ptr + x_offset, row_ptr, kept * sizeof(Pixel));
+            std::fill_n(
+                row_ptr, std::min(x_offset, new_width), transparent_pixel);
+        }
+    }
+    if (y_offset > 0)
+    {
+        const auto kept = std::max(new_height - y_offset, 0);
+        for (const auto i : algo::range(kept))
+        {
+            const auto y = kept - 1 - i;
+            std::memcpy(row(y + y_offset), row(y), new_width * sizeof(Pixel));
+        }
+        for (const auto y : algo::range(std::min(y_offset, new_height)))
+            std::fill_n(row(y), new_width, transparent_pixel);
+    }
+    return *this;
 }
 
 Image &Image::crop(const size_t new_width, const size_t new_height)
 {
-    std::vector<Pixel> old_content(content.begin(), content.end());
     if (!new_width || !new_height)
         throw err::BadDataSizeError();
     const auto old_width = _width;
     const auto old_height = _height;
-    _width = new_width;
-    _height = new_height;
-    content.resize(new_width * new_height);
-    for (const auto y : algo::range(std::min(old_height, new_height)))
-    for (const auto x : algo::range(std::min(old_width, new_width)))
+    const auto copy_width = std::min(old_width, new_width);
+    const auto copy_height = std::min(old_height, new_height);
+    const auto row_size = copy_width * sizeof(Pixel);
+
+    // rearrange the rows in place instead of copying the whole image:
+    // shrinking rows pack towards the front before the resize, growing
+    // rows spread from the back after it
+    if (new_width <= old_width)
     {
-        content[y * new_width + x] = old_content[y * old_width + x];
+        for (const auto y : algo::range(copy_height))
+        {
+            std::memmove(
+                content.data() + y * new_width,
+                content.data() + y * old_width,
+                row_size);
+        }
+        content.resize(new_width * new_height);
     }
-    for (const auto y : algo::range(old_height, new_height))
-    for (const auto x : algo::range(new_width))
+    else
+    {
+        content.resize(new_width * new_height);
+        for (const auto i : algo::range(copy_height))
+        {
+            const auto y = copy_height - 1 - i;
+            std::memmove(
+                content.data() + y * new_width,
+                content.data() + y * old_width,
+                row_size);
+        }
+    }
+    _width = new_width;
+    _height = new_height;
+
+    for (const auto y : algo::range(copy_height))
+    for (const auto x : algo::range(copy_width, new_width))
         content[y * new_width + x] = transparent_pixel;
-    for (const auto y : algo::range(old_height))
-    for (const auto x : algo::range(old_width, new_width))
+    for (const auto y : algo::range(copy_height, new_height))
+    for (const auto x : algo::range(new_width))
         content[y * new_width + x] = transparent_pixel;
     return *this;
 }
@@ -153,19 +261,30 @@ Image &Image::apply_mask(const Image &other)
 {
     if (other.width() != _width || other.height() != _height)
         throw std::logic_error("Mask image size is different from image size");
-    for (const auto y : algo::range(_height))
-    for (const auto x : algo::range(_width))
-        at(x, y).a = other.at(x, y).r;
+    // the mask's red channel shifts straight up into this image's alpha
+    // lane, two word ops per pixel instead of byte surgery
+    const auto *other_ptr = other.begin();
+    for (auto &c : content)
+    {
+        const auto alpha = (read_packed(other_ptr++) << 8) & 0xFF00'0000;
+        write_packed(&c, (read_packed(&c) & 0x00FF'FFFF) | alpha);
+    }
     return *this;
 }
 
 Image &Image::apply_palette(const Palette &palette)
 {
+    // the indices are u8, so copy the colors out of the palette's pimpl
+    // once and make the per-pixel lookup a plain array load
     const auto palette_size = palette.size();
+    Pixel colors[256];
+    for (const auto i : algo::range(std::min<size_t>(palette_size, 256)))
+        colors[i] = palette[i];
+
     for (auto &c : content)
     {
         if (c.r < palette_size)
-            c = palette[c.r];
+            c = colors[c.r];
         else
             c.a = 0;
     }
@@ -191,32 +310,48 @@ Image &Image::overlay(
     const int y2 = std::min<int>(height(), target_y + other.height());
     const int source_x = -target_x;
     const int source_y = -target_y;
+    if (x1 >= x2 || y1 >= y2)
+        return *this;
+
+    // blend row by row over raw pointers - compositing runs over the same
+    // pixels many times in animation archives, so the inner loops should
+    // be nothing but the blend itself
+    const auto span = x2 - x1;
     if (overlay_kind == OverlayKind::OverwriteAll)
     {
         for (const auto y : algo::range(y1, y2))
-        for (const auto x : algo::range(x1, x2))
-            at(x, y) = other.at(source_x + x, source_y + y);
+        {
+            std::memcpy(
+                row(y) + x1,
+                other.row(source_y + y) + source_x + x1,
+                span * sizeof(Pixel));
+        }
     }
     else if (overlay_kind == OverlayKind::OverwriteNonTransparent)
     {
         for (const auto y : algo::range(y1, y2))
-        for (const auto x : algo::range(x1, x2))
         {
-            const auto &source_pixel = other.at(source_x + x, source_y + y);
-            if (source_pixel.a)
-                at(x, y) = source_pixel;
+            auto *target_row = row(y) + x1;
+            const auto *source_row = other.row(source_y + y) + source_x + x1;
+            for (const auto i : algo::range(span))
+            {
+                if (source_row[i].a)
+                    target_row[i] = source_row[i];
+            }
         }
     }
     else if (overlay_kind == OverlayKind::AddSimple)
     {
         for (const auto y : algo::range(y1, y2))
-        for (const auto x : algo::range(x1, x2))
         {
-            auto &target_pixel = at(x, y);
-            const auto &source_pixel = other.at(source_x + x, source_y + y);
-            target_pixel.r += source_pixel.r;
-            target_pixel.g += source_pixel.g;
-            target_pixel.b += source_pixel.b;
+            auto *target_row = row(y) + x1;
+            const auto *source_row = other.row(source_y + y) + source_x + x1;
+            for (const auto i : algo::range(span))
+            {
+                target_row[i].r += source_row[i].r;
+                target_row[i].g += source_row[i].g;
+                target_row[i].b += source_row[i].b;
+            }
         }
     }
     else
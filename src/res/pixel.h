@@ -17,6 +17,8 @@
 
 #pragma once
 
+#include <cstring>
+#include "algo/endian.h"
 #include "types.h"
 
 namespace au {
@@ -47,4 +49,41 @@ namespace res {
         }
     };
 
+    // Bulk kernels may rely on the packed layout: a Pixel is exactly one
+    // 32-bit word holding 0xAARRGGBB (blue in bits 0-7, green in 8-15,
+    // red in 16-23, alpha in 24-31; the machine is little endian, which
+    // the tests verify). The accessors below are the sanctioned way to
+    // touch pixel memory a word or a block at a time - the memcpy
+    // compiles to plain word loads and stores, carries no alignment
+    // requirement and no aliasing UB, and gives the autovectorizer
+    // whole-register operations to chew on.
+    static_assert(sizeof(Pixel) == 4, "Pixel must pack into one u32");
+    static_assert(
+        algo::get_machine_endianness() == algo::Endianness::LittleEndian,
+        "packed pixel accessors assume a little endian machine");
+
+    inline u32 read_packed(const Pixel *src)
+    {
+        u32 value;
+        std::memcpy(&value, src, sizeof(value));
+        return value;
+    }
+
+    inline void write_packed(Pixel *dst, const u32 value)
+    {
+        std::memcpy(dst, &value, sizeof(value));
+    }
+
+    template<size_t N> inline void read_packed(
+        const Pixel *src, u32 (&block)[N])
+    {
+        std::memcpy(block, src, sizeof(block));
+    }
+
+    template<size_t N> inline void write_packed(
+        Pixel *dst, const u32 (&block)[N])
+    {
+        std::memcpy(dst, block, sizeof(block));
+    }
+
 } }
@@ -17,6 +17,7 @@
 
 #include "res/pixel_format.h"
 #include <cstring>
+#include <mutex>
 #include "algo/format.h"
 #include "algo/range.h"
 
@@ -255,19 +256,15 @@ namespace res {
         return c;
     }
 
-    void read_pixels(
-        const u8 *input_ptr, std::vector<Pixel> &output, const PixelFormat fmt)
+    static void read_pixels_generic(
+        const u8 *input_ptr,
+        Pixel *output_ptr,
+        const size_t count,
+        const PixelFormat fmt)
     {
-        // save those precious CPU cycles
-        if (fmt == PixelFormat::BGRA8888)
-        {
-            std::memcpy(output.data(), input_ptr, output.size() * 4);
-            return;
-        }
-
         // I don't think there is a better alternative to this
         using PF = PixelFormat;
-        std::function<void(const u8 *, std::vector<Pixel> &)> impl;
+        std::function<void(const u8 *, Pixel *, const size_t)> impl;
         switch (fmt)
         {
             case PF::Gray8:     impl = read_pixels<PF::Gray8>; break;
@@ -293,9 +290,123 @@ namespace res {
             case PF::RGBnA8888: impl = read_pixels<PF::RGBnA8888>; break;
             default:
                 throw std::logic_error(
-                    algo::format("Unsupported pixel format: %d", fmt));
+                    algo::format(
+                        "Unsupported pixel format: %d",
+                        static_cast<int>(fmt)));
+        }
+        impl(input_ptr, output_ptr, count);
+    }
+
+    // Every 16-bit format maps u16→Pixel, so a 64K-entry table built once
+    // per process replaces the per-pixel bit fiddling with a single load.
+    // The tables are filled through the generic path above, so they always
+    // agree with the per-pixel conversions.
+    static const Pixel *get_pixel_lut(const PixelFormat fmt)
+    {
+        static std::mutex mutex;
+        static std::unique_ptr<std::vector<Pixel>>
+            luts[static_cast<size_t>(PixelFormat::Count)];
+
+        const auto index = static_cast<size_t>(fmt);
+        std::unique_lock<std::mutex> lock(mutex);
+        if (!luts[index])
+        {
+            bstr input(0x10000 * 2);
+            for (const auto i : algo::range(0x10000))
+            {
+                input[i * 2] = i & 0xFF;
+                input[i * 2 + 1] = i >> 8;
+            }
+            auto lut = std::make_unique<std::vector<Pixel>>(0x10000);
+            read_pixels_generic(
+                input.get<const u8>(), lut->data(), lut->size(), fmt);
+            luts[index] = std::move(lut);
+        }
+        return luts[index]->data();
+    }
+
+    void read_pixels(
+        const u8 *input_ptr,
+        Pixel *output_ptr,
+        const size_t count,
+        const PixelFormat fmt)
+    {
+        // save those precious CPU cycles - the most common formats get
+        // batch loops over the whole buffer (plain index arithmetic, which
+        // the compiler is able to vectorize) rather than the generic
+        // advance-a-pointer-per-pixel path
+        auto *out = output_ptr;
+
+        if (fmt == PixelFormat::BGRA8888)
+        {
+            std::memcpy(out, input_ptr, count * 4);
+            return;
+        }
+
+        if (fmt == PixelFormat::BGR888X)
+        {
+            // the source alpha is ignored (OR-ed with 0xFF)
+            std::memcpy(out, input_ptr, count * 4);
+            for (const auto i : algo::range(count))
+                out[i].a = 0xFF;
+            return;
+        }
+
+        if (fmt == PixelFormat::BGRnA8888)
+        {
+            std::memcpy(out, input_ptr, count * 4);
+            for (const auto i : algo::range(count))
+                out[i].a ^= 0xFF;
+            return;
         }
-        impl(input_ptr, output);
+
+        if (fmt == PixelFormat::BGR888)
+        {
+            for (const auto i : algo::range(count))
+            {
+                out[i].b = input_ptr[i * 3];
+                out[i].g = input_ptr[i * 3 + 1];
+                out[i].r = input_ptr[i * 3 + 2];
+                out[i].a = 0xFF;
+            }
+            return;
+        }
+
+        if (fmt == PixelFormat::RGBA8888)
+        {
+            for (const auto i : algo::range(count))
+            {
+                out[i].r = input_ptr[i * 4];
+                out[i].g = input_ptr[i * 4 + 1];
+                out[i].b = input_ptr[i * 4 + 2];
+                out[i].a = input_ptr[i * 4 + 3];
+            }
+            return;
+        }
+
+        if (fmt == PixelFormat::Gray8)
+        {
+            for (const auto i : algo::range(count))
+            {
+                out[i].b = out[i].g = out[i].r = input_ptr[i];
+                out[i].a = 0xFF;
+            }
+            return;
+        }
+
+        if (pixel_format_to_bpp(fmt) == 2)
+        {
+            const auto *lut = get_pixel_lut(fmt);
+            for (const auto i : algo::range(count))
+            {
+                const u16 tmp
+                    = reinterpret_cast<const u16&>(input_ptr[i * 2]);
+                out[i] = lut[tmp];
+            }
+            return;
+        }
+
+        read_pixels_generic(input_ptr, output_ptr, count, fmt);
     }
 
 } }
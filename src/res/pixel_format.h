@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include <cstring>
 #include "io/base_byte_stream.h"
 #include "res/pixel.h"
 
@@ -84,17 +85,37 @@ namespace res {
     template<PixelFormat fmt> Pixel read_pixel(const u8 *&ptr);
 
     template<PixelFormat fmt> void read_pixels(
-        const u8 *input_ptr, std::vector<Pixel> &output)
+        const u8 *input_ptr, Pixel *output_ptr, const size_t count)
     {
-        for (auto &c : output)
-            c = read_pixel<fmt>(input_ptr);
+        for (auto *c = output_ptr; c < output_ptr + count; c++)
+            *c = read_pixel<fmt>(input_ptr);
+    }
+
+    // Pixel's memory layout is exactly the BGRA8888 wire format, so whole
+    // canvases in that format convert with one block copy.
+    template<> inline void read_pixels<PixelFormat::BGRA8888>(
+        const u8 *input_ptr, Pixel *output_ptr, const size_t count)
+    {
+        static_assert(sizeof(Pixel) == 4, "Unexpected pixel size");
+        std::memcpy(output_ptr, input_ptr, count * sizeof(Pixel));
     }
 
     void read_pixels(
         const u8 *input_ptr,
-        std::vector<Pixel> &output,
+        Pixel *output_ptr,
+        const size_t count,
         const PixelFormat fmt);
 
+    // canvases and palettes store their pixels in differently allocated
+    // vectors; the raw pointer core serves both
+    template<typename Alloc> inline void read_pixels(
+        const u8 *input_ptr,
+        std::vector<Pixel, Alloc> &output,
+        const PixelFormat fmt)
+    {
+        read_pixels(input_ptr, output.data(), output.size(), fmt);
+    }
+
     template<PixelFormat fmt> inline Pixel read_pixel(
         io::BaseByteStream &input_stream)
     {
@@ -17,29 +17,138 @@
 
 #include "types.h"
 #include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include "algo/alloc_stats.h"
+#include "algo/big_alloc.h"
+#include "algo/copy_stats.h"
 
 using namespace au;
 
 const size_t bstr::npos = static_cast<size_t>(-1);
 
-bstr::bstr()
+void bstr::grow(const size_t min_capacity)
 {
+    auto new_capacity = cap;
+    while (new_capacity < min_capacity)
+        new_capacity *= 2;
+    if (algo::AllocStats::enabled())
+    {
+        algo::AllocStats::record_alloc(new_capacity);
+        if (!is_inline())
+            algo::AllocStats::record_free(cap);
+    }
+    const auto new_data = algo::big_alloc(new_capacity);
+    std::memcpy(new_data, d, n);
+    if (!is_inline())
+        algo::big_free(d, cap);
+    d = new_data;
+    cap = new_capacity;
+}
+
+bstr::bstr() : d(inline_buffer), n(0), cap(inline_capacity)
+{
+}
+
+bstr::bstr(const size_t size, u8 fill) : bstr()
+{
+    if (size > cap)
+        grow(size);
+    std::memset(d, fill, size);
+    n = size;
+}
+
+bstr::bstr(const u8 *str, const size_t size) : bstr()
+{
+    if (size > cap)
+        grow(size);
+    std::memcpy(d, str, size);
+    n = size;
 }
 
-bstr::bstr(const size_t n, u8 fill) : v(n, fill)
+bstr::bstr(const char *str, const size_t size)
+    : bstr(reinterpret_cast<const u8*>(str), size)
 {
 }
 
-bstr::bstr(const u8 *str, const size_t size) : v(str, str + size)
+bstr::bstr(const std::string &other)
+    : bstr(reinterpret_cast<const u8*>(other.data()), other.size())
+{
+}
+
+bstr::bstr(const bstr &other) : bstr(other.d, other.n)
+{
+    if (algo::CopyStats::enabled())
+        algo::CopyStats::record_copy(n);
+}
+
+bstr::bstr(bstr &&other) noexcept
+    : d(inline_buffer), n(other.n), cap(inline_capacity)
+{
+    if (other.is_inline())
+    {
+        std::memcpy(inline_buffer, other.inline_buffer, other.n);
+    }
+    else
+    {
+        d = other.d;
+        cap = other.cap;
+        other.d = other.inline_buffer;
+        other.cap = inline_capacity;
+    }
+    other.n = 0;
+}
+
+bstr::~bstr()
 {
+    if (!is_inline())
+    {
+        if (algo::AllocStats::enabled())
+            algo::AllocStats::record_free(cap);
+        algo::big_free(d, cap);
+    }
 }
 
-bstr::bstr(const char *str, const size_t size) : v(str, str + size)
+bstr &bstr::operator =(const bstr &other)
 {
+    if (this == &other)
+        return *this;
+    n = 0;
+    if (other.n > cap)
+        grow(other.n);
+    std::memcpy(d, other.d, other.n);
+    n = other.n;
+    if (algo::CopyStats::enabled())
+        algo::CopyStats::record_copy(n);
+    return *this;
 }
 
-bstr::bstr(const std::string &other) : v(other.begin(), other.end())
+bstr &bstr::operator =(bstr &&other) noexcept
 {
+    if (this == &other)
+        return *this;
+    if (!is_inline())
+    {
+        if (algo::AllocStats::enabled())
+            algo::AllocStats::record_free(cap);
+        algo::big_free(d, cap);
+    }
+    if (other.is_inline())
+    {
+        d = inline_buffer;
+        cap = inline_capacity;
+        std::memcpy(inline_buffer, other.inline_buffer, other.n);
+    }
+    else
+    {
+        d = other.d;
+        cap = other.cap;
+        other.d = other.inline_buffer;
+        other.cap = inline_capacity;
+    }
+    n = other.n;
+    other.n = 0;
+    return *this;
 }
 
 const char *bstr::c_str() const
@@ -51,45 +160,44 @@ std::string bstr::str(bool trim_to_zero) const
 {
     if (trim_to_zero)
     {
-        const auto pos = std::find(v.begin(), v.end(), '\0');
-        return std::string(c_str(), pos != v.end() ? pos - v.begin() : size());
+        const auto pos = std::find(d, d + n, '\0');
+        return std::string(c_str(), pos - d);
     }
     return std::string(c_str(), size());
 }
 
 bool bstr::empty() const
 {
-    return v.size() == 0;
+    return n == 0;
 }
 
 size_t bstr::size() const
 {
-    return v.size();
+    return n;
 }
 
 size_t bstr::capacity() const
 {
-    return v.capacity();
+    return cap;
 }
 
 size_t bstr::find(const bstr &other) const
 {
-    const auto pos = std::search(
-        v.begin(), v.end(),
-        other.get<u8>(), other.get<u8>() + other.size());
-    if (pos == v.end())
+    const auto pos = std::search(d, d + n, other.d, other.d + other.n);
+    if (pos == d + n)
         return bstr::npos;
-    return pos - v.begin();
+    return pos - d;
 }
 
 size_t bstr::find(const bstr &other, const size_t start_pos) const
 {
+    if (start_pos > n)
+        return bstr::npos;
     const auto pos = std::search(
-        v.begin() + start_pos, v.end(),
-        other.get<u8>(), other.get<u8>() + other.size());
-    if (pos == v.end())
+        d + start_pos, d + n, other.d, other.d + other.n);
+    if (pos == d + n)
         return bstr::npos;
-    return pos - v.begin();
+    return pos - d;
 }
 
 bstr bstr::substr(int start) const
@@ -97,124 +205,144 @@ bstr bstr::substr(int start) const
     if (start > static_cast<int>(size()))
         return ""_b;
     while (start < 0)
-        start += v.size();
-    return bstr(get<const u8>() + start, size() - start);
+        start += n;
+    return bstr(d + start, n - start);
 }
 
 bstr bstr::substr(int start, int size) const
 {
-    if (start > static_cast<int>(v.size()))
+    if (start > static_cast<int>(n))
         return ""_b;
     while (size < 0)
-        size += v.size();
+        size += n;
     while (start < 0)
-        start += v.size();
-    if (start > static_cast<int>(v.size()))
+        start += n;
+    if (start > static_cast<int>(n))
         return ""_b;
-    if (start + size > static_cast<int>(v.size()))
-        return substr(start, v.size() - start);
-    return bstr(get<const u8>() + start, size);
+    if (start + size > static_cast<int>(n))
+        return substr(start, n - start);
+    return bstr(d + start, size);
 }
 
 void bstr::replace(int start, int size, const bstr &what)
 {
     while (size < 0)
-        size += v.size();
+        size += n;
     while (start < 0)
-        start += v.size();
-    if (start > static_cast<int>(v.size()))
+        start += n;
+    if (start > static_cast<int>(n))
     {
-        v.insert(v.end(), what.begin(), what.end());
+        *this += what;
         return;
     }
-    if (start + size > static_cast<int>(v.size()))
+    if (start + size > static_cast<int>(n))
     {
-        replace(start, v.size() - start, what);
+        replace(start, n - start, what);
         return;
     }
-    if (size > 0)
-        v.erase(v.begin() + start, v.begin() + start + size);
-    v.insert(v.begin() + start, what.begin(), what.end());
+    const auto tail_size = n - start - size;
+    const auto new_size = n - size + what.n;
+    if (new_size > cap)
+        grow(new_size);
+    std::memmove(d + start + what.n, d + start + size, tail_size);
+    std::memcpy(d + start, what.d, what.n);
+    n = new_size;
 }
 
 void bstr::resize(const size_t how_much)
 {
-    v.resize(how_much);
+    if (how_much > cap)
+        grow(how_much);
+    if (how_much > n)
+        std::memset(d + n, 0, how_much - n);
+    n = how_much;
 }
 
 void bstr::reserve(const size_t how_much)
 {
-    v.reserve(how_much);
+    if (how_much > cap)
+        grow(how_much);
 }
 
 bstr bstr::operator +(const bstr &other) const
 {
-    bstr ret(v.data(), size());
+    bstr ret(d, n);
     ret += other;
     return ret;
 }
 
 void bstr::operator +=(const bstr &other)
 {
-    v.insert(v.end(), other.get<u8>(), other.get<u8>() + other.size());
+    const auto other_size = other.n;
+    if (n + other_size > cap)
+        grow(n + other_size);
+    // after a potential reallocation, self-appends must read from d
+    std::memcpy(d + n, &other == this ? d : other.d, other_size);
+    n += other_size;
 }
 
 void bstr::operator +=(const char c)
 {
-    v.push_back(c);
+    *this += static_cast<u8>(c);
 }
 
 void bstr::operator +=(const u8 c)
 {
-    v.push_back(c);
+    if (n == cap)
+        grow(n + 1);
+    d[n++] = c;
 }
 
 bool bstr::operator ==(const bstr &other) const
 {
-    return v == other.v;
+    return n == other.n && !std::memcmp(d, other.d, n);
 }
 
 bool bstr::operator !=(const bstr &other) const
 {
-    return v != other.v;
+    return !(*this == other);
 }
 
-bool bstr::operator <=(const bstr &other) const
+bool bstr::operator <(const bstr &other) const
 {
-    return v <= other.v;
+    return std::lexicographical_compare(d, d + n, other.d, other.d + other.n);
 }
 
-bool bstr::operator >=(const bstr &other) const
+bool bstr::operator >(const bstr &other) const
 {
-    return v >= other.v;
+    return other < *this;
 }
 
-bool bstr::operator <(const bstr &other) const
+bool bstr::operator <=(const bstr &other) const
 {
-    return v < other.v;
+    return !(other < *this);
 }
 
-bool bstr::operator >(const bstr &other) const
+bool bstr::operator >=(const bstr &other) const
 {
-    return v > other.v;
+    return !(*this < other);
 }
 
 u8 &bstr::operator [](const size_t pos)
 {
-    return v[pos];
+    return d[pos];
 }
 
 const u8 &bstr::operator [](const size_t pos) const
 {
-    return v[pos];
+    return d[pos];
 }
 
 u8 &bstr::at(const size_t pos)
 {
-    return v.at(pos);
+    if (pos >= n)
+        throw std::out_of_range("Invalid bstr index");
+    return d[pos];
 }
 
 const u8 &bstr::at(const size_t pos) const
 {
-    return v.at(pos);
+    if (pos >= n)
+        throw std::out_of_range("Invalid bstr index");
+    return d[pos];
 }
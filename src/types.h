@@ -49,6 +49,12 @@ namespace au {
         bstr(const std::string &other);
         bstr(const u8 *str, const size_t size);
         bstr(const char *str, const size_t size);
+        bstr(const bstr &other);
+        bstr(bstr &&other) noexcept;
+        ~bstr();
+
+        bstr &operator =(const bstr &other);
+        bstr &operator =(bstr &&other) noexcept;
 
         bool empty() const;
         size_t size() const;
@@ -64,22 +70,22 @@ namespace au {
 
         template<typename T> T *get()
         {
-            return reinterpret_cast<T*>(v.data());
+            return reinterpret_cast<T*>(d);
         }
 
         template<typename T> T *end()
         {
-            return v.empty() ? nullptr : get<T>() + v.size() / sizeof(T);
+            return n == 0 ? nullptr : get<T>() + n / sizeof(T);
         }
 
         template<typename T> const T *get() const
         {
-            return reinterpret_cast<const T*>(v.data());
+            return reinterpret_cast<const T*>(d);
         }
 
         template<typename T> const T *end() const
         {
-            return v.empty() ? nullptr : get<T>() + v.size() / sizeof(T);
+            return n == 0 ? nullptr : get<T>() + n / sizeof(T);
         }
 
         u8 *begin()
@@ -121,7 +127,23 @@ namespace au {
         const u8 &at(const size_t pos) const;
 
     private:
-        std::vector<u8> v;
+        // Buffers up to inline_capacity bytes (magic numbers, crypt keys,
+        // single pixels - the sizes that dominate allocation counts) live
+        // inside the object and never touch the heap; larger buffers are
+        // heap-backed and moving them is a pointer swap.
+        static const size_t inline_capacity = 16;
+
+        bool is_inline() const
+        {
+            return d == inline_buffer;
+        }
+
+        void grow(const size_t min_capacity);
+
+        u8 *d;
+        size_t n;
+        size_t cap;
+        u8 inline_buffer[inline_capacity];
     };
 
     constexpr size_t operator "" _z(unsigned long long int value)
@@ -19,76 +19,168 @@
 #include <map>
 #include <mutex>
 #include <set>
+#include <unordered_map>
 #include "algo/str.h"
 #include "err.h"
 #include "io/file_system.h"
 
 using namespace au;
 
-static std::mutex mutex;
-static std::map<io::path, std::function<std::unique_ptr<io::File>()>> factories;
-static std::set<io::path> directories;
-static bool enabled = true;
+// The registry is kept as a chain of immutable snapshots. Lookups happen
+// from many decode threads at once (companion files such as alpha masks
+// and key files) and simply load the current snapshot atomically - no
+// lock, and the view cannot change mid-search. Writers copy the current
+// snapshot under a mutex, apply their changes and publish the copy; the
+// batch interface lets an archive publish all of its entries in one such
+// copy, so lookups see an archive's entries either all at once or not at
+// all, never a timing-dependent prefix. The stem and name indices turn
+// the searches into hash lookups instead of scans over all registered
+// files.
+namespace
+{
+    struct State final
+    {
+        std::map<io::path, VirtualFileSystem::FileFactory> factories;
+        std::unordered_map<std::string, std::set<io::path>> stem_index;
+        std::unordered_map<std::string, std::set<io::path>> name_index;
+        std::set<io::path> directories;
+        bool enabled = true;
+    };
+}
+
+static std::mutex writer_mutex;
+static std::shared_ptr<const State> current_state = std::make_shared<State>();
+
+static std::shared_ptr<const State> snapshot()
+{
+    return std::atomic_load_explicit(
+        &current_state, std::memory_order_acquire);
+}
+
+static void publish(State &&state)
+{
+    std::atomic_store_explicit(
+        &current_state,
+        std::shared_ptr<const State>(
+            std::make_shared<State>(std::move(state))),
+        std::memory_order_release);
+}
+
+static void add_to_state(
+    State &state, const io::path &path, VirtualFileSystem::FileFactory factory)
+{
+    const io::path key(algo::lower(path.str()));
+    state.factories[key] = std::move(factory);
+    state.stem_index[key.stem()].insert(key);
+    state.name_index[key.name()].insert(key);
+}
+
+static void remove_from_state(State &state, const io::path &path)
+{
+    const io::path key(algo::lower(path.str()));
+    state.factories.erase(key);
+    const auto stem_entry = state.stem_index.find(key.stem());
+    if (stem_entry != state.stem_index.end())
+    {
+        stem_entry->second.erase(key);
+        if (stem_entry->second.empty())
+            state.stem_index.erase(stem_entry);
+    }
+    const auto name_entry = state.name_index.find(key.name());
+    if (name_entry != state.name_index.end())
+    {
+        name_entry->second.erase(key);
+        if (name_entry->second.empty())
+            state.name_index.erase(name_entry);
+    }
+}
 
 void VirtualFileSystem::disable()
 {
-    std::unique_lock<std::mutex> lock(mutex);
-    enabled = false;
+    std::unique_lock<std::mutex> lock(writer_mutex);
+    auto state = State(*snapshot());
+    state.enabled = false;
+    publish(std::move(state));
 }
 
 void VirtualFileSystem::enable()
 {
-    std::unique_lock<std::mutex> lock(mutex);
-    enabled = true;
+    std::unique_lock<std::mutex> lock(writer_mutex);
+    auto state = State(*snapshot());
+    state.enabled = true;
+    publish(std::move(state));
 }
 
 void VirtualFileSystem::clear()
 {
-    directories.clear();
-    factories.clear();
+    std::unique_lock<std::mutex> lock(writer_mutex);
+    auto state = State();
+    state.enabled = snapshot()->enabled;
+    publish(std::move(state));
 }
 
 void VirtualFileSystem::register_file(
-    const io::path &path,
-    const std::function<std::unique_ptr<io::File>()> factory)
+    const io::path &path, const FileFactory factory)
 {
-    std::unique_lock<std::mutex> lock(mutex);
-    if (enabled)
-        factories[io::path(algo::lower(path.str()))] = factory;
+    register_files({{path, factory}});
 }
 
 void VirtualFileSystem::unregister_file(const io::path &path)
 {
-    std::unique_lock<std::mutex> lock(mutex);
-    factories.erase(io::path(algo::lower(path.str())));
+    unregister_files({path});
+}
+
+void VirtualFileSystem::register_files(std::vector<RegisteredFile> files)
+{
+    std::unique_lock<std::mutex> lock(writer_mutex);
+    if (!snapshot()->enabled)
+        return;
+    auto state = State(*snapshot());
+    for (auto &file : files)
+        add_to_state(state, file.path, std::move(file.factory));
+    publish(std::move(state));
+}
+
+void VirtualFileSystem::unregister_files(const std::vector<io::path> &paths)
+{
+    std::unique_lock<std::mutex> lock(writer_mutex);
+    auto state = State(*snapshot());
+    for (const auto &path : paths)
+        remove_from_state(state, path);
+    publish(std::move(state));
 }
 
 void VirtualFileSystem::register_directory(const io::path &path)
 {
-    std::unique_lock<std::mutex> lock(mutex);
-    if (enabled)
-        directories.insert(path);
+    std::unique_lock<std::mutex> lock(writer_mutex);
+    if (!snapshot()->enabled)
+        return;
+    auto state = State(*snapshot());
+    state.directories.insert(path);
+    publish(std::move(state));
 }
 
 void VirtualFileSystem::unregister_directory(const io::path &path)
 {
-    std::unique_lock<std::mutex> lock(mutex);
-    directories.erase(path);
+    std::unique_lock<std::mutex> lock(writer_mutex);
+    auto state = State(*snapshot());
+    state.directories.erase(path);
+    publish(std::move(state));
 }
 
 std::unique_ptr<io::File> VirtualFileSystem::get_by_stem(
     const std::string &stem)
 {
-    std::unique_lock<std::mutex> lock(mutex);
-    if (!enabled)
+    const auto state = snapshot();
+    if (!state->enabled)
         return nullptr;
 
     const auto check = algo::lower(stem);
-    for (const auto &kv : factories)
-        if (kv.first.stem() == check)
-            return kv.second();
+    const auto entry = state->stem_index.find(check);
+    if (entry != state->stem_index.end() && !entry->second.empty())
+        return state->factories.find(*entry->second.begin())->second();
 
-    for (const auto &directory : directories)
+    for (const auto &directory : state->directories)
     for (const auto &other_path : io::recursive_directory_range(directory))
         if (algo::lower(other_path.stem()) == check)
             return std::make_unique<io::File>(other_path, io::FileMode::Read);
@@ -99,16 +191,16 @@ std::unique_ptr<io::File> VirtualFileSystem::get_by_stem(
 std::unique_ptr<io::File> VirtualFileSystem::get_by_name(
     const std::string &name)
 {
-    std::unique_lock<std::mutex> lock(mutex);
-    if (!enabled)
+    const auto state = snapshot();
+    if (!state->enabled)
         return nullptr;
 
     const auto check = algo::lower(name);
-    for (const auto &kv : factories)
-        if (kv.first.name() == check)
-            return kv.second();
+    const auto entry = state->name_index.find(check);
+    if (entry != state->name_index.end() && !entry->second.empty())
+        return state->factories.find(*entry->second.begin())->second();
 
-    for (const auto &directory : directories)
+    for (const auto &directory : state->directories)
     for (const auto &other_path : io::recursive_directory_range(directory))
         if (algo::lower(other_path.name()) == check)
             return std::make_unique<io::File>(other_path, io::FileMode::Read);
@@ -118,15 +210,16 @@ std::unique_ptr<io::File> VirtualFileSystem::get_by_name(
 
 std::unique_ptr<io::File> VirtualFileSystem::get_by_path(const io::path &path)
 {
-    std::unique_lock<std::mutex> lock(mutex);
-    if (!enabled)
+    const auto state = snapshot();
+    if (!state->enabled)
         return nullptr;
 
     const auto check = io::path(algo::lower(path.str()));
-    if (factories.find(check) != factories.end())
-        return factories[check]();
+    const auto entry = state->factories.find(check);
+    if (entry != state->factories.end())
+        return entry->second();
 
-    for (const auto &directory : directories)
+    for (const auto &directory : state->directories)
     for (const auto &other_path : io::recursive_directory_range(directory))
     {
         if (io::path(algo::lower(other_path.str())) == check)
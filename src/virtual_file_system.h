@@ -19,6 +19,7 @@
 
 #include <functional>
 #include <memory>
+#include <vector>
 #include "io/file.h"
 #include "io/path.h"
 
@@ -27,15 +28,31 @@ namespace au {
     class VirtualFileSystem final
     {
     public:
+        using FileFactory = std::function<std::unique_ptr<io::File>()>;
+
+        struct RegisteredFile final
+        {
+            io::path path;
+            FileFactory factory;
+        };
+
         static void enable();
         static void disable();
 
         static void clear();
         static void register_file(
-            const io::path &path,
-            const std::function<std::unique_ptr<io::File>()> factory);
+            const io::path &path, const FileFactory factory);
         static void unregister_file(const io::path &path);
 
+        // Registers (or removes) a whole archive's worth of entries as
+        // one atomic publication: concurrent lookups see either none or
+        // all of them, so companion-file resolution between sibling
+        // entries cannot depend on task timing. Also the preferred way
+        // to register in bulk - each publication copies the registry
+        // once, however many files it carries.
+        static void register_files(std::vector<RegisteredFile> files);
+        static void unregister_files(const std::vector<io::path> &paths);
+
         static void register_directory(const io::path &path);
         static void unregister_directory(const io::path &path);
 
@@ -0,0 +1,55 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "algo/alloc_stats.h"
+#include "algo/grid.h"
+#include "test_support/catch.h"
+
+using namespace au;
+using namespace au::algo;
+
+TEST_CASE("Buffer allocation statistics", "[algo]")
+{
+    AllocStats::set_label("alloc_test");
+    AllocStats::reset();
+    AllocStats::enable();
+
+    {
+        // large enough to spill the inline buffer
+        const bstr buffer(4096);
+        const Grid<u32> grid(16, 16);
+
+        const auto entry = AllocStats::get("alloc_test");
+        REQUIRE(entry.alloc_count == 2);
+        REQUIRE(entry.alloc_bytes >= 4096 + 16 * 16 * sizeof(u32));
+        REQUIRE(AllocStats::get_live_bytes() == entry.alloc_bytes);
+        REQUIRE(AllocStats::get_peak_bytes() == entry.alloc_bytes);
+    }
+
+    // freeing the buffers drops the live total but not the peak
+    const auto entry = AllocStats::get("alloc_test");
+    REQUIRE(AllocStats::get_live_bytes() == 0);
+    REQUIRE(AllocStats::get_peak_bytes() == entry.alloc_bytes);
+
+    AllocStats::disable();
+    AllocStats::set_label("");
+
+    // nothing is recorded while disabled
+    const bstr ignored(4096);
+    REQUIRE(AllocStats::get("alloc_test").alloc_count == 2);
+    REQUIRE(AllocStats::get_live_bytes() == 0);
+}
@@ -0,0 +1,65 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "algo/big_alloc.h"
+#include <cstring>
+#include "test_support/catch.h"
+
+using namespace au;
+
+TEST_CASE("Big buffer allocation", "[algo]")
+{
+    SECTION("Buffers below the threshold")
+    {
+        const auto size = algo::big_alloc_threshold / 2;
+        const auto data = algo::big_alloc(size);
+        std::memset(data, 0xAA, size);
+        REQUIRE(data[0] == 0xAA);
+        REQUIRE(data[size - 1] == 0xAA);
+        algo::big_free(data, size);
+    }
+
+    SECTION("Buffers at and above the threshold")
+    {
+        const auto size = algo::big_alloc_threshold * 3 + 123;
+        const auto data = algo::big_alloc(size);
+        std::memset(data, 0x55, size);
+        REQUIRE(data[0] == 0x55);
+        REQUIRE(data[size - 1] == 0x55);
+        algo::big_free(data, size);
+    }
+
+    SECTION("Freed big buffers are recycled")
+    {
+        const auto size = algo::big_alloc_threshold * 2;
+        const auto data = algo::big_alloc(size);
+        data[0] = 'x';
+        algo::big_free(data, size);
+        // most recently freed buffer of the same size class comes back
+        const auto recycled = algo::big_alloc(size - 1);
+        REQUIRE(recycled == data);
+        algo::big_free(recycled, size - 1);
+    }
+
+    SECTION("Container storage through the allocator")
+    {
+        std::vector<u32, algo::BigAllocator<u32>> big(
+            algo::big_alloc_threshold, 0x12345678);
+        REQUIRE(big.front() == 0x12345678);
+        REQUIRE(big.back() == 0x12345678);
+    }
+}
@@ -0,0 +1,88 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "algo/copy_stats.h"
+#include "io/memory_byte_stream.h"
+#include "test_support/catch.h"
+
+using namespace au;
+using namespace au::algo;
+
+TEST_CASE("Buffer copy statistics", "[algo]")
+{
+    CopyStats::reset();
+    CopyStats::enable();
+
+    SECTION("Copies below the threshold are not recorded")
+    {
+        const bstr small(copy_stats_threshold - 1);
+        const bstr copy(small);
+        REQUIRE(CopyStats::get("bstr copy").copy_count == 0);
+    }
+
+    SECTION("Unscoped bstr copies land under the default site")
+    {
+        const bstr big(copy_stats_threshold);
+        const bstr copy(big);
+        const auto entry = CopyStats::get("bstr copy");
+        REQUIRE(entry.copy_count == 1);
+        REQUIRE(entry.copy_bytes == copy_stats_threshold);
+    }
+
+    SECTION("Scoped sites claim the copies made inside them")
+    {
+        const bstr big(copy_stats_threshold);
+        {
+            CopyStats::SiteScope site("copy_test");
+            const bstr copy(big);
+        }
+        const bstr unscoped_copy(big);
+        REQUIRE(CopyStats::get("copy_test").copy_count == 1);
+        REQUIRE(CopyStats::get("bstr copy").copy_count == 1);
+    }
+
+    SECTION("Copy-on-write streams record only the actual detach")
+    {
+        const bstr buffer(copy_stats_threshold);
+        io::MemoryByteStream stream(buffer);
+        const auto cloned = stream.clone();
+        REQUIRE(CopyStats::get("io::MemoryByteStream::detach").copy_count
+            == 0);
+        stream.write("x"_b);
+        REQUIRE(CopyStats::get("io::MemoryByteStream::detach").copy_count
+            == 1);
+    }
+
+    SECTION("Output bytes feed the copies-per-output-byte ratio")
+    {
+        CopyStats::record_output(12345);
+        REQUIRE(CopyStats::get_output_bytes() == 12345);
+        const bstr big(copy_stats_threshold);
+        const bstr copy(big);
+        REQUIRE(CopyStats::get_total_copied_bytes() == copy_stats_threshold);
+    }
+
+    CopyStats::disable();
+    CopyStats::reset();
+
+    // nothing is recorded while disabled
+    const bstr big(copy_stats_threshold);
+    const bstr ignored(big);
+    CopyStats::record_output(1);
+    REQUIRE(CopyStats::get("bstr copy").copy_count == 0);
+    REQUIRE(CopyStats::get_output_bytes() == 0);
+}
@@ -0,0 +1,67 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "algo/cpu.h"
+#include "test_support/catch.h"
+
+using namespace au;
+using namespace au::algo;
+
+static int scalar_kernel() { return 1; }
+static int accelerated_kernel() { return 2; }
+
+TEST_CASE("CPU feature dispatch", "[algo]")
+{
+    SECTION("Scalar is always supported")
+    {
+        REQUIRE(cpu_supports(CpuVariant::Scalar));
+    }
+
+    SECTION("Forcing a variant hides the ones above it")
+    {
+        force_cpu_variant(CpuVariant::Scalar);
+        REQUIRE(cpu_supports(CpuVariant::Scalar));
+        REQUIRE(!cpu_supports(CpuVariant::Sse4));
+        REQUIRE(!cpu_supports(CpuVariant::Avx2));
+        REQUIRE(!cpu_supports(CpuVariant::Neon));
+        reset_cpu_variant();
+        REQUIRE(cpu_supports(CpuVariant::Scalar));
+    }
+
+    SECTION("Dispatch tables fall back to scalar")
+    {
+        CpuDispatch<int(*)()> dispatch = {scalar_kernel};
+        REQUIRE(dispatch.choose()() == 1);
+
+        dispatch.sse4 = accelerated_kernel;
+        dispatch.avx2 = accelerated_kernel;
+        dispatch.neon = accelerated_kernel;
+        force_cpu_variant(CpuVariant::Scalar);
+        REQUIRE(dispatch.choose()() == 1);
+        reset_cpu_variant();
+
+        // whichever variant gets picked on this machine, it must run
+        REQUIRE(dispatch.choose() != nullptr);
+        REQUIRE(dispatch.choose()() >= 1);
+    }
+
+    SECTION("Variant names")
+    {
+        REQUIRE(cpu_variant_name(CpuVariant::Scalar) == "scalar");
+        REQUIRE(cpu_variant_name(CpuVariant::Avx2) == "avx2");
+    }
+}
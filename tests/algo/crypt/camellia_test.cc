@@ -16,6 +16,8 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "algo/crypt/camellia.h"
+#include "algo/range.h"
+#include "io/memory_byte_stream.h"
 #include "test_support/catch.h"
 
 using namespace au;
@@ -53,4 +55,31 @@ TEST_CASE("Camellia", "[algo][crypt]")
     REQUIRE(actual_block[1] == input_block[1]);
     REQUIRE(actual_block[2] == input_block[2]);
     REQUIRE(actual_block[3] == input_block[3]);
+
+    SECTION("Batched block decryption matches per-block decryption")
+    {
+        const size_t block_count = 5;
+        bstr encrypted(block_count * 0x10);
+        for (const auto i : algo::range(encrypted.size()))
+            encrypted[i] = i * 7 + 3;
+
+        bstr expected(block_count * 0x10);
+        io::MemoryByteStream encrypted_stream(encrypted);
+        io::MemoryByteStream expected_stream;
+        for (const auto i : algo::range(block_count))
+        {
+            u32 enc_block[4], dec_block[4];
+            for (const auto j : algo::range(4))
+                enc_block[j] = encrypted_stream.read_le<u32>();
+            c.decrypt_block_128(i * 0x10, enc_block, dec_block);
+            for (const auto j : algo::range(4))
+                expected_stream.write_be<u32>(dec_block[j]);
+        }
+        expected = expected_stream.seek(0).read_to_eof();
+
+        bstr actual(block_count * 0x10);
+        c.decrypt_blocks_128(
+            0, encrypted.get<const u8>(), actual.get<u8>(), block_count);
+        REQUIRE(actual == expected);
+    }
 }
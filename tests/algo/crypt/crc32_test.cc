@@ -0,0 +1,42 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "algo/crypt/crc32.h"
+#include "test_support/catch.h"
+
+using namespace au;
+
+TEST_CASE("CRC32", "[algo][crypt]")
+{
+    SECTION("Empty input")
+    {
+        REQUIRE(algo::crypt::crc32(""_b) == 0);
+    }
+
+    SECTION("Standard check value")
+    {
+        REQUIRE(algo::crypt::crc32("123456789"_b) == 0xCBF43926);
+    }
+
+    SECTION("Input longer than one slice")
+    {
+        bstr input;
+        for (auto i = 0; i < 256; i++)
+            input += static_cast<u8>(i);
+        REQUIRE(algo::crypt::crc32(input) == 0x29058C73);
+    }
+}
@@ -39,4 +39,12 @@ TEST_CASE("MD5", "[algo][crypt]")
             "\x7E\x8E\xFD\x2F\x05\x58\x82\x92"
             "\x58\xC8\x1F\xC9\x59\x81\xCF\xFF"_b);
     }
+
+    SECTION("Incremental hashing")
+    {
+        Md5 hasher;
+        hasher.update("te"_b);
+        hasher.update("st"_b);
+        tests::compare_binary(hasher.finish(), algo::crypt::md5("test"_b));
+    }
 }
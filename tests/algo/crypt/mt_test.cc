@@ -0,0 +1,45 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "algo/crypt/mt.h"
+#include <vector>
+#include "algo/range.h"
+#include "test_support/catch.h"
+
+using namespace au;
+using namespace au::algo::crypt;
+
+TEST_CASE("Mersenne Twister", "[algo][crypt]")
+{
+    SECTION("Reference output")
+    {
+        auto mt = MersenneTwister::Improved(5489);
+        REQUIRE(mt->next_u32() == 0xD091BB5C);
+    }
+
+    SECTION("Batched output matches sequential output")
+    {
+        // spans several state refills
+        const size_t count = 2000;
+        auto mt1 = MersenneTwister::Improved(123);
+        auto mt2 = MersenneTwister::Improved(123);
+        std::vector<u32> batch(count);
+        mt1->next_u32_batch(batch.data(), count);
+        for (const auto i : algo::range(count))
+            REQUIRE(batch[i] == mt2->next_u32());
+    }
+}
@@ -16,6 +16,7 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "algo/locale.h"
+#include "algo/cpu.h"
 #include "test_support/catch.h"
 #include "test_support/common.h"
 
@@ -50,6 +51,30 @@ TEST_CASE("Converting text encoding", "[algo]")
     {
         tests::compare_binary(algo::utf8_to_sjis(utf8), sjis);
     }
+
+    SECTION("Mixed ASCII and SJIS content")
+    {
+        // long ASCII spans around the SJIS runs exercise the span-wise
+        // conversion path, including trail bytes in the ASCII range
+        // (sjis "ｱﾎﾟA" uses half-width katakana and an ASCII letter)
+        const bstr ascii(100, 'x');
+        const auto mixed_sjis = ascii + sjis + ascii + "\xB1\xCE\xDFZ"_b;
+        const auto expected
+            = ascii + utf8 + ascii + "\xEF\xBD\xB1\xEF\xBE\x8E\xEF\xBE\x9FZ"_b;
+        tests::compare_binary(algo::sjis_to_utf8(mixed_sjis), expected);
+    }
+
+    SECTION("Every compiled scan variant agrees")
+    {
+        bstr input(1000, 'a');
+        input += sjis;
+        input += bstr(17, 'b');
+        input += sjis;
+        algo::force_cpu_variant(algo::CpuVariant::Scalar);
+        const auto scalar_output = algo::sjis_to_utf8(input);
+        algo::reset_cpu_variant();
+        tests::compare_binary(algo::sjis_to_utf8(input), scalar_output);
+    }
 }
 
 TEST_CASE("Normalizing SJIS strings", "[algo]")
@@ -0,0 +1,95 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include "algo/pack/lzss.h"
+#include "algo/pack/zlib.h"
+#include "test_support/archive_support.h"
+#include "test_support/catch.h"
+
+using namespace au;
+
+// Gross-regression insurance for the kernels every decoder depends on.
+// Absolute numbers vary wildly between machines, so each kernel is held
+// against a memcpy of the same output measured on the same machine in
+// the same process - a machine-class baseline that needs no stored
+// figures. The margins are generous on purpose: a kernel an order of
+// magnitude below its usual distance from memcpy fails, honest
+// compiler-to-compiler scatter does not.
+
+static const size_t payload_size = 4 * 1024 * 1024;
+
+static double best_seconds_of_three(const std::function<void()> &runnable)
+{
+    auto best = 0.0;
+    for (auto i = 0; i < 3; i++)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        runnable();
+        const auto seconds = std::chrono::duration_cast<
+            std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count() / 1e9;
+        if (!i || seconds < best)
+            best = seconds;
+    }
+    return best;
+}
+
+TEST_CASE("Hot kernel throughput smoke", "[algo][perf]")
+{
+    tests::SyntheticArchiveSpec spec;
+    spec.entry_count = 1;
+    spec.entry_size = payload_size;
+    spec.compressibility_percent = 70;
+    const auto payload = tests::synthetic_entry_data(spec, 0);
+
+    bstr scratch(payload.size());
+    const auto memcpy_seconds = best_seconds_of_three([&]()
+    {
+        std::memcpy(scratch.get<u8>(), payload.get<const u8>(),
+            payload.size());
+    });
+    const auto memcpy_rate = payload.size() / memcpy_seconds;
+
+    SECTION("Bytewise LZSS decompression")
+    {
+        const auto compressed = algo::pack::lzss_compress(payload);
+        bstr output;
+        const auto seconds = best_seconds_of_three([&]()
+        {
+            output = algo::pack::lzss_decompress(
+                compressed, payload.size());
+        });
+        REQUIRE(output == payload);
+        REQUIRE(payload.size() / seconds >= memcpy_rate / 500);
+    }
+
+    SECTION("Zlib inflation")
+    {
+        const auto compressed = algo::pack::zlib_deflate(payload);
+        bstr output;
+        const auto seconds = best_seconds_of_three([&]()
+        {
+            output = algo::pack::zlib_inflate(
+                compressed, payload.size());
+        });
+        REQUIRE(output == payload);
+        REQUIRE(payload.size() / seconds >= memcpy_rate / 500);
+    }
+}
@@ -0,0 +1,133 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <vector>
+#include "algo/pack/huffman.h"
+#include "algo/pack/lzss.h"
+#include "algo/range.h"
+#include "err.h"
+#include "test_support/catch.h"
+
+using namespace au;
+
+// Corrupt archives feed these kernels arbitrary bytes, and a decoder
+// whose worst case is quadratic stalls a worker until the timeout. The
+// harness throws a batch of adversarial inputs - random noise plus the
+// historically bad shapes, like repetition-only control streams that
+// wrap the dictionary - at each kernel and compares the per-byte cost
+// of the slowest input against the 90th percentile of the batch. The
+// median would be misleading: fuzzed batches legitimately mix full
+// decodes with near-free degenerate paths, like the single-leaf
+// Huffman tree that resolves to one memset. Linear kernels keep the
+// worst input within a small factor of the rest; a superlinear
+// degradation shows up as orders of magnitude, far beyond the generous
+// margin used here.
+
+static const size_t sample_count = 48;
+static const size_t input_size = 65536;
+static const size_t target_size = 1024 * 1024;
+
+static bstr fuzz_bytes(u32 state, const size_t size)
+{
+    bstr data(size);
+    for (const auto i : algo::range(size))
+    {
+        state = state * 0x343FD + 0x269EC3;
+        data[i] = state >> 24;
+    }
+    return data;
+}
+
+static double worst_to_p90_ratio(
+    const std::function<size_t(const bstr &input)> &decode)
+{
+    std::vector<double> costs;
+    for (const auto i : algo::range(sample_count))
+    {
+        auto input = fuzz_bytes(0x12345678 + i * 0x9E3779B9, input_size);
+        // every fourth sample is repetitions only: zeroed control bytes
+        // produce back-references that lap the dictionary over and over
+        if (i % 4 == 0)
+        {
+            for (const auto j : algo::range(0, input.size(), 3))
+                input[j] = 0;
+        }
+        const auto start = std::chrono::steady_clock::now();
+        size_t produced = 0;
+        try
+        {
+            produced = decode(input);
+        }
+        catch (const err::EofError &)
+        {
+            // truncated streams are expected among fuzzed inputs; the
+            // kernel did at most one target's worth of work before the
+            // throw discarded its output, so cap the estimate there -
+            // underestimating the per-byte cost only makes the check
+            // more lenient, and a stall exceeds the margin regardless
+            produced = target_size;
+        }
+        const auto nanoseconds = std::chrono::duration_cast<
+            std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count();
+        costs.push_back(
+            static_cast<double>(nanoseconds)
+            / (input.size() + produced + 1));
+    }
+    std::sort(costs.begin(), costs.end());
+    return costs.back() / costs[costs.size() * 9 / 10];
+}
+
+TEST_CASE("Adversarial decompression inputs stay linear", "[algo][perf]")
+{
+    SECTION("Bytewise LZSS")
+    {
+        const auto ratio = worst_to_p90_ratio([](const bstr &input)
+        {
+            return algo::pack::lzss_decompress(input, target_size).size();
+        });
+        REQUIRE(ratio < 50);
+    }
+
+    SECTION("Bitwise LZSS")
+    {
+        algo::pack::BitwiseLzssSettings settings;
+        settings.position_bits = 12;
+        settings.size_bits = 4;
+        settings.min_match_size = 3;
+        settings.initial_dictionary_pos = 0xFEE;
+        const auto ratio = worst_to_p90_ratio(
+            [&settings](const bstr &input)
+        {
+            return algo::pack::lzss_decompress(
+                input, target_size, settings).size();
+        });
+        REQUIRE(ratio < 50);
+    }
+
+    SECTION("Huffman")
+    {
+        const auto ratio = worst_to_p90_ratio([](const bstr &input)
+        {
+            return algo::pack::decode_huffman(input, target_size).size();
+        });
+        REQUIRE(ratio < 50);
+    }
+}
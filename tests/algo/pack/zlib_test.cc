@@ -43,6 +43,36 @@ TEST_CASE("ZLIB compression", "[algo][pack]")
         REQUIRE(input_stream.left() == 0);
     }
 
+    SECTION("Inflating ZLIB with known output size")
+    {
+        tests::compare_binary(zlib_inflate(input, output.size()), output);
+    }
+
+    SECTION("Inflating ZLIB with wrong output size hint")
+    {
+        tests::compare_binary(zlib_inflate(input, 1), output);
+        tests::compare_binary(zlib_inflate(input, 1000), output);
+    }
+
+    SECTION("Inflating ZLIB through a chunk sink")
+    {
+        io::MemoryByteStream input_stream(input);
+        bstr collected;
+        zlib_inflate(
+            input_stream,
+            [&](const bstr &chunk) { collected += chunk; });
+        tests::compare_binary(collected, output);
+        REQUIRE(input_stream.left() == 0);
+    }
+
+    SECTION("Inflating ZLIB into an output stream")
+    {
+        io::MemoryByteStream input_stream(input);
+        io::MemoryByteStream output_stream;
+        zlib_inflate(input_stream, output_stream);
+        tests::compare_binary(output_stream.seek(0).read_to_eof(), output);
+    }
+
     SECTION("Deflating ZLIB from bstr")
     {
         tests::compare_binary(zlib_inflate(zlib_deflate(output)), output);
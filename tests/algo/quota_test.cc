@@ -0,0 +1,61 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "algo/quota.h"
+#include <chrono>
+#include "err.h"
+#include "test_support/catch.h"
+#include "types.h"
+
+using namespace au;
+
+TEST_CASE("Decode quotas", "[algo]")
+{
+    SECTION("Oversized allocations are rejected while armed")
+    {
+        algo::DecodeQuota::set_output_limit(2 * 1024 * 1024);
+        {
+            const algo::DecodeQuotaGuard guard;
+            REQUIRE_THROWS_AS(
+                bstr(16 * 1024 * 1024), err::QuotaError);
+            const bstr small(1024 * 1024);
+            REQUIRE(small.size() == 1024 * 1024);
+        }
+        // disarmed threads (e.g. the file saver) are unaffected
+        const bstr huge(16 * 1024 * 1024);
+        REQUIRE(huge.size() == 16 * 1024 * 1024);
+        algo::DecodeQuota::set_output_limit(0);
+    }
+
+    SECTION("An expired deadline trips exactly once")
+    {
+        algo::DecodeQuota::set_time_limit(1);
+        const algo::DecodeQuotaGuard guard;
+        // burn past the 1 ms deadline, then force an unthrottled check
+        const auto deadline = std::chrono::steady_clock::now()
+            + std::chrono::milliseconds(2);
+        while (std::chrono::steady_clock::now() < deadline)
+        {
+        }
+        REQUIRE_THROWS_AS(
+            algo::DecodeQuota::check_deadline(), err::QuotaError);
+        // the deadline clears itself so that error handling can still
+        // touch streams without tripping again
+        algo::DecodeQuota::check_deadline();
+        algo::DecodeQuota::set_time_limit(0);
+    }
+}
@@ -0,0 +1,63 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "algo/scratch_arena.h"
+#include "test_support/catch.h"
+
+using namespace au;
+
+TEST_CASE("Scratch arena", "[algo]")
+{
+    SECTION("Buffers arrive zero-filled")
+    {
+        algo::ScratchBuffer buffer(0x1000);
+        REQUIRE(buffer.size() == 0x1000);
+        for (const auto i : {0_z, 0x123_z, 0xFFF_z})
+            REQUIRE(buffer[i] == 0);
+    }
+
+    SECTION("Sequential reuse returns the same memory, zeroed again")
+    {
+        u8 *first;
+        {
+            algo::ScratchBuffer buffer(0x800);
+            buffer[0] = 0xFF;
+            first = buffer.data();
+        }
+        algo::ScratchBuffer buffer(0x800);
+        REQUIRE(buffer.data() == first);
+        REQUIRE(buffer[0] == 0);
+    }
+
+    SECTION("Nested buffers do not overlap")
+    {
+        algo::ScratchBuffer outer(0x100);
+        algo::ScratchBuffer inner(0x100);
+        outer[0xFF] = 1;
+        inner[0] = 2;
+        REQUIRE(outer[0xFF] == 1);
+        REQUIRE(inner.data() != outer.data());
+    }
+
+    SECTION("Demand beyond the arena falls back gracefully")
+    {
+        algo::ScratchBuffer small(0x10);
+        algo::ScratchBuffer huge(64 * 1024 * 1024);
+        huge[huge.size() - 1] = 0x42;
+        REQUIRE(huge[huge.size() - 1] == 0x42);
+    }
+}
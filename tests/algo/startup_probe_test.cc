@@ -0,0 +1,40 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "algo/startup_probe.h"
+#include "test_support/catch.h"
+
+using namespace au;
+using namespace au::algo;
+
+TEST_CASE("Startup probe", "[algo]")
+{
+    // the test runner never marks main(), so both windows read as zero
+    REQUIRE(StartupProbe::static_init_nanoseconds() == 0);
+    REQUIRE(StartupProbe::pre_main_nanoseconds() == 0);
+
+    StartupProbe::mark_main_entry();
+
+    #ifdef __GNUC__
+        // the constructor hook fired long before this test ran
+        REQUIRE(StartupProbe::static_init_nanoseconds() > 0);
+    #endif
+    // the kernel's process age has clock-tick resolution, so for a
+    // fast-starting process it legitimately reads as zero; only its
+    // availability is checked, not a lower bound
+    StartupProbe::pre_main_nanoseconds();
+}
@@ -0,0 +1,53 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "algo/str.h"
+#include "test_support/catch.h"
+
+using namespace au;
+
+TEST_CASE("Wildcard matching", "[algo]")
+{
+    SECTION("Literal patterns")
+    {
+        REQUIRE(algo::wildcard_match("voice.ogg", "voice.ogg"));
+        REQUIRE(!algo::wildcard_match("voice.ogg", "voice.wav"));
+    }
+
+    SECTION("Case insensitivity")
+    {
+        REQUIRE(algo::wildcard_match("*.OGG", "voice.ogg"));
+    }
+
+    SECTION("Asterisks")
+    {
+        REQUIRE(algo::wildcard_match("*.ogg", "voice.ogg"));
+        REQUIRE(algo::wildcard_match("*.ogg", "sub/dir/voice.ogg"));
+        REQUIRE(algo::wildcard_match("voice/*", "voice/001.ogg"));
+        REQUIRE(algo::wildcard_match("*voice*01*", "cd1/voice_b01.ogg"));
+        REQUIRE(!algo::wildcard_match("*.ogg", "voice.ogg.txt"));
+        REQUIRE(algo::wildcard_match("*", "anything"));
+        REQUIRE(algo::wildcard_match("*", ""));
+    }
+
+    SECTION("Question marks")
+    {
+        REQUIRE(algo::wildcard_match("voice?.ogg", "voice1.ogg"));
+        REQUIRE(!algo::wildcard_match("voice?.ogg", "voice10.ogg"));
+        REQUIRE(!algo::wildcard_match("voice?.ogg", "voice.ogg"));
+    }
+}
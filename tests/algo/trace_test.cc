@@ -0,0 +1,56 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "algo/trace.h"
+#include "io/memory_byte_stream.h"
+#include "test_support/catch.h"
+
+using namespace au;
+using namespace au::algo;
+
+TEST_CASE("Scoped tracing", "[algo]")
+{
+    Trace::reset();
+    Trace::enable();
+    {
+        const TraceSpan span("decode file.dat", "decoder_a");
+    }
+    {
+        AU_TRACE_SPAN("save out.png", "FileSaverHdd");
+    }
+    Trace::disable();
+
+    io::MemoryByteStream output_stream;
+    Trace::write_chrome_trace(output_stream);
+    const auto trace = output_stream.seek(0).read_to_eof().str();
+
+    REQUIRE(trace.find("\"traceEvents\"") != std::string::npos);
+    REQUIRE(trace.find("\"ph\": \"X\"") != std::string::npos);
+    REQUIRE(
+        trace.find("\"name\": \"decode file.dat\"") != std::string::npos);
+    REQUIRE(trace.find("\"cat\": \"decoder_a\"") != std::string::npos);
+    REQUIRE(trace.find("\"name\": \"save out.png\"") != std::string::npos);
+
+    // spans opened while disabled leave no events behind
+    {
+        const TraceSpan span("ignored", "decoder_a");
+    }
+    io::MemoryByteStream second_stream;
+    Trace::write_chrome_trace(second_stream);
+    const auto second = second_stream.seek(0).read_to_eof().str();
+    REQUIRE(second.find("ignored") == std::string::npos);
+}
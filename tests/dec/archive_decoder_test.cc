@@ -127,7 +127,11 @@ static void test_many_files(
     {
         tests::compare_paths(
             saved_files[i]->path,
-            algo::format("%s_%0*d.dat", prefix.c_str(), format_size, i));
+            algo::format(
+                "%s_%0*d.dat",
+                prefix.c_str(),
+                static_cast<int>(format_size),
+                i));
     }
 }
 
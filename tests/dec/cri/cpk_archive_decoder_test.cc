@@ -0,0 +1,297 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "dec/cri/cpk_archive_decoder.h"
+#include "algo/any.h"
+#include "algo/range.h"
+#include "algo/str.h"
+#include "io/memory_byte_stream.h"
+#include "io/msb_bit_stream.h"
+#include "test_support/catch.h"
+#include "test_support/decoder_support.h"
+
+using namespace au;
+using namespace au::dec::cri;
+
+namespace
+{
+    struct UtfColumnSpec final
+    {
+        std::string name;
+        u32 flags;
+    };
+
+    using UtfCell = algo::any;
+
+    struct LaylaOp final
+    {
+        bool is_reference;
+        u8 literal;
+        size_t look_behind;
+        size_t repetitions;
+    };
+}
+
+static const u32 storage_zero    = 0x10;
+static const u32 storage_per_row = 0x50;
+static const u32 type_u16 = 0x02;
+static const u32 type_u32 = 0x04;
+static const u32 type_u64 = 0x06;
+static const u32 type_str = 0x0A;
+
+static bstr make_utf_packet(
+    const std::string &table_name,
+    const std::vector<UtfColumnSpec> &columns,
+    const std::vector<std::vector<UtfCell>> &rows)
+{
+    bstr text = "\x00"_b;
+    const auto add_text = [&](const std::string &value)
+    {
+        const auto offset = text.size();
+        text += bstr(value);
+        text += "\x00"_b;
+        return offset;
+    };
+    const auto table_name_offset = add_text(table_name);
+
+    io::MemoryByteStream descriptor_stream;
+    std::vector<size_t> cell_sizes;
+    size_t row_size = 0;
+    for (const auto &column : columns)
+    {
+        descriptor_stream.write<u8>(column.flags);
+        descriptor_stream.write_be<u32>(add_text(column.name));
+        size_t cell_size = 0;
+        if ((column.flags & 0xF0) == storage_per_row)
+        {
+            switch (column.flags & 0x0F)
+            {
+                case type_u16: cell_size = 2; break;
+                case type_u32: cell_size = 4; break;
+                case type_u64: cell_size = 8; break;
+                case type_str: cell_size = 4; break;
+            }
+        }
+        cell_sizes.push_back(cell_size);
+        row_size += cell_size;
+    }
+
+    io::MemoryByteStream rows_stream;
+    for (const auto &row : rows)
+    {
+        for (const auto i : algo::range(columns.size()))
+        {
+            if (!cell_sizes[i])
+                continue;
+            switch (columns[i].flags & 0x0F)
+            {
+                case type_u16:
+                    rows_stream.write_be<u16>(row[i].get<u16>());
+                    break;
+                case type_u32:
+                    rows_stream.write_be<u32>(row[i].get<u32>());
+                    break;
+                case type_u64:
+                    rows_stream.write_be<u64>(row[i].get<u64>());
+                    break;
+                case type_str:
+                    rows_stream.write_be<u32>(
+                        add_text(row[i].get<std::string>()));
+                    break;
+            }
+        }
+    }
+    rows_stream.seek(0);
+    const auto rows_data = rows_stream.read_to_eof();
+    descriptor_stream.seek(0);
+    const auto descriptors = descriptor_stream.read_to_eof();
+
+    const auto rows_offset = 32 + descriptors.size();
+    const auto text_offset = rows_offset + rows_data.size();
+    const auto data_offset = text_offset + text.size();
+
+    io::MemoryByteStream output_stream;
+    output_stream.write("@UTF"_b);
+    output_stream.write_be<u32>(data_offset - 8);
+    output_stream.write_be<u32>(rows_offset - 8);
+    output_stream.write_be<u32>(text_offset - 8);
+    output_stream.write_be<u32>(data_offset - 8);
+    output_stream.write_be<u32>(table_name_offset);
+    output_stream.write_be<u16>(columns.size());
+    output_stream.write_be<u16>(row_size);
+    output_stream.write_be<u32>(rows.size());
+    output_stream.write(descriptors);
+    output_stream.write(rows_data);
+    output_stream.write(text);
+    output_stream.seek(0);
+    return output_stream.read_to_eof();
+}
+
+static bstr wrap_utf_packet(const bstr &utf_packet)
+{
+    io::MemoryByteStream output_stream;
+    output_stream.write_le<u32>(0xFF);
+    output_stream.write_le<u64>(utf_packet.size());
+    output_stream.write(utf_packet);
+    output_stream.seek(0);
+    return output_stream.read_to_eof();
+}
+
+// Builds a CRILAYLA blob from operations given in generation order and
+// returns both the blob and the data it should decompress to, computed
+// with the straightforward construction the format is defined by.
+static std::pair<bstr, bstr> make_layla_blob(
+    const std::vector<LaylaOp> &ops, const bstr &prefix)
+{
+    bstr reference;
+    io::MemoryByteStream bit_backing_stream;
+    io::MsbBitStream bit_stream(bit_backing_stream);
+    for (const auto &op : ops)
+    {
+        if (!op.is_reference)
+        {
+            bit_stream.write(1, 0);
+            bit_stream.write(8, op.literal);
+            reference += op.literal;
+            continue;
+        }
+        bit_stream.write(1, 1);
+        bit_stream.write(13, op.look_behind - 3);
+        auto extra = op.repetitions - 3;
+        for (const auto size : {2, 3, 5, 8, 8, 8, 8})
+        {
+            const u32 limit = (1u << size) - 1;
+            const auto marker = std::min<u32>(extra, limit);
+            bit_stream.write(size, marker);
+            extra -= marker;
+            if (marker != limit)
+                break;
+        }
+        for (const auto i : algo::range(op.repetitions))
+        {
+            reference
+                += reference.at(reference.size() - op.look_behind);
+        }
+    }
+    bit_stream.flush();
+    bit_backing_stream.seek(0);
+    const auto comp = algo::reverse(bit_backing_stream.read_to_eof());
+
+    io::MemoryByteStream blob_stream;
+    blob_stream.write("CRILAYLA"_b);
+    blob_stream.write_le<u32>(reference.size());
+    blob_stream.write_le<u32>(comp.size());
+    blob_stream.write(comp);
+    blob_stream.write(prefix);
+    blob_stream.seek(0);
+    return {blob_stream.read_to_eof(), prefix + algo::reverse(reference)};
+}
+
+TEST_CASE("CRI CPK archives", "[dec]")
+{
+    bstr prefix(0x100);
+    for (const auto i : algo::range(prefix.size()))
+        prefix[i] = i;
+
+    std::vector<LaylaOp> ops;
+    u32 state = 0x12345678;
+    const auto add_literals = [&](const size_t count)
+    {
+        for (const auto i : algo::range(count))
+        {
+            state = state * 0x343FD + 0x269EC3;
+            ops.push_back({false, static_cast<u8>(state >> 24), 0, 0});
+        }
+    };
+    add_literals(64);
+    ops.push_back({true, 0, 10, 20});   // overlapping back-reference
+    add_literals(200);
+    ops.push_back({true, 0, 250, 40});  // bulk copy with chained markers
+    ops.push_back({true, 0, 3, 5});
+    add_literals(9);
+    const auto layla = make_layla_blob(ops, prefix);
+
+    const auto plain_data = "just stored"_b;
+
+    const std::vector<UtfColumnSpec> toc_columns =
+    {
+        {"ID", storage_per_row | type_u32},
+        {"DirName", storage_per_row | type_str},
+        {"FileName", storage_per_row | type_str},
+        {"FileOffset", storage_per_row | type_u64},
+        {"FileSize", storage_per_row | type_u32},
+        {"ExtractSize", storage_zero | type_u32},
+        {"UserString", storage_zero | type_str},
+        {"Unused", storage_per_row | type_u32},
+    };
+
+    const std::vector<UtfColumnSpec> header_columns =
+    {
+        {"ContentOffset", storage_per_row | type_u64},
+        {"Align", storage_per_row | type_u16},
+        {"TocOffset", storage_per_row | type_u64},
+        {"ItocOffset", storage_zero | type_u64},
+        {"EtocOffset", storage_zero | type_u64},
+    };
+
+    // the header size does not depend on the stored values, so a throwaway
+    // packet establishes the content offset
+    const auto header_size = wrap_utf_packet(make_utf_packet(
+        "CpkHeader", header_columns, {{u64(0), u16(0), u64(0)}})).size();
+    const u64 content_offset = 4 + header_size;
+    const u64 toc_offset
+        = content_offset + layla.first.size() + plain_data.size();
+
+    const auto toc_packet = make_utf_packet(
+        "CpkTocInfo",
+        toc_columns,
+        {
+            {
+                u32(0), std::string("dir"), std::string("packed.bin"),
+                u64(0), u32(layla.first.size()), UtfCell(), UtfCell(),
+                u32(0),
+            },
+            {
+                u32(1), std::string(""), std::string("plain.bin"),
+                u64(layla.first.size()), u32(plain_data.size()), UtfCell(),
+                UtfCell(), u32(0),
+            },
+        });
+
+    const auto header_packet = make_utf_packet(
+        "CpkHeader",
+        header_columns,
+        {{content_offset, u16(16), toc_offset}});
+
+    io::MemoryByteStream output_stream;
+    output_stream.write("CPK\x20"_b);
+    output_stream.write(wrap_utf_packet(header_packet));
+    output_stream.write(layla.first);
+    output_stream.write(plain_data);
+    output_stream.write("TOC\x20"_b);
+    output_stream.write(wrap_utf_packet(toc_packet));
+    output_stream.seek(0);
+
+    io::File input_file("test.cpk", output_stream.read_to_eof());
+    CpkArchiveDecoder decoder;
+    const auto actual_files = tests::unpack(decoder, input_file);
+    REQUIRE(actual_files.size() == 2);
+    REQUIRE(actual_files[0]->path == io::path("dir/packed.bin"));
+    REQUIRE(actual_files[0]->stream.seek(0).read_to_eof() == layla.second);
+    REQUIRE(actual_files[1]->path == io::path("plain.bin"));
+    REQUIRE(actual_files[1]->stream.seek(0).read_to_eof() == plain_data);
+}
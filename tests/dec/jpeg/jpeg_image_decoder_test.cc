@@ -16,6 +16,7 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "dec/jpeg/jpeg_image_decoder.h"
+#include <cstdlib>
 #include "io/file_byte_stream.h"
 #include "test_support/catch.h"
 #include "test_support/decoder_support.h"
@@ -43,6 +44,37 @@ TEST_CASE("JPEG 24-bit images", "[dec]")
     REQUIRE(static_cast<int>(color.a) == 0xFF);
 }
 
+TEST_CASE("JPEG header-only metadata", "[dec]")
+{
+    auto input_file = tests::file_from_path(dir + "reimu_opaque.jpg");
+
+    const auto decoder = JpegImageDecoder();
+    const auto metadata = decoder.read_metadata(*input_file);
+    REQUIRE(metadata.width == 1024);
+    REQUIRE(metadata.height == 1024);
+    REQUIRE(metadata.channels == 3);
+}
+
+TEST_CASE("JPEG scaled decoding", "[dec]")
+{
+    auto input_file = tests::file_from_path(dir + "reimu_opaque.jpg");
+
+    const auto decoder = JpegImageDecoder();
+    const Logger logger;
+    const auto image = decoder.decode(logger, *input_file, 8);
+    REQUIRE(image.width() == 128);
+    REQUIRE(image.height() == 128);
+
+    // DCT scaling averages each 8x8 block, so the thumbnail pixel should
+    // sit near the full-resolution sample from the same area
+    const auto color = image.at(25, 12);
+    REQUIRE(std::abs(static_cast<int>(color.r) - 0x60) < 0x20);
+    REQUIRE(std::abs(static_cast<int>(color.g) - 0x97) < 0x20);
+    REQUIRE(std::abs(static_cast<int>(color.b) - 0xE7) < 0x20);
+
+    REQUIRE_THROWS(decoder.decode(logger, *input_file, 3));
+}
+
 TEST_CASE("JPEG 8-bit images", "[dec]")
 {
     const auto decoder = JpegImageDecoder();
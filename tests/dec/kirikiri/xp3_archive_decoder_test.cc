@@ -16,6 +16,10 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "dec/kirikiri/xp3_archive_decoder.h"
+#include "algo/locale.h"
+#include "algo/pack/zlib.h"
+#include "algo/range.h"
+#include "io/memory_byte_stream.h"
 #include "test_support/catch.h"
 #include "test_support/decoder_support.h"
 #include "test_support/file_support.h"
@@ -75,4 +79,80 @@ TEST_CASE("KiriKiri XP3 archives", "[dec]")
     {
         do_test("xp3-time.xp3");
     }
+
+    SECTION("Parallel inflation of large multi-segment entries")
+    {
+        // a synthesized archive crossing the threshold above which the
+        // decoder inflates the segments on separate threads
+        const size_t segment_count = 3;
+        const size_t segment_size = 2 * 1024 * 1024;
+
+        bstr expected_data(segment_count * segment_size);
+        u32 state = 0x12345678;
+        for (const auto i : algo::range(expected_data.size()))
+        {
+            state = state * 0x343FD + 0x269EC3;
+            expected_data[i] = (i % 5 == 0) ? state >> 24 : 'x';
+        }
+
+        io::MemoryByteStream output_stream;
+        output_stream.write("XP3\r\n\x20\x0A\x1A\x8B\x67\x01"_b);
+        const auto table_offset_stub = output_stream.pos();
+        output_stream.write_le<u64>(0);
+
+        std::vector<uoff_t> segment_offsets;
+        std::vector<size_t> segment_sizes_comp;
+        for (const auto i : algo::range(segment_count))
+        {
+            const auto compressed = algo::pack::zlib_deflate(
+                expected_data.substr(i * segment_size, segment_size),
+                algo::pack::ZlibKind::PlainZlib,
+                algo::pack::CompressionLevel::Fast);
+            segment_offsets.push_back(output_stream.pos());
+            segment_sizes_comp.push_back(compressed.size());
+            output_stream.write(compressed);
+        }
+
+        io::MemoryByteStream file_entry_stream;
+        file_entry_stream.write("info"_b);
+        file_entry_stream.write_le<u64>(4 + 8 + 8 + 2 + 16);
+        file_entry_stream.write_le<u32>(0);
+        file_entry_stream.write_le<u64>(expected_data.size());
+        file_entry_stream.write_le<u64>(expected_data.size());
+        file_entry_stream.write_le<u16>(8);
+        file_entry_stream.write(algo::utf8_to_utf16("huge.bin"_b));
+        file_entry_stream.write("segm"_b);
+        file_entry_stream.write_le<u64>(segment_count * 28);
+        for (const auto i : algo::range(segment_count))
+        {
+            file_entry_stream.write_le<u32>(1);
+            file_entry_stream.write_le<u64>(segment_offsets[i]);
+            file_entry_stream.write_le<u64>(segment_size);
+            file_entry_stream.write_le<u64>(segment_sizes_comp[i]);
+        }
+        file_entry_stream.write("adlr"_b);
+        file_entry_stream.write_le<u64>(4);
+        file_entry_stream.write_le<u32>(0);
+
+        file_entry_stream.seek(0);
+        const auto file_entry_data = file_entry_stream.read_to_eof();
+        const auto table_offset = output_stream.pos();
+        output_stream.write<u8>(0);
+        output_stream.write_le<u64>(4 + 8 + file_entry_data.size());
+        output_stream.write("File"_b);
+        output_stream.write_le<u64>(file_entry_data.size());
+        output_stream.write(file_entry_data);
+        output_stream.seek(table_offset_stub);
+        output_stream.write_le<u64>(table_offset);
+
+        output_stream.seek(0);
+        io::File input_file("huge.xp3", output_stream.read_to_eof());
+        Xp3ArchiveDecoder decoder;
+        decoder.plugin_manager.set("noop");
+        const auto actual_files = tests::unpack(decoder, input_file);
+        REQUIRE(actual_files.size() == 1);
+        REQUIRE(actual_files[0]->path.name() == "huge.bin");
+        REQUIRE(actual_files[0]->stream.seek(0).read_to_eof()
+            == expected_data);
+    }
 }
@@ -130,3 +130,50 @@ TEST_CASE("Microsoft BMP images", "[dec]")
         do_test("pal8topdown.bmp", "pal8-out.png");
     }
 }
+
+TEST_CASE("Microsoft BMP banded decoding", "[dec]")
+{
+    Logger dummy_logger;
+    dummy_logger.mute();
+
+    struct CollectingSink final : dec::ImageBandSink
+    {
+        void start(const size_t width, const size_t height) override
+        {
+            image = std::make_unique<res::Image>(width, height);
+        }
+
+        void band(const res::Image &image_band) override
+        {
+            image->overlay(
+                image_band, 0, y, res::Image::OverlayKind::OverwriteAll);
+            y += image_band.height();
+        }
+
+        std::unique_ptr<res::Image> image;
+        size_t y = 0;
+    };
+
+    const auto decoder = BmpImageDecoder();
+    REQUIRE(decoder.supports_banded_decode());
+
+    SECTION("Plain 24-bit images stream through the passthrough path")
+    {
+        io::File file(dir + "rgb24.bmp", io::FileMode::Read);
+        CollectingSink sink;
+        decoder.decode_banded(dummy_logger, file, sink);
+        const auto expected_image = decoder.decode(dummy_logger, file);
+        REQUIRE(sink.y == expected_image.height());
+        tests::compare_images(expected_image, *sink.image);
+    }
+
+    SECTION("Other variants fall back to whole-image decoding")
+    {
+        io::File file(dir + "rgba32.bmp", io::FileMode::Read);
+        CollectingSink sink;
+        decoder.decode_banded(dummy_logger, file, sink);
+        const auto expected_image = decoder.decode(dummy_logger, file);
+        REQUIRE(sink.y == expected_image.height());
+        tests::compare_images(expected_image, *sink.image);
+    }
+}
@@ -0,0 +1,83 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "dec/playstation/swizzle.h"
+#include "algo/cpu.h"
+#include "algo/range.h"
+#include "err.h"
+#include "test_support/catch.h"
+
+using namespace au;
+using namespace au::dec::playstation;
+
+TEST_CASE("Playstation morton deswizzle", "[dec]")
+{
+    SECTION("4x4 square")
+    {
+        bstr input(16);
+        for (const auto i : algo::range(16))
+            input[i] = i;
+        const auto output = deswizzle_morton(input, 4, 4, 1);
+        const bstr expected =
+            "\x00\x01\x04\x05"
+            "\x02\x03\x06\x07"
+            "\x08\x09\x0C\x0D"
+            "\x0A\x0B\x0E\x0F"_b;
+        REQUIRE(output == expected);
+    }
+
+    SECTION("4x2 keeps extra width bits linear")
+    {
+        bstr input(8);
+        for (const auto i : algo::range(8))
+            input[i] = i;
+        const auto output = deswizzle_morton(input, 4, 2, 1);
+        const bstr expected =
+            "\x00\x01\x04\x05"
+            "\x02\x03\x06\x07"_b;
+        REQUIRE(output == expected);
+    }
+
+    SECTION("Wide pixels")
+    {
+        bstr input(16 * 4);
+        for (const auto i : algo::range(16))
+            input.get<u32>()[i] = 0x12340000 + i;
+        const auto output = deswizzle_morton(input, 4, 4, 4);
+        const u32 expected[16] =
+            {0, 1, 4, 5, 2, 3, 6, 7, 8, 9, 12, 13, 10, 11, 14, 15};
+        for (const auto i : algo::range(16))
+            REQUIRE(output.get<const u32>()[i] == 0x12340000 + expected[i]);
+    }
+
+    SECTION("All compiled-in variants agree")
+    {
+        bstr input(64 * 64 * 4);
+        for (const auto i : algo::range(input.size()))
+            input[i] = i * 2654435761u;
+        const auto reference = deswizzle_morton(input, 64, 64, 4);
+        algo::force_cpu_variant(algo::CpuVariant::Scalar);
+        const auto scalar = deswizzle_morton(input, 64, 64, 4);
+        algo::reset_cpu_variant();
+        REQUIRE(scalar == reference);
+    }
+
+    SECTION("Non-power-of-two dimensions are rejected")
+    {
+        REQUIRE_THROWS(deswizzle_morton(bstr(48), 6, 8, 1));
+    }
+}
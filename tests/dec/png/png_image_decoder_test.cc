@@ -99,3 +99,38 @@ TEST_CASE("PNG images with extra chunks", "[dec]")
         REQUIRE(chunks["POSn"] == "\x00\x00\x00\x6C\x00\x00\x00\x60"_b);
     }
 }
+
+TEST_CASE("PNG banded decoding", "[dec]")
+{
+    Logger dummy_logger;
+    dummy_logger.mute();
+    // 720 rows, so the image spans several bands
+    io::File file(dir + "reimu_transparent.png", io::FileMode::Read);
+
+    struct CollectingSink final : dec::ImageBandSink
+    {
+        void start(const size_t width, const size_t height) override
+        {
+            image = std::make_unique<res::Image>(width, height);
+        }
+
+        void band(const res::Image &image_band) override
+        {
+            image->overlay(
+                image_band, 0, y, res::Image::OverlayKind::OverwriteAll);
+            y += image_band.height();
+        }
+
+        std::unique_ptr<res::Image> image;
+        size_t y = 0;
+    };
+
+    const auto decoder = PngImageDecoder();
+    REQUIRE(decoder.supports_banded_decode());
+    CollectingSink sink;
+    decoder.decode_banded(dummy_logger, file, sink);
+    REQUIRE(sink.y == 720);
+
+    const auto expected_image = decoder.decode(dummy_logger, file);
+    tests::compare_images(expected_image, *sink.image);
+}
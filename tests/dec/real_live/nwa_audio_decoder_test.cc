@@ -16,6 +16,7 @@
 // along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
 
 #include "dec/real_live/nwa_audio_decoder.h"
+#include "algo/range.h"
 #include "test_support/audio_support.h"
 #include "test_support/catch.h"
 #include "test_support/decoder_support.h"
@@ -47,4 +48,55 @@ TEST_CASE("RealLive NWA audio", "[dec]")
     {
         do_test("BATSWING-zlib.nwa", "BATSWING-zlib-out.wav");
     }
+
+    SECTION("Uncompressed tracks decode streamed in bounded blocks")
+    {
+        bstr samples(5000);
+        for (const auto i : algo::range(samples.size()))
+            samples[i] = i * 13;
+
+        io::File input_file("test.nwa", ""_b);
+        input_file.stream.write_le<u16>(2);      // channel count
+        input_file.stream.write_le<u16>(16);     // bits per sample
+        input_file.stream.write_le<u32>(44100);  // sample rate
+        input_file.stream.write_le<u32>(0xFFFFFFFF); // no compression
+        input_file.stream.write_le<u32>(0);      // no run length
+        input_file.stream.write_le<u32>(0);      // block count
+        input_file.stream.write_le<u32>(samples.size());
+        input_file.stream.write_le<u32>(0);      // compressed size
+        input_file.stream.write_le<u32>(samples.size() / 2);
+        input_file.stream.write_le<u32>(0);      // block size
+        input_file.stream.write_le<u32>(0);      // rest size
+        input_file.stream.write(samples);
+
+        struct CollectingSink final : dec::AudioBlockSink
+        {
+            void start(const res::Audio &spec) override
+            {
+                this->spec = spec;
+            }
+
+            void block(const bstr &block_samples) override
+            {
+                collected += block_samples;
+            }
+
+            res::Audio spec;
+            bstr collected;
+        };
+
+        const auto decoder = NwaAudioDecoder();
+        REQUIRE(decoder.supports_streamed_decode());
+        CollectingSink sink;
+        Logger dummy_logger;
+        dummy_logger.mute();
+        decoder.decode_streamed(dummy_logger, input_file, sink);
+        REQUIRE(sink.spec.channel_count == 2);
+        REQUIRE(sink.spec.bits_per_sample == 16);
+        REQUIRE(sink.spec.sample_rate == 44100);
+        REQUIRE(sink.collected == samples);
+
+        const auto audio = tests::decode(decoder, input_file);
+        REQUIRE(audio.samples == sink.collected);
+    }
 }
@@ -0,0 +1,120 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "dec/registry.h"
+#include "io/file.h"
+#include "test_support/catch.h"
+
+using namespace au;
+
+TEST_CASE("Registry signature index", "[core]")
+{
+    const auto registry = dec::Registry::create_mock();
+    registry->add_decoder(
+        "test/signed", []() { return std::shared_ptr<dec::IDecoder>(); });
+    registry->add_decoder(
+        "test/unsigned", []() { return std::shared_ptr<dec::IDecoder>(); });
+    registry->add_signature("test/signed", "MAGIC"_b);
+
+    SECTION("Matching signatures keep the decoder as a candidate")
+    {
+        io::File input_file("test.dat", "MAGIC and payload"_b);
+        const auto candidates
+            = registry->get_candidate_decoder_names(input_file);
+        REQUIRE(candidates.count("test/signed"));
+        REQUIRE(candidates.count("test/unsigned"));
+    }
+
+    SECTION("Mismatched signatures rule the decoder out")
+    {
+        io::File input_file("test.dat", "garbage"_b);
+        const auto candidates
+            = registry->get_candidate_decoder_names(input_file);
+        REQUIRE(!candidates.count("test/signed"));
+        REQUIRE(candidates.count("test/unsigned"));
+    }
+
+    SECTION("Files shorter than the signature rule the decoder out")
+    {
+        io::File input_file("test.dat", "MA"_b);
+        const auto candidates
+            = registry->get_candidate_decoder_names(input_file);
+        REQUIRE(!candidates.count("test/signed"));
+        REQUIRE(candidates.count("test/unsigned"));
+    }
+
+    SECTION("Decoders without signatures are always candidates")
+    {
+        io::File input_file("test.dat", ""_b);
+        const auto candidates
+            = registry->get_candidate_decoder_names(input_file);
+        REQUIRE(candidates.count("test/unsigned"));
+    }
+
+    SECTION("Gates rule decoders out from header arithmetic")
+    {
+        registry->add_decoder(
+            "test/gated", []() { return std::shared_ptr<dec::IDecoder>(); });
+        // plausible only when the first byte, read as an entry count,
+        // fits 4-byte records in the file
+        registry->add_gate(
+            "test/gated",
+            1,
+            [](const bstr &prefix, const uoff_t file_size)
+            {
+                return prefix.size() >= 1
+                    && 1 + prefix[0] * 4ull <= file_size;
+            });
+        io::File good_file("test.dat", "\x02........"_b);
+        io::File bad_file("test.dat", "\x99......."_b);
+        io::File empty_file("test.dat", ""_b);
+        REQUIRE(registry->get_candidate_decoder_names(good_file)
+            .count("test/gated"));
+        REQUIRE(!registry->get_candidate_decoder_names(bad_file)
+            .count("test/gated"));
+        REQUIRE(!registry->get_candidate_decoder_names(empty_file)
+            .count("test/gated"));
+    }
+
+    SECTION("Signatures and gates compose")
+    {
+        registry->add_gate(
+            "test/signed",
+            0,
+            [](const bstr &, const uoff_t file_size)
+            {
+                return file_size >= 10;
+            });
+        io::File long_file("test.dat", "MAGIC and payload"_b);
+        io::File short_file("test.dat", "MAGIC"_b);
+        REQUIRE(registry->get_candidate_decoder_names(long_file)
+            .count("test/signed"));
+        REQUIRE(!registry->get_candidate_decoder_names(short_file)
+            .count("test/signed"));
+    }
+
+    SECTION("Signatures at nonzero offsets")
+    {
+        registry->add_signature("test/unsigned", "XYZ"_b, 4);
+        io::File good_file("test.dat", "????XYZ?"_b);
+        io::File bad_file("test.dat", "XYZ?????"_b);
+        REQUIRE(registry->get_candidate_decoder_names(good_file)
+            .count("test/unsigned"));
+        REQUIRE(!registry->get_candidate_decoder_names(bad_file)
+            .count("test/unsigned"));
+    }
+}
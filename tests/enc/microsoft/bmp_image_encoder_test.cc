@@ -49,6 +49,19 @@ TEST_CASE("Microsoft BMP images encoding", "[enc]")
             "\x00\x00\x00\x00\x00\x00\x03\x02\x01\xFF"_b);
     }
 
+    SECTION("Encoding into a caller-provided sink")
+    {
+        const auto input_image = tests::get_opaque_test_image();
+        const auto reference_file
+            = bmp_encoder.encode(dummy_logger, input_image, "test.dat");
+        io::File sink_file("test.dat", ""_b);
+        bmp_encoder.encode(dummy_logger, input_image, sink_file);
+        REQUIRE(sink_file.path.name() == "test.bmp");
+        tests::compare_binary(
+            sink_file.stream.seek(0).read_to_eof(),
+            reference_file->stream.seek(0).read_to_eof());
+    }
+
     SECTION("Bigger image")
     {
         const auto bmp_decoder = dec::microsoft::BmpImageDecoder();
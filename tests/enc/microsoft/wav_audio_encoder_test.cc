@@ -0,0 +1,92 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "enc/microsoft/wav_audio_encoder.h"
+#include "algo/range.h"
+#include "test_support/catch.h"
+
+using namespace au;
+using namespace au::enc::microsoft;
+
+static res::Audio get_test_audio()
+{
+    res::Audio audio;
+    audio.codec = 1;
+    audio.channel_count = 2;
+    audio.bits_per_sample = 16;
+    audio.sample_rate = 44100;
+    audio.samples.resize(4000);
+    for (const auto i : algo::range(audio.samples.size()))
+        audio.samples[i] = i * 7;
+    return audio;
+}
+
+TEST_CASE("Microsoft WAV audio encoding", "[enc]")
+{
+    Logger dummy_logger;
+    dummy_logger.mute();
+
+    SECTION("Block encoding matches whole-track encoding")
+    {
+        const auto input_audio = get_test_audio();
+
+        const auto encoder = WavAudioEncoder();
+        const auto whole_file
+            = encoder.encode(dummy_logger, input_audio, "test.dat");
+        REQUIRE(whole_file->path.name() == "test.wav");
+
+        io::File blocked_file("test.wav", ""_b);
+        {
+            WavBlockEncoder block_encoder(blocked_file.stream, input_audio);
+            const size_t block_size = 999;
+            size_t offset = 0;
+            while (offset < input_audio.samples.size())
+            {
+                const auto size = std::min(
+                    block_size, input_audio.samples.size() - offset);
+                block_encoder.write_block(
+                    input_audio.samples.substr(offset, size));
+                offset += size;
+            }
+            block_encoder.finish();
+        }
+
+        REQUIRE(whole_file->stream.seek(0).read_to_eof()
+            == blocked_file.stream.seek(0).read_to_eof());
+    }
+
+    SECTION("Loop chunks survive block encoding")
+    {
+        auto input_audio = get_test_audio();
+        input_audio.loops.push_back({100, 900, 0});
+
+        const auto encoder = WavAudioEncoder();
+        const auto whole_file
+            = encoder.encode(dummy_logger, input_audio, "test.dat");
+        REQUIRE(whole_file->path.name() == "test.wavloop");
+
+        io::File blocked_file("test.wavloop", ""_b);
+        {
+            WavBlockEncoder block_encoder(blocked_file.stream, input_audio);
+            block_encoder.write_block(input_audio.samples);
+            block_encoder.finish();
+        }
+
+        REQUIRE(whole_file->stream.seek(0).read_to_eof()
+            == blocked_file.stream.seek(0).read_to_eof());
+    }
+}
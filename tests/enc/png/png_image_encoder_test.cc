@@ -0,0 +1,155 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "enc/png/png_image_encoder.h"
+#include "algo/range.h"
+#include "dec/png/png_image_decoder.h"
+#include "test_support/catch.h"
+#include "test_support/image_support.h"
+
+using namespace au;
+using namespace au::enc::png;
+
+TEST_CASE("PNG images encoding", "[enc]")
+{
+    Logger dummy_logger;
+    dummy_logger.mute();
+    const auto png_encoder = PngImageEncoder();
+    const auto png_decoder = dec::png::PngImageDecoder();
+
+    SECTION("Small image")
+    {
+        const auto input_image = tests::get_transparent_test_image();
+        const auto output_file
+            = png_encoder.encode(dummy_logger, input_image, "test.dat");
+        REQUIRE(output_file->path.name() == "test.png");
+        const auto output_image
+            = png_decoder.decode(dummy_logger, *output_file);
+        tests::compare_images(input_image, output_image);
+    }
+
+    SECTION("Compression levels")
+    {
+        const auto input_image = tests::get_opaque_test_image();
+        for (const auto compression_level : {
+            algo::pack::CompressionLevel::Store,
+            algo::pack::CompressionLevel::Fast,
+            algo::pack::CompressionLevel::Good,
+            algo::pack::CompressionLevel::Best})
+        {
+            auto encoder = PngImageEncoder();
+            encoder.compression_level = compression_level;
+            const auto output_file
+                = encoder.encode(dummy_logger, input_image, "test.dat");
+            const auto output_image
+                = png_decoder.decode(dummy_logger, *output_file);
+            tests::compare_images(input_image, output_image);
+        }
+    }
+
+    SECTION("Banded encoding")
+    {
+        const auto input_image = tests::get_transparent_test_image();
+        const auto width = input_image.width();
+        const auto height = input_image.height();
+        io::File output_file("test.png", ""_b);
+        {
+            PngBandEncoder band_encoder(
+                output_file.stream,
+                width,
+                height,
+                algo::pack::CompressionLevel::Fast);
+            const size_t band_height = 13;
+            size_t y = 0;
+            while (y < height)
+            {
+                const auto rows = std::min(band_height, height - y);
+                res::Image band(width, rows);
+                for (const auto band_y : algo::range(rows))
+                for (const auto x : algo::range(width))
+                    band.at(x, band_y) = input_image.at(x, y + band_y);
+                band_encoder.write_band(band);
+                y += rows;
+            }
+            band_encoder.finish();
+        }
+        const auto output_image
+            = png_decoder.decode(dummy_logger, output_file);
+        tests::compare_images(input_image, output_image);
+    }
+
+    SECTION("Grayscale images come out as gray PNG")
+    {
+        res::Image input_image(50, 40);
+        for (const auto y : algo::range(input_image.height()))
+        for (const auto x : algo::range(input_image.width()))
+        {
+            const u8 value = x * 5 + y;
+            input_image.at(x, y) = {value, value, value, 0xFF};
+        }
+        const auto output_file
+            = png_encoder.encode(dummy_logger, input_image, "test.dat");
+        // the color type byte of the IHDR chunk: 0 = grayscale
+        REQUIRE(output_file->stream.seek(25).read<u8>() == 0);
+        const auto output_image
+            = png_decoder.decode(dummy_logger, *output_file);
+        tests::compare_images(input_image, output_image);
+    }
+
+    SECTION("Low-color images come out as palette PNG")
+    {
+        res::Image input_image(50, 40);
+        const res::Pixel colors[] =
+        {
+            {0x00, 0x40, 0x80, 0xFF},
+            {0x11, 0x22, 0x33, 0xFF},
+            {0xFF, 0x00, 0x7F, 0x80},
+            {0x00, 0x00, 0x00, 0x00},
+        };
+        for (const auto y : algo::range(input_image.height()))
+        for (const auto x : algo::range(input_image.width()))
+            input_image.at(x, y) = colors[(x + y) & 3];
+        const auto output_file
+            = png_encoder.encode(dummy_logger, input_image, "test.dat");
+        // the color type byte of the IHDR chunk: 3 = palette
+        REQUIRE(output_file->stream.seek(25).read<u8>() == 3);
+        const auto output_image
+            = png_decoder.decode(dummy_logger, *output_file);
+        tests::compare_images(input_image, output_image);
+    }
+
+    SECTION("Large image taking the parallel path")
+    {
+        res::Image input_image(512, 600);
+        u32 state = 0x12345678;
+        for (const auto y : algo::range(input_image.height()))
+        for (const auto x : algo::range(input_image.width()))
+        {
+            state = state * 0x343FD + 0x269EC3;
+            auto &c = input_image.at(x, y);
+            c.b = state >> 8;
+            c.g = state >> 16;
+            c.r = state >> 24;
+            c.a = 0xFF;
+        }
+        const auto output_file
+            = png_encoder.encode(dummy_logger, input_image, "test.dat");
+        const auto output_image
+            = png_decoder.decode(dummy_logger, *output_file);
+        tests::compare_images(input_image, output_image);
+    }
+}
@@ -0,0 +1,44 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "flow/archive_memo.h"
+#include "test_support/catch.h"
+
+using namespace au;
+
+TEST_CASE("Archive memo", "[flow]")
+{
+    flow::ArchiveMemo memo;
+    io::path prior_name;
+
+    SECTION("The first archive of a kind is recorded, not found")
+    {
+        REQUIRE(!memo.find_or_store("key1"_b, "volume1.arc", prior_name));
+        REQUIRE(!memo.find_or_store("key2"_b, "volume2.arc", prior_name));
+    }
+
+    SECTION("An identical archive resolves to the first one's name")
+    {
+        REQUIRE(!memo.find_or_store("key1"_b, "volume1.arc", prior_name));
+        REQUIRE(memo.find_or_store("key1"_b, "volume2.arc", prior_name));
+        REQUIRE(prior_name.str() == "volume1.arc");
+
+        // the later name must not displace the recorded one
+        REQUIRE(memo.find_or_store("key1"_b, "volume3.arc", prior_name));
+        REQUIRE(prior_name.str() == "volume1.arc");
+    }
+}
@@ -0,0 +1,88 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "flow/file_saver_cas.h"
+#include "algo/crypt/sha1.h"
+#include "algo/str.h"
+#include "io/file_system.h"
+#include "test_support/catch.h"
+
+using namespace au;
+
+static void remove_store(const io::path &store_dir)
+{
+    if (!io::exists(store_dir))
+        return;
+    std::vector<io::path> files, directories;
+    for (const auto &path : io::recursive_directory_range(store_dir))
+    {
+        if (io::is_directory(path))
+            directories.push_back(path);
+        else
+            files.push_back(path);
+    }
+    for (const auto &path : files)
+        io::remove(path);
+    for (auto it = directories.rbegin(); it != directories.rend(); ++it)
+        io::remove(*it);
+    io::remove(store_dir);
+}
+
+TEST_CASE("CAS file saver", "[core]")
+{
+    const io::path store_dir = "cas_test_store";
+    const auto digest = algo::hex(algo::crypt::sha1("content"_b));
+    const auto object_path
+        = store_dir / "objects" / digest.substr(0, 2) / digest;
+    try
+    {
+        {
+            const flow::FileSaverCas file_saver(store_dir);
+            file_saver.save(
+                std::make_shared<io::File>("dir/first.dat", "content"_b));
+            file_saver.save(
+                std::make_shared<io::File>("dir/second.dat", "content"_b));
+            REQUIRE(file_saver.get_saved_file_count() == 2);
+        }
+        REQUIRE(io::exists(object_path));
+        {
+            io::FileByteStream object_stream(object_path, io::FileMode::Read);
+            REQUIRE(object_stream.read_to_eof() == "content"_b);
+        }
+
+        // a second run over the same content adds nothing to the manifest
+        {
+            const flow::FileSaverCas file_saver(store_dir);
+            file_saver.save(
+                std::make_shared<io::File>("dir/first.dat", "content"_b));
+        }
+        io::FileByteStream manifest_stream(
+            store_dir / "manifest.tsv", io::FileMode::Read);
+        const auto lines = algo::split(
+            manifest_stream.read_to_eof().str(), '\n', false);
+        REQUIRE(lines.size() == 2);
+        for (const auto &line : lines)
+            REQUIRE(line.substr(0, digest.size()) == digest);
+
+        remove_store(store_dir);
+    }
+    catch (...)
+    {
+        remove_store(store_dir);
+        throw;
+    }
+}
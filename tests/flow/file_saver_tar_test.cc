@@ -0,0 +1,71 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "flow/file_saver_tar.h"
+#include "io/file_byte_stream.h"
+#include "io/file_system.h"
+#include "test_support/catch.h"
+
+using namespace au;
+
+static std::string read_header_field(
+    const bstr &block, const size_t offset, const size_t size)
+{
+    const auto field = block.substr(offset, size).str();
+    return field.substr(0, field.find('\0'));
+}
+
+TEST_CASE("FileSaverTar", "[core]")
+{
+    const io::path tar_path = "test.tar";
+    try
+    {
+        {
+            const flow::FileSaverTar file_saver(tar_path);
+            file_saver.save(
+                std::make_shared<io::File>("dir/first.txt", "content"_b));
+            file_saver.save(
+                std::make_shared<io::File>("dir/first.txt", "other"_b));
+            REQUIRE(file_saver.get_saved_file_count() == 2);
+        }
+
+        io::FileByteStream tar_stream(tar_path, io::FileMode::Read);
+        // two headers, one data block each, end-of-archive marker
+        REQUIRE(tar_stream.size() == 6 * 512);
+
+        const auto first_header = tar_stream.read(512);
+        REQUIRE(read_header_field(first_header, 0, 100) == "dir/first.txt");
+        REQUIRE(read_header_field(first_header, 124, 12) == "00000000007");
+        REQUIRE(read_header_field(first_header, 257, 6) == "ustar");
+        REQUIRE(tar_stream.read(512).substr(0, 7) == "content"_b);
+
+        const auto second_header = tar_stream.read(512);
+        REQUIRE(read_header_field(second_header, 0, 100)
+            == "dir/first(1).txt");
+        REQUIRE(tar_stream.read(512).substr(0, 5) == "other"_b);
+
+        REQUIRE(tar_stream.read(1024) == bstr(1024));
+
+        io::remove(tar_path);
+    }
+    catch (...)
+    {
+        if (io::exists(tar_path))
+            io::remove(tar_path);
+        throw;
+    }
+}
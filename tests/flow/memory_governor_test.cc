@@ -0,0 +1,51 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "flow/memory_governor.h"
+#include <thread>
+#include "test_support/catch.h"
+
+using namespace au;
+using namespace au::flow;
+
+TEST_CASE("MemoryGovernor", "[core]")
+{
+    SECTION("Zero limit disables accounting")
+    {
+        MemoryGovernor governor;
+        governor.acquire(1000);
+        governor.acquire(1000);
+        governor.release(1000);
+        governor.release(1000);
+    }
+
+    SECTION("Oversized requests are admitted when nothing is in flight")
+    {
+        MemoryGovernor governor(10);
+        const MemoryGuard guard(governor, 1000);
+    }
+
+    SECTION("Releasing unblocks waiting acquirers")
+    {
+        MemoryGovernor governor(10);
+        governor.acquire(10);
+        std::thread releaser([&]() { governor.release(10); });
+        governor.acquire(10);
+        releaser.join();
+        governor.release(10);
+    }
+}
@@ -0,0 +1,78 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "flow/perf_tracker.h"
+#include "io/memory_byte_stream.h"
+#include "test_support/catch.h"
+
+using namespace au;
+using namespace au::flow;
+
+TEST_CASE("Perf tracker JSON report", "[core]")
+{
+    PerfTracker tracker;
+    tracker.add("decoder_a", "decode", 2000000, 100, "slow.dat");
+    tracker.add("decoder_a", "decode", 1000000, 50, "fast.dat");
+    tracker.add("decoder_b", "encode", 3000000, 200);
+
+    RunSummary summary;
+    summary.success_count = 3;
+    summary.error_count = 1;
+    summary.saved_file_count = 2;
+    summary.wall_nanoseconds = 5000000000ull;
+    summary.cpu_seconds = 7.5;
+    summary.memory_limit = 1024;
+    summary.memory_peak = 512;
+    WorkerUtilization worker;
+    worker.busy_nanoseconds = 4000000000ull;
+    worker.lock_wait_nanoseconds = 250000000ull;
+    worker.idle_nanoseconds = 750000000ull;
+    worker.executed_task_count = 4;
+    summary.workers.push_back(worker);
+
+    io::MemoryByteStream output_stream;
+    tracker.write_json_report(output_stream, summary);
+    const auto report = output_stream.seek(0).read_to_eof().str();
+
+    REQUIRE(report.find("\"success_count\": 3") != std::string::npos);
+    REQUIRE(report.find("\"error_count\": 1") != std::string::npos);
+    REQUIRE(report.find("\"saved_file_count\": 2") != std::string::npos);
+    REQUIRE(report.find("\"wall_seconds\": 5.000") != std::string::npos);
+    REQUIRE(report.find("\"cpu_seconds\": 7.500") != std::string::npos);
+    REQUIRE(report.find("\"memory_limit\": 1024") != std::string::npos);
+    REQUIRE(
+        report.find("\"estimated_memory_peak\": 512") != std::string::npos);
+
+    REQUIRE(report.find("\"busy_seconds\": 4.000") != std::string::npos);
+    REQUIRE(report.find("\"lock_wait_seconds\": 0.250") != std::string::npos);
+    REQUIRE(report.find("\"idle_seconds\": 0.750") != std::string::npos);
+    REQUIRE(report.find("\"tasks\": 4") != std::string::npos);
+
+    REQUIRE(report.find("\"category\": \"decoder_a\"") != std::string::npos);
+    REQUIRE(report.find("\"stage\": \"encode\"") != std::string::npos);
+    REQUIRE(report.find("\"calls\": 2") != std::string::npos);
+    REQUIRE(report.find("\"bytes\": 150") != std::string::npos);
+    REQUIRE(report.find("\"p50_milliseconds\": 2.000") != std::string::npos);
+
+    // the slowest files are sorted by duration, so the slow one comes
+    // first even though it was not added last
+    const auto slow = report.find("\"name\": \"slow.dat\"");
+    const auto fast = report.find("\"name\": \"fast.dat\"");
+    REQUIRE(slow != std::string::npos);
+    REQUIRE(fast != std::string::npos);
+    REQUIRE(slow < fast);
+}
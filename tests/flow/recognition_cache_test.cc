@@ -0,0 +1,68 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "flow/recognition_cache.h"
+#include "io/file_byte_stream.h"
+#include "io/file_system.h"
+#include "test_support/catch.h"
+
+using namespace au;
+
+TEST_CASE("RecognitionCache", "[core]")
+{
+    const io::path cache_path = "recognition_cache_test.cache";
+    const io::path input_path = "recognition_cache_test.dat";
+    try
+    {
+        {
+            io::FileByteStream input_stream(input_path, io::FileMode::Write);
+            input_stream.write("original content"_b);
+        }
+
+        {
+            flow::RecognitionCache cache(cache_path);
+            REQUIRE(cache.get_decoder_name(input_path) == "");
+            cache.put_decoder_name(input_path, "test/decoder");
+            REQUIRE(cache.get_decoder_name(input_path) == "test/decoder");
+        }
+
+        {
+            flow::RecognitionCache cache(cache_path);
+            REQUIRE(cache.get_decoder_name(input_path) == "test/decoder");
+            REQUIRE(cache.get_decoder_name("nonexistent.dat") == "");
+        }
+
+        {
+            io::FileByteStream input_stream(input_path, io::FileMode::Write);
+            input_stream.write("changed content, different size"_b);
+        }
+
+        {
+            flow::RecognitionCache cache(cache_path);
+            REQUIRE(cache.get_decoder_name(input_path) == "");
+        }
+
+        io::remove(cache_path);
+        io::remove(input_path);
+    }
+    catch (...)
+    {
+        if (io::exists(cache_path)) io::remove(cache_path);
+        if (io::exists(input_path)) io::remove(input_path);
+        throw;
+    }
+}
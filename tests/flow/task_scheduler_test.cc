@@ -0,0 +1,67 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "flow/task_scheduler.h"
+#include <chrono>
+#include <thread>
+#include "test_support/catch.h"
+
+using namespace au;
+using namespace au::flow;
+
+namespace
+{
+    class SleepTask final : public ITask
+    {
+    public:
+        bool work() const override
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            return true;
+        }
+    };
+}
+
+TEST_CASE("Task scheduler worker utilization", "[core]")
+{
+    TaskScheduler scheduler;
+    for (auto i = 0; i < 4; i++)
+        scheduler.push_back(std::make_shared<SleepTask>());
+
+    const auto result = scheduler.run(2);
+    REQUIRE(result.success_count == 4);
+    REQUIRE(result.error_count == 0);
+
+    const auto stats = scheduler.get_stats();
+    REQUIRE(stats.total_task_count == 4);
+    REQUIRE(stats.finished_task_count == 4);
+    REQUIRE(stats.pending_task_count == 0);
+
+    const auto utilization = scheduler.get_worker_utilization();
+    REQUIRE(utilization.size() == 2);
+    u64 executed_task_count = 0;
+    u64 busy_nanoseconds = 0;
+    for (const auto &worker : utilization)
+    {
+        executed_task_count += worker.executed_task_count;
+        busy_nanoseconds += worker.busy_nanoseconds;
+    }
+    REQUIRE(executed_task_count == 4);
+
+    // four 5 ms sleeps; sleep_for can overshoot but never undershoots
+    REQUIRE(busy_nanoseconds >= 20000000ull);
+}
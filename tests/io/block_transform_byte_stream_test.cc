@@ -0,0 +1,105 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "io/block_transform_byte_stream.h"
+#include "algo/range.h"
+#include "err.h"
+#include "io/memory_byte_stream.h"
+#include "test_support/catch.h"
+#include "test_support/common.h"
+
+using namespace au;
+
+static void xor_block(const uoff_t block_num, bstr &block)
+{
+    for (const auto i : algo::range(block.size()))
+        block[i] ^= 0x40 + block_num;
+}
+
+static bstr make_encrypted(const bstr &plain, const size_t block_size)
+{
+    auto ret = plain;
+    for (const auto i : algo::range(ret.size()))
+        ret[i] ^= 0x40 + i / block_size;
+    return ret;
+}
+
+TEST_CASE("BlockTransformByteStream", "[io][stream]")
+{
+    const auto plain = "0123456789abcdef"_b;
+
+    SECTION("Small reads crossing block boundaries")
+    {
+        io::MemoryByteStream parent_stream(make_encrypted(plain, 4));
+        io::BlockTransformByteStream stream(parent_stream, 4, xor_block);
+        tests::compare_binary(stream.read(3), "012"_b);
+        tests::compare_binary(stream.read(3), "345"_b);
+        tests::compare_binary(stream.read(10), "6789abcdef"_b);
+    }
+
+    SECTION("Unaligned reads after seeking")
+    {
+        io::MemoryByteStream parent_stream(make_encrypted(plain, 4));
+        io::BlockTransformByteStream stream(parent_stream, 4, xor_block);
+        stream.seek(5);
+        tests::compare_binary(stream.read(6), "56789a"_b);
+        stream.seek(1);
+        tests::compare_binary(stream.read(2), "12"_b);
+    }
+
+    SECTION("Block counting over short tail blocks")
+    {
+        io::MemoryByteStream parent_stream(
+            make_encrypted("0123456789"_b, 4));
+        io::BlockTransformByteStream stream(parent_stream, 4, xor_block);
+        stream.seek(8);
+        tests::compare_binary(stream.read(2), "89"_b);
+    }
+
+    SECTION("Empty transforms pass data through")
+    {
+        io::MemoryByteStream parent_stream(plain);
+        io::BlockTransformByteStream stream(
+            parent_stream, 4, io::BlockTransformByteStream::Transform());
+        tests::compare_binary(stream.read(plain.size()), plain);
+    }
+
+    SECTION("Reading beyond EOF")
+    {
+        io::MemoryByteStream parent_stream(make_encrypted(plain, 4));
+        io::BlockTransformByteStream stream(parent_stream, 4, xor_block);
+        stream.seek(14);
+        REQUIRE_THROWS_AS(stream.read(3), err::BadDataSizeError);
+    }
+
+    SECTION("Cloning")
+    {
+        io::MemoryByteStream parent_stream(make_encrypted(plain, 4));
+        io::BlockTransformByteStream stream(parent_stream, 4, xor_block);
+        stream.skip(5);
+        const auto cloned_stream = stream.clone();
+        REQUIRE(cloned_stream->pos() == 5);
+        tests::compare_binary(cloned_stream->read(2), "56"_b);
+    }
+
+    SECTION("Rejecting writes")
+    {
+        io::MemoryByteStream parent_stream(make_encrypted(plain, 4));
+        io::BlockTransformByteStream stream(parent_stream, 4, xor_block);
+        REQUIRE_THROWS_AS(stream.write("test"_b), err::NotSupportedError);
+    }
+}
@@ -0,0 +1,77 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "io/buffered_byte_stream.h"
+#include "err.h"
+#include "io/memory_byte_stream.h"
+#include "test_support/catch.h"
+#include "test_support/common.h"
+
+using namespace au;
+
+TEST_CASE("BufferedByteStream", "[io][stream]")
+{
+    SECTION("Sequential reads crossing chunk boundaries")
+    {
+        io::BufferedByteStream stream(
+            std::make_unique<io::MemoryByteStream>("0123456789"_b), 4);
+        tests::compare_binary(stream.read(3), "012"_b);
+        tests::compare_binary(stream.read(3), "345"_b);
+        tests::compare_binary(stream.read(4), "6789"_b);
+    }
+
+    SECTION("Reads larger than the chunk size")
+    {
+        io::BufferedByteStream stream(
+            std::make_unique<io::MemoryByteStream>("0123456789"_b), 2);
+        tests::compare_binary(stream.read(10), "0123456789"_b);
+    }
+
+    SECTION("Seeking backwards and forwards")
+    {
+        io::BufferedByteStream stream(
+            std::make_unique<io::MemoryByteStream>("0123456789"_b), 4);
+        stream.seek(8);
+        tests::compare_binary(stream.read(2), "89"_b);
+        stream.seek(1);
+        tests::compare_binary(stream.read(2), "12"_b);
+    }
+
+    SECTION("Reading beyond EOF")
+    {
+        io::BufferedByteStream stream(
+            std::make_unique<io::MemoryByteStream>("12"_b), 4);
+        REQUIRE_THROWS_AS(stream.read(3), err::EofError);
+    }
+
+    SECTION("Cloning")
+    {
+        io::BufferedByteStream stream(
+            std::make_unique<io::MemoryByteStream>("0123456789"_b), 4);
+        stream.skip(5);
+        const auto cloned_stream = stream.clone();
+        REQUIRE(cloned_stream->pos() == 5);
+        tests::compare_binary(cloned_stream->read(2), "56"_b);
+    }
+
+    SECTION("Rejecting writes")
+    {
+        io::BufferedByteStream stream(
+            std::make_unique<io::MemoryByteStream>("0123456789"_b), 4);
+        REQUIRE_THROWS_AS(stream.write("test"_b), err::NotSupportedError);
+    }
+}
@@ -29,4 +29,14 @@ TEST_CASE("MemoryByteStream", "[io][stream]")
             []() { return std::make_unique<io::MemoryByteStream>(); },
             []() { });
     }
+
+    SECTION("Copy-on-write cloning")
+    {
+        io::MemoryByteStream stream("0123"_b);
+        const auto cloned_stream = stream.clone();
+        stream.write("xx"_b);
+        stream.seek(0);
+        REQUIRE(stream.read_to_eof() == "xx23"_b);
+        REQUIRE(cloned_stream->read_to_eof() == "0123"_b);
+    }
 }
@@ -0,0 +1,71 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "io/mmap_byte_stream.h"
+#include "err.h"
+#include "io/file_byte_stream.h"
+#include "test_support/catch.h"
+#include "test_support/common.h"
+
+using namespace au;
+
+TEST_CASE("MmapByteStream", "[io][stream]")
+{
+    SECTION("Reading from existing files")
+    {
+        static const bstr png_magic = "\x89PNG"_b;
+        io::MmapByteStream stream(
+            "tests/dec/png/files/reimu_transparent.png");
+        tests::compare_binary(stream.read(png_magic.size()), png_magic);
+    }
+
+    SECTION("Matching FileByteStream contents")
+    {
+        io::MmapByteStream mmap_stream(
+            "tests/dec/png/files/reimu_transparent.png");
+        io::FileByteStream file_stream(
+            "tests/dec/png/files/reimu_transparent.png", io::FileMode::Read);
+        REQUIRE(mmap_stream.size() == file_stream.size());
+        tests::compare_binary(
+            mmap_stream.read_to_eof(), file_stream.read_to_eof());
+    }
+
+    SECTION("Clones sharing the mapping")
+    {
+        io::MmapByteStream stream(
+            "tests/dec/png/files/reimu_transparent.png");
+        stream.skip(2);
+        const auto cloned_stream = stream.clone();
+        REQUIRE(cloned_stream->pos() == 2);
+        REQUIRE(cloned_stream->read<u8>() == stream.read<u8>());
+    }
+
+    SECTION("Rejecting writes")
+    {
+        io::MmapByteStream stream(
+            "tests/dec/png/files/reimu_transparent.png");
+        REQUIRE_THROWS_AS(
+            stream.write("test"_b), err::NotSupportedError);
+    }
+
+    SECTION("Missing files")
+    {
+        REQUIRE_THROWS_AS(
+            io::MmapByteStream("tests/nonexistent.out"),
+            err::FileNotFoundError);
+    }
+}
@@ -0,0 +1,79 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "io/slice_byte_stream.h"
+#include "err.h"
+#include "io/memory_byte_stream.h"
+#include "test_support/catch.h"
+#include "test_support/common.h"
+
+using namespace au;
+
+TEST_CASE("SliceByteStream", "[io][stream]")
+{
+    SECTION("Slicing memory-backed streams")
+    {
+        io::MemoryByteStream parent_stream("0123456789"_b);
+        io::SliceByteStream stream(parent_stream, 2, 5);
+        REQUIRE(stream.size() == 5);
+        tests::compare_binary(stream.read(3), "234"_b);
+        stream.seek(0);
+        tests::compare_binary(stream.read_to_eof(), "23456"_b);
+    }
+
+    SECTION("Nested slices")
+    {
+        io::MemoryByteStream parent_stream("0123456789"_b);
+        io::SliceByteStream outer_stream(parent_stream, 2, 6);
+        io::SliceByteStream inner_stream(outer_stream, 1, 4);
+        REQUIRE(inner_stream.size() == 4);
+        tests::compare_binary(inner_stream.read_to_eof(), "3456"_b);
+    }
+
+    SECTION("Independent slice positions")
+    {
+        io::MemoryByteStream parent_stream("0123456789"_b);
+        io::SliceByteStream stream(parent_stream, 2, 5);
+        parent_stream.seek(9);
+        tests::compare_binary(stream.read(2), "23"_b);
+    }
+
+    SECTION("Reading beyond the slice")
+    {
+        io::MemoryByteStream parent_stream("0123456789"_b);
+        io::SliceByteStream stream(parent_stream, 2, 5);
+        stream.seek(4);
+        REQUIRE_THROWS_AS(stream.read(2), err::EofError);
+    }
+
+    SECTION("Slices exceeding the parent stream")
+    {
+        io::MemoryByteStream parent_stream("0123456789"_b);
+        REQUIRE_THROWS_AS(
+            io::SliceByteStream(parent_stream, 2, 9), err::BadDataSizeError);
+    }
+
+    SECTION("Cloning")
+    {
+        io::MemoryByteStream parent_stream("0123456789"_b);
+        io::SliceByteStream stream(parent_stream, 2, 5);
+        stream.skip(2);
+        const auto cloned_stream = stream.clone();
+        REQUIRE(cloned_stream->pos() == 2);
+        tests::compare_binary(cloned_stream->read(2), "45"_b);
+    }
+}
@@ -0,0 +1,55 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "io/stream_stats.h"
+#include "io/memory_byte_stream.h"
+#include "test_support/catch.h"
+
+using namespace au;
+using namespace au::io;
+
+TEST_CASE("Stream I/O statistics", "[io]")
+{
+    StreamStats::set_label("stats_test");
+    StreamStats::reset();
+    StreamStats::enable();
+
+    io::MemoryByteStream stream("0123456789abcdef"_b);
+    stream.read(4);
+    stream.read_le<u32>();
+    stream.seek(0);
+    stream.write("xy"_b);
+
+    StreamStats::disable();
+    StreamStats::set_label("");
+
+    const auto entry = StreamStats::get("stats_test");
+    REQUIRE(entry.read_count == 2);
+    REQUIRE(entry.read_bytes == 8);
+    REQUIRE(entry.write_count == 1);
+    REQUIRE(entry.write_bytes == 2);
+    REQUIRE(entry.seek_count == 1);
+
+    // both reads were 4 bytes, landing in the <=4 bucket
+    REQUIRE(entry.read_size_buckets[2] == 2);
+    for (const auto i : {0, 1, 3, 4, 5})
+        REQUIRE(entry.read_size_buckets[i] == 0);
+
+    // nothing is recorded while disabled
+    stream.seek(0).read(2);
+    REQUIRE(StreamStats::get("stats_test").read_count == 2);
+}
@@ -26,3 +26,36 @@ TEST_CASE("Pixel properties", "[res]")
     REQUIRE(sizeof(res::Pixel) == 4);
     REQUIRE(std::is_pod<res::Pixel>::value);
 }
+
+TEST_CASE("Packed pixel accessors", "[res]")
+{
+    SECTION("A pixel reads as one 0xAARRGGBB word")
+    {
+        const res::Pixel pixel = {0x11, 0x22, 0x33, 0x44};
+        REQUIRE(res::read_packed(&pixel) == 0x44332211);
+    }
+
+    SECTION("Words write back into the component bytes")
+    {
+        res::Pixel pixel = {0, 0, 0, 0};
+        res::write_packed(&pixel, 0x44332211);
+        REQUIRE(pixel.b == 0x11);
+        REQUIRE(pixel.g == 0x22);
+        REQUIRE(pixel.r == 0x33);
+        REQUIRE(pixel.a == 0x44);
+    }
+
+    SECTION("Block transfers round trip")
+    {
+        res::Pixel pixels[8];
+        u32 block[8];
+        for (const auto i : {0, 1, 2, 3, 4, 5, 6, 7})
+            block[i] = 0x01010101 * i;
+        res::write_packed(pixels, block);
+        u32 readback[8];
+        res::read_packed(pixels, readback);
+        for (const auto i : {0, 1, 2, 3, 4, 5, 6, 7})
+            REQUIRE(readback[i] == block[i]);
+        REQUIRE(pixels[3].a == 3);
+    }
+}
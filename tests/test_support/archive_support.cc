@@ -0,0 +1,155 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "test_support/archive_support.h"
+#include "algo/format.h"
+#include "algo/locale.h"
+#include "algo/range.h"
+#include "io/memory_byte_stream.h"
+
+using namespace au;
+
+std::string tests::synthetic_entry_name(const size_t index)
+{
+    return algo::format("entry_%04zu.dat", index);
+}
+
+bstr tests::synthetic_entry_data(
+    const SyntheticArchiveSpec &spec, const size_t index)
+{
+    bstr data(spec.entry_size);
+    auto data_ptr = data.get<u8>();
+    u32 state = spec.seed ^ (static_cast<u32>(index) * 0x9E3779B9);
+    for (const auto i : algo::range(spec.entry_size))
+    {
+        state = state * 0x343FD + 0x269EC3;
+        // a compressible byte repeats; the rest is pseudo-random noise
+        data_ptr[i] = (state >> 16) % 100 < spec.compressibility_percent
+            ? 0x61
+            : state >> 24;
+    }
+    return data;
+}
+
+std::unique_ptr<io::File> tests::create_nsa_archive(
+    const SyntheticArchiveSpec &spec)
+{
+    size_t table_size = 2 + 4;
+    for (const auto i : algo::range(spec.entry_count))
+        table_size += synthetic_entry_name(i).size() + 1 + 1 + 4 + 4 + 4;
+
+    io::MemoryByteStream output_stream;
+    output_stream.write_be<u16>(spec.entry_count);
+    output_stream.write_be<u32>(table_size);
+    size_t offset = 0;
+    for (const auto i : algo::range(spec.entry_count))
+    {
+        output_stream.write(bstr(synthetic_entry_name(i)));
+        output_stream.write<u8>(0);
+        output_stream.write<u8>(0); // compression type: none
+        output_stream.write_be<u32>(offset);
+        output_stream.write_be<u32>(spec.entry_size);
+        output_stream.write_be<u32>(spec.entry_size);
+        offset += spec.entry_size;
+    }
+    for (const auto i : algo::range(spec.entry_count))
+        output_stream.write(synthetic_entry_data(spec, i));
+
+    return std::make_unique<io::File>(
+        "synthetic.nsa", output_stream.seek(0).read_to_eof());
+}
+
+std::unique_ptr<io::File> tests::create_xp3_archive(
+    const SyntheticArchiveSpec &spec)
+{
+    static const bstr magic = "XP3\r\n\x20\x0A\x1A\x8B\x67\x01"_b;
+    const auto header_size = magic.size() + 8;
+
+    io::MemoryByteStream table_stream;
+    for (const auto i : algo::range(spec.entry_count))
+    {
+        const auto name = algo::utf8_to_utf16(
+            bstr(synthetic_entry_name(i)));
+
+        io::MemoryByteStream entry_stream;
+        entry_stream.write("info"_b);
+        entry_stream.write_le<u64>(4 + 8 + 8 + 2 + name.size());
+        entry_stream.write_le<u32>(0); // flags
+        entry_stream.write_le<u64>(spec.entry_size);
+        entry_stream.write_le<u64>(spec.entry_size);
+        entry_stream.write_le<u16>(name.size() / 2);
+        entry_stream.write(name);
+
+        entry_stream.write("segm"_b);
+        entry_stream.write_le<u64>(4 + 8 + 8 + 8);
+        entry_stream.write_le<u32>(0); // flags: not compressed
+        entry_stream.write_le<u64>(header_size + i * spec.entry_size);
+        entry_stream.write_le<u64>(spec.entry_size);
+        entry_stream.write_le<u64>(spec.entry_size);
+
+        entry_stream.write("adlr"_b);
+        entry_stream.write_le<u64>(4);
+        entry_stream.write_le<u32>(i + 1);
+
+        const auto entry_data = entry_stream.seek(0).read_to_eof();
+        table_stream.write("File"_b);
+        table_stream.write_le<u64>(entry_data.size());
+        table_stream.write(entry_data);
+    }
+    const auto table_data = table_stream.seek(0).read_to_eof();
+
+    io::MemoryByteStream output_stream;
+    output_stream.write(magic);
+    output_stream.write_le<u64>(
+        header_size + spec.entry_count * spec.entry_size);
+    for (const auto i : algo::range(spec.entry_count))
+        output_stream.write(synthetic_entry_data(spec, i));
+    output_stream.write<u8>(0); // table is not compressed
+    output_stream.write_le<u64>(table_data.size());
+    output_stream.write(table_data);
+
+    return std::make_unique<io::File>(
+        "synthetic.xp3", output_stream.seek(0).read_to_eof());
+}
+
+std::unique_ptr<io::File> tests::create_packdat_archive(
+    const SyntheticArchiveSpec &spec)
+{
+    static const size_t name_field_size = 32;
+    const auto data_start
+        = 8 + 4 + 4 + spec.entry_count * (name_field_size + 4 * 4);
+
+    io::MemoryByteStream output_stream;
+    output_stream.write("PACKDAT."_b);
+    output_stream.write_le<u32>(spec.entry_count);
+    output_stream.write_le<u32>(0);
+    for (const auto i : algo::range(spec.entry_count))
+    {
+        const auto name = synthetic_entry_name(i);
+        output_stream.write(bstr(name));
+        output_stream.write(bstr(name_field_size - name.size()));
+        output_stream.write_le<u32>(data_start + i * spec.entry_size);
+        output_stream.write_le<u32>(0); // flags: not encrypted
+        output_stream.write_le<u32>(spec.entry_size);
+        output_stream.write_le<u32>(spec.entry_size);
+    }
+    for (const auto i : algo::range(spec.entry_count))
+        output_stream.write(synthetic_entry_data(spec, i));
+
+    return std::make_unique<io::File>(
+        "synthetic.dat", output_stream.seek(0).read_to_eof());
+}
@@ -0,0 +1,58 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <memory>
+#include "io/file.h"
+
+namespace au {
+namespace tests {
+
+    // Knobs for synthetic corpora: everything is derived from the seed,
+    // so a spec fully reproduces an archive - benchmarks and stress
+    // tests can be shared without shipping game data.
+    struct SyntheticArchiveSpec final
+    {
+        size_t entry_count = 10;
+        size_t entry_size = 1024;
+        // 0: incompressible noise, 100: a single repeated byte
+        size_t compressibility_percent = 50;
+        u32 seed = 0x12345678;
+    };
+
+    std::string synthetic_entry_name(const size_t index);
+
+    // The payload the generated archives store for the index-th entry;
+    // tests compare decode output against it.
+    bstr synthetic_entry_data(
+        const SyntheticArchiveSpec &spec, const size_t index);
+
+    // NScripter NSA archive with uncompressed entries.
+    std::unique_ptr<io::File> create_nsa_archive(
+        const SyntheticArchiveSpec &spec);
+
+    // KiriKiri XP3 version 1 archive, single uncompressed segment per
+    // entry; decode with the "noop" plugin.
+    std::unique_ptr<io::File> create_xp3_archive(
+        const SyntheticArchiveSpec &spec);
+
+    // SystemEpsilon PACKDAT archive with plain entries.
+    std::unique_ptr<io::File> create_packdat_archive(
+        const SyntheticArchiveSpec &spec);
+
+} }
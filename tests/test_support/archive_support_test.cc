@@ -0,0 +1,78 @@
+// Copyright (C) 2016 by rr-
+//
+// This file is part of arc_unpacker.
+//
+// arc_unpacker is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or (at
+// your option) any later version.
+//
+// arc_unpacker is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with arc_unpacker. If not, see <http://www.gnu.org/licenses/>.
+
+#include "test_support/archive_support.h"
+#include "dec/kirikiri/xp3_archive_decoder.h"
+#include "dec/nscripter/nsa_archive_decoder.h"
+#include "dec/system_epsilon/packdat_archive_decoder.h"
+#include "test_support/catch.h"
+#include "test_support/decoder_support.h"
+#include "test_support/file_support.h"
+
+using namespace au;
+using namespace au::tests;
+
+static std::vector<std::shared_ptr<io::File>> expected_files(
+    const SyntheticArchiveSpec &spec)
+{
+    std::vector<std::shared_ptr<io::File>> files;
+    for (size_t i = 0; i < spec.entry_count; i++)
+    {
+        files.push_back(tests::stub_file(
+            synthetic_entry_name(i), synthetic_entry_data(spec, i)));
+    }
+    return files;
+}
+
+TEST_CASE("Synthetic archive generator", "[dec]")
+{
+    SyntheticArchiveSpec spec;
+    spec.entry_count = 5;
+    spec.entry_size = 3000;
+
+    SECTION("Generation is deterministic")
+    {
+        const auto archive1 = create_nsa_archive(spec);
+        const auto archive2 = create_nsa_archive(spec);
+        tests::compare_files(*archive1, *archive2, true);
+    }
+
+    SECTION("NSA archives decode to the synthetic payloads")
+    {
+        const auto decoder = dec::nscripter::NsaArchiveDecoder();
+        const auto input_file = create_nsa_archive(spec);
+        const auto actual_files = tests::unpack(decoder, *input_file);
+        tests::compare_files(actual_files, expected_files(spec), true);
+    }
+
+    SECTION("XP3 archives decode to the synthetic payloads")
+    {
+        dec::kirikiri::Xp3ArchiveDecoder decoder;
+        decoder.plugin_manager.set("noop");
+        const auto input_file = create_xp3_archive(spec);
+        const auto actual_files = tests::unpack(decoder, *input_file);
+        tests::compare_files(actual_files, expected_files(spec), true);
+    }
+
+    SECTION("PACKDAT archives decode to the synthetic payloads")
+    {
+        const auto decoder = dec::system_epsilon::PackdatArchiveDecoder();
+        const auto input_file = create_packdat_archive(spec);
+        const auto actual_files = tests::unpack(decoder, *input_file);
+        tests::compare_files(actual_files, expected_files(spec), true);
+    }
+}
@@ -43,6 +43,7 @@ std::vector<std::shared_ptr<io::File>> tests::flow_unpack(
         file_saver,
         registry,
         enable_nested_decoding,
+        algo::pack::CompressionLevel::Fast,
         {},
         std::set<std::string>(name_list.begin(), name_list.end()));
 
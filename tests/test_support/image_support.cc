@@ -40,7 +40,7 @@ static inline bool compare_pixels(
             return true;
         WARN(algo::format(
             "Pixels differ at %d, %d: %02x%02x%02x%02x != %02x%02x%02x%02x",
-            x, y,
+            static_cast<int>(x), static_cast<int>(y),
             actual.b, actual.g, actual.r, actual.a,
             expected.b, expected.g, expected.r, expected.a));
         return false;
@@ -53,6 +53,26 @@ void tests::stream_test(
             REQUIRE(stream->size() == 4);
         }
 
+        SECTION("Reading into caller-provided buffers")
+        {
+            stream->write("\x01\x02\x03\x04"_b).seek(0);
+            u8 destination[4] = {0, 0, 0, 0};
+            stream->read(destination, 4);
+            REQUIRE(destination[0] == 1);
+            REQUIRE(destination[3] == 4);
+            REQUIRE(stream->pos() == 4);
+        }
+
+        SECTION("Reading into reusable buffers")
+        {
+            stream->write("\x01\x02\x03\x04"_b).seek(0);
+            bstr scratch;
+            stream->read_into(scratch, 3);
+            tests::compare_binary(scratch, "\x01\x02\x03"_b);
+            stream->read_into(scratch, 1);
+            tests::compare_binary(scratch, "\x04"_b);
+        }
+
         SECTION("Writing integers")
         {
             stream->write_le<u32>(1);